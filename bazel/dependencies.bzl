@@ -27,12 +27,13 @@ def _com_github_google_benchmark():
 
 def _com_github_axboe_liburing():
     """
-    linux/io_uring.h shipped by distribution is old
+    linux/io_uring.h shipped by distribution is old. Since 2.2, the raw
+    syscall wrappers return -errno.
     """
     new_git_repository(
         name = "liburing",
         remote = "https://github.com/axboe/liburing",
-        commit = "556960942eaa69fd53544932f00db3fa9f196e00",
+        tag = "liburing-2.5",
         build_file = "@bipolar//bazel/external:liburing.BUILD",
     )
 
@@ -0,0 +1,115 @@
+#include "bipolar/async/channel.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bipolar;
+
+namespace {
+constexpr std::int64_t kItemsPerProducer = 100000;
+
+// Sends `n` integers, suspending while the channel is full
+auto make_producer(MpscSender<std::int64_t>& tx, std::int64_t n) {
+    return make_promise(
+        [&tx, n, i = std::int64_t(0),
+         sending = Option<Promise<Void, ChannelError>>()](
+            Context& ctx) mutable -> Result<Void, ChannelError> {
+            for (; i < n; ++i) {
+                if (!sending.has_value()) {
+                    sending.emplace(tx.send(std::int64_t(i)).box());
+                }
+                auto result = sending.value()(ctx);
+                if (result.is_pending()) {
+                    return Pending{};
+                }
+                sending.clear();
+                if (result.is_error()) {
+                    return Err(result.take_error());
+                }
+            }
+            return Ok(Void{});
+        });
+}
+
+// Receives up to `batch` integers at once until every sender is gone
+auto make_consumer(MpscReceiver<std::int64_t>& rx, std::size_t batch,
+                   std::int64_t& sum) {
+    using Batch = Promise<std::vector<std::int64_t>, ChannelError>;
+    return make_promise([&rx, batch, &sum, receiving = Option<Batch>()](
+                            Context& ctx) mutable -> Result<Void, Void> {
+        for (;;) {
+            if (!receiving.has_value()) {
+                receiving.emplace(rx.recv_many(batch).box());
+            }
+            auto result = receiving.value()(ctx);
+            if (result.is_pending()) {
+                return Pending{};
+            }
+            receiving.clear();
+            if (result.is_error()) {
+                return Ok(Void{});
+            }
+            for (auto x : result.value()) {
+                sum += x;
+            }
+        }
+    });
+}
+} // namespace
+
+// Producers and the consumer run on their own executor and thread.
+// Arguments: number of producers, `recv_many()` batch size
+static void BM_mpsc_across_executors(benchmark::State& state) {
+    const auto producers = static_cast<int>(state.range(0));
+    const auto batch = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state) {
+        auto [tx, rx] = make_mpsc_channel<std::int64_t>(1024);
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([tx = tx]() mutable {
+                SingleThreadedExecutor executor;
+                executor.schedule_task(
+                    PendingTask(make_producer(tx, kItemsPerProducer)));
+                executor.run();
+            });
+        }
+        { auto dropped = std::move(tx); }
+
+        std::int64_t sum = 0;
+        SingleThreadedExecutor executor;
+        executor.schedule_task(PendingTask(make_consumer(rx, batch, sum)));
+        executor.run();
+        benchmark::DoNotOptimize(sum);
+
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * producers *
+                            kItemsPerProducer);
+}
+BENCHMARK(BM_mpsc_across_executors)
+    ->Args({1, 1})
+    ->Args({1, 64})
+    ->Args({4, 1})
+    ->Args({4, 64})
+    ->UseRealTime();
+
+// The single-threaded cost of a round trip through the channel
+static void BM_mpsc_try_send_try_recv(benchmark::State& state) {
+    auto [tx, rx] = make_mpsc_channel<std::int64_t>(1024);
+
+    for (auto _ : state) {
+        (void)tx.try_send(1);
+        benchmark::DoNotOptimize(rx.try_recv());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_mpsc_try_send_try_recv);
@@ -0,0 +1,502 @@
+//! Channels
+//!
+//! Bounded channels handing values between tasks, possibly running on
+//! different executors:
+//! - `make_mpsc_channel()`: many senders, one receiver
+//! - `make_oneshot_channel()`: a single value
+//! - `make_broadcast_channel()`: every receiver gets every value
+//!
+
+#ifndef BIPOLAR_ASYNC_CHANNEL_HPP_
+#define BIPOLAR_ASYNC_CHANNEL_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bipolar/async/channel_error.hpp"
+#include "bipolar/async/internal/channel.hpp"
+#include "bipolar/async/stream.hpp"
+#include "bipolar/core/movable.hpp"
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/promise.hpp"
+
+namespace bipolar {
+/// MpscSender
+///
+/// The sending side of a MPSC channel, created by `make_mpsc_channel()`.
+///
+/// Senders are copyable, the receiver sees the channel closed once every
+/// sender is destroyed.
+///
+/// The promises returned by `send()` refer to the sender which must outlive
+/// them.
+template <typename T>
+class MpscSender final {
+public:
+    explicit MpscSender(std::shared_ptr<internal::MpscChannel<T>> chan) noexcept
+        : chan_(std::move(chan)) {}
+
+    MpscSender(const MpscSender& rhs) : chan_(rhs.chan_) {
+        if (chan_) {
+            chan_->add_sender();
+        }
+    }
+
+    MpscSender(MpscSender&& rhs) noexcept = default;
+
+    MpscSender& operator=(const MpscSender& rhs) {
+        MpscSender(rhs).swap(*this);
+        return *this;
+    }
+
+    MpscSender& operator=(MpscSender&& rhs) noexcept {
+        MpscSender(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~MpscSender() {
+        if (chan_) {
+            chan_->drop_sender();
+        }
+    }
+
+    /// Sends `item` if the channel has room for it, without waiting.
+    ///
+    /// `item` is only moved from on success. Fails with:
+    /// - `ChannelError::FULL` if the channel is full
+    /// - `ChannelError::CLOSED` if the receiver is gone
+    Result<Void, ChannelError> try_send(T&& item) {
+        return chan_->try_send(item);
+    }
+
+    /// Returns an unboxed promise which sends `item`, suspending the task
+    /// while the channel is full.
+    ///
+    /// Fails with `ChannelError::CLOSED` if the receiver is gone.
+    /// Parked senders are resumed in FIFO order.
+    auto send(T item) {
+        return PromiseImpl(
+            internal::MpscSendContinuation<T>(chan_.get(), std::move(item)));
+    }
+
+    /// Returns true if the receiver is gone
+    bool is_closed() const noexcept {
+        return chan_->is_closed_by_receiver();
+    }
+
+    /// Returns the number of values the channel can hold
+    std::size_t capacity() const noexcept {
+        return chan_->capacity();
+    }
+
+    void swap(MpscSender& rhs) noexcept {
+        chan_.swap(rhs.chan_);
+    }
+
+private:
+    std::shared_ptr<internal::MpscChannel<T>> chan_;
+};
+
+/// MpscReceiver
+///
+/// The receiving side of a MPSC channel, created by `make_mpsc_channel()`.
+///
+/// The promises returned by `recv()` and `recv_many()` refer to the receiver
+/// which must outlive them.
+template <typename T>
+class MpscReceiver final : public Movable {
+public:
+    explicit MpscReceiver(
+        std::shared_ptr<internal::MpscChannel<T>> chan) noexcept
+        : chan_(std::move(chan)) {}
+
+    MpscReceiver(MpscReceiver&& rhs) noexcept = default;
+
+    MpscReceiver& operator=(MpscReceiver&& rhs) noexcept {
+        MpscReceiver(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~MpscReceiver() {
+        if (chan_) {
+            chan_->close_receiver();
+        }
+    }
+
+    /// Receives a value if there is one, without waiting.
+    ///
+    /// Fails with:
+    /// - `ChannelError::EMPTY` if the channel is empty
+    /// - `ChannelError::CLOSED` if the channel is empty and every sender is
+    ///   gone
+    Result<T, ChannelError> try_recv() {
+        return chan_->try_recv();
+    }
+
+    /// Returns an unboxed promise which receives a value, suspending the task
+    /// while the channel is empty.
+    ///
+    /// Fails with `ChannelError::CLOSED` once the channel is empty and every
+    /// sender is gone.
+    auto recv() {
+        return PromiseImpl(internal::MpscRecvContinuation<T>(chan_.get()));
+    }
+
+    /// Returns an unboxed promise which receives at least one and at most
+    /// `max` values at once, suspending the task while the channel is empty.
+    ///
+    /// It amortizes the cost of polling when values arrive in bursts.
+    ///
+    /// Fails with `ChannelError::CLOSED` once the channel is empty and every
+    /// sender is gone.
+    /// Asserts that `max` is not 0.
+    auto recv_many(std::size_t max) {
+        return PromiseImpl(
+            internal::MpscRecvManyContinuation<T>(chan_.get(), max));
+    }
+
+    /// Converts the receiver into a `Stream` which ends once the channel is
+    /// empty and every sender is gone.
+    Stream<T, ChannelError> into_stream() && {
+        return make_stream([rx = std::move(*this)](Context& ctx) mutable
+                           -> Result<Option<T>, ChannelError> {
+            auto result = rx.chan_->poll_recv(ctx);
+            if (result.is_ok()) {
+                return Ok(Some(result.take_value()));
+            }
+            if (result.is_pending()) {
+                return Pending{};
+            }
+            if (result.error() == ChannelError::CLOSED) {
+                return Ok(Option<T>(None));
+            }
+            return Err(result.take_error());
+        });
+    }
+
+    void swap(MpscReceiver& rhs) noexcept {
+        chan_.swap(rhs.chan_);
+    }
+
+private:
+    std::shared_ptr<internal::MpscChannel<T>> chan_;
+};
+
+/// make_mpsc_channel
+///
+/// Creates a bounded multi-producer, single-consumer channel holding up to
+/// `capacity` values, rounded up to a power of 2, with a minimum of 2.
+///
+/// Sending and receiving are lock-free unless a task has to be suspended:
+/// senders suspend while the channel is full and the receiver while it's
+/// empty.
+///
+/// # Examples
+///
+/// ```
+/// auto [tx, rx] = make_mpsc_channel<int>(1024);
+///
+/// // on an executor
+/// executor1.schedule_task(PendingTask(tx.send(42)));
+///
+/// // on another executor
+/// executor2.schedule_task(PendingTask(rx.recv().and_then(
+///     [](int& x) -> Result<Void, ChannelError> { ... })));
+/// ```
+template <typename T>
+std::tuple<MpscSender<T>, MpscReceiver<T>>
+make_mpsc_channel(std::size_t capacity) {
+    auto chan = std::make_shared<internal::MpscChannel<T>>(capacity);
+    return {MpscSender<T>(chan), MpscReceiver<T>(chan)};
+}
+
+/// OneshotSender
+///
+/// The sending side of a oneshot channel, created by
+/// `make_oneshot_channel()`.
+///
+/// Destroying the sender without sending closes the channel.
+template <typename T>
+class OneshotSender final : public Movable {
+public:
+    explicit OneshotSender(
+        std::shared_ptr<internal::OneshotChannel<T>> chan) noexcept
+        : chan_(std::move(chan)) {}
+
+    OneshotSender(OneshotSender&& rhs) noexcept = default;
+
+    OneshotSender& operator=(OneshotSender&& rhs) noexcept {
+        OneshotSender(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~OneshotSender() {
+        if (chan_) {
+            chan_->close_sender();
+        }
+    }
+
+    /// Sends `value` and resumes the receiver if it's waiting.
+    ///
+    /// Fails with `ChannelError::CLOSED` if the receiver is gone.
+    /// Asserts that nothing was sent yet.
+    Result<Void, ChannelError> send(T value) {
+        assert(chan_ && "value already sent");
+        auto chan = std::move(chan_);
+        return chan->send(std::move(value));
+    }
+
+    /// Returns true if the receiver is gone
+    bool is_closed() const noexcept {
+        return !chan_ || chan_->is_closed_by_receiver();
+    }
+
+    void swap(OneshotSender& rhs) noexcept {
+        chan_.swap(rhs.chan_);
+    }
+
+private:
+    std::shared_ptr<internal::OneshotChannel<T>> chan_;
+};
+
+/// OneshotReceiver
+///
+/// The receiving side of a oneshot channel, created by
+/// `make_oneshot_channel()`.
+///
+/// The promise returned by `recv()` refers to the receiver which must
+/// outlive it.
+template <typename T>
+class OneshotReceiver final : public Movable {
+public:
+    explicit OneshotReceiver(
+        std::shared_ptr<internal::OneshotChannel<T>> chan) noexcept
+        : chan_(std::move(chan)) {}
+
+    OneshotReceiver(OneshotReceiver&& rhs) noexcept = default;
+
+    OneshotReceiver& operator=(OneshotReceiver&& rhs) noexcept {
+        OneshotReceiver(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~OneshotReceiver() {
+        if (chan_) {
+            chan_->close_receiver();
+        }
+    }
+
+    /// Receives the value if it was sent, without waiting.
+    ///
+    /// Fails with:
+    /// - `ChannelError::EMPTY` if nothing was sent yet
+    /// - `ChannelError::CLOSED` if the sender is gone without sending or the
+    ///   value was already received
+    Result<T, ChannelError> try_recv() {
+        return chan_->try_recv();
+    }
+
+    /// Returns an unboxed promise which receives the value, suspending the
+    /// task until it's sent.
+    ///
+    /// Fails with `ChannelError::CLOSED` if the sender is gone without
+    /// sending.
+    auto recv() {
+        return PromiseImpl(internal::OneshotRecvContinuation<T>(chan_.get()));
+    }
+
+    void swap(OneshotReceiver& rhs) noexcept {
+        chan_.swap(rhs.chan_);
+    }
+
+private:
+    std::shared_ptr<internal::OneshotChannel<T>> chan_;
+};
+
+/// make_oneshot_channel
+///
+/// Creates a channel for sending a single value.
+///
+/// Both sides are lock-free: they synchronize through a single atomic word.
+///
+/// # Examples
+///
+/// ```
+/// auto [tx, rx] = make_oneshot_channel<std::string>();
+///
+/// std::thread t([tx = std::move(tx)]() mutable { tx.send("done"); });
+///
+/// executor.schedule_task(PendingTask(rx.recv().and_then(
+///     [](std::string& s) -> Result<Void, ChannelError> { ... })));
+/// ```
+template <typename T>
+std::tuple<OneshotSender<T>, OneshotReceiver<T>> make_oneshot_channel() {
+    auto chan = std::make_shared<internal::OneshotChannel<T>>();
+    return {OneshotSender<T>(chan), OneshotReceiver<T>(chan)};
+}
+
+// forward
+template <typename T>
+class BroadcastReceiver;
+
+/// BroadcastSender
+///
+/// The sending side of a broadcast channel, created by
+/// `make_broadcast_channel()`.
+///
+/// Senders are copyable, the receivers see the channel closed once every
+/// sender is destroyed.
+///
+/// The promises returned by `send()` refer to the sender which must outlive
+/// them.
+template <typename T>
+class BroadcastSender final {
+    template <typename U>
+    friend class BroadcastReceiver;
+
+public:
+    explicit BroadcastSender(
+        std::shared_ptr<internal::BroadcastChannel<T>> chan) noexcept
+        : chan_(std::move(chan)) {}
+
+    BroadcastSender(const BroadcastSender& rhs) : chan_(rhs.chan_) {
+        if (chan_) {
+            chan_->add_sender();
+        }
+    }
+
+    BroadcastSender(BroadcastSender&& rhs) noexcept = default;
+
+    BroadcastSender& operator=(const BroadcastSender& rhs) {
+        BroadcastSender(rhs).swap(*this);
+        return *this;
+    }
+
+    BroadcastSender& operator=(BroadcastSender&& rhs) noexcept {
+        BroadcastSender(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~BroadcastSender() {
+        if (chan_) {
+            chan_->drop_sender();
+        }
+    }
+
+    /// Creates a new receiver which gets the values sent from now on
+    BroadcastReceiver<T> subscribe() {
+        return BroadcastReceiver<T>(chan_);
+    }
+
+    /// Sends `item` if the channel has room for it, without waiting.
+    ///
+    /// `item` is only moved from on success. Fails with:
+    /// - `ChannelError::FULL` if some receiver hasn't read the oldest value
+    /// - `ChannelError::CLOSED` if there is no receiver
+    Result<Void, ChannelError> try_send(T&& item) {
+        return chan_->try_send(item);
+    }
+
+    /// Returns an unboxed promise which sends `item`, suspending the task
+    /// while some receiver hasn't read the oldest value.
+    ///
+    /// Fails with `ChannelError::CLOSED` if there is no receiver.
+    auto send(T item) {
+        return PromiseImpl(internal::BroadcastSendContinuation<T>(
+            chan_.get(), std::move(item)));
+    }
+
+    void swap(BroadcastSender& rhs) noexcept {
+        chan_.swap(rhs.chan_);
+    }
+
+private:
+    std::shared_ptr<internal::BroadcastChannel<T>> chan_;
+};
+
+/// BroadcastReceiver
+///
+/// A receiving side of a broadcast channel, created by
+/// `make_broadcast_channel()` or `BroadcastSender::subscribe()`.
+///
+/// Each receiver gets a copy of every value sent after its creation, the
+/// last one to read a value gets it moved.
+///
+/// The promises returned by `recv()` refer to the receiver which must
+/// outlive them.
+template <typename T>
+class BroadcastReceiver final : public Movable {
+public:
+    explicit BroadcastReceiver(
+        std::shared_ptr<internal::BroadcastChannel<T>> chan)
+        : chan_(std::move(chan)), next_(chan_->add_receiver()) {}
+
+    BroadcastReceiver(BroadcastReceiver&& rhs) noexcept = default;
+
+    BroadcastReceiver& operator=(BroadcastReceiver&& rhs) noexcept {
+        BroadcastReceiver(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~BroadcastReceiver() {
+        if (chan_) {
+            chan_->drop_receiver(next_);
+        }
+    }
+
+    /// Receives the next value if there is one, without waiting.
+    ///
+    /// Fails with:
+    /// - `ChannelError::EMPTY` if there is no new value
+    /// - `ChannelError::CLOSED` if there is no new value and every sender is
+    ///   gone
+    Result<T, ChannelError> try_recv() {
+        return chan_->try_recv(next_);
+    }
+
+    /// Returns an unboxed promise which receives the next value, suspending
+    /// the task until there is one.
+    ///
+    /// Fails with `ChannelError::CLOSED` once there is no new value and every
+    /// sender is gone.
+    auto recv() {
+        return PromiseImpl(
+            internal::BroadcastRecvContinuation<T>(chan_.get(), &next_));
+    }
+
+    void swap(BroadcastReceiver& rhs) noexcept {
+        chan_.swap(rhs.chan_);
+        std::swap(next_, rhs.next_);
+    }
+
+private:
+    std::shared_ptr<internal::BroadcastChannel<T>> chan_;
+    std::uint64_t next_;
+};
+
+/// make_broadcast_channel
+///
+/// Creates a bounded broadcast channel holding up to `capacity` values.
+///
+/// Every value is delivered to every receiver. Senders suspend while the
+/// slowest receiver lags `capacity` values behind.
+///
+/// Unlike the MPSC channel, every operation takes a lock. `T` must be copy
+/// constructible.
+template <typename T>
+std::tuple<BroadcastSender<T>, BroadcastReceiver<T>>
+make_broadcast_channel(std::size_t capacity) {
+    auto chan = std::make_shared<internal::BroadcastChannel<T>>(capacity);
+    return {BroadcastSender<T>(chan), BroadcastReceiver<T>(chan)};
+}
+
+} // namespace bipolar
+
+#endif
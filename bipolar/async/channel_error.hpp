@@ -0,0 +1,21 @@
+#ifndef BIPOLAR_ASYNC_CHANNEL_ERROR_HPP_
+#define BIPOLAR_ASYNC_CHANNEL_ERROR_HPP_
+
+namespace bipolar {
+/// ChannelError
+///
+/// Describes why a value couldn't be sent or received
+enum class ChannelError {
+    /// The channel has no room for the value
+    FULL,
+    /// The channel has no value
+    EMPTY,
+    /// The other side of the channel is gone.
+    ///
+    /// A receiver only gets it once every value sent was received.
+    CLOSED,
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef BIPOLAR_ASYNC_INTERNAL_BOUNDED_QUEUE_HPP_
+#define BIPOLAR_ASYNC_INTERNAL_BOUNDED_QUEUE_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/sync/cacheline.hpp"
+
+#include <boost/noncopyable.hpp>
+
+namespace bipolar {
+namespace internal {
+// BoundedQueue
+//
+// A lock-free bounded MPMC queue, see
+// http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//
+// Every cell carries a sequence number telling whether it's ready to be
+// written or read for a given lap of the ring, so producers and consumers
+// only contend on their own position counter.
+//
+// The capacity is rounded up to a power of 2, and is 2 at least: with a
+// single cell, the sequence number of a full cell would equal the one of
+// the free cell of the next lap.
+template <typename T>
+class BoundedQueue final : public boost::noncopyable {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "T must be nothrow move constructible");
+
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : mask_(round_up(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedQueue() {
+        while (try_pop().has_value()) {
+        }
+    }
+
+    std::size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    // Moves `item` into the queue, leaving it untouched if the queue is full
+    bool try_push(T& item) noexcept {
+        Cell* cell;
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) -
+                              static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // full
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (&cell->storage) T(std::move(item));
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    Option<T> try_pop() noexcept {
+        Cell* cell;
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) -
+                              static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // empty
+                return None;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* p = std::launder(reinterpret_cast<T*>(&cell->storage));
+        Option<T> item(Some(std::move(*p)));
+        p->~T();
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return item;
+    }
+
+    // Returns the approximate number of items
+    std::size_t size() const noexcept {
+        const std::size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+        const std::size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    static std::size_t round_up(std::size_t n) noexcept {
+        std::size_t cap = 2; // see the class comment
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+    };
+
+    const std::size_t mask_;
+    const std::unique_ptr<Cell[]> cells_;
+
+    alignas(BIPOLAR_CACHELINE_SIZE) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(BIPOLAR_CACHELINE_SIZE) std::atomic<std::size_t> dequeue_pos_{0};
+};
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
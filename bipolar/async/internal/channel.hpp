@@ -0,0 +1,778 @@
+#ifndef BIPOLAR_ASYNC_INTERNAL_CHANNEL_HPP_
+#define BIPOLAR_ASYNC_INTERNAL_CHANNEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "bipolar/async/channel_error.hpp"
+#include "bipolar/async/internal/bounded_queue.hpp"
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+#include "bipolar/sync/cacheline.hpp"
+#include "bipolar/sync/spinlock.hpp"
+
+#include <boost/noncopyable.hpp>
+
+namespace bipolar {
+namespace internal {
+// MpscChannel
+//
+// The state shared by the senders and the receiver of a MPSC channel.
+//
+// Values go through a lock-free `BoundedQueue`. The lock only guards the
+// parked tasks: a sender facing a full queue or a receiver facing an empty
+// one parks its task, then tries again since the other side may have made
+// progress meanwhile. The other side checks the `*_waiting_` counters after
+// each push/pop, both sides being ordered by a sequentially consistent fence,
+// so that a parked task cannot be missed while the uncontended path never
+// takes the lock.
+//
+// Parked tasks are always resumed or released outside the lock since either
+// may run or destroy the task, which may re-enter the channel.
+template <typename T>
+class MpscChannel final : public boost::noncopyable {
+public:
+    explicit MpscChannel(std::size_t capacity) : queue_(capacity) {}
+
+    std::size_t capacity() const noexcept {
+        return queue_.capacity();
+    }
+
+    void add_sender() noexcept {
+        senders_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void drop_sender() {
+        if (senders_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake_receiver();
+        }
+    }
+
+    void close_receiver() {
+        rx_closed_.store(true, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake_senders(true);
+    }
+
+    bool is_closed_by_receiver() const noexcept {
+        return rx_closed_.load(std::memory_order_acquire);
+    }
+
+    bool is_closed_by_senders() const noexcept {
+        return senders_.load(std::memory_order_acquire) == 0;
+    }
+
+    Result<Void, ChannelError> try_send(T& item) {
+        if (is_closed_by_receiver()) {
+            return Err(ChannelError::CLOSED);
+        }
+        if (!queue_.try_push(item)) {
+            return Err(ChannelError::FULL);
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (rx_waiting_.load(std::memory_order_relaxed)) {
+            wake_receiver();
+        }
+        return Ok(Void{});
+    }
+
+    Result<T, ChannelError> try_recv() {
+        auto item = queue_.try_pop();
+        if (!item.has_value()) {
+            if (!is_closed_by_senders()) {
+                return Err(ChannelError::EMPTY);
+            }
+
+            // values pushed before the last sender was dropped are visible
+            item = queue_.try_pop();
+            if (!item.has_value()) {
+                return Err(ChannelError::CLOSED);
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (tx_waiting_.load(std::memory_order_relaxed) > 0) {
+            wake_senders(false);
+        }
+        return Ok(std::move(item.value()));
+    }
+
+    // Polls to send `item`, parking the task if the channel is full.
+    //
+    // `waiter` holds the parking ticket of the caller across polls.
+    Result<Void, ChannelError> poll_send(Context& ctx, T& item,
+                                         Option<std::uint64_t>& waiter) {
+        for (bool parked = false;;) {
+            auto result = try_send(item);
+            if (result.is_ok() || result.error() != ChannelError::FULL) {
+                cancel_sender(waiter);
+                return result;
+            }
+            if (parked) {
+                return Pending{};
+            }
+
+            // replaces a registration left by a previous poll
+            cancel_sender(waiter);
+            waiter = Some(park_sender(ctx.suspend_task()));
+            parked = true;
+        }
+    }
+
+    // Polls to receive a value, parking the task if the channel is empty
+    Result<T, ChannelError> poll_recv(Context& ctx) {
+        for (bool parked = false;;) {
+            auto result = try_recv();
+            if (result.is_ok() || result.error() != ChannelError::EMPTY) {
+                if (parked) {
+                    unpark_receiver();
+                }
+                return result;
+            }
+            if (parked) {
+                return Pending{};
+            }
+
+            park_receiver(ctx.suspend_task());
+            parked = true;
+        }
+    }
+
+    // Unregisters a parked sender. If the sender was already woken up but
+    // won't be polled again, the wake up is handed to another parked sender.
+    void abandon_sender(Option<std::uint64_t>& waiter) {
+        if (waiter.has_value() && !unpark_sender(waiter.value())) {
+            wake_senders(false);
+        }
+        waiter.clear();
+    }
+
+private:
+    void cancel_sender(Option<std::uint64_t>& waiter) {
+        if (waiter.has_value()) {
+            unpark_sender(waiter.value());
+            waiter.clear();
+        }
+    }
+
+    std::uint64_t park_sender(SuspendedTask task) {
+        std::uint64_t id;
+        {
+            std::lock_guard lock(lock_);
+            id = next_id_++;
+            tx_tasks_.emplace_back(id, std::move(task));
+            tx_waiting_.store(tx_tasks_.size(), std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return id;
+    }
+
+    // Returns false if the sender isn't parked anymore
+    bool unpark_sender(std::uint64_t id) {
+        SuspendedTask task;
+        {
+            std::lock_guard lock(lock_);
+            for (auto iter = tx_tasks_.begin(); iter != tx_tasks_.end();
+                 ++iter) {
+                if (iter->first == id) {
+                    task = std::move(iter->second);
+                    tx_tasks_.erase(iter);
+                    tx_waiting_.store(tx_tasks_.size(),
+                                      std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+        return static_cast<bool>(task);
+    }
+
+    void wake_senders(bool all) {
+        std::vector<SuspendedTask> tasks;
+        {
+            std::lock_guard lock(lock_);
+            while (!tx_tasks_.empty()) {
+                tasks.push_back(std::move(tx_tasks_.front().second));
+                tx_tasks_.pop_front();
+                if (!all) {
+                    break;
+                }
+            }
+            tx_waiting_.store(tx_tasks_.size(), std::memory_order_relaxed);
+        }
+
+        for (auto& task : tasks) {
+            task.resume_task();
+        }
+    }
+
+    void park_receiver(SuspendedTask task) {
+        {
+            std::lock_guard lock(lock_);
+            std::swap(rx_task_, task);
+            rx_waiting_.store(true, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // `task` is now the stale ticket of a previous poll, if any
+    }
+
+    void unpark_receiver() {
+        SuspendedTask task;
+        std::lock_guard lock(lock_);
+        std::swap(rx_task_, task);
+        rx_waiting_.store(false, std::memory_order_relaxed);
+        // `task` is released outside the lock
+    }
+
+    void wake_receiver() {
+        SuspendedTask task;
+        {
+            std::lock_guard lock(lock_);
+            std::swap(rx_task_, task);
+            rx_waiting_.store(false, std::memory_order_relaxed);
+        }
+        if (task) {
+            task.resume_task();
+        }
+    }
+
+private:
+    BoundedQueue<T> queue_;
+
+    alignas(BIPOLAR_CACHELINE_SIZE) std::atomic<std::size_t> senders_{1};
+    std::atomic<bool> rx_closed_{false};
+    std::atomic<bool> rx_waiting_{false};
+    std::atomic<std::size_t> tx_waiting_{0};
+
+    SpinLock lock_;
+    SuspendedTask rx_task_ BIPOLAR_GUARDED_BY(lock_);
+    std::deque<std::pair<std::uint64_t, SuspendedTask>>
+        tx_tasks_ BIPOLAR_GUARDED_BY(lock_);
+    std::uint64_t next_id_ BIPOLAR_GUARDED_BY(lock_) = 0;
+};
+
+// The continuation produced by `MpscSender::send()`
+template <typename T>
+class MpscSendContinuation {
+public:
+    MpscSendContinuation(MpscChannel<T>* chan, T item)
+        : chan_(chan), item_(std::move(item)) {}
+
+    MpscSendContinuation(MpscSendContinuation&& rhs)
+        : chan_(rhs.chan_), item_(std::move(rhs.item_)),
+          waiter_(std::move(rhs.waiter_)) {
+        rhs.waiter_.clear();
+    }
+
+    ~MpscSendContinuation() {
+        if (waiter_.has_value()) {
+            chan_->abandon_sender(waiter_);
+        }
+    }
+
+    Result<Void, ChannelError> operator()(Context& ctx) {
+        return chan_->poll_send(ctx, item_, waiter_);
+    }
+
+private:
+    MpscChannel<T>* chan_;
+    T item_;
+    Option<std::uint64_t> waiter_;
+};
+
+// The continuation produced by `MpscReceiver::recv()`
+template <typename T>
+class MpscRecvContinuation {
+public:
+    explicit MpscRecvContinuation(MpscChannel<T>* chan) noexcept
+        : chan_(chan) {}
+
+    Result<T, ChannelError> operator()(Context& ctx) {
+        return chan_->poll_recv(ctx);
+    }
+
+private:
+    MpscChannel<T>* chan_;
+};
+
+// The continuation produced by `MpscReceiver::recv_many()`
+template <typename T>
+class MpscRecvManyContinuation {
+public:
+    MpscRecvManyContinuation(MpscChannel<T>* chan, std::size_t max) noexcept
+        : chan_(chan), max_(max) {
+        assert(max_ > 0);
+    }
+
+    Result<std::vector<T>, ChannelError> operator()(Context& ctx) {
+        auto first = chan_->poll_recv(ctx);
+        if (!first.is_ok()) {
+            if (first.is_pending()) {
+                return Pending{};
+            }
+            return Err(first.take_error());
+        }
+
+        std::vector<T> items;
+        items.reserve(std::min(max_, chan_->capacity()));
+        items.push_back(first.take_value());
+        while (items.size() < max_) {
+            auto item = chan_->try_recv();
+            if (!item.is_ok()) {
+                break;
+            }
+            items.push_back(item.take_value());
+        }
+        return Ok(std::move(items));
+    }
+
+private:
+    MpscChannel<T>* chan_;
+    const std::size_t max_;
+};
+
+// OneshotChannel
+//
+// The state shared by the two ends of a oneshot channel.
+//
+// `state_` is the only synchronization: the sender publishes the value by
+// setting `VALUE`, the receiver publishes its task by setting `RX_TASK`.
+// Each side only touches the other side's data after observing its flag and
+// the receiver clears `RX_TASK` before replacing its task.
+template <typename T>
+class OneshotChannel final : public boost::noncopyable {
+public:
+    static constexpr std::uint32_t VALUE = 1;
+    static constexpr std::uint32_t TX_CLOSED = 2;
+    static constexpr std::uint32_t RX_CLOSED = 4;
+    static constexpr std::uint32_t RX_TASK = 8;
+
+    Result<Void, ChannelError> send(T value) {
+        value_ = Some(std::move(value));
+        const std::uint32_t prev =
+            state_.fetch_or(VALUE | TX_CLOSED, std::memory_order_acq_rel);
+        if (prev & RX_CLOSED) {
+            // the value is destroyed along with the channel
+            return Err(ChannelError::CLOSED);
+        }
+        if (prev & RX_TASK) {
+            rx_task_.resume_task();
+        }
+        return Ok(Void{});
+    }
+
+    void close_sender() {
+        const std::uint32_t prev =
+            state_.fetch_or(TX_CLOSED, std::memory_order_acq_rel);
+        if ((prev & RX_TASK) && !(prev & VALUE)) {
+            rx_task_.resume_task();
+        }
+    }
+
+    void close_receiver() noexcept {
+        state_.fetch_or(RX_CLOSED, std::memory_order_acq_rel);
+    }
+
+    bool is_closed_by_receiver() const noexcept {
+        return state_.load(std::memory_order_acquire) & RX_CLOSED;
+    }
+
+    Result<T, ChannelError> try_recv() {
+        return ready(state_.load(std::memory_order_acquire),
+                     ChannelError::EMPTY);
+    }
+
+    Result<T, ChannelError> poll_recv(Context& ctx) {
+        std::uint32_t state = state_.load(std::memory_order_acquire);
+        if (state & (VALUE | TX_CLOSED)) {
+            return ready(state, ChannelError::EMPTY);
+        }
+
+        if (state & RX_TASK) {
+            // retracts the task of a previous poll before replacing it
+            state = state_.fetch_and(~RX_TASK, std::memory_order_acq_rel);
+            if (state & (VALUE | TX_CLOSED)) {
+                return ready(state, ChannelError::EMPTY);
+            }
+        }
+
+        rx_task_ = ctx.suspend_task();
+        state = state_.fetch_or(RX_TASK, std::memory_order_acq_rel);
+        if (state & (VALUE | TX_CLOSED)) {
+            // the sender completed before seeing our task
+            rx_task_.reset();
+            return ready(state, ChannelError::EMPTY);
+        }
+        return Pending{};
+    }
+
+private:
+    Result<T, ChannelError> ready(std::uint32_t state, ChannelError empty) {
+        if ((state & VALUE) && value_.has_value()) {
+            auto value = std::move(value_.value());
+            value_.clear();
+            return Ok(std::move(value));
+        }
+        if (state & TX_CLOSED) {
+            return Err(ChannelError::CLOSED);
+        }
+        return Err(empty);
+    }
+
+private:
+    std::atomic<std::uint32_t> state_{0};
+    Option<T> value_;
+    SuspendedTask rx_task_;
+};
+
+// The continuation produced by `OneshotReceiver::recv()`
+template <typename T>
+class OneshotRecvContinuation {
+public:
+    explicit OneshotRecvContinuation(OneshotChannel<T>* chan) noexcept
+        : chan_(chan) {}
+
+    Result<T, ChannelError> operator()(Context& ctx) {
+        return chan_->poll_recv(ctx);
+    }
+
+private:
+    OneshotChannel<T>* chan_;
+};
+
+// BroadcastChannel
+//
+// The state shared by the ends of a broadcast channel.
+//
+// Every value is stored once with the number of receivers which haven't
+// read it yet. The last reader moves it out and frees the slot. Senders
+// are parked while the oldest value is unread, receivers while they have
+// read everything.
+//
+// Unlike `MpscChannel` every operation takes the lock, values being shared
+// by several receivers.
+//
+// A parked send or receive keeps its `Waiter` across polls, so that polling
+// it again replaces its ticket instead of queueing another one, and dropping
+// it unregisters it.
+template <typename T>
+class BroadcastChannel final : public boost::noncopyable {
+public:
+    // A parked send or receive, guarded by the lock of the channel
+    struct Waiter {
+        SuspendedTask task;
+        bool queued = false;
+    };
+
+    explicit BroadcastChannel(std::size_t capacity) : slots_(capacity) {
+        assert(capacity > 0);
+    }
+
+    void add_sender() {
+        std::lock_guard lock(lock_);
+        ++senders_;
+    }
+
+    void drop_sender() {
+        std::vector<SuspendedTask> tasks;
+        {
+            std::lock_guard lock(lock_);
+            if (--senders_ == 0) {
+                take(rx_waiters_, tasks);
+            }
+        }
+        resume(tasks);
+    }
+
+    // Returns the sequence number of the next value the receiver will read
+    std::uint64_t add_receiver() {
+        std::lock_guard lock(lock_);
+        ++receivers_;
+        return tail_;
+    }
+
+    void drop_receiver(std::uint64_t next) {
+        std::vector<SuspendedTask> tasks;
+        {
+            std::lock_guard lock(lock_);
+            --receivers_;
+            for (; next < tail_; ++next) {
+                consume(next);
+            }
+            if (receivers_ == 0 || advance()) {
+                take(tx_waiters_, tasks);
+            }
+        }
+        resume(tasks);
+    }
+
+    Result<Void, ChannelError> try_send(T& item) {
+        std::shared_ptr<Waiter> waiter;
+        return poll_send(nullptr, item, waiter);
+    }
+
+    Result<T, ChannelError> try_recv(std::uint64_t& next) {
+        std::shared_ptr<Waiter> waiter;
+        return poll_recv(nullptr, next, waiter);
+    }
+
+    // Sends `item`. If the channel is full, parks the task of `ctx` in
+    // `waiter`, or fails with `FULL` if `ctx` is null.
+    Result<Void, ChannelError> poll_send(Context* ctx, T& item,
+                                         std::shared_ptr<Waiter>& waiter) {
+        // the stale ticket of a previous poll is released after the lock
+        for (SuspendedTask task;;) {
+            std::vector<SuspendedTask> tasks;
+            Result<Void, ChannelError> result = Pending{};
+            {
+                std::lock_guard lock(lock_);
+                if (receivers_ == 0) {
+                    result = Err(ChannelError::CLOSED);
+                } else if (tail_ - head_ == slots_.size()) {
+                    if (!ctx) {
+                        return Err(ChannelError::FULL);
+                    }
+                    if (task) {
+                        park(tx_waiters_, waiter, task);
+                        return Pending{};
+                    }
+                } else {
+                    Slot& slot = slots_[tail_ % slots_.size()];
+                    slot.value = Some(std::move(item));
+                    slot.unread = receivers_;
+                    ++tail_;
+                    take(rx_waiters_, tasks);
+                    result = Ok(Void{});
+                }
+
+                if (!result.is_pending()) {
+                    unpark(tx_waiters_, waiter, task);
+                }
+            }
+
+            if (!result.is_pending()) {
+                resume(tasks);
+                return result;
+            }
+            // obtained without holding the lock, then checks again
+            task = ctx->suspend_task();
+        }
+    }
+
+    // Receives the value numbered `next`. If there is none yet, parks the
+    // task of `ctx` in `waiter`, or fails with `EMPTY` if `ctx` is null.
+    Result<T, ChannelError> poll_recv(Context* ctx, std::uint64_t& next,
+                                      std::shared_ptr<Waiter>& waiter) {
+        // the stale ticket of a previous poll is released after the lock
+        for (SuspendedTask task;;) {
+            std::vector<SuspendedTask> tasks;
+            Result<T, ChannelError> result = Pending{};
+            {
+                std::lock_guard lock(lock_);
+                if (next != tail_) {
+                    result = read(next, tasks);
+                } else if (senders_ == 0) {
+                    result = Err(ChannelError::CLOSED);
+                } else if (!ctx) {
+                    return Err(ChannelError::EMPTY);
+                } else if (task) {
+                    park(rx_waiters_, waiter, task);
+                    return Pending{};
+                }
+
+                if (!result.is_pending()) {
+                    unpark(rx_waiters_, waiter, task);
+                }
+            }
+
+            if (!result.is_pending()) {
+                resume(tasks);
+                return result;
+            }
+            // obtained without holding the lock, then checks again
+            task = ctx->suspend_task();
+        }
+    }
+
+    // Unregisters the waiter of a dropped send
+    void cancel_send(std::shared_ptr<Waiter>& waiter) {
+        SuspendedTask task;
+        std::lock_guard lock(lock_);
+        unpark(tx_waiters_, waiter, task);
+        // `task` is released outside the lock
+    }
+
+    // Unregisters the waiter of a dropped receive
+    void cancel_recv(std::shared_ptr<Waiter>& waiter) {
+        SuspendedTask task;
+        std::lock_guard lock(lock_);
+        unpark(rx_waiters_, waiter, task);
+        // `task` is released outside the lock
+    }
+
+private:
+    struct Slot {
+        Option<T> value;
+        std::size_t unread = 0;
+    };
+
+    Result<T, ChannelError> read(std::uint64_t& next,
+                                 std::vector<SuspendedTask>& tasks)
+        BIPOLAR_REQUIRES(lock_) {
+        Slot& slot = slots_[next % slots_.size()];
+        ++next;
+        if (slot.unread > 1) {
+            --slot.unread;
+            return Ok(T(slot.value.value()));
+        }
+
+        // the last reader takes the value
+        T value = std::move(slot.value.value());
+        slot.value.clear();
+        slot.unread = 0;
+        if (advance()) {
+            take(tx_waiters_, tasks);
+        }
+        return Ok(std::move(value));
+    }
+
+    void consume(std::uint64_t seq) BIPOLAR_REQUIRES(lock_) {
+        Slot& slot = slots_[seq % slots_.size()];
+        if (--slot.unread == 0) {
+            slot.value.clear();
+        }
+    }
+
+    // Frees the slots read by every receiver, returns true if any
+    bool advance() BIPOLAR_REQUIRES(lock_) {
+        const std::uint64_t head = head_;
+        while (head_ < tail_ && slots_[head_ % slots_.size()].unread == 0) {
+            ++head_;
+        }
+        return head_ != head;
+    }
+
+    // Queues `waiter` in `waiters` unless it already is, and swaps `task`
+    // with its ticket
+    static void park(std::vector<std::shared_ptr<Waiter>>& waiters,
+                     std::shared_ptr<Waiter>& waiter, SuspendedTask& task) {
+        if (!waiter) {
+            waiter = std::make_shared<Waiter>();
+        }
+        if (!waiter->queued) {
+            waiter->queued = true;
+            waiters.push_back(waiter);
+        }
+        std::swap(waiter->task, task);
+    }
+
+    // Removes `waiter` from `waiters` if queued, its ticket is swapped with
+    // `task`
+    static void unpark(std::vector<std::shared_ptr<Waiter>>& waiters,
+                       std::shared_ptr<Waiter>& waiter, SuspendedTask& task) {
+        if (!waiter) {
+            return;
+        }
+        if (waiter->queued) {
+            waiters.erase(std::find(waiters.begin(), waiters.end(), waiter));
+            std::swap(waiter->task, task);
+        }
+        waiter.reset();
+    }
+
+    // Moves the tickets of `waiters` into `tasks`, to be resumed outside the
+    // lock
+    static void take(std::vector<std::shared_ptr<Waiter>>& waiters,
+                     std::vector<SuspendedTask>& tasks) {
+        for (auto& waiter : waiters) {
+            waiter->queued = false;
+            tasks.push_back(std::move(waiter->task));
+        }
+        waiters.clear();
+    }
+
+    static void resume(std::vector<SuspendedTask>& tasks) {
+        for (auto& task : tasks) {
+            task.resume_task();
+        }
+    }
+
+private:
+    std::mutex lock_;
+    std::vector<Slot> slots_ BIPOLAR_GUARDED_BY(lock_);
+    std::uint64_t head_ BIPOLAR_GUARDED_BY(lock_) = 0;
+    std::uint64_t tail_ BIPOLAR_GUARDED_BY(lock_) = 0;
+    std::size_t senders_ BIPOLAR_GUARDED_BY(lock_) = 1;
+    std::size_t receivers_ BIPOLAR_GUARDED_BY(lock_) = 0;
+    std::vector<std::shared_ptr<Waiter>> tx_waiters_ BIPOLAR_GUARDED_BY(lock_);
+    std::vector<std::shared_ptr<Waiter>> rx_waiters_ BIPOLAR_GUARDED_BY(lock_);
+};
+
+// The continuation produced by `BroadcastSender::send()`
+template <typename T>
+class BroadcastSendContinuation {
+public:
+    BroadcastSendContinuation(BroadcastChannel<T>* chan, T item)
+        : chan_(chan), item_(std::move(item)) {}
+
+    BroadcastSendContinuation(BroadcastSendContinuation&&) = default;
+
+    ~BroadcastSendContinuation() {
+        if (waiter_) {
+            chan_->cancel_send(waiter_);
+        }
+    }
+
+    Result<Void, ChannelError> operator()(Context& ctx) {
+        return chan_->poll_send(&ctx, item_, waiter_);
+    }
+
+private:
+    BroadcastChannel<T>* chan_;
+    T item_;
+    std::shared_ptr<typename BroadcastChannel<T>::Waiter> waiter_;
+};
+
+// The continuation produced by `BroadcastReceiver::recv()`
+template <typename T>
+class BroadcastRecvContinuation {
+public:
+    BroadcastRecvContinuation(BroadcastChannel<T>* chan,
+                              std::uint64_t* next) noexcept
+        : chan_(chan), next_(next) {}
+
+    BroadcastRecvContinuation(BroadcastRecvContinuation&&) noexcept = default;
+
+    ~BroadcastRecvContinuation() {
+        if (waiter_) {
+            chan_->cancel_recv(waiter_);
+        }
+    }
+
+    Result<T, ChannelError> operator()(Context& ctx) {
+        return chan_->poll_recv(&ctx, *next_, waiter_);
+    }
+
+private:
+    BroadcastChannel<T>* chan_;
+    std::uint64_t* next_;
+    std::shared_ptr<typename BroadcastChannel<T>::Waiter> waiter_;
+};
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,410 @@
+#ifndef BIPOLAR_ASYNC_INTERNAL_STREAM_ADAPTOR_HPP_
+#define BIPOLAR_ASYNC_INTERNAL_STREAM_ADAPTOR_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bipolar/async/sink.hpp"
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/internal/adaptor.hpp"
+#include "bipolar/futures/internal/join_waker.hpp"
+
+namespace bipolar {
+namespace internal {
+// Converts a pending or failed poll of an upstream stream to the result type
+// of the downstream one
+template <typename R, typename T, typename E>
+constexpr R propagate_non_ok(Result<T, E>& result) {
+    if (result.is_pending()) {
+        return Pending{};
+    }
+    return Err(result.take_error());
+}
+
+// The source produced by `make_stream()`
+template <typename StreamHandler>
+using StreamSource = ContextHandlerInvoker<StreamHandler>;
+
+// The source produced by `make_iter_stream()`
+template <typename T, typename E>
+class IterSource {
+public:
+    explicit IterSource(std::vector<T> items) : items_(std::move(items)) {}
+
+    Result<Option<T>, E> operator()(Context& ctx) {
+        (void)ctx;
+        if (pos_ == items_.size()) {
+            return Ok(Option<T>(None));
+        }
+        return Ok(Some(std::move(items_[pos_++])));
+    }
+
+private:
+    std::vector<T> items_;
+    std::size_t pos_ = 0;
+};
+
+// The source produced by `Stream::map()`
+template <typename Stream, typename Handler>
+class MapSource {
+    using item_type = std::decay_t<
+        std::invoke_result_t<Handler&, typename Stream::item_type&>>;
+    using result_type = Result<Option<item_type>, typename Stream::error_type>;
+
+public:
+    MapSource(Stream stream, Handler handler)
+        : stream_(std::move(stream)), handler_(std::move(handler)) {}
+
+    result_type operator()(Context& ctx) {
+        auto result = stream_.poll_next(ctx);
+        if (!result.is_ok()) {
+            return propagate_non_ok<result_type>(result);
+        }
+
+        auto& item = result.value();
+        if (!item.has_value()) {
+            return Ok(Option<item_type>(None));
+        }
+        return Ok(Some(item_type(handler_(item.value()))));
+    }
+
+private:
+    Stream stream_;
+    MoveOnlyHandler<Handler> handler_;
+};
+
+// The source produced by `Stream::filter()`
+template <typename Stream, typename Predicate>
+class FilterSource {
+    using result_type = typename Stream::result_type;
+
+public:
+    FilterSource(Stream stream, Predicate pred)
+        : stream_(std::move(stream)), pred_(std::move(pred)) {}
+
+    result_type operator()(Context& ctx) {
+        for (;;) {
+            auto result = stream_.poll_next(ctx);
+            if (!result.is_ok() || !result.value().has_value() ||
+                pred_(std::as_const(result.value().value()))) {
+                return result;
+            }
+        }
+    }
+
+private:
+    Stream stream_;
+    MoveOnlyHandler<Predicate> pred_;
+};
+
+// The source produced by `Stream::chunks()` and `Stream::ready_chunks()`
+//
+// Items are collected until `capacity` of them are available, the upstream
+// ends or, for `ready_chunks()`, the upstream becomes pending. An upstream
+// error is reported after the items collected before it.
+template <typename Stream>
+class ChunksSource {
+    using item_type = std::vector<typename Stream::item_type>;
+    using error_type = typename Stream::error_type;
+    using result_type = Result<Option<item_type>, error_type>;
+
+public:
+    ChunksSource(Stream stream, std::size_t capacity, bool flush_on_pending)
+        : stream_(std::move(stream)), capacity_(capacity),
+          flush_on_pending_(flush_on_pending) {
+        assert(capacity_ > 0);
+    }
+
+    result_type operator()(Context& ctx) {
+        while (!done_) {
+            auto result = stream_.poll_next(ctx);
+            if (result.is_pending()) {
+                if (flush_on_pending_ && !chunk_.empty()) {
+                    return Ok(Some(take_chunk()));
+                }
+                return Pending{};
+            }
+
+            if (result.is_error()) {
+                done_ = true;
+                error_ = Some(result.take_error());
+                break;
+            }
+
+            auto& item = result.value();
+            if (!item.has_value()) {
+                done_ = true;
+                break;
+            }
+
+            if (chunk_.empty()) {
+                chunk_.reserve(capacity_);
+            }
+            chunk_.push_back(std::move(item.value()));
+            if (chunk_.size() == capacity_) {
+                return Ok(Some(take_chunk()));
+            }
+        }
+
+        if (!chunk_.empty()) {
+            return Ok(Some(take_chunk()));
+        }
+        if (error_.has_value()) {
+            auto error = std::move(error_.value());
+            error_.clear();
+            return Err(std::move(error));
+        }
+        return Ok(Option<item_type>(None));
+    }
+
+private:
+    item_type take_chunk() {
+        item_type chunk;
+        chunk.swap(chunk_);
+        return chunk;
+    }
+
+private:
+    Stream stream_;
+    const std::size_t capacity_;
+    const bool flush_on_pending_;
+    bool done_ = false;
+    item_type chunk_;
+    Option<error_type> error_;
+};
+
+// The source produced by `Stream::buffer_unordered()`
+//
+// Runs up to `limit` promises pulled from the upstream concurrently. Every
+// promise lives in a fixed slot and is polled through a `JoinContext` so that
+// only the promises which were resumed get polled again, as `join_promises()`
+// does.
+template <typename Stream>
+class BufferUnorderedSource {
+    using promise_type = typename Stream::item_type;
+    using item_type = typename promise_type::result_type;
+    using error_type = typename Stream::error_type;
+    using result_type = Result<Option<item_type>, error_type>;
+
+public:
+    BufferUnorderedSource(Stream stream, std::size_t limit)
+        : stream_(std::move(stream)), slots_(limit),
+          waker_(new JoinWaker(limit)) {
+        assert(limit > 0);
+        free_.reserve(limit);
+        for (std::size_t i = limit; i > 0; --i) {
+            free_.push_back(i - 1);
+        }
+    }
+
+    result_type operator()(Context& ctx) {
+        waker_->take_ready(&ready_);
+        for (std::size_t index : ready_) {
+            poll_slot(ctx, index);
+        }
+        ready_.clear();
+
+        // refill the free slots
+        while (!done_ && !free_.empty()) {
+            auto result = stream_.poll_next(ctx);
+            if (result.is_pending()) {
+                break;
+            }
+            if (result.is_error()) {
+                return Err(result.take_error());
+            }
+
+            auto& item = result.value();
+            if (!item.has_value()) {
+                done_ = true;
+                break;
+            }
+
+            const std::size_t index = free_.back();
+            free_.pop_back();
+            slots_[index] = std::move(item.value());
+            ++running_;
+            poll_slot(ctx, index);
+        }
+
+        if (!completed_.empty()) {
+            auto result = std::move(completed_.front());
+            completed_.pop_front();
+            return Ok(Some(std::move(result)));
+        }
+        if (done_ && running_ == 0) {
+            return Ok(Option<item_type>(None));
+        }
+
+        waker_->park(ctx);
+        return Pending{};
+    }
+
+private:
+    void poll_slot(Context& ctx, std::size_t index) {
+        auto& promise = slots_[index];
+        if (!promise) {
+            // a stale wake up of a finished promise
+            return;
+        }
+
+        JoinContext branch_ctx(ctx, *waker_, index);
+        auto result = promise(branch_ctx);
+        if (!result.is_pending()) {
+            completed_.push_back(std::move(result));
+            promise = nullptr;
+            free_.push_back(index);
+            --running_;
+        } else if (!branch_ctx.suspended()) {
+            waker_->requeue(index);
+        }
+    }
+
+private:
+    Stream stream_;
+    bool done_ = false;
+    std::size_t running_ = 0;
+    std::vector<promise_type> slots_;
+    std::vector<std::size_t> free_;
+    std::deque<item_type> completed_;
+    std::vector<std::size_t> ready_;
+    std::unique_ptr<JoinWaker, JoinWaker::Releaser> waker_;
+};
+
+// The continuation produced by `Stream::fold()`
+template <typename Stream, typename Acc, typename Handler>
+class FoldContinuation {
+    using result_type = Result<Acc, typename Stream::error_type>;
+
+public:
+    FoldContinuation(Stream stream, Acc init, Handler handler)
+        : stream_(std::move(stream)), acc_(std::move(init)),
+          handler_(std::move(handler)) {}
+
+    result_type operator()(Context& ctx) {
+        for (;;) {
+            auto result = stream_.poll_next(ctx);
+            if (!result.is_ok()) {
+                return propagate_non_ok<result_type>(result);
+            }
+
+            auto& item = result.value();
+            if (!item.has_value()) {
+                return Ok(std::move(acc_));
+            }
+            handler_(acc_, item.value());
+        }
+    }
+
+private:
+    Stream stream_;
+    Acc acc_;
+    MoveOnlyHandler<Handler> handler_;
+};
+
+// The continuation produced by `Stream::for_each()`
+template <typename Stream, typename Handler>
+class ForEachContinuation {
+    using result_type = Result<Void, typename Stream::error_type>;
+
+public:
+    ForEachContinuation(Stream stream, Handler handler)
+        : stream_(std::move(stream)), handler_(std::move(handler)) {}
+
+    result_type operator()(Context& ctx) {
+        for (;;) {
+            auto result = stream_.poll_next(ctx);
+            if (!result.is_ok()) {
+                return propagate_non_ok<result_type>(result);
+            }
+
+            auto& item = result.value();
+            if (!item.has_value()) {
+                return Ok(Void{});
+            }
+            handler_(item.value());
+        }
+    }
+
+private:
+    Stream stream_;
+    MoveOnlyHandler<Handler> handler_;
+};
+
+// The continuation produced by `Stream::forward()`
+//
+// Items are handed to the sink as long as the sink is ready and the upstream
+// has some. The sink is flushed whenever the upstream becomes pending so that
+// buffered items don't wait for the next one, and closed once the upstream
+// ends.
+template <typename Stream>
+class ForwardContinuation {
+    using item_type = typename Stream::item_type;
+    using error_type = typename Stream::error_type;
+    using result_type = Result<Void, error_type>;
+
+public:
+    ForwardContinuation(Stream stream, Sink<item_type, error_type>& sink)
+        : stream_(std::move(stream)), sink_(sink) {}
+
+    result_type operator()(Context& ctx) {
+        while (!done_) {
+            if (buffered_.has_value()) {
+                auto ready = sink_.poll_ready(ctx);
+                if (!ready.is_ok()) {
+                    return propagate_non_ok<result_type>(ready);
+                }
+
+                auto sent = sink_.start_send(std::move(buffered_.value()));
+                buffered_.clear();
+                if (sent.is_error()) {
+                    return Err(sent.take_error());
+                }
+            }
+
+            auto result = stream_.poll_next(ctx);
+            if (result.is_pending()) {
+                auto flushed = sink_.poll_flush(ctx);
+                if (flushed.is_error()) {
+                    return Err(flushed.take_error());
+                }
+                return Pending{};
+            }
+            if (result.is_error()) {
+                return Err(result.take_error());
+            }
+
+            auto& item = result.value();
+            if (!item.has_value()) {
+                done_ = true;
+                break;
+            }
+            buffered_ = std::move(item);
+        }
+
+        auto closed = sink_.poll_close(ctx);
+        if (!closed.is_ok()) {
+            return propagate_non_ok<result_type>(closed);
+        }
+        return Ok(Void{});
+    }
+
+private:
+    Stream stream_;
+    Sink<item_type, error_type>& sink_;
+    Option<item_type> buffered_;
+    bool done_ = false;
+};
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,69 @@
+//! Mutex
+//!
+//! - `AsyncMutex`
+//!
+
+#ifndef BIPOLAR_ASYNC_MUTEX_HPP_
+#define BIPOLAR_ASYNC_MUTEX_HPP_
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/async/semaphore.hpp"
+#include "bipolar/core/option.hpp"
+
+namespace bipolar {
+/// AsyncMutexGuard
+///
+/// Holds an `AsyncMutex` locked until destroyed or `release()`d
+using AsyncMutexGuard = SemaphorePermit;
+
+/// AsyncMutex
+///
+/// A mutex whose `lock()` suspends the task instead of blocking the thread,
+/// so that a task may hold it across suspension points without stalling
+/// the executor.
+///
+/// Tasks acquire the mutex in the order they started waiting for it.
+///
+/// All methods are thread-safe. The mutex must outlive the promises
+/// returned by `lock()` and the guards.
+///
+/// # Examples
+///
+/// ```
+/// AsyncMutex mtx;
+///
+/// executor.schedule_task(PendingTask(mtx.lock().and_then(
+///     [](AsyncMutexGuard& guard) -> Result<Void, Void> {
+///         // exclusive until `guard` is released
+///         ...
+///     })));
+/// ```
+class AsyncMutex final : public boost::noncopyable {
+public:
+    AsyncMutex() noexcept : sem_(1) {}
+
+    /// Returns an unboxed promise which locks the mutex, suspending the task
+    /// while it's held by another one
+    auto lock() {
+        return sem_.acquire(1);
+    }
+
+    /// Locks the mutex if it's free and nobody is waiting for it, without
+    /// suspending
+    Option<AsyncMutexGuard> try_lock() {
+        return sem_.try_acquire(1);
+    }
+
+    /// Returns true if the mutex is held
+    bool is_locked() const {
+        return sem_.available_permits() == 0;
+    }
+
+private:
+    AsyncSemaphore sem_;
+};
+
+} // namespace bipolar
+
+#endif
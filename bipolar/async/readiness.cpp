@@ -0,0 +1,129 @@
+#include "bipolar/async/readiness.hpp"
+
+#include <sys/epoll.h>
+
+#include <utility>
+
+namespace bipolar {
+namespace {
+constexpr std::size_t kMaxEvents = 256;
+
+std::uint32_t interests_of(const SuspendedTask& reader,
+                           const SuspendedTask& writer) noexcept {
+    std::uint32_t interests = 0;
+    if (reader) {
+        interests |= EPOLLIN;
+    }
+    if (writer) {
+        interests |= EPOLLOUT;
+    }
+    return interests;
+}
+} // namespace
+
+EpollReadinessWaiter::EpollReadinessWaiter(Epoll epoll) noexcept
+    : epoll_(std::move(epoll)) {}
+
+void EpollReadinessWaiter::wait_readiness(int fd, std::uint32_t events,
+                                          SuspendedTask task) {
+    SuspendedTask stale;
+    bool failed = false;
+    {
+        std::lock_guard lock(mtx_);
+        Waiters& waiters = waiters_[fd];
+        if (events & EPOLLIN) {
+            stale = std::exchange(waiters.reader, std::move(task));
+        } else {
+            stale = std::exchange(waiters.writer, std::move(task));
+        }
+
+        const std::uint32_t interests =
+            interests_of(waiters.reader, waiters.writer) | EPOLLONESHOT;
+        auto res = waiters.registered ? epoll_.mod(fd, fd, interests)
+                                      : epoll_.add(fd, fd, interests);
+        if (res.is_error() && res.error() == ENOENT) {
+            // `fd` was closed and its number reused without `forget()`
+            res = epoll_.add(fd, fd, interests);
+        }
+
+        if (res.is_error()) {
+            // let the task find out the error by itself
+            failed = true;
+            task = std::exchange((events & EPOLLIN) ? waiters.reader
+                                                    : waiters.writer,
+                                 SuspendedTask());
+        } else {
+            waiters.registered = true;
+        }
+    }
+
+    // released outside the lock since dropping a task may destroy it
+    stale.reset();
+    if (failed) {
+        task.resume_task();
+    }
+}
+
+void EpollReadinessWaiter::forget(int fd) {
+    Waiters waiters;
+    {
+        std::lock_guard lock(mtx_);
+        auto iter = waiters_.find(fd);
+        if (iter == waiters_.end()) {
+            return;
+        }
+
+        waiters = std::move(iter->second);
+        waiters_.erase(iter);
+        if (waiters.registered) {
+            (void)epoll_.del(fd);
+        }
+    }
+}
+
+Result<std::size_t, int>
+EpollReadinessWaiter::poll(std::chrono::milliseconds timeout) {
+    // `Epoll::poll()` fills the vector up to its capacity then shrinks it
+    events_.resize(kMaxEvents);
+    auto res = epoll_.poll(events_, timeout);
+    if (res.is_error()) {
+        return Err(res.error());
+    }
+
+    std::vector<SuspendedTask> ready;
+    {
+        std::lock_guard lock(mtx_);
+        for (const auto& ev : events_) {
+            auto iter = waiters_.find(ev.data.fd);
+            if (iter == waiters_.end()) {
+                continue;
+            }
+
+            Waiters& waiters = iter->second;
+            const std::uint32_t hangup = EPOLLERR | EPOLLHUP;
+            if ((ev.events & (EPOLLIN | EPOLLRDHUP | hangup)) &&
+                waiters.reader) {
+                ready.push_back(std::move(waiters.reader));
+            }
+            if ((ev.events & (EPOLLOUT | hangup)) && waiters.writer) {
+                ready.push_back(std::move(waiters.writer));
+            }
+
+            // one-shot mode disarmed the fd, rearms it for the remaining
+            // waiter
+            const std::uint32_t interests =
+                interests_of(waiters.reader, waiters.writer);
+            if (interests != 0) {
+                (void)epoll_.mod(ev.data.fd, ev.data.fd,
+                                 interests | EPOLLONESHOT);
+            }
+        }
+    }
+
+    for (auto& task : ready) {
+        task.resume_task();
+    }
+    return Ok(ready.size());
+}
+
+} // namespace bipolar
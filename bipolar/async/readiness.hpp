@@ -0,0 +1,102 @@
+//! Readiness
+//!
+//! - `ReadinessWaiter`
+//! - `EpollReadinessWaiter`
+//!
+
+#ifndef BIPOLAR_ASYNC_READINESS_HPP_
+#define BIPOLAR_ASYNC_READINESS_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+#include "bipolar/net/epoll.hpp"
+
+namespace bipolar {
+/// ReadinessWaiter
+///
+/// Resumes suspended tasks once file descriptors become ready for I/O.
+///
+/// It's the glue between nonblocking sockets and the tasks polling them:
+/// a task hitting `EAGAIN` hands its `SuspendedTask` to the waiter and
+/// returns `Pending`.
+class ReadinessWaiter {
+public:
+    virtual ~ReadinessWaiter() = default;
+
+    /// Arranges for `task` to be resumed once `fd` is ready for the I/O
+    /// described by `events`, either `EPOLLIN` or `EPOLLOUT`.
+    ///
+    /// At most one task waits for each direction of a file descriptor,
+    /// a newer one replaces (and releases) the older one.
+    virtual void wait_readiness(int fd, std::uint32_t events,
+                                SuspendedTask task) = 0;
+};
+
+/// EpollReadinessWaiter
+///
+/// A `ReadinessWaiter` backed by an `Epoll` instance registering file
+/// descriptors in one-shot mode.
+///
+/// `wait_readiness()` may be called from any thread while a single thread
+/// drives `poll()`.
+///
+/// # Examples
+///
+/// ```
+/// EpollReadinessWaiter waiter(Epoll::create().expect("epoll create failed"));
+///
+/// std::thread reactor([&]() {
+///     while (running) {
+///         waiter.poll(std::chrono::milliseconds(10));
+///     }
+/// });
+/// ```
+class EpollReadinessWaiter final : public ReadinessWaiter,
+                                   public boost::noncopyable {
+public:
+    explicit EpollReadinessWaiter(Epoll epoll) noexcept;
+
+    ~EpollReadinessWaiter() override = default;
+
+    void wait_readiness(int fd, std::uint32_t events,
+                        SuspendedTask task) override;
+
+    /// Stops waiting on `fd`, releasing the tasks waiting for it.
+    ///
+    /// Must be called before `fd` is closed if some task may still be
+    /// waiting for it.
+    void forget(int fd);
+
+    /// Waits at most `timeout` for readiness events then resumes the tasks
+    /// waiting for them.
+    ///
+    /// On success, returns the number of resumed tasks.
+    Result<std::size_t, int> poll(std::chrono::milliseconds timeout);
+
+private:
+    struct Waiters {
+        SuspendedTask reader;
+        SuspendedTask writer;
+        bool registered = false;
+    };
+
+    Epoll epoll_;
+    std::vector<struct epoll_event> events_;
+
+    std::mutex mtx_;
+    std::unordered_map<int, Waiters> waiters_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,81 @@
+//! RwLock
+//!
+//! - `AsyncRwLock`
+//!
+
+#ifndef BIPOLAR_ASYNC_RWLOCK_HPP_
+#define BIPOLAR_ASYNC_RWLOCK_HPP_
+
+#include <cassert>
+#include <cstddef>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/async/semaphore.hpp"
+#include "bipolar/core/option.hpp"
+
+namespace bipolar {
+/// AsyncRwLockReadGuard
+///
+/// Holds an `AsyncRwLock` locked for reading until destroyed or
+/// `release()`d
+using AsyncRwLockReadGuard = SemaphorePermit;
+
+/// AsyncRwLockWriteGuard
+///
+/// Holds an `AsyncRwLock` locked for writing until destroyed or
+/// `release()`d
+using AsyncRwLockWriteGuard = SemaphorePermit;
+
+/// AsyncRwLock
+///
+/// A reader-writer lock whose `read()` and `write()` suspend the task
+/// instead of blocking the thread.
+///
+/// It's a semaphore holding one permit per reader, a writer taking them
+/// all. Tasks are served in FIFO order: readers arriving after a waiting
+/// writer queue behind it, so writers don't starve.
+///
+/// All methods are thread-safe. The lock must outlive the promises returned
+/// by `read()` and `write()` and the guards.
+class AsyncRwLock final : public boost::noncopyable {
+public:
+    /// The default maximum number of concurrent readers
+    static constexpr std::size_t kMaxReaders = 1UL << 24;
+
+    /// Constructs a lock letting at most `max_readers` readers in at once
+    explicit AsyncRwLock(std::size_t max_readers = kMaxReaders) noexcept
+        : max_readers_(max_readers), sem_(max_readers) {
+        assert(max_readers > 0);
+    }
+
+    /// Returns an unboxed promise which locks for reading, suspending the
+    /// task while a writer holds the lock or is queued first
+    auto read() {
+        return sem_.acquire(1);
+    }
+
+    /// Returns an unboxed promise which locks for writing, suspending the
+    /// task while the lock is held or other tasks are queued first
+    auto write() {
+        return sem_.acquire(max_readers_);
+    }
+
+    /// Locks for reading if possible, without suspending
+    Option<AsyncRwLockReadGuard> try_read() {
+        return sem_.try_acquire(1);
+    }
+
+    /// Locks for writing if possible, without suspending
+    Option<AsyncRwLockWriteGuard> try_write() {
+        return sem_.try_acquire(max_readers_);
+    }
+
+private:
+    const std::size_t max_readers_;
+    AsyncSemaphore sem_;
+};
+
+} // namespace bipolar
+
+#endif
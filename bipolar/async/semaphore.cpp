@@ -0,0 +1,115 @@
+#include "bipolar/async/semaphore.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace bipolar {
+void SemaphorePermit::release() {
+    if (sem_) {
+        std::exchange(sem_, nullptr)->add_permits(std::exchange(permits_, 0));
+    }
+}
+
+AsyncSemaphore::AsyncSemaphore(std::size_t permits) noexcept
+    : permits_(permits) {}
+
+AsyncSemaphore::~AsyncSemaphore() {
+    assert(waiters_.empty() && "destroyed while tasks are waiting");
+}
+
+std::size_t AsyncSemaphore::available_permits() const {
+    std::lock_guard lock(mtx_);
+    return permits_;
+}
+
+void AsyncSemaphore::add_permits(std::size_t n) {
+    std::vector<SuspendedTask> tasks;
+    {
+        std::lock_guard lock(mtx_);
+        permits_ += n;
+        grant(tasks);
+    }
+
+    for (auto& task : tasks) {
+        task.resume_task();
+    }
+}
+
+Option<SemaphorePermit> AsyncSemaphore::try_acquire(std::size_t n) {
+    std::lock_guard lock(mtx_);
+    if (!waiters_.empty() || permits_ < n) {
+        return None;
+    }
+
+    permits_ -= n;
+    return Some(SemaphorePermit(this, n));
+}
+
+Result<SemaphorePermit, Void>
+AsyncSemaphore::poll_acquire(Context& ctx, std::size_t n,
+                             std::shared_ptr<Waiter>& waiter) {
+    if (!waiter) {
+        auto permit = try_acquire(n);
+        if (permit.has_value()) {
+            return Ok(std::move(permit.value()));
+        }
+    }
+
+    // obtained without holding the lock, then checks again
+    SuspendedTask task = ctx.suspend_task();
+    std::lock_guard lock(mtx_);
+    if (waiter && waiter->granted) {
+        waiter.reset();
+        return Ok(SemaphorePermit(this, n));
+    }
+
+    if (!waiter) {
+        if (waiters_.empty() && permits_ >= n) {
+            permits_ -= n;
+            return Ok(SemaphorePermit(this, n));
+        }
+
+        waiter = std::make_shared<Waiter>(Waiter{n, false, SuspendedTask()});
+        waiters_.push_back(waiter);
+    }
+
+    // the previous ticket, if any, is released along with `task`
+    std::swap(waiter->task, task);
+    return Pending{};
+}
+
+void AsyncSemaphore::cancel(std::shared_ptr<Waiter>& waiter) {
+    std::vector<SuspendedTask> tasks;
+    SuspendedTask task;
+    {
+        std::lock_guard lock(mtx_);
+        if (waiter->granted) {
+            // granted but never observed, the permits go back
+            permits_ += waiter->permits;
+        } else {
+            waiters_.erase(
+                std::find(waiters_.begin(), waiters_.end(), waiter));
+        }
+        std::swap(task, waiter->task);
+
+        // a large request leaving the front may unblock the following ones
+        grant(tasks);
+    }
+    waiter.reset();
+
+    for (auto& t : tasks) {
+        t.resume_task();
+    }
+}
+
+void AsyncSemaphore::grant(std::vector<SuspendedTask>& tasks) {
+    while (!waiters_.empty() && waiters_.front()->permits <= permits_) {
+        auto& waiter = waiters_.front();
+        permits_ -= waiter->permits;
+        waiter->granted = true;
+        tasks.push_back(std::move(waiter->task));
+        waiters_.pop_front();
+    }
+}
+
+} // namespace bipolar
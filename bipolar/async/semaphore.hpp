@@ -0,0 +1,191 @@
+//! Semaphore
+//!
+//! - `AsyncSemaphore`
+//! - `SemaphorePermit`
+//!
+
+#ifndef BIPOLAR_ASYNC_SEMAPHORE_HPP_
+#define BIPOLAR_ASYNC_SEMAPHORE_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/core/movable.hpp"
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+
+namespace bipolar {
+// forward
+class AsyncSemaphore;
+
+/// SemaphorePermit
+///
+/// Permits acquired from an `AsyncSemaphore`, released when destroyed.
+///
+/// The semaphore must outlive its permits.
+class SemaphorePermit final : public Movable {
+    friend class AsyncSemaphore;
+
+public:
+    /// Constructs an empty permit
+    constexpr SemaphorePermit() noexcept = default;
+
+    SemaphorePermit(SemaphorePermit&& rhs) noexcept
+        : sem_(std::exchange(rhs.sem_, nullptr)),
+          permits_(std::exchange(rhs.permits_, 0)) {}
+
+    SemaphorePermit& operator=(SemaphorePermit&& rhs) noexcept {
+        if (this != &rhs) {
+            release();
+            sem_ = std::exchange(rhs.sem_, nullptr);
+            permits_ = std::exchange(rhs.permits_, 0);
+        }
+        return *this;
+    }
+
+    ~SemaphorePermit() {
+        release();
+    }
+
+    /// Returns true if the permit holds permits
+    explicit operator bool() const noexcept {
+        return sem_ != nullptr;
+    }
+
+    /// Returns the number of permits held
+    std::size_t permits() const noexcept {
+        return permits_;
+    }
+
+    /// Gives the permits back to the semaphore, leaving this one empty
+    void release();
+
+    /// Leaves this permit empty without giving the permits back, reducing
+    /// the capacity of the semaphore
+    void forget() noexcept {
+        sem_ = nullptr;
+        permits_ = 0;
+    }
+
+private:
+    SemaphorePermit(AsyncSemaphore* sem, std::size_t permits) noexcept
+        : sem_(sem), permits_(permits) {}
+
+    AsyncSemaphore* sem_ = nullptr;
+    std::size_t permits_ = 0;
+};
+
+/// AsyncSemaphore
+///
+/// A counting semaphore whose `acquire()` suspends the task instead of
+/// blocking the thread, making it usable to bound concurrency, e.g. the
+/// number of in-flight requests to a backend, without stalling the
+/// executor.
+///
+/// Waiters are served in FIFO order: a waiter asking for many permits
+/// holds back the ones queued after it, even if they ask for fewer, so
+/// none of them starves. Released permits are handed over to the waiters
+/// directly.
+///
+/// All methods are thread-safe. The semaphore must outlive the promises
+/// returned by `acquire()` and the permits.
+///
+/// # Examples
+///
+/// ```
+/// AsyncSemaphore sem(16);
+///
+/// executor.schedule_task(PendingTask(sem.acquire().and_then(
+///     [](SemaphorePermit& permit) -> Result<Void, Void> {
+///         // at most 16 tasks get here at once, until `permit` is released
+///         ...
+///     })));
+/// ```
+class AsyncSemaphore final : public boost::noncopyable {
+    friend class SemaphorePermit;
+
+    struct Waiter {
+        const std::size_t permits;
+        bool granted = false;
+        SuspendedTask task;
+    };
+
+    // The continuation produced by `acquire()`
+    class AcquireContinuation {
+    public:
+        AcquireContinuation(AsyncSemaphore* sem, std::size_t permits) noexcept
+            : sem_(sem), permits_(permits) {}
+
+        AcquireContinuation(AcquireContinuation&&) noexcept = default;
+
+        ~AcquireContinuation() {
+            if (waiter_) {
+                sem_->cancel(waiter_);
+            }
+        }
+
+        Result<SemaphorePermit, Void> operator()(Context& ctx) {
+            return sem_->poll_acquire(ctx, permits_, waiter_);
+        }
+
+    private:
+        AsyncSemaphore* sem_;
+        std::size_t permits_;
+        std::shared_ptr<Waiter> waiter_;
+    };
+
+public:
+    /// Constructs a semaphore holding `permits` permits
+    explicit AsyncSemaphore(std::size_t permits) noexcept;
+
+    /// Asserts that no task waits for permits
+    ~AsyncSemaphore();
+
+    /// Returns the number of permits which can be acquired right now
+    std::size_t available_permits() const;
+
+    /// Adds `n` permits, possibly resuming waiters
+    void add_permits(std::size_t n);
+
+    /// Acquires `n` permits if they're available and nobody is waiting for
+    /// permits, without suspending.
+    Option<SemaphorePermit> try_acquire(std::size_t n = 1);
+
+    /// Returns an unboxed promise which acquires `n` permits, suspending the
+    /// task until they're available.
+    ///
+    /// Destroying the promise before completion gives up its place in the
+    /// queue.
+    auto acquire(std::size_t n = 1) {
+        return PromiseImpl(AcquireContinuation(this, n));
+    }
+
+private:
+    Result<SemaphorePermit, Void> poll_acquire(Context& ctx, std::size_t n,
+                                               std::shared_ptr<Waiter>& waiter);
+
+    void cancel(std::shared_ptr<Waiter>& waiter);
+
+    // Hands the available permits to the waiters at the front of the queue,
+    // collecting their tasks to be resumed once the lock is released
+    void grant(std::vector<SuspendedTask>& tasks) BIPOLAR_REQUIRES(mtx_);
+
+    mutable std::mutex mtx_;
+    std::size_t permits_ BIPOLAR_GUARDED_BY(mtx_);
+    std::deque<std::shared_ptr<Waiter>> waiters_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,101 @@
+//! Sink
+//!
+//! See `Sink` for details
+
+#ifndef BIPOLAR_ASYNC_SINK_HPP_
+#define BIPOLAR_ASYNC_SINK_HPP_
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+
+namespace bipolar {
+/// Sink
+///
+/// # Brief
+///
+/// A `Sink` is a value into which other values can be sent asynchronously.
+/// It's the counterpart of `Stream`: a stream produces values, a sink
+/// consumes them.
+///
+/// Sending a value is split into several phases so that the sink can apply
+/// backpressure:
+/// - `poll_ready()` must be called, and must return `Ok`, before each call to
+///   `start_send()`. A sink that is full suspends the task via
+///   `Context::suspend_task()` and returns `Pending`.
+/// - `start_send()` hands a value to the sink. It must not block; the value
+///   is usually buffered until the sink is flushed.
+/// - `poll_flush()` pushes out buffered values.
+/// - `poll_close()` flushes and then closes the sink. No value can be sent
+///   afterwards.
+///
+/// All the `poll_*` methods follow the `Promise` protocol: `Pending` means
+/// that the task was suspended and will be resumed once progress is possible,
+/// `Ok` means that the phase completed and `Err` reports an error after which
+/// the sink should be considered unusable.
+///
+/// `Stream::forward()` drives a stream into a sink.
+///
+/// # Examples
+///
+/// ```
+/// class VectorSink final : public Sink<int, Void> {
+/// public:
+///     Result<Void, Void> poll_ready(Context&) override {
+///         return Ok(Void{});
+///     }
+///
+///     Result<Void, Void> start_send(int item) override {
+///         items.push_back(item);
+///         return Ok(Void{});
+///     }
+///
+///     Result<Void, Void> poll_flush(Context&) override {
+///         return Ok(Void{});
+///     }
+///
+///     Result<Void, Void> poll_close(Context&) override {
+///         return Ok(Void{});
+///     }
+///
+///     std::vector<int> items;
+/// };
+/// ```
+template <typename T, typename E>
+class Sink {
+public:
+    /// The type of value consumed by the sink
+    using item_type = T;
+
+    /// The type of error produced by the sink
+    using error_type = E;
+
+    virtual ~Sink() = default;
+
+    /// Attempts to prepare the sink to receive a value.
+    ///
+    /// Returns `Ok` when the sink is ready for a `start_send()`.
+    /// Otherwise suspends the task and returns `Pending`.
+    virtual Result<Void, E> poll_ready(Context& ctx) = 0;
+
+    /// Begins the process of sending a value to the sink.
+    ///
+    /// Must be preceded by a successful `poll_ready()`.
+    virtual Result<Void, E> start_send(T item) = 0;
+
+    /// Flushes any value buffered in the sink.
+    ///
+    /// Returns `Ok` when nothing remains buffered.
+    /// Otherwise suspends the task and returns `Pending`.
+    virtual Result<Void, E> poll_flush(Context& ctx) = 0;
+
+    /// Flushes and closes the sink.
+    ///
+    /// Returns `Ok` once the sink has been closed.
+    /// Otherwise suspends the task and returns `Pending`.
+    virtual Result<Void, E> poll_close(Context& ctx) = 0;
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,205 @@
+#include "bipolar/async/socket_stream.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+namespace bipolar {
+namespace {
+// The number of buffers gathered by one `sendmsg(2)`
+constexpr std::size_t kMaxIovecs = 64;
+
+bool would_block(int err) noexcept {
+    return err == EAGAIN || err == EWOULDBLOCK;
+}
+
+class TcpReadSource {
+public:
+    TcpReadSource(TcpStream& stream, std::size_t chunk_size,
+                  ReadinessWaiter& waiter) noexcept
+        : stream_(stream), chunk_size_(chunk_size), waiter_(waiter) {}
+
+    Result<Option<std::vector<char>>, int> operator()(Context& ctx) {
+        // reused across `EAGAIN`s, only handed out when filled
+        buf_.resize(chunk_size_);
+        for (;;) {
+            auto res = stream_.recv(buf_.data(), buf_.size());
+            if (res.is_error()) {
+                const int err = res.error();
+                if (err == EINTR) {
+                    continue;
+                }
+                if (would_block(err)) {
+                    waiter_.wait_readiness(stream_.as_fd(), EPOLLIN,
+                                           ctx.suspend_task());
+                    return Pending{};
+                }
+                return Err(err);
+            }
+
+            if (res.value() == 0) {
+                return Ok(Option<std::vector<char>>(None));
+            }
+            buf_.resize(res.value());
+            return Ok(Some(std::move(buf_)));
+        }
+    }
+
+private:
+    TcpStream& stream_;
+    const std::size_t chunk_size_;
+    ReadinessWaiter& waiter_;
+    std::vector<char> buf_;
+};
+
+class UdpRecvSource {
+    using item_type = std::tuple<std::vector<char>, SocketAddress>;
+
+public:
+    UdpRecvSource(UdpSocket& socket, std::size_t max_size,
+                  ReadinessWaiter& waiter) noexcept
+        : socket_(socket), max_size_(max_size), waiter_(waiter) {}
+
+    Result<Option<item_type>, int> operator()(Context& ctx) {
+        buf_.resize(max_size_);
+        for (;;) {
+            auto res = socket_.recvfrom(buf_.data(), buf_.size());
+            if (res.is_error()) {
+                const int err = res.error();
+                if (err == EINTR) {
+                    continue;
+                }
+                if (would_block(err)) {
+                    waiter_.wait_readiness(socket_.as_fd(), EPOLLIN,
+                                           ctx.suspend_task());
+                    return Pending{};
+                }
+                return Err(err);
+            }
+
+            auto [len, addr] = res.take_value();
+            buf_.resize(len);
+            return Ok(Some(item_type(std::move(buf_), addr)));
+        }
+    }
+
+private:
+    UdpSocket& socket_;
+    const std::size_t max_size_;
+    ReadinessWaiter& waiter_;
+    std::vector<char> buf_;
+};
+} // namespace
+
+Stream<std::vector<char>, int>
+make_tcp_read_stream(TcpStream& stream, std::size_t chunk_size,
+                     ReadinessWaiter& waiter) {
+    return StreamImpl(TcpReadSource(stream, chunk_size, waiter));
+}
+
+Stream<std::tuple<std::vector<char>, SocketAddress>, int>
+make_udp_recv_stream(UdpSocket& socket, std::size_t max_size,
+                     ReadinessWaiter& waiter) {
+    return StreamImpl(UdpRecvSource(socket, max_size, waiter));
+}
+
+TcpWriteSink::TcpWriteSink(TcpStream& stream, ReadinessWaiter& waiter,
+                           std::size_t high_watermark) noexcept
+    : stream_(stream), waiter_(waiter), high_watermark_(high_watermark) {}
+
+Result<Void, int> TcpWriteSink::poll_ready(Context& ctx) {
+    if (buffered_ < high_watermark_) {
+        return Ok(Void{});
+    }
+
+    auto res = poll_flush(ctx);
+    if (res.is_error()) {
+        return res;
+    }
+    if (buffered_ < high_watermark_) {
+        return Ok(Void{});
+    }
+    return Pending{};
+}
+
+Result<Void, int> TcpWriteSink::start_send(std::vector<char> item) {
+    if (closed_) {
+        return Err(EPIPE);
+    }
+
+    if (!item.empty()) {
+        buffered_ += item.size();
+        queue_.push_back(std::move(item));
+    }
+    return Ok(Void{});
+}
+
+Result<Void, int> TcpWriteSink::poll_flush(Context& ctx) {
+    struct iovec iov[kMaxIovecs];
+
+    while (!queue_.empty()) {
+        const std::size_t n = std::min(queue_.size(), kMaxIovecs);
+        for (std::size_t i = 0; i < n; ++i) {
+            iov[i].iov_base = queue_[i].data();
+            iov[i].iov_len = queue_[i].size();
+        }
+        iov[0].iov_base = static_cast<char*>(iov[0].iov_base) + offset_;
+        iov[0].iov_len -= offset_;
+
+        struct msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n;
+
+        auto res = stream_.sendmsg(&msg, MSG_NOSIGNAL);
+        if (res.is_error()) {
+            const int err = res.error();
+            if (err == EINTR) {
+                continue;
+            }
+            if (would_block(err)) {
+                waiter_.wait_readiness(stream_.as_fd(), EPOLLOUT,
+                                       ctx.suspend_task());
+                return Pending{};
+            }
+            return Err(err);
+        }
+
+        // pops the buffers fully written
+        std::size_t written = res.value();
+        buffered_ -= written;
+        while (written > 0) {
+            const std::size_t left = queue_.front().size() - offset_;
+            if (written < left) {
+                offset_ += written;
+                break;
+            }
+            written -= left;
+            offset_ = 0;
+            queue_.pop_front();
+        }
+    }
+
+    return Ok(Void{});
+}
+
+Result<Void, int> TcpWriteSink::poll_close(Context& ctx) {
+    auto res = poll_flush(ctx);
+    if (!res.is_ok()) {
+        return res;
+    }
+
+    if (!closed_) {
+        closed_ = true;
+        auto shut = stream_.shutdown(SHUT_WR);
+        if (shut.is_error() && shut.error() != ENOTCONN) {
+            return Err(shut.error());
+        }
+    }
+    return Ok(Void{});
+}
+
+} // namespace bipolar
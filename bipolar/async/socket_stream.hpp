@@ -0,0 +1,100 @@
+//! Socket streams
+//!
+//! Adapts the nonblocking sockets of `bipolar/net` to `Stream` and `Sink`:
+//! - `make_tcp_read_stream()`
+//! - `make_udp_recv_stream()`
+//! - `TcpWriteSink`
+//!
+
+#ifndef BIPOLAR_ASYNC_SOCKET_STREAM_HPP_
+#define BIPOLAR_ASYNC_SOCKET_STREAM_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <tuple>
+#include <vector>
+
+#include "bipolar/async/readiness.hpp"
+#include "bipolar/async/sink.hpp"
+#include "bipolar/async/stream.hpp"
+#include "bipolar/net/socket_address.hpp"
+#include "bipolar/net/tcp.hpp"
+#include "bipolar/net/udp.hpp"
+
+namespace bipolar {
+/// Returns a stream yielding the bytes read from `stream` in chunks of at
+/// most `chunk_size` bytes. The stream ends once the peer shuts down its
+/// writing side and fails with `errno`.
+///
+/// `stream` must be nonblocking. The task polling the stream is suspended on
+/// `EAGAIN` until `waiter` reports `stream` readable.
+///
+/// `stream` and `waiter` must outlive the returned stream.
+Stream<std::vector<char>, int>
+make_tcp_read_stream(TcpStream& stream, std::size_t chunk_size,
+                     ReadinessWaiter& waiter);
+
+/// Returns a stream yielding the datagrams received by `socket`, along with
+/// their source address. Datagrams longer than `max_size` bytes are
+/// truncated. The stream never ends and fails with `errno`.
+///
+/// `socket` must be nonblocking. The task polling the stream is suspended on
+/// `EAGAIN` until `waiter` reports `socket` readable.
+///
+/// `socket` and `waiter` must outlive the returned stream.
+Stream<std::tuple<std::vector<char>, SocketAddress>, int>
+make_udp_recv_stream(UdpSocket& socket, std::size_t max_size,
+                     ReadinessWaiter& waiter);
+
+/// TcpWriteSink
+///
+/// A `Sink` writing byte buffers to a nonblocking `TcpStream`.
+///
+/// Buffers are queued by `start_send()` and written with a single
+/// `sendmsg(2)` gathering many of them when flushing. `poll_ready()` applies
+/// backpressure once more than `high_watermark` bytes are queued.
+/// `poll_close()` shuts down the writing side of the stream.
+///
+/// `stream` and `waiter` must outlive the sink.
+///
+/// # Examples
+///
+/// ```
+/// // echo
+/// TcpWriteSink sink(stream, waiter);
+/// auto echo = make_tcp_read_stream(stream, 4096, waiter).forward(sink);
+/// ```
+class TcpWriteSink final : public Sink<std::vector<char>, int> {
+public:
+    TcpWriteSink(TcpStream& stream, ReadinessWaiter& waiter,
+                 std::size_t high_watermark = 64 * 1024) noexcept;
+
+    ~TcpWriteSink() override = default;
+
+    Result<Void, int> poll_ready(Context& ctx) override;
+
+    Result<Void, int> start_send(std::vector<char> item) override;
+
+    Result<Void, int> poll_flush(Context& ctx) override;
+
+    Result<Void, int> poll_close(Context& ctx) override;
+
+    /// Returns the number of bytes queued but not written yet
+    std::size_t buffered_bytes() const noexcept {
+        return buffered_;
+    }
+
+private:
+    TcpStream& stream_;
+    ReadinessWaiter& waiter_;
+    const std::size_t high_watermark_;
+
+    std::deque<std::vector<char>> queue_;
+    std::size_t offset_ = 0;   // of the first buffer of the queue
+    std::size_t buffered_ = 0; // bytes
+    bool closed_ = false;
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,397 @@
+//! Stream
+//!
+//! See `Stream` for details
+
+#ifndef BIPOLAR_ASYNC_STREAM_HPP_
+#define BIPOLAR_ASYNC_STREAM_HPP_
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bipolar/async/internal/stream_adaptor.hpp"
+#include "bipolar/async/sink.hpp"
+#include "bipolar/core/function.hpp"
+#include "bipolar/core/movable.hpp"
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/traits.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/traits.hpp"
+
+namespace bipolar {
+// forward
+template <typename>
+class StreamImpl;
+
+/// Checks whether `Source` is a stream source, i.e. a continuation whose
+/// result type is `Result<Option<T>, E>`
+template <typename Source, typename = void>
+struct is_stream_source : std::false_type {};
+
+template <typename Source>
+struct is_stream_source<
+    Source,
+    std::enable_if_t<is_continuation_v<Source> &&
+                     detail::is_option_v<typename continuation_traits<
+                         Source>::result_type::value_type>>>
+    : std::true_type {};
+
+template <typename Source>
+inline constexpr bool is_stream_source_v = is_stream_source<Source>::value;
+
+/// Stream
+///
+/// # Brief
+///
+/// A `Stream` is the asynchronous counterpart of an iterator: it produces
+/// a sequence of values over time. It plays the same role for a sequence as
+/// `Promise` does for a single value.
+///
+/// A stream wraps a source: a continuation with the following signature
+/// `Result<Option<T>, E>(Context&)`
+///
+/// Each poll of the source returns one of:
+/// - `Pending`: no value is available yet. The source has suspended the task
+///   via `Context::suspend_task()` and will resume it later
+/// - `Ok(Some(value))`: the next value of the sequence
+/// - `Ok(None)`: the sequence has ended
+/// - `Err(error)`: the sequence failed
+///
+/// Once a stream has ended or failed its source is destroyed and the stream
+/// becomes empty.
+///
+/// # Combinators
+///
+/// Like promises, streams are lazy: nothing happens until the stream is
+/// polled, and combinators only poll their upstream when they are polled
+/// themselves.
+///
+/// Available combinators:
+/// - `map()`: transforms every value
+/// - `filter()`: drops the values not satisfying a predicate
+/// - `chunks()`: groups values into vectors of a fixed size
+/// - `ready_chunks()`: groups the values that are immediately available
+/// - `buffer_unordered()`: runs a stream of promises concurrently
+/// - `fold()`: reduces the stream into a promise
+/// - `for_each()`: runs a handler on every value
+/// - `forward()`: sends every value into a `Sink`
+/// - `box()`: wraps the stream's source into a `Function`
+///
+/// And some helpful functions:
+/// - `make_stream()` creates a stream with a handler
+/// - `make_iter_stream()` creates a stream yielding the elements of a vector
+///
+/// # Examples
+///
+/// ```
+/// auto sum = make_iter_stream(std::vector<int>{1, 2, 3, 4, 5})
+///     .filter([](const int& x) { return x % 2 == 1; })
+///     .map([](int& x) { return x * x; })
+///     .fold(0, [](int& acc, int& x) { acc += x; });
+///
+/// SingleThreadedExecutor executor;
+/// executor.schedule_task(PendingTask(std::move(sum).and_then(
+///     [](int& x) -> Result<Void, Void> {
+///         assert(x == 35);
+///         return Ok(Void{});
+///     })));
+/// executor.run();
+/// ```
+template <typename T = Void, typename E = Void>
+using Stream = StreamImpl<Function<Result<Option<T>, E>(Context&)>>;
+
+/// Stream implementation details.
+/// See `Stream` documentation for more information.
+template <typename Source>
+class StreamImpl final : public Movable {
+    // A source is a callable object with this signature:
+    // Result<Option<T>, E>(Context&)
+    static_assert(is_stream_source_v<Source>, "Source type is invalid");
+
+    template <typename>
+    friend class StreamImpl;
+
+public:
+    /// The result type of `poll_next()`.
+    /// Equivalent to `Result<Option<T>, E>`
+    using result_type = typename continuation_traits<Source>::result_type;
+
+    /// The type of value produced by the stream
+    using item_type = typename result_type::value_type::value_type;
+
+    /// The type of error produced by the stream
+    using error_type = typename result_type::error_type;
+
+    /// Creates an empty stream without a source.
+    constexpr StreamImpl() noexcept = default;
+    constexpr explicit StreamImpl(std::nullptr_t) noexcept {}
+
+    /// Constructs/Assigns the stream by taking the source from another stream,
+    /// leaving the other stream empty.
+    constexpr StreamImpl(StreamImpl&& rhs) noexcept(
+        std::is_nothrow_move_constructible_v<Source>) = default;
+    constexpr StreamImpl& operator=(StreamImpl&& rhs) noexcept(
+        std::is_nothrow_move_constructible_v<Source>) = default;
+
+    /// Creates a stream with a source.
+    constexpr explicit StreamImpl(Source source) noexcept(
+        std::is_nothrow_move_constructible_v<Source>)
+        : src_(std::move(source)) {}
+
+    /// Converts from a stream holding a source that is assignable to this
+    /// stream's source type
+    ///
+    /// This is typically used to create a stream with a boxed source type
+    /// (such as `Function`) from an unboxed stream.
+    template <
+        typename OtherSource,
+        std::enable_if_t<!std::is_same_v<Source, OtherSource> &&
+                             std::is_constructible_v<Source, OtherSource&&>,
+                         int> = 0>
+    constexpr StreamImpl(StreamImpl<OtherSource> rhs) noexcept(
+        std::is_nothrow_constructible_v<Source, OtherSource&&>)
+        : src_(rhs.src_.has_value()
+                   ? Some(Source(std::move(rhs.src_.value())))
+                   : None) {}
+
+    /// Discards the stream's source, leaving it empty.
+    constexpr StreamImpl& operator=(std::nullptr_t) noexcept {
+        src_.clear();
+        return *this;
+    }
+
+    /// Destroys the stream, releasing its source
+    ~StreamImpl() = default;
+
+    /// Returns true if the stream is non-empty (has a valid source).
+    constexpr explicit operator bool() const noexcept {
+        return src_.has_value();
+    }
+
+    /// Polls the stream for its next value.
+    ///
+    /// Once the source ends or fails, the stream is assigned an empty source.
+    ///
+    /// Throws `OptionEmptyException` when the stream is empty.
+    constexpr result_type poll_next(Context& ctx) {
+        result_type result = (src_.value())(ctx);
+        if (result.is_error() ||
+            (result.is_ok() && !result.value().has_value())) {
+            src_.clear();
+        }
+        return result;
+    }
+
+    /// Returns an unboxed stream which yields the values of this stream
+    /// transformed by `handler`.
+    ///
+    /// `handler` must accept one of the following argument lists:
+    /// - (item_type&)
+    /// - (const item_type&)
+    ///
+    /// This method consumes the stream's source, leaving it empty.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// auto s = make_iter_stream(std::vector<int>{1, 2, 3})
+    ///     .map([](int& x) { return std::to_string(x); });
+    /// ```
+    template <typename Handler>
+    constexpr auto map(Handler handler) {
+        static_assert(std::is_invocable_v<Handler&, item_type&>,
+                      "Handler must accept item_type&");
+
+        return StreamImpl<internal::MapSource<StreamImpl, Handler>>(
+            internal::MapSource<StreamImpl, Handler>(std::move(*this),
+                                                     std::move(handler)));
+    }
+
+    /// Returns an unboxed stream which only yields the values of this stream
+    /// satisfying `pred`.
+    ///
+    /// `pred` must accept a `const item_type&` and return a `bool`.
+    ///
+    /// This method consumes the stream's source, leaving it empty.
+    template <typename Predicate>
+    constexpr auto filter(Predicate pred) {
+        static_assert(std::is_invocable_r_v<bool, Predicate&, const item_type&>,
+                      "Predicate must be callable with const item_type&");
+
+        return StreamImpl<internal::FilterSource<StreamImpl, Predicate>>(
+            internal::FilterSource<StreamImpl, Predicate>(std::move(*this),
+                                                          std::move(pred)));
+    }
+
+    /// Returns an unboxed stream which yields the values of this stream in
+    /// `std::vector`s of `capacity` values.
+    ///
+    /// The last vector may hold less than `capacity` values. An error of this
+    /// stream is yielded after the values received before it.
+    ///
+    /// Asserts that `capacity` is not 0.
+    /// This method consumes the stream's source, leaving it empty.
+    constexpr auto chunks(std::size_t capacity) {
+        return StreamImpl<internal::ChunksSource<StreamImpl>>(
+            internal::ChunksSource<StreamImpl>(std::move(*this), capacity,
+                                               false));
+    }
+
+    /// Like `chunks()` but also yields the values collected so far as soon as
+    /// this stream becomes pending.
+    ///
+    /// It's useful for batching: values which are available immediately get
+    /// processed together while a lonely value is not delayed.
+    ///
+    /// Asserts that `capacity` is not 0.
+    /// This method consumes the stream's source, leaving it empty.
+    constexpr auto ready_chunks(std::size_t capacity) {
+        return StreamImpl<internal::ChunksSource<StreamImpl>>(
+            internal::ChunksSource<StreamImpl>(std::move(*this), capacity,
+                                               true));
+    }
+
+    /// Returns an unboxed stream which runs up to `limit` promises yielded by
+    /// this stream concurrently and yields their results in the order they
+    /// complete.
+    ///
+    /// Only the promises which were resumed are polled again.
+    ///
+    /// `item_type` must be a promise. The new stream yields the promises'
+    /// `result_type` and fails with this stream's error.
+    ///
+    /// Asserts that `limit` is not 0.
+    /// This method consumes the stream's source, leaving it empty.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// Promise<Response, int> fetch(Request req);
+    ///
+    /// auto responses = make_iter_stream(std::move(requests))
+    ///     .map([](Request& req) { return fetch(std::move(req)); })
+    ///     .buffer_unordered(16);
+    /// ```
+    constexpr auto buffer_unordered(std::size_t limit) {
+        static_assert(is_continuation_v<item_type>,
+                      "item_type must be a promise");
+
+        return StreamImpl<internal::BufferUnorderedSource<StreamImpl>>(
+            internal::BufferUnorderedSource<StreamImpl>(std::move(*this),
+                                                        limit));
+    }
+
+    /// Returns an unboxed promise which folds every value of this stream into
+    /// an accumulator initialized with `init`, then completes with the
+    /// accumulator once the stream has ended.
+    ///
+    /// `handler` must accept the argument list `(Acc&, item_type&)`.
+    ///
+    /// This method consumes the stream's source, leaving it empty.
+    template <typename Acc, typename Handler>
+    constexpr auto fold(Acc init, Handler handler) {
+        static_assert(std::is_invocable_v<Handler&, Acc&, item_type&>,
+                      "Handler must accept (Acc&, item_type&)");
+
+        return PromiseImpl(internal::FoldContinuation<StreamImpl, Acc, Handler>(
+            std::move(*this), std::move(init), std::move(handler)));
+    }
+
+    /// Returns an unboxed promise which invokes `handler` on every value of
+    /// this stream and completes once the stream has ended.
+    ///
+    /// `handler` must accept the argument list `(item_type&)`.
+    ///
+    /// This method consumes the stream's source, leaving it empty.
+    template <typename Handler>
+    constexpr auto for_each(Handler handler) {
+        static_assert(std::is_invocable_v<Handler&, item_type&>,
+                      "Handler must accept item_type&");
+
+        return PromiseImpl(internal::ForEachContinuation<StreamImpl, Handler>(
+            std::move(*this), std::move(handler)));
+    }
+
+    /// Returns an unboxed promise which sends every value of this stream into
+    /// `sink`, then closes the sink once the stream has ended.
+    ///
+    /// The sink is flushed each time this stream becomes pending.
+    ///
+    /// `sink` must outlive the returned promise.
+    /// This method consumes the stream's source, leaving it empty.
+    constexpr auto forward(Sink<item_type, error_type>& sink) {
+        return PromiseImpl(internal::ForwardContinuation<StreamImpl>(
+            std::move(*this), sink));
+    }
+
+    /// Wraps the stream's source into a `Function`.
+    ///
+    /// Returns an empty stream if the stream is empty.
+    /// This method consumes the stream's source, leaving it empty.
+    constexpr StreamImpl<Function<result_type(Context&)>> box() {
+        return std::move(*this);
+    }
+
+    /// Swaps the stream's source.
+    constexpr void
+    swap(StreamImpl& rhs) noexcept(std::is_nothrow_swappable_v<Source>) {
+        using std::swap;
+        swap(src_, rhs.src_);
+    }
+
+private:
+    Option<Source> src_;
+};
+
+/// Swaps the `Stream`
+template <typename Source>
+constexpr void
+swap(StreamImpl<Source>& lhs,
+     StreamImpl<Source>& rhs) noexcept(std::is_nothrow_swappable_v<Source>) {
+    lhs.swap(rhs);
+}
+
+/// make_stream
+///
+/// Returns an unboxed stream that wraps the specified handler.
+///
+/// The handler must return `Result<Option<T>, E>` and accept one of the
+/// following argument lists:
+/// - ()
+/// - (Context&)
+///
+/// # Examples
+///
+/// ```
+/// auto countdown = make_stream([n = 3]() mutable
+///                                -> Result<Option<int>, Void> {
+///     if (n == 0) {
+///         return Ok(Option<int>(None));
+///     }
+///     return Ok(Some(n--));
+/// });
+/// ```
+template <typename StreamHandler>
+constexpr auto make_stream(StreamHandler handler) {
+    static_assert(is_functor_v<StreamHandler>,
+                  "StreamHandler must be callable");
+
+    return StreamImpl(
+        internal::StreamSource<StreamHandler>(std::move(handler)));
+}
+
+/// make_iter_stream
+///
+/// Returns an unboxed stream that yields the elements of `items` in order,
+/// then ends.
+template <typename E = Void, typename T>
+constexpr auto make_iter_stream(std::vector<T> items) {
+    return StreamImpl(internal::IterSource<T, E>(std::move(items)));
+}
+
+} // namespace bipolar
+
+#endif
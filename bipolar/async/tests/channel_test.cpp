@@ -0,0 +1,409 @@
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bipolar/async/channel.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+// A context counting how many of its tickets were resumed
+class CountingContext : public Context, public SuspendedTask::Resolver {
+public:
+    Executor* get_executor() const override {
+        return nullptr;
+    }
+
+    SuspendedTask suspend_task() override {
+        return SuspendedTask(this, 0);
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket, bool resume_task) override {
+        if (resume_task) {
+            ++resumed;
+        }
+    }
+
+    int resumed = 0;
+};
+
+TEST(MpscChannel, try_send_and_try_recv) {
+    auto [tx, rx] = make_mpsc_channel<int>(3);
+    EXPECT_EQ(tx.capacity(), 4);
+    EXPECT_EQ(std::get<0>(make_mpsc_channel<int>(1)).capacity(), 2);
+
+    EXPECT_EQ(rx.try_recv().error(), ChannelError::EMPTY);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(tx.try_send(int(i)).is_ok());
+    }
+    EXPECT_EQ(tx.try_send(4).error(), ChannelError::FULL);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(rx.try_recv().value(), i);
+    }
+    EXPECT_EQ(rx.try_recv().error(), ChannelError::EMPTY);
+}
+
+TEST(MpscChannel, item_kept_on_failure) {
+    auto [tx, rx] = make_mpsc_channel<std::unique_ptr<int>>(2);
+    EXPECT_TRUE(tx.try_send(std::make_unique<int>(1)).is_ok());
+    EXPECT_TRUE(tx.try_send(std::make_unique<int>(2)).is_ok());
+
+    auto item = std::make_unique<int>(3);
+    EXPECT_EQ(tx.try_send(std::move(item)).error(), ChannelError::FULL);
+    ASSERT_TRUE(item);
+    EXPECT_EQ(*item, 3);
+
+    EXPECT_EQ(*rx.try_recv().value(), 1);
+}
+
+TEST(MpscChannel, closed_by_senders) {
+    auto [tx, rx] = make_mpsc_channel<int>(4);
+    {
+        auto tx2 = tx;
+        EXPECT_TRUE(tx2.try_send(1).is_ok());
+    }
+    EXPECT_TRUE(tx.try_send(2).is_ok());
+    { auto dropped = std::move(tx); }
+
+    // values sent before closing are still received
+    EXPECT_EQ(rx.try_recv().value(), 1);
+    EXPECT_EQ(rx.try_recv().value(), 2);
+    EXPECT_EQ(rx.try_recv().error(), ChannelError::CLOSED);
+}
+
+TEST(MpscChannel, closed_by_receiver) {
+    auto [tx, rx] = make_mpsc_channel<int>(4);
+    EXPECT_FALSE(tx.is_closed());
+    { auto dropped = std::move(rx); }
+
+    EXPECT_TRUE(tx.is_closed());
+    EXPECT_EQ(tx.try_send(1).error(), ChannelError::CLOSED);
+}
+
+TEST(MpscChannel, send_suspends_while_full) {
+    CountingContext ctx;
+    auto [tx, rx] = make_mpsc_channel<int>(2);
+    EXPECT_TRUE(tx.try_send(0).is_ok());
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+
+    auto first = tx.send(2);
+    auto second = tx.send(3);
+    EXPECT_TRUE(first(ctx).is_pending());
+    EXPECT_TRUE(second(ctx).is_pending());
+    EXPECT_EQ(ctx.resumed, 0);
+
+    // senders are resumed one at a time in FIFO order
+    EXPECT_EQ(rx.try_recv().value(), 0);
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_TRUE(first(ctx).is_ok());
+    EXPECT_TRUE(second(ctx).is_pending());
+
+    EXPECT_EQ(rx.try_recv().value(), 1);
+    EXPECT_EQ(ctx.resumed, 2);
+    EXPECT_EQ(rx.try_recv().value(), 2);
+    EXPECT_TRUE(second(ctx).is_ok());
+    EXPECT_EQ(rx.try_recv().value(), 3);
+}
+
+TEST(MpscChannel, abandoned_sender_passes_wakeup) {
+    CountingContext ctx;
+    auto [tx, rx] = make_mpsc_channel<int>(2);
+    EXPECT_TRUE(tx.try_send(0).is_ok());
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+
+    auto second = tx.send(3);
+    {
+        auto first = tx.send(2);
+        EXPECT_TRUE(first(ctx).is_pending());
+        EXPECT_TRUE(second(ctx).is_pending());
+
+        EXPECT_EQ(rx.try_recv().value(), 0);
+        EXPECT_EQ(ctx.resumed, 1);
+    }
+
+    // `first` was woken up but destroyed, `second` takes its turn
+    EXPECT_EQ(ctx.resumed, 2);
+    EXPECT_TRUE(second(ctx).is_ok());
+}
+
+TEST(MpscChannel, send_fails_when_receiver_closes) {
+    CountingContext ctx;
+    auto [tx, rx] = make_mpsc_channel<int>(2);
+    EXPECT_TRUE(tx.try_send(0).is_ok());
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+
+    auto send = tx.send(2);
+    EXPECT_TRUE(send(ctx).is_pending());
+    { auto dropped = std::move(rx); }
+
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_EQ(send(ctx).error(), ChannelError::CLOSED);
+}
+
+TEST(MpscChannel, recv_suspends_while_empty) {
+    CountingContext ctx;
+    auto [tx, rx] = make_mpsc_channel<int>(2);
+
+    auto recv = rx.recv();
+    EXPECT_TRUE(recv(ctx).is_pending());
+    EXPECT_EQ(ctx.resumed, 0);
+
+    EXPECT_TRUE(tx.try_send(42).is_ok());
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_EQ(recv(ctx).value(), 42);
+
+    // the last sender leaving resumes the receiver as well
+    auto recv2 = rx.recv();
+    EXPECT_TRUE(recv2(ctx).is_pending());
+    { auto dropped = std::move(tx); }
+    EXPECT_EQ(ctx.resumed, 2);
+    EXPECT_EQ(recv2(ctx).error(), ChannelError::CLOSED);
+}
+
+TEST(MpscChannel, recv_many) {
+    CountingContext ctx;
+    auto [tx, rx] = make_mpsc_channel<int>(8);
+
+    auto recv = rx.recv_many(3);
+    EXPECT_TRUE(recv(ctx).is_pending());
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(tx.try_send(int(i)).is_ok());
+    }
+    EXPECT_EQ(ctx.resumed, 1);
+
+    EXPECT_EQ(recv(ctx).value(), (std::vector<int>{0, 1, 2}));
+    auto recv2 = rx.recv_many(3);
+    EXPECT_EQ(recv2(ctx).value(), (std::vector<int>{3, 4}));
+}
+
+TEST(MpscChannel, into_stream) {
+    CountingContext ctx;
+    auto [tx, rx] = make_mpsc_channel<int>(4);
+    auto stream = std::move(rx).into_stream();
+
+    EXPECT_TRUE(stream.poll_next(ctx).is_pending());
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+    EXPECT_EQ(stream.poll_next(ctx).value().value(), 1);
+
+    EXPECT_TRUE(tx.try_send(2).is_ok());
+    { auto dropped = std::move(tx); }
+    EXPECT_EQ(stream.poll_next(ctx).value().value(), 2);
+    EXPECT_FALSE(stream.poll_next(ctx).value().has_value());
+    EXPECT_FALSE(stream);
+}
+
+TEST(MpscChannel, across_executors) {
+    constexpr int kProducers = 4;
+    constexpr int kCount = 10000;
+    auto [tx, rx] = make_mpsc_channel<int>(64);
+
+    long sum = 0;
+    std::thread consumer([&, rx = std::move(rx)]() mutable {
+        SingleThreadedExecutor executor;
+        executor.schedule_task(PendingTask(std::move(rx).into_stream().fold(
+            0L, [](long& acc, int& x) { acc += x; })
+            .and_then([&](long& total) -> Result<Void, ChannelError> {
+                sum = total;
+                return Ok(Void{});
+            })));
+        executor.run();
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([tx = tx]() mutable {
+            SingleThreadedExecutor executor;
+            executor.schedule_task(PendingTask(make_promise(
+                [&tx, i = 0, sending = Option<Promise<Void, ChannelError>>()](
+                    Context& ctx) mutable -> Result<Void, ChannelError> {
+                    for (; i < kCount; ++i) {
+                        if (!sending.has_value()) {
+                            sending.emplace(tx.send(int(i)).box());
+                        }
+                        auto result = sending.value()(ctx);
+                        if (result.is_pending()) {
+                            return Pending{};
+                        }
+                        sending.clear();
+                        if (result.is_error()) {
+                            return Err(result.take_error());
+                        }
+                    }
+                    return Ok(Void{});
+                })));
+            executor.run();
+        });
+    }
+    { auto dropped = std::move(tx); }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+    EXPECT_EQ(sum, long(kProducers) * kCount * (kCount - 1) / 2);
+}
+
+TEST(OneshotChannel, send_then_recv) {
+    auto [tx, rx] = make_oneshot_channel<std::string>();
+    EXPECT_EQ(rx.try_recv().error(), ChannelError::EMPTY);
+
+    EXPECT_TRUE(tx.send("hello").is_ok());
+    EXPECT_TRUE(tx.is_closed());
+    EXPECT_EQ(rx.try_recv().value(), "hello");
+    EXPECT_EQ(rx.try_recv().error(), ChannelError::CLOSED);
+}
+
+TEST(OneshotChannel, recv_suspends) {
+    CountingContext ctx;
+    auto [tx, rx] = make_oneshot_channel<int>();
+
+    auto recv = rx.recv();
+    EXPECT_TRUE(recv(ctx).is_pending());
+    EXPECT_TRUE(recv(ctx).is_pending());
+    EXPECT_EQ(ctx.resumed, 0);
+
+    EXPECT_TRUE(tx.send(42).is_ok());
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_EQ(recv(ctx).value(), 42);
+}
+
+TEST(OneshotChannel, sender_dropped) {
+    CountingContext ctx;
+    auto [tx, rx] = make_oneshot_channel<int>();
+
+    auto recv = rx.recv();
+    EXPECT_TRUE(recv(ctx).is_pending());
+    { auto dropped = std::move(tx); }
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_EQ(recv(ctx).error(), ChannelError::CLOSED);
+}
+
+TEST(OneshotChannel, receiver_dropped) {
+    auto [tx, rx] = make_oneshot_channel<int>();
+    { auto dropped = std::move(rx); }
+
+    EXPECT_TRUE(tx.is_closed());
+    EXPECT_EQ(tx.send(1).error(), ChannelError::CLOSED);
+}
+
+TEST(OneshotChannel, across_threads) {
+    auto [tx, rx] = make_oneshot_channel<int>();
+
+    int value = 0;
+    std::thread sender([tx = std::move(tx)]() mutable { (void)tx.send(42); });
+
+    SingleThreadedExecutor executor;
+    executor.schedule_task(PendingTask(
+        rx.recv().and_then([&](int& x) -> Result<Void, ChannelError> {
+            value = x;
+            return Ok(Void{});
+        })));
+    executor.run();
+    sender.join();
+    EXPECT_EQ(value, 42);
+}
+
+TEST(BroadcastChannel, every_receiver_gets_every_value) {
+    auto [tx, rx1] = make_broadcast_channel<std::string>(2);
+    EXPECT_TRUE(tx.try_send("a").is_ok());
+
+    // subscribers only get values sent afterwards
+    auto rx2 = tx.subscribe();
+    EXPECT_TRUE(tx.try_send("b").is_ok());
+    EXPECT_EQ(tx.try_send("c").error(), ChannelError::FULL);
+
+    EXPECT_EQ(rx1.try_recv().value(), "a");
+    EXPECT_EQ(rx2.try_recv().value(), "b");
+    EXPECT_EQ(rx2.try_recv().error(), ChannelError::EMPTY);
+    EXPECT_TRUE(tx.try_send("c").is_ok());
+    EXPECT_EQ(tx.try_send("d").error(), ChannelError::FULL);
+
+    EXPECT_EQ(rx1.try_recv().value(), "b");
+    EXPECT_EQ(rx1.try_recv().value(), "c");
+    EXPECT_EQ(rx2.try_recv().value(), "c");
+}
+
+TEST(BroadcastChannel, suspends_both_sides) {
+    CountingContext ctx;
+    auto [tx, rx1] = make_broadcast_channel<int>(1);
+    auto rx2 = tx.subscribe();
+
+    auto recv = rx1.recv();
+    EXPECT_TRUE(recv(ctx).is_pending());
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_EQ(recv(ctx).value(), 1);
+
+    auto send = tx.send(2);
+    EXPECT_TRUE(send(ctx).is_pending());
+    EXPECT_EQ(rx2.try_recv().value(), 1);
+    EXPECT_EQ(ctx.resumed, 2);
+    EXPECT_TRUE(send(ctx).is_ok());
+}
+
+TEST(BroadcastChannel, repolled_waiters_are_replaced) {
+    CountingContext ctx;
+    auto [tx, rx1] = make_broadcast_channel<int>(1);
+    auto rx2 = tx.subscribe();
+
+    // a single ticket is left, resumed once
+    auto recv = rx1.recv();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(recv(ctx).is_pending());
+    }
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+    EXPECT_EQ(ctx.resumed, 1);
+    EXPECT_EQ(recv(ctx).value(), 1);
+
+    auto send = tx.send(2);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(send(ctx).is_pending());
+    }
+    EXPECT_EQ(rx2.try_recv().value(), 1);
+    EXPECT_EQ(ctx.resumed, 2);
+    EXPECT_TRUE(send(ctx).is_ok());
+
+    // dropped while parked, nothing to resume
+    EXPECT_EQ(rx1.try_recv().value(), 2);
+    {
+        auto dropped = rx1.recv();
+        EXPECT_TRUE(dropped(ctx).is_pending());
+    }
+    EXPECT_EQ(rx2.try_recv().value(), 2);
+    EXPECT_TRUE(tx.try_send(3).is_ok());
+    EXPECT_EQ(ctx.resumed, 2);
+}
+
+TEST(BroadcastChannel, closed) {
+    auto [tx, rx1] = make_broadcast_channel<int>(2);
+    auto rx2 = tx.subscribe();
+    EXPECT_TRUE(tx.try_send(1).is_ok());
+
+    // a lagging receiver leaving frees its unread values
+    { auto dropped = std::move(rx2); }
+    EXPECT_EQ(rx1.try_recv().value(), 1);
+    EXPECT_TRUE(tx.try_send(2).is_ok());
+    EXPECT_TRUE(tx.try_send(3).is_ok());
+
+    { auto dropped = std::move(tx); }
+    EXPECT_EQ(rx1.try_recv().value(), 2);
+    EXPECT_EQ(rx1.try_recv().value(), 3);
+    EXPECT_EQ(rx1.try_recv().error(), ChannelError::CLOSED);
+}
+
+TEST(BroadcastChannel, no_receiver) {
+    auto [tx, rx] = make_broadcast_channel<int>(2);
+    { auto dropped = std::move(rx); }
+    EXPECT_EQ(tx.try_send(1).error(), ChannelError::CLOSED);
+}
@@ -0,0 +1,77 @@
+#include <thread>
+#include <vector>
+
+#include "bipolar/async/mutex.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+TEST(AsyncMutex, try_lock) {
+    AsyncMutex mtx;
+    EXPECT_FALSE(mtx.is_locked());
+
+    auto guard = mtx.try_lock();
+    ASSERT_TRUE(guard.has_value());
+    EXPECT_TRUE(mtx.is_locked());
+    EXPECT_FALSE(mtx.try_lock().has_value());
+
+    guard.value().release();
+    EXPECT_FALSE(mtx.is_locked());
+}
+
+TEST(AsyncMutex, held_across_suspension) {
+    AsyncMutex mtx;
+    SingleThreadedExecutor executor;
+    std::vector<int> trace;
+
+    // each task yields once while holding the mutex
+    for (int i = 0; i < 3; ++i) {
+        executor.schedule_task(PendingTask(mtx.lock().and_then(
+            [&, i, yielded = false](Context& ctx, AsyncMutexGuard& guard) mutable
+            -> Result<Void, Void> {
+                if (!yielded) {
+                    trace.push_back(i);
+                    yielded = true;
+                    ctx.suspend_task().resume_task();
+                    return Pending{};
+                }
+                trace.push_back(i);
+                guard.release();
+                return Ok(Void{});
+            })));
+    }
+    executor.run();
+
+    EXPECT_EQ(trace, (std::vector<int>{0, 0, 1, 1, 2, 2}));
+    EXPECT_FALSE(mtx.is_locked());
+}
+
+TEST(AsyncMutex, across_executors) {
+    constexpr int kThreads = 4;
+    constexpr int kTasks = 1000;
+    AsyncMutex mtx;
+    long counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            SingleThreadedExecutor executor;
+            for (int i = 0; i < kTasks; ++i) {
+                executor.schedule_task(PendingTask(mtx.lock().and_then(
+                    [&](AsyncMutexGuard&) -> Result<Void, Void> {
+                        ++counter;
+                        return Ok(Void{});
+                    })));
+            }
+            executor.run();
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(counter, kThreads * kTasks);
+}
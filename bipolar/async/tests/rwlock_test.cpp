@@ -0,0 +1,72 @@
+#include "bipolar/async/rwlock.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+// A context counting how many of its tickets were resumed
+class CountingContext : public Context, public SuspendedTask::Resolver {
+public:
+    Executor* get_executor() const override {
+        return nullptr;
+    }
+
+    SuspendedTask suspend_task() override {
+        return SuspendedTask(this, 0);
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket, bool resume_task) override {
+        if (resume_task) {
+            ++resumed;
+        }
+    }
+
+    int resumed = 0;
+};
+
+TEST(AsyncRwLock, readers_share) {
+    AsyncRwLock lock;
+
+    auto r1 = lock.try_read();
+    auto r2 = lock.try_read();
+    EXPECT_TRUE(r1.has_value());
+    EXPECT_TRUE(r2.has_value());
+    EXPECT_FALSE(lock.try_write().has_value());
+
+    r1.value().release();
+    r2.value().release();
+    auto w = lock.try_write();
+    EXPECT_TRUE(w.has_value());
+    EXPECT_FALSE(lock.try_read().has_value());
+}
+
+TEST(AsyncRwLock, writer_not_starved) {
+    CountingContext wctx, rctx;
+    AsyncRwLock lock(4);
+
+    auto reader = lock.try_read();
+    auto write = lock.write();
+    EXPECT_TRUE(write(wctx).is_pending());
+
+    // readers arriving after a waiting writer queue behind it
+    EXPECT_FALSE(lock.try_read().has_value());
+    auto read = lock.read();
+    EXPECT_TRUE(read(rctx).is_pending());
+
+    reader.value().release();
+    EXPECT_EQ(wctx.resumed, 1);
+    EXPECT_EQ(rctx.resumed, 0);
+
+    auto writer = write(wctx);
+    ASSERT_TRUE(writer.is_ok());
+    EXPECT_TRUE(read(rctx).is_pending());
+
+    writer.value().release();
+    EXPECT_EQ(rctx.resumed, 1);
+    EXPECT_TRUE(read(rctx).is_ok());
+}
@@ -0,0 +1,164 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bipolar/async/semaphore.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+// A context counting how many of its tickets were resumed
+class CountingContext : public Context, public SuspendedTask::Resolver {
+public:
+    Executor* get_executor() const override {
+        return nullptr;
+    }
+
+    SuspendedTask suspend_task() override {
+        return SuspendedTask(this, 0);
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket, bool resume_task) override {
+        if (resume_task) {
+            ++resumed;
+        }
+    }
+
+    int resumed = 0;
+};
+
+TEST(AsyncSemaphore, try_acquire) {
+    AsyncSemaphore sem(3);
+
+    auto p1 = sem.try_acquire(2);
+    ASSERT_TRUE(p1.has_value());
+    EXPECT_EQ(p1.value().permits(), 2);
+    EXPECT_EQ(sem.available_permits(), 1);
+    EXPECT_FALSE(sem.try_acquire(2).has_value());
+
+    p1.value().release();
+    EXPECT_FALSE(p1.value());
+    EXPECT_EQ(sem.available_permits(), 3);
+
+    {
+        auto p2 = sem.try_acquire(3);
+        EXPECT_EQ(sem.available_permits(), 0);
+        auto p3 = std::move(p2);
+    }
+    EXPECT_EQ(sem.available_permits(), 3);
+
+    sem.try_acquire(1).value().forget();
+    EXPECT_EQ(sem.available_permits(), 2);
+}
+
+TEST(AsyncSemaphore, acquire_suspends_in_fifo_order) {
+    CountingContext ctx1, ctx2, ctx3;
+    AsyncSemaphore sem(2);
+
+    auto held = sem.try_acquire(2);
+    auto big = sem.acquire(2);
+    auto small = sem.acquire(1);
+    EXPECT_TRUE(big(ctx1).is_pending());
+    EXPECT_TRUE(small(ctx2).is_pending());
+
+    // queued after `big` even though a permit is free
+    held.value().release();
+    held = sem.try_acquire(1);
+    EXPECT_FALSE(held.has_value());
+    EXPECT_EQ(ctx1.resumed, 1);
+    EXPECT_EQ(ctx2.resumed, 0);
+
+    auto p1 = big(ctx1);
+    ASSERT_TRUE(p1.is_ok());
+    EXPECT_EQ(p1.value().permits(), 2);
+
+    auto late = sem.acquire(1);
+    EXPECT_TRUE(late(ctx3).is_pending());
+
+    p1.value().release();
+    EXPECT_EQ(ctx2.resumed, 1);
+    EXPECT_EQ(ctx3.resumed, 1);
+    EXPECT_TRUE(small(ctx2).is_ok());
+    EXPECT_TRUE(late(ctx3).is_ok());
+    EXPECT_EQ(sem.available_permits(), 2);
+}
+
+TEST(AsyncSemaphore, cancel_waiting) {
+    CountingContext ctx1, ctx2;
+    AsyncSemaphore sem(2);
+
+    auto held = sem.try_acquire(1);
+    auto small = sem.acquire(1);
+    {
+        auto big = sem.acquire(2);
+        EXPECT_TRUE(big(ctx1).is_pending());
+        EXPECT_TRUE(small(ctx2).is_pending());
+    }
+
+    // `big` leaving the front lets `small` in
+    EXPECT_EQ(ctx2.resumed, 1);
+    EXPECT_TRUE(small(ctx2).is_ok());
+    EXPECT_EQ(sem.available_permits(), 1);
+}
+
+TEST(AsyncSemaphore, cancel_granted) {
+    CountingContext ctx;
+    AsyncSemaphore sem(1);
+
+    auto held = sem.try_acquire(1);
+    {
+        auto acquire = sem.acquire(1);
+        EXPECT_TRUE(acquire(ctx).is_pending());
+        held.value().release();
+        EXPECT_EQ(ctx.resumed, 1);
+        EXPECT_EQ(sem.available_permits(), 0);
+    }
+
+    // granted permits never observed go back
+    EXPECT_EQ(sem.available_permits(), 1);
+}
+
+TEST(AsyncSemaphore, bounds_concurrency_across_executors) {
+    constexpr int kThreads = 4;
+    constexpr int kTasks = 100;
+    AsyncSemaphore sem(2);
+    std::atomic<int> inside{0};
+    std::atomic<int> max_inside{0};
+    std::atomic<int> done{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            SingleThreadedExecutor executor;
+            for (int i = 0; i < kTasks; ++i) {
+                executor.schedule_task(PendingTask(sem.acquire().and_then(
+                    [&](SemaphorePermit&) -> Result<Void, Void> {
+                        const int n = ++inside;
+                        int max = max_inside.load();
+                        while (n > max &&
+                               !max_inside.compare_exchange_weak(max, n)) {
+                        }
+                        std::this_thread::yield();
+                        --inside;
+                        ++done;
+                        return Ok(Void{});
+                    })));
+            }
+            executor.run();
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(done.load(), kThreads * kTasks);
+    EXPECT_LE(max_inside.load(), 2);
+    EXPECT_EQ(sem.available_permits(), 2);
+}
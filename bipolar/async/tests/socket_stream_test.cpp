@@ -0,0 +1,158 @@
+#include <sys/epoll.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "bipolar/async/readiness.hpp"
+#include "bipolar/async/socket_stream.hpp"
+#include "bipolar/futures/pending_task.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::chrono_literals;
+
+inline constexpr auto anonymous_addr =
+    SocketAddress(IPv4Address(127, 0, 0, 1), 0);
+
+namespace {
+// Drives `waiter` on another thread until destroyed
+class Reactor {
+public:
+    explicit Reactor(EpollReadinessWaiter& waiter)
+        : thread_([this, &waiter]() {
+              while (!stop_.load(std::memory_order_relaxed)) {
+                  waiter.poll(10ms).expect("epoll wait failed");
+              }
+          }) {}
+
+    ~Reactor() {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+    }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+} // namespace
+
+TEST(SocketStream, tcp_echo) {
+    EpollReadinessWaiter waiter(Epoll::create().expect("epoll create failed"));
+    Reactor reactor(waiter);
+
+    auto listener = TcpListener::bind(anonymous_addr).expect("bind failed");
+    const auto addr = listener.local_addr().expect("local_addr failed");
+
+    std::string received;
+    std::thread client([&addr, &received]() {
+        auto stream = TcpStream::connect(addr).expect("connect failed");
+        stream.set_nonblocking(false).expect("set_nonblocking failed");
+
+        const std::string msg(100000, 'x');
+        std::size_t sent = 0;
+        while (sent < msg.size()) {
+            sent += stream.write(msg.data() + sent, msg.size() - sent)
+                        .expect("write failed");
+        }
+        stream.shutdown(SHUT_WR).expect("shutdown failed");
+
+        char buf[4096];
+        for (;;) {
+            const auto n = stream.read(buf, sizeof(buf)).expect("read failed");
+            if (n == 0) {
+                break;
+            }
+            received.append(buf, n);
+        }
+    });
+
+    Result<std::tuple<TcpStream, SocketAddress>, int> accepted = Err(EAGAIN);
+    while (accepted.is_error() && accepted.error() == EAGAIN) {
+        std::this_thread::sleep_for(1ms);
+        accepted = listener.accept();
+    }
+    auto [stream, peer] = accepted.take_value();
+    (void)peer;
+
+    TcpWriteSink sink(stream, waiter, 4096);
+    Result<Void, int> result;
+    SingleThreadedExecutor executor;
+    executor.schedule_task(
+        PendingTask(make_tcp_read_stream(stream, 1024, waiter)
+                        .forward(sink)
+                        .then([&](Result<Void, int>& r) -> Result<Void, Void> {
+                            result = std::move(r);
+                            return Ok(Void{});
+                        })));
+    executor.run();
+    waiter.forget(stream.as_fd());
+
+    client.join();
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ(received, std::string(100000, 'x'));
+}
+
+TEST(SocketStream, udp_recv) {
+    EpollReadinessWaiter waiter(Epoll::create().expect("epoll create failed"));
+    Reactor reactor(waiter);
+
+    auto server = UdpSocket::bind(anonymous_addr).expect("bind failed");
+    auto client = UdpSocket::bind(anonymous_addr).expect("bind failed");
+    const auto server_addr = server.local_addr().expect("local_addr failed");
+    const auto client_addr = client.local_addr().expect("local_addr failed");
+
+    std::thread sender([&]() {
+        for (int i = 0; i < 8; ++i) {
+            std::this_thread::sleep_for(1ms);
+            const std::string msg = std::to_string(i);
+            client.sendto(msg.data(), msg.size(), server_addr)
+                .expect("sendto failed");
+        }
+    });
+
+    std::vector<std::string> msgs;
+    std::atomic<int> received{0};
+    std::atomic<bool> done{false};
+    SingleThreadedExecutor executor;
+    executor.schedule_task(PendingTask(
+        make_udp_recv_stream(server, 64, waiter)
+            .filter([&](const std::tuple<std::vector<char>, SocketAddress>&
+                            item) { return std::get<1>(item) == client_addr; })
+            .map([&](std::tuple<std::vector<char>, SocketAddress>& item) {
+                ++received;
+                auto& buf = std::get<0>(item);
+                return std::string(buf.begin(), buf.end());
+            })
+            .chunks(4)
+            .fold(0, [&](int& n, std::vector<std::string>& chunk) {
+                EXPECT_EQ(chunk.size(), 4);
+                msgs.insert(msgs.end(), chunk.begin(), chunk.end());
+                ++n;
+            })
+            .discard_result()));
+
+    std::thread stopper([&]() {
+        sender.join();
+        while (received.load() < 8) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // the receive stream never ends, abandons the task by releasing it
+        while (!done.load()) {
+            std::this_thread::sleep_for(10ms);
+            waiter.forget(server.as_fd());
+        }
+    });
+    executor.run();
+    done.store(true);
+    stopper.join();
+
+    EXPECT_EQ(msgs, (std::vector<std::string>{"0", "1", "2", "3", "4", "5",
+                                               "6", "7"}));
+}
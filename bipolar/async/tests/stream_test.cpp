@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bipolar/async/sink.hpp"
+#include "bipolar/async/stream.hpp"
+#include "bipolar/futures/promise.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+class DummyContext : public Context {
+public:
+    Executor* get_executor() const override {
+        return nullptr;
+    }
+
+    SuspendedTask suspend_task() override {
+        __builtin_unreachable();
+    }
+};
+
+class VectorSink final : public Sink<int, Void> {
+public:
+    Result<Void, Void> poll_ready(Context&) override {
+        return Ok(Void{});
+    }
+
+    Result<Void, Void> start_send(int item) override {
+        items.push_back(item);
+        return Ok(Void{});
+    }
+
+    Result<Void, Void> poll_flush(Context&) override {
+        ++flushes;
+        return Ok(Void{});
+    }
+
+    Result<Void, Void> poll_close(Context&) override {
+        closed = true;
+        return Ok(Void{});
+    }
+
+    std::vector<int> items;
+    int flushes = 0;
+    bool closed = false;
+};
+
+// A context whose tickets can be resumed and are simply dropped
+class RecordingContext : public Context, public SuspendedTask::Resolver {
+public:
+    Executor* get_executor() const override {
+        return nullptr;
+    }
+
+    SuspendedTask suspend_task() override {
+        return SuspendedTask(this, 0);
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket, bool) override {}
+};
+
+namespace {
+DummyContext ctx;
+
+// Yields `n` integers from 0, returning `Pending` before each odd one
+auto make_bumpy_stream(int n) {
+    return make_stream([i = 0, pending = false, n]() mutable
+                       -> Result<Option<int>, Void> {
+        if (i == n) {
+            return Ok(Option<int>(None));
+        }
+        if (i % 2 == 1 && !pending) {
+            pending = true;
+            return Pending{};
+        }
+        pending = false;
+        return Ok(Some(i++));
+    });
+}
+
+template <typename S>
+std::vector<typename S::item_type> drain(S& stream) {
+    std::vector<typename S::item_type> items;
+    for (;;) {
+        auto result = stream.poll_next(ctx);
+        if (result.is_pending()) {
+            continue;
+        }
+        if (!result.value().has_value()) {
+            break;
+        }
+        items.push_back(std::move(result.value().value()));
+    }
+    return items;
+}
+} // namespace
+
+TEST(Stream, empty) {
+    Stream<int, int> stream;
+    EXPECT_FALSE(stream);
+
+    Stream<int, int> stream2(nullptr);
+    EXPECT_FALSE(stream2);
+}
+
+TEST(Stream, make_iter_stream) {
+    auto stream = make_iter_stream(std::vector<int>{1, 2, 3});
+    EXPECT_TRUE(stream);
+
+    EXPECT_EQ(drain(stream), (std::vector<int>{1, 2, 3}));
+    EXPECT_FALSE(stream);
+}
+
+TEST(Stream, ends_on_error) {
+    auto stream = make_stream([i = 0]() mutable -> Result<Option<int>, int> {
+        if (i == 2) {
+            return Err(-1);
+        }
+        return Ok(Some(i++));
+    });
+
+    EXPECT_EQ(stream.poll_next(ctx).value().value(), 0);
+    EXPECT_EQ(stream.poll_next(ctx).value().value(), 1);
+    EXPECT_EQ(stream.poll_next(ctx).error(), -1);
+    EXPECT_FALSE(stream);
+}
+
+TEST(Stream, map_and_filter) {
+    Stream<std::string, Void> stream =
+        make_iter_stream(std::vector<int>{1, 2, 3, 4, 5})
+            .filter([](const int& x) { return x % 2 == 1; })
+            .map([](int& x) { return std::to_string(x * x); });
+
+    EXPECT_EQ(drain(stream), (std::vector<std::string>{"1", "9", "25"}));
+}
+
+TEST(Stream, is_lazy) {
+    int polled = 0;
+    auto stream = make_stream([&]() -> Result<Option<int>, Void> {
+                      return Ok(Some(polled++));
+                  })
+                      .map([](int& x) { return x; });
+    EXPECT_EQ(polled, 0);
+
+    EXPECT_EQ(stream.poll_next(ctx).value().value(), 0);
+    EXPECT_EQ(polled, 1);
+}
+
+TEST(Stream, chunks) {
+    auto stream = make_bumpy_stream(7).chunks(3);
+
+    using V = std::vector<int>;
+    EXPECT_EQ(drain(stream), (std::vector<V>{{0, 1, 2}, {3, 4, 5}, {6}}));
+}
+
+TEST(Stream, chunks_error_after_items) {
+    auto stream = make_stream([i = 0]() mutable -> Result<Option<int>, int> {
+                      if (i == 2) {
+                          return Err(-1);
+                      }
+                      return Ok(Some(i++));
+                  }).chunks(4);
+
+    EXPECT_EQ(stream.poll_next(ctx).value().value(), (std::vector<int>{0, 1}));
+    EXPECT_EQ(stream.poll_next(ctx).error(), -1);
+    EXPECT_FALSE(stream);
+}
+
+TEST(Stream, ready_chunks) {
+    auto stream = make_bumpy_stream(5).ready_chunks(8);
+
+    using V = std::vector<int>;
+    EXPECT_EQ(drain(stream), (std::vector<V>{{0}, {1, 2}, {3, 4}}));
+}
+
+TEST(Stream, fold) {
+    auto promise = make_bumpy_stream(5).fold(
+        std::string(),
+        [](std::string& acc, int& x) { acc += std::to_string(x); });
+
+    Result<std::string, Void> result;
+    while (result.is_pending()) {
+        result = promise(ctx);
+    }
+    EXPECT_EQ(result.value(), "01234");
+}
+
+TEST(Stream, for_each) {
+    std::vector<int> items;
+    auto promise = make_iter_stream(std::vector<int>{1, 2, 3})
+                       .for_each([&](int& x) { items.push_back(x); });
+
+    EXPECT_TRUE(promise(ctx).is_ok());
+    EXPECT_EQ(items, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(Stream, forward) {
+    VectorSink sink;
+    auto promise = make_bumpy_stream(4).forward(sink);
+
+    while (promise(ctx).is_pending()) {
+        EXPECT_FALSE(sink.closed);
+    }
+    EXPECT_EQ(sink.items, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(sink.flushes, 2);
+    EXPECT_TRUE(sink.closed);
+}
+
+TEST(Stream, box) {
+    Stream<int, Void> stream = make_iter_stream(std::vector<int>{1, 2});
+    auto boxed = make_iter_stream(std::vector<int>{3}).box();
+    static_assert(std::is_same_v<decltype(boxed), Stream<int, Void>>);
+
+    EXPECT_EQ(drain(stream), (std::vector<int>{1, 2}));
+    EXPECT_EQ(drain(boxed), (std::vector<int>{3}));
+}
+
+TEST(Stream, buffer_unordered) {
+    constexpr int N = 16;
+    constexpr std::size_t LIMIT = 4;
+
+    RecordingContext rctx;
+    std::vector<SuspendedTask> tasks(N);
+    std::vector<int> polls(N, 0);
+    std::size_t running = 0;
+    std::size_t max_running = 0;
+
+    std::vector<int> ids;
+    for (int i = 0; i < N; ++i) {
+        ids.push_back(i);
+    }
+
+    auto stream =
+        make_iter_stream(std::move(ids))
+            .map([&](int& id) -> Promise<int, Void> {
+                max_running = std::max(max_running, ++running);
+                return make_promise(
+                    [&, id](Context& ctx) -> Result<int, Void> {
+                        if (++polls[id] == 1) {
+                            tasks[id] = ctx.suspend_task();
+                            return Pending{};
+                        }
+                        --running;
+                        return Ok(id);
+                    });
+            })
+            .buffer_unordered(LIMIT);
+
+    EXPECT_TRUE(stream.poll_next(rctx).is_pending());
+    EXPECT_EQ(running, LIMIT);
+
+    // resumes the running promises in the reverse order
+    std::vector<int> results;
+    for (;;) {
+        for (int i = N - 1; i >= 0; --i) {
+            if (tasks[i]) {
+                tasks[i].resume_task();
+                break;
+            }
+        }
+
+        auto result = stream.poll_next(rctx);
+        if (result.is_pending()) {
+            continue;
+        }
+        if (!result.value().has_value()) {
+            break;
+        }
+        results.push_back(result.value().value().value());
+    }
+
+    EXPECT_EQ(results.size(), N);
+    EXPECT_EQ(max_running, LIMIT);
+    EXPECT_EQ(running, 0);
+    for (int i = 0; i < N; ++i) {
+        // only the resumed promise is polled again
+        EXPECT_EQ(polls[i], 2);
+    }
+    EXPECT_EQ(results.front(), 3);
+    EXPECT_FALSE(stream);
+}
@@ -0,0 +1,45 @@
+#include "bipolar/core/histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bipolar {
+std::uint64_t HistogramSnapshot::percentile(double q) const noexcept {
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto rank = static_cast<std::uint64_t>(
+        std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank && seen > 0) {
+            // the largest value of the bucket
+            const std::uint64_t bound =
+                i == 0 ? 0 : (std::uint64_t(1) << i) - 1;
+            return std::min(bound, max);
+        }
+    }
+    return max;
+}
+
+std::ostream& operator<<(std::ostream& os, const HistogramSnapshot& hist) {
+    return os << "count=" << hist.count << " mean=" << hist.mean()
+              << " p50=" << hist.percentile(0.5)
+              << " p99=" << hist.percentile(0.99)
+              << " p999=" << hist.percentile(0.999) << " max=" << hist.max;
+}
+
+HistogramSnapshot Histogram::snapshot() const noexcept {
+    HistogramSnapshot hist;
+    for (std::size_t i = 0; i < buckets_.size(); ++i) {
+        hist.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    hist.count = count_.load(std::memory_order_relaxed);
+    hist.sum = sum_.load(std::memory_order_relaxed);
+    hist.max = max_.load(std::memory_order_relaxed);
+    return hist;
+}
+
+} // namespace bipolar
@@ -0,0 +1,99 @@
+//! Histogram
+//!
+//! - `Histogram`
+//! - `HistogramSnapshot`
+//!
+
+#ifndef BIPOLAR_CORE_HISTOGRAM_HPP_
+#define BIPOLAR_CORE_HISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace bipolar {
+/// HistogramSnapshot
+///
+/// A copy of the buckets of a `Histogram`
+struct HistogramSnapshot {
+    /// Bucket 0 counts the zeros, bucket `i` the values in `[2^(i-1), 2^i)`
+    std::array<std::uint64_t, 64> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+
+    /// Returns the mean value, 0 if empty
+    double mean() const noexcept {
+        return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+    }
+
+    /// Returns an upper bound of the `q` quantile, `q` in `[0, 1]`.
+    ///
+    /// It's exact within a factor of 2 and never exceeds `max`.
+    std::uint64_t percentile(double q) const noexcept;
+};
+
+std::ostream& operator<<(std::ostream& os, const HistogramSnapshot& hist);
+
+/// Histogram
+///
+/// A histogram of unsigned values, such as durations in nanoseconds or
+/// batch sizes, with power of 2 buckets.
+///
+/// Recording costs a few relaxed stores and must only be done by one thread
+/// at a time, while snapshots may be taken from any thread.
+class Histogram {
+public:
+    Histogram() noexcept = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    /// Records `value`
+    void record(std::uint64_t value) noexcept {
+        bump(buckets_[bucket_of(value)], 1);
+        bump(count_, 1);
+        bump(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /// Records a duration in nanoseconds, negative ones count as 0
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> d) noexcept {
+        const auto ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+    }
+
+    HistogramSnapshot snapshot() const noexcept;
+
+    /// Returns the bucket in which `value` is counted
+    static std::size_t bucket_of(std::uint64_t value) noexcept {
+        if (value == 0) {
+            return 0;
+        }
+        const std::size_t bits = 64 - __builtin_clzll(value);
+        return bits < 63 ? bits : 63;
+    }
+
+private:
+    // a single writer doesn't need read-modify-write instructions
+    static void bump(std::atomic<std::uint64_t>& counter,
+                     std::uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, 64> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+} // namespace bipolar
+
+#endif
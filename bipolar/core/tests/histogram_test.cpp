@@ -0,0 +1,38 @@
+#include <cstdint>
+
+#include "bipolar/core/histogram.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::literals;
+
+TEST(Histogram, buckets) {
+    EXPECT_EQ(Histogram::bucket_of(0), 0);
+    EXPECT_EQ(Histogram::bucket_of(1), 1);
+    EXPECT_EQ(Histogram::bucket_of(2), 2);
+    EXPECT_EQ(Histogram::bucket_of(3), 2);
+    EXPECT_EQ(Histogram::bucket_of(1024), 11);
+    EXPECT_EQ(Histogram::bucket_of(UINT64_MAX), 63);
+}
+
+TEST(Histogram, percentile) {
+    Histogram hist;
+    EXPECT_EQ(hist.snapshot().percentile(0.5), 0);
+
+    for (int i = 0; i < 99; ++i) {
+        hist.record(100);
+    }
+    hist.record(5us);
+
+    const auto snapshot = hist.snapshot();
+    EXPECT_EQ(snapshot.count, 100);
+    EXPECT_EQ(snapshot.max, 5000);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), (99 * 100 + 5000) / 100.0);
+
+    // within a factor of 2 and bounded by the max
+    EXPECT_EQ(snapshot.percentile(0.5), 127);
+    EXPECT_EQ(snapshot.percentile(0.99), 127);
+    EXPECT_EQ(snapshot.percentile(0.999), 5000);
+    EXPECT_EQ(snapshot.percentile(1.0), 5000);
+}
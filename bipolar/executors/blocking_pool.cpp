@@ -0,0 +1,119 @@
+#include "bipolar/executors/blocking_pool.hpp"
+
+#include <cassert>
+
+namespace bipolar {
+BlockingPool::BlockingPool(std::size_t max_threads, std::size_t max_queued,
+                           std::chrono::milliseconds keep_alive)
+    : max_threads_(max_threads), max_queued_(max_queued),
+      keep_alive_(keep_alive), slots_(max_queued) {
+    assert(max_threads_ >= 1);
+    assert(max_queued_ >= 1);
+}
+
+BlockingPool::~BlockingPool() {
+    std::list<std::thread> threads;
+    {
+        std::lock_guard lock(mtx_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    // the threads drain the queue before exiting
+    while (true) {
+        {
+            std::lock_guard lock(mtx_);
+            if (threads_.empty()) {
+                break;
+            }
+            threads.splice(threads.end(), threads_);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        threads.clear();
+    }
+    reap();
+}
+
+std::size_t BlockingPool::threads() const {
+    std::lock_guard lock(mtx_);
+    return threads_.size();
+}
+
+std::size_t BlockingPool::idle_threads() const {
+    std::lock_guard lock(mtx_);
+    return idle_;
+}
+
+std::size_t BlockingPool::queued() const {
+    std::lock_guard lock(mtx_);
+    return queue_.size();
+}
+
+void BlockingPool::submit(std::shared_ptr<internal::BlockingJobBase> job,
+                          SemaphorePermit slot) {
+    reap();
+
+    {
+        std::lock_guard lock(mtx_);
+        assert(!stopping_);
+        queue_.push_back(Entry{std::move(job), std::move(slot)});
+        if (idle_ < queue_.size() && threads_.size() < max_threads_) {
+            threads_.emplace_front();
+            // the thread finds its own handle to hand it over when exiting
+            threads_.front() =
+                std::thread([this, self = threads_.begin()] { work(self); });
+        }
+    }
+
+    wake_.notify_one();
+}
+
+void BlockingPool::work(std::list<std::thread>::iterator self) {
+    std::unique_lock lock(mtx_);
+    while (true) {
+        if (queue_.empty()) {
+            if (stopping_) {
+                // joined by the destructor
+                return;
+            }
+
+            ++idle_;
+            const bool timeout =
+                wake_.wait_for(lock, keep_alive_) == std::cv_status::timeout;
+            --idle_;
+            if (timeout && queue_.empty() && !stopping_) {
+                // joined by the next `submit()`
+                exited_.push_back(std::move(*self));
+                threads_.erase(self);
+                return;
+            }
+            continue;
+        }
+
+        Entry entry = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        // makes room for a waiting promise
+        entry.slot.release();
+        entry.job->run();
+        entry.job.reset();
+
+        lock.lock();
+    }
+}
+
+void BlockingPool::reap() {
+    std::vector<std::thread> exited;
+    {
+        std::lock_guard lock(mtx_);
+        exited.swap(exited_);
+    }
+    for (auto& t : exited) {
+        t.join();
+    }
+}
+
+} // namespace bipolar
@@ -0,0 +1,209 @@
+//! BlockingPool
+//!
+//! See `BlockingPool` for details
+//!
+
+#ifndef BIPOLAR_EXECUTORS_BLOCKING_POOL_HPP_
+#define BIPOLAR_EXECUTORS_BLOCKING_POOL_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/async/semaphore.hpp"
+#include "bipolar/core/function.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/internal/park_lock.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+
+namespace bipolar {
+namespace internal {
+// A function run by a `BlockingPool`
+class BlockingJobBase : public boost::noncopyable {
+public:
+    virtual ~BlockingJobBase() = default;
+
+    virtual void run() = 0;
+};
+
+// A function run by a `BlockingPool` along with its result, shared by the
+// pool and the promise waiting for it
+template <typename T, typename E>
+class BlockingJob final : public BlockingJobBase {
+public:
+    template <typename F>
+    explicit BlockingJob(F&& fn) : fn_(std::forward<F>(fn)) {}
+
+    void run() override {
+        auto result = fn_();
+        fn_ = nullptr;
+
+        SuspendedTask waiter;
+        {
+            std::lock_guard lock(mtx_);
+            result_ = std::move(result);
+            done_ = true;
+            waiter = std::move(waiter_);
+        }
+        waiter.resume_task();
+    }
+
+    Result<T, E> poll(Context& ctx) {
+        ParkLock lock(ctx, mtx_);
+        if (done_) {
+            return std::move(result_);
+        }
+        lock.park(waiter_);
+        return Pending{};
+    }
+
+private:
+    Function<Result<T, E>()> fn_;
+
+    std::mutex mtx_;
+    bool done_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    Result<T, E> result_ BIPOLAR_GUARDED_BY(mtx_);
+    SuspendedTask waiter_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+} // namespace internal
+
+/// BlockingPool
+///
+/// Runs blocking functions (`fsync`, compression, name resolution...) on
+/// helper threads, so that the tasks waiting for them only suspend instead
+/// of stalling their executor.
+///
+/// The pool is elastic: a thread is started when a function is queued
+/// while no thread is idle, up to `max_threads`, and an idle thread exits
+/// after `keep_alive`. At most `max_queued` functions wait for a thread,
+/// the promises spawning more wait for room in the queue, in FIFO order.
+///
+/// All methods are thread-safe. The pool must outlive the promises
+/// returned by `spawn_blocking()`; when destroyed, it runs the queued
+/// functions and waits for its threads.
+///
+/// # Examples
+///
+/// ```
+/// BlockingPool pool;
+///
+/// executor.schedule_task(PendingTask(
+///     pool.spawn_blocking([fd]() -> Result<Void, int> {
+///             if (::fsync(fd) < 0) {
+///                 return Err(errno);
+///             }
+///             return Ok(Void{});
+///         })
+///         .and_then([](const Void&) {
+///             // durable
+///             return Ok(Void{});
+///         })));
+/// ```
+class BlockingPool final : public boost::noncopyable {
+public:
+    static constexpr std::size_t kDefaultMaxThreads = 64;
+    static constexpr std::size_t kDefaultMaxQueued = 1024;
+    static constexpr std::chrono::milliseconds kDefaultKeepAlive{10000};
+
+    /// Constructs a pool without threads.
+    ///
+    /// Preconditions:
+    /// - `max_threads` and `max_queued` must be at least 1
+    explicit BlockingPool(
+        std::size_t max_threads = kDefaultMaxThreads,
+        std::size_t max_queued = kDefaultMaxQueued,
+        std::chrono::milliseconds keep_alive = kDefaultKeepAlive);
+
+    /// Runs the queued functions, then waits for the threads to exit
+    ~BlockingPool();
+
+    /// Returns an unboxed promise which runs `fn` on a thread of the pool
+    /// and produces its result, `fn` returning a `Result<T, E>`.
+    ///
+    /// `fn` is queued once the promise is polled and there's room in the
+    /// queue. Once queued, it runs even if the promise is dropped.
+    template <typename F>
+    auto spawn_blocking(F fn) {
+        using result_type = std::invoke_result_t<F&>;
+        static_assert(detail::is_result_v<result_type>,
+                      "The function must return a Result");
+        using Job = internal::BlockingJob<typename result_type::value_type,
+                                          typename result_type::error_type>;
+
+        return slots_.acquire().then(
+            [this, fn = std::move(fn)](
+                Result<SemaphorePermit, Void>& permit) mutable {
+                auto job = std::make_shared<Job>(std::move(fn));
+                submit(job, std::move(permit.value()));
+                return make_promise(
+                    [job = std::move(job)](Context& ctx) mutable {
+                        return job->poll(ctx);
+                    });
+            });
+    }
+
+    /// Returns the maximum number of threads
+    std::size_t max_threads() const noexcept {
+        return max_threads_;
+    }
+
+    /// Returns the maximum number of functions waiting for a thread
+    std::size_t max_queued() const noexcept {
+        return max_queued_;
+    }
+
+    /// Returns the number of threads
+    std::size_t threads() const;
+
+    /// Returns the number of threads waiting for a function
+    std::size_t idle_threads() const;
+
+    /// Returns the number of functions waiting for a thread
+    std::size_t queued() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<internal::BlockingJobBase> job;
+        // leaves the queue along with the job
+        SemaphorePermit slot;
+    };
+
+    void submit(std::shared_ptr<internal::BlockingJobBase> job,
+                SemaphorePermit slot);
+
+    void work(std::list<std::thread>::iterator self);
+
+    // Joins the threads which exited, without holding the lock
+    void reap();
+
+    const std::size_t max_threads_;
+    const std::size_t max_queued_;
+    const std::chrono::milliseconds keep_alive_;
+    AsyncSemaphore slots_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable wake_;
+    std::deque<Entry> queue_ BIPOLAR_GUARDED_BY(mtx_);
+    std::list<std::thread> threads_ BIPOLAR_GUARDED_BY(mtx_);
+    std::vector<std::thread> exited_ BIPOLAR_GUARDED_BY(mtx_);
+    std::size_t idle_ BIPOLAR_GUARDED_BY(mtx_) = 0;
+    bool stopping_ BIPOLAR_GUARDED_BY(mtx_) = false;
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,160 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bipolar/executors/blocking_pool.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::literals;
+
+TEST(BlockingPool, spawn_blocking) {
+    BlockingPool pool;
+    SingleThreadedExecutor executor;
+    const auto caller = std::this_thread::get_id();
+
+    Option<std::string> value;
+    Option<int> error;
+    executor.schedule_task(PendingTask(
+        pool.spawn_blocking([caller]() -> Result<std::string, int> {
+                EXPECT_NE(std::this_thread::get_id(), caller);
+                std::this_thread::sleep_for(10ms);
+                return Ok("done"s);
+            })
+            .and_then([&](std::string& s) {
+                value.emplace(std::move(s));
+                return Ok(Void{});
+            })));
+    executor.schedule_task(PendingTask(
+        pool.spawn_blocking([]() -> Result<Void, int> { return Err(5); })
+            .or_else([&](const int& e) {
+                error.emplace(e);
+                return Ok(Void{});
+            })));
+
+    // the executor keeps running other tasks meanwhile
+    bool ran = false;
+    executor.schedule_task(PendingTask(make_promise([&] {
+        ran = true;
+        return Ok(Void{});
+    })));
+    executor.run();
+
+    EXPECT_TRUE(ran);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(value.value(), "done");
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error.value(), 5);
+    EXPECT_GE(pool.threads(), 1);
+    EXPECT_EQ(pool.queued(), 0);
+}
+
+TEST(BlockingPool, limits) {
+    BlockingPool pool(2, 3);
+    EXPECT_EQ(pool.max_threads(), 2);
+    EXPECT_EQ(pool.max_queued(), 3);
+
+    SingleThreadedExecutor executor;
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    std::atomic<bool> release{false};
+    int completed = 0;
+
+    for (int i = 0; i < 10; ++i) {
+        executor.schedule_task(PendingTask(
+            pool.spawn_blocking([&]() -> Result<int, Void> {
+                    const int n = running.fetch_add(1) + 1;
+                    int max = max_running.load();
+                    while (n > max &&
+                           !max_running.compare_exchange_weak(max, n)) {
+                    }
+                    while (!release.load()) {
+                        std::this_thread::yield();
+                    }
+                    running.fetch_sub(1);
+                    return Ok(1);
+                })
+                .and_then([&](const int& n) {
+                    completed += n;
+                    return Ok(Void{});
+                })));
+    }
+
+    // 2 running, 3 queued, the others wait for room; the waiting promises
+    // are resumed as the threads dequeue
+    while (running.load() < 2 || pool.queued() < 3) {
+        executor.run_until_idle();
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(pool.threads(), 2);
+    EXPECT_EQ(pool.queued(), 3);
+
+    release.store(true);
+    executor.run();
+
+    EXPECT_EQ(completed, 10);
+    EXPECT_EQ(max_running.load(), 2);
+    EXPECT_EQ(pool.queued(), 0);
+}
+
+TEST(BlockingPool, idle_threads_exit) {
+    BlockingPool pool(4, 16, 20ms);
+    SingleThreadedExecutor executor;
+
+    for (int i = 0; i < 4; ++i) {
+        executor.schedule_task(PendingTask(
+            pool.spawn_blocking([]() -> Result<Void, Void> {
+                std::this_thread::sleep_for(5ms);
+                return Ok(Void{});
+            })));
+    }
+    executor.run();
+    EXPECT_GE(pool.threads(), 1);
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (pool.threads() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    EXPECT_EQ(pool.threads(), 0);
+    EXPECT_EQ(pool.idle_threads(), 0);
+
+    // and are started again
+    bool done = false;
+    executor.schedule_task(PendingTask(
+        pool.spawn_blocking([]() -> Result<int, Void> { return Ok(7); })
+            .and_then([&](const int& n) {
+                done = n == 7;
+                return Ok(Void{});
+            })));
+    executor.run();
+    EXPECT_TRUE(done);
+}
+
+TEST(BlockingPool, dropped_promises) {
+    std::atomic<int> ran{0};
+    {
+        BlockingPool pool(1, 8);
+        SingleThreadedExecutor executor;
+        for (int i = 0; i < 4; ++i) {
+            auto p = pool.spawn_blocking([&]() -> Result<Void, Void> {
+                ran.fetch_add(1);
+                return Ok(Void{});
+            });
+            // queued once polled, then dropped
+            executor.schedule_task(PendingTask(make_promise(
+                [p = std::move(p)](Context& ctx) mutable
+                -> Result<Void, Void> {
+                    p(ctx);
+                    return Ok(Void{});
+                })));
+        }
+        executor.run();
+    }
+
+    // the pool ran the queued functions before being destroyed
+    EXPECT_EQ(ran.load(), 4);
+}
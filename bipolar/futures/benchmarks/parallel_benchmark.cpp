@@ -0,0 +1,98 @@
+#include "bipolar/futures/parallel.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bipolar;
+
+namespace {
+constexpr std::size_t kItems = 1 << 20;
+
+// Runs `promise` to completion on the calling thread
+template <typename Promise>
+void block_on(Promise promise) {
+    SingleThreadedExecutor executor;
+    executor.schedule_task(PendingTask(std::move(promise)));
+    executor.run();
+}
+
+// Registers 1, 2, 4... up to the number of cores
+void thread_counts(benchmark::internal::Benchmark* b) {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned n = 1; n < cores; n *= 2) {
+        b->Arg(n);
+    }
+    b->Arg(cores);
+}
+
+} // namespace
+
+// Uneven work per item, like decoding records of various sizes
+static void BM_ParallelFor(benchmark::State& state) {
+    ThreadPoolExecutor pool(state.range(0));
+    std::vector<double> out(kItems);
+
+    for (auto _ : state) {
+        block_on(parallel_for(&pool, 0, kItems, [&](std::size_t i) {
+            double x = i;
+            for (std::size_t k = 0; k < i % 64; ++k) {
+                x = std::sqrt(x + k);
+            }
+            out[i] = x;
+        }, 256));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_ParallelFor)->Apply(thread_counts)->UseRealTime();
+
+static void BM_ParallelMapReduce(benchmark::State& state) {
+    ThreadPoolExecutor pool(state.range(0));
+    std::vector<std::uint32_t> in(kItems);
+    std::mt19937 gen(42);
+    for (auto& x : in) {
+        x = gen();
+    }
+
+    for (auto _ : state) {
+        block_on(parallel_map_reduce(
+                     &pool, 0, kItems, std::uint64_t(0),
+                     [&](std::size_t i) {
+                         return std::uint64_t(__builtin_popcount(in[i]));
+                     },
+                     [](std::uint64_t a, std::uint64_t b) { return a + b; },
+                     4096)
+                     .and_then([](std::uint64_t& sum) {
+                         benchmark::DoNotOptimize(sum);
+                         return Ok(Void{});
+                     }));
+    }
+    state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_ParallelMapReduce)->Apply(thread_counts)->UseRealTime();
+
+static void BM_ParallelSort(benchmark::State& state) {
+    ThreadPoolExecutor pool(state.range(0));
+    std::vector<std::uint32_t> in(kItems);
+    std::mt19937 gen(42);
+    for (auto& x : in) {
+        x = gen();
+    }
+
+    std::vector<std::uint32_t> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = in;
+        state.ResumeTiming();
+
+        block_on(parallel_sort(&pool, v.begin(), v.end()));
+    }
+    state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_ParallelSort)->Apply(thread_counts)->UseRealTime();
@@ -44,10 +44,19 @@ public:
     virtual SuspendedTask suspend_task() = 0;
 
     /// Converts this `Context` to a derived context type.
+    ///
+    /// A context wrapping the one of the executor, such as the one a join
+    /// passes to each of its promises, converts the context it wraps.
     template <typename Derived,
               std::enable_if_t<std::is_base_of_v<Context, Derived>, int> = 0>
     Derived& as() & {
-        return static_cast<Derived&>(*this);
+        return static_cast<Derived&>(executor_context());
+    }
+
+    /// Returns the context provided by the executor, which is this one
+    /// unless it wraps another context.
+    virtual Context& executor_context() noexcept {
+        return *this;
     }
 
 protected:
@@ -0,0 +1,22 @@
+#include "bipolar/futures/executor_metrics.hpp"
+
+namespace bipolar {
+std::ostream& operator<<(std::ostream& os,
+                         const ExecutorMetricsSnapshot& snapshot) {
+    os << "runnable=" << snapshot.runnable_tasks
+       << " suspended=" << snapshot.suspended_tasks
+       << " tickets=" << snapshot.outstanding_tickets;
+    if (!snapshot.enabled) {
+        return os;
+    }
+
+    return os << " scheduled=" << snapshot.scheduled
+              << " polls=" << snapshot.polls
+              << " completed=" << snapshot.completed
+              << " wakes=" << snapshot.wakes
+              << " abandoned=" << snapshot.abandoned << "\n"
+              << "poll_latency_ns: " << snapshot.poll_latency << "\n"
+              << "schedule_delay_ns: " << snapshot.schedule_delay;
+}
+
+} // namespace bipolar
@@ -0,0 +1,153 @@
+//! Executor metrics
+//!
+//! - `LatencyHistogram`
+//! - `ExecutorMetrics`
+//! - `ExecutorMetricsSnapshot`
+//!
+//! The instrumentation of executors is compiled in only if
+//! `BIPOLAR_FUTURES_METRICS` is defined, e.g. by building with
+//! `--define bipolar_futures_metrics=true`. Otherwise recording compiles to
+//! nothing and snapshots only carry the queue gauges.
+//!
+
+#ifndef BIPOLAR_FUTURES_EXECUTOR_METRICS_HPP_
+#define BIPOLAR_FUTURES_EXECUTOR_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/core/histogram.hpp"
+#include "bipolar/futures/pending_task.hpp"
+
+namespace bipolar {
+/// LatencyHistogram
+///
+/// A `Histogram` of durations in nanoseconds
+using LatencyHistogram = Histogram;
+
+/// ExecutorMetricsSnapshot
+///
+/// The state of an executor at some point in time, see
+/// `SingleThreadedExecutor::metrics()`.
+struct ExecutorMetricsSnapshot {
+    /// False if the instrumentation is compiled out, only the gauges are
+    /// filled then
+    bool enabled = false;
+
+    /// Gauges
+    std::size_t runnable_tasks = 0;
+    std::size_t suspended_tasks = 0;
+    std::size_t outstanding_tickets = 0;
+
+    /// Counters since the executor was created
+    std::uint64_t scheduled = 0;
+    std::uint64_t polls = 0;
+    std::uint64_t completed = 0;
+    std::uint64_t wakes = 0;
+    std::uint64_t abandoned = 0;
+
+    /// How long a task runs per poll
+    HistogramSnapshot poll_latency;
+    /// How long a task waits between becoming runnable and being polled
+    HistogramSnapshot schedule_delay;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const ExecutorMetricsSnapshot& snapshot);
+
+/// ExecutorMetrics
+///
+/// The instrumentation points of an executor. Every method is a no-op
+/// unless `BIPOLAR_FUTURES_METRICS` is defined, in which case the object
+/// also holds the counters and histograms.
+///
+/// `on_poll()` must only be called by the thread running the tasks, the
+/// other methods by any thread.
+class ExecutorMetrics final : public boost::noncopyable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+#ifdef BIPOLAR_FUTURES_METRICS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    /// Returns the current time, or the epoch if disabled
+    static Clock::time_point now() noexcept {
+#ifdef BIPOLAR_FUTURES_METRICS
+        return Clock::now();
+#else
+        return Clock::time_point();
+#endif
+    }
+
+    void on_schedule() noexcept {
+#ifdef BIPOLAR_FUTURES_METRICS
+        scheduled_.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    void on_wake() noexcept {
+#ifdef BIPOLAR_FUTURES_METRICS
+        wakes_.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    void on_abandon() noexcept {
+#ifdef BIPOLAR_FUTURES_METRICS
+        abandoned_.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    /// Records a poll of `task` which started at `start`
+    void on_poll([[maybe_unused]] const PendingTask& task,
+                 [[maybe_unused]] Clock::time_point start,
+                 [[maybe_unused]] bool finished) noexcept {
+#ifdef BIPOLAR_FUTURES_METRICS
+        const auto end = Clock::now();
+        poll_latency_.record(end - start);
+        schedule_delay_.record(start - task.runnable_since());
+        polls_.fetch_add(1, std::memory_order_relaxed);
+        if (finished) {
+            completed_.fetch_add(1, std::memory_order_relaxed);
+        }
+#endif
+    }
+
+    /// Fills the counters and histograms of `snapshot`
+    void fill([[maybe_unused]] ExecutorMetricsSnapshot* snapshot) const
+        noexcept {
+#ifdef BIPOLAR_FUTURES_METRICS
+        snapshot->enabled = true;
+        snapshot->scheduled = scheduled_.load(std::memory_order_relaxed);
+        snapshot->polls = polls_.load(std::memory_order_relaxed);
+        snapshot->completed = completed_.load(std::memory_order_relaxed);
+        snapshot->wakes = wakes_.load(std::memory_order_relaxed);
+        snapshot->abandoned = abandoned_.load(std::memory_order_relaxed);
+        snapshot->poll_latency = poll_latency_.snapshot();
+        snapshot->schedule_delay = schedule_delay_.snapshot();
+#endif
+    }
+
+private:
+#ifdef BIPOLAR_FUTURES_METRICS
+    std::atomic<std::uint64_t> scheduled_{0};
+    std::atomic<std::uint64_t> polls_{0};
+    std::atomic<std::uint64_t> completed_{0};
+    std::atomic<std::uint64_t> wakes_{0};
+    std::atomic<std::uint64_t> abandoned_{0};
+    LatencyHistogram poll_latency_;
+    LatencyHistogram schedule_delay_;
+#endif
+};
+
+} // namespace bipolar
+
+#endif
@@ -1,17 +1,20 @@
 #ifndef BIPOLAR_FUTURES_ADAPTOR_HPP_
 #define BIPOLAR_FUTURES_ADAPTOR_HPP_
 
-#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "bipolar/core/movable.hpp"
 #include "bipolar/core/option.hpp"
 #include "bipolar/core/result.hpp"
 #include "bipolar/core/void.hpp"
 #include "bipolar/futures/context.hpp"
+#include "bipolar/futures/internal/join_waker.hpp"
 #include "bipolar/futures/traits.hpp"
 
 #include <boost/callable_traits.hpp>
@@ -511,58 +514,125 @@ private:
 };
 
 // The continuation produced by `join_promises()`
+//
+// The first invocation polls every branch. Later invocations only poll the
+// branches which were resumed (or which didn't suspend), see `JoinWaker`.
 template <typename... Promises>
 class JoinContinuation {
 public:
-    constexpr JoinContinuation(Promises... promises)
-        : futures_(std::move(promises)...) {}
+    explicit JoinContinuation(Promises... promises)
+        : futures_(std::move(promises)...),
+          waker_(new JoinWaker(sizeof...(Promises))) {}
 
-    constexpr auto operator()(Context& ctx) {
+    auto operator()(Context& ctx) {
         return helper(ctx, std::index_sequence_for<Promises...>{});
     }
 
 private:
     template <std::size_t... Is>
-    constexpr auto helper(Context& ctx, std::index_sequence<Is...>)
+    auto helper(Context& ctx, std::index_sequence<Is...>)
         -> Result<std::tuple<typename Promises::result_type...>, Void> {
-        bool comps[] = {std::get<Is>(futures_)(ctx)...};
-        if (std::all_of(std::begin(comps), std::end(comps),
-                        [](bool b) { return b; })) {
+        if (!started_) {
+            started_ = true;
+            (poll<Is>(ctx), ...);
+        } else {
+            std::array<bool, sizeof...(Promises)> woken = {};
+            waker_->take_ready(&ready_);
+            for (std::size_t index : ready_) {
+                woken[index] = true;
+            }
+            ready_.clear();
+            ((woken[Is] ? poll<Is>(ctx) : void()), ...);
+        }
+
+        if (pending_ == 0) {
             return Ok(std::make_tuple(std::get<Is>(futures_).take_result()...));
         }
+        waker_->park(ctx);
         return Pending{};
     }
 
+    template <std::size_t I>
+    void poll(Context& ctx) {
+        auto& future = std::get<I>(futures_);
+        if (future.is_ready()) {
+            return;
+        }
+
+        JoinContext branch_ctx(ctx, *waker_, I);
+        if (future(branch_ctx)) {
+            --pending_;
+        } else if (!branch_ctx.suspended()) {
+            waker_->requeue(I);
+        }
+    }
+
 private:
     std::tuple<FutureImpl<Promises>...> futures_;
+    std::unique_ptr<JoinWaker, JoinWaker::Releaser> waker_;
+    std::vector<std::size_t> ready_;
+    std::size_t pending_ = sizeof...(Promises);
+    bool started_ = false;
 };
 
 // The continuation produced by `join_promise_vector()`
+//
+// The first invocation polls every branch. Later invocations only poll the
+// branches which were resumed (or which didn't suspend), see `JoinWaker`.
+// Completion is tracked by counting the pending branches so joining N branches
+// which complete one at a time costs O(N) polls instead of O(N^2).
 template <typename Promise>
 class JoinVectorContinuation {
 public:
-    constexpr explicit JoinVectorContinuation(std::vector<Promise> promises)
-        : promises_(std::move(promises)), results_(promises_.size()) {}
+    explicit JoinVectorContinuation(std::vector<Promise> promises)
+        : promises_(std::move(promises)), results_(promises_.size()),
+          waker_(new JoinWaker(promises_.size())), pending_(promises_.size()) {}
 
-    constexpr auto operator()(Context& ctx)
+    auto operator()(Context& ctx)
         -> Result<std::vector<typename Promise::result_type>, Void> {
-        bool done = true;
-        for (std::size_t i = 0; i < promises_.size(); ++i) {
-            if (!results_[i]) {
-                results_[i] = promises_[i](ctx);
-                done &= static_cast<bool>(results_[i]);
+        if (!started_) {
+            started_ = true;
+            for (std::size_t i = 0; i < promises_.size(); ++i) {
+                poll(ctx, i);
+            }
+        } else {
+            waker_->take_ready(&ready_);
+            for (std::size_t index : ready_) {
+                poll(ctx, index);
             }
+            ready_.clear();
         }
 
-        if (done) {
+        if (pending_ == 0) {
             return Ok(std::move(results_));
         }
+        waker_->park(ctx);
         return Pending{};
     }
 
+private:
+    void poll(Context& ctx, std::size_t index) {
+        if (results_[index]) {
+            // a stale ticket of a completed branch
+            return;
+        }
+
+        JoinContext branch_ctx(ctx, *waker_, index);
+        results_[index] = promises_[index](branch_ctx);
+        if (results_[index]) {
+            --pending_;
+        } else if (!branch_ctx.suspended()) {
+            waker_->requeue(index);
+        }
+    }
+
 private:
     std::vector<Promise> promises_;
     std::vector<typename Promise::result_type> results_;
+    std::unique_ptr<JoinWaker, JoinWaker::Releaser> waker_;
+    std::vector<std::size_t> ready_;
+    std::size_t pending_;
+    bool started_ = false;
 };
 
 } // namespace internal
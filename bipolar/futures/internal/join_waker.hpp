@@ -0,0 +1,234 @@
+#ifndef BIPOLAR_FUTURES_INTERNAL_JOIN_WAKER_HPP_
+#define BIPOLAR_FUTURES_INTERNAL_JOIN_WAKER_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+
+namespace bipolar {
+namespace internal {
+// JoinWaker
+//
+// Tracks which branches of a join need to be polled again so that the join
+// does not re-poll every pending branch each time it runs.
+//
+// Each branch is polled with a `JoinContext` whose `suspend_task()` issues
+// a ticket carrying the index of the branch. Resuming such a ticket appends
+// the branch to the ready list and wakes the joining task through the one
+// `SuspendedTask` obtained from the joining task's own context by `park()`.
+//
+// A branch which is pending but holds no ticket (it never suspended, or all
+// of its tickets were released) is also put in the ready list, without waking
+// the joining task, so it's polled again whenever the join is. If no branch
+// holds a ticket and none was resumed, the joining task is not suspended at
+// all and gets abandoned like any task which cannot be resumed.
+//
+// The object is reference counted. The owning continuation holds one
+// reference and every outstanding ticket holds another one since tickets may
+// outlive the continuation and be resolved from any thread.
+class JoinWaker final : public SuspendedTask::Resolver {
+public:
+    // Releases the owner's reference
+    struct Releaser {
+        void operator()(JoinWaker* waker) const {
+            waker->release();
+        }
+    };
+
+    explicit JoinWaker(std::size_t n) : tickets_(n, 0), queued_(n, false) {}
+
+    JoinWaker(const JoinWaker&) = delete;
+    JoinWaker& operator=(const JoinWaker&) = delete;
+
+    // Issues a ticket for the branch `index`
+    SuspendedTask suspend(std::size_t index) {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(mtx_);
+            ++tickets_[index];
+            ++outstanding_;
+        }
+        return SuspendedTask(this, index);
+    }
+
+    // Puts the branch `index` in the ready list without waking the joining
+    // task. Used for pending branches that didn't suspend themselves.
+    void requeue(std::size_t index) {
+        std::lock_guard lock(mtx_);
+        enqueue(index);
+    }
+
+    // Moves the indices of the branches to poll into `ready`, in the order
+    // they became ready. Each index appears at most once.
+    void take_ready(std::vector<std::size_t>* ready) {
+        assert(ready && ready->empty());
+
+        std::lock_guard lock(mtx_);
+        ready_.swap(*ready);
+        for (std::size_t index : *ready) {
+            queued_[index] = false;
+        }
+        woken_ = false;
+    }
+
+    // Arranges for the joining task to be resumed once a branch is resumed.
+    //
+    // Must be called by the joining task before it returns `Pending`.
+    void park(Context& ctx) {
+        {
+            std::lock_guard lock(mtx_);
+            if (!woken_ && outstanding_ == 0) {
+                // nothing can wake us up
+                return;
+            }
+        }
+
+        // Obtained without holding the lock since the executor may take its
+        // own lock to issue the ticket
+        SuspendedTask task = ctx.suspend_task();
+        bool resume = false;
+        {
+            std::lock_guard lock(mtx_);
+            if (woken_) {
+                // some branch was resumed while we were polling others
+                resume = true;
+            } else if (outstanding_ > 0) {
+                std::swap(parent_, task);
+            } else {
+                // all tickets were released meanwhile, dropping `task`
+                // abandons the join
+            }
+        }
+
+        if (resume) {
+            task.resume_task();
+        }
+        // otherwise `task` is empty, abandoned, or a stale handle replaced
+        // by a fresher one and it's released here
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(mtx_);
+        ++tickets_[ticket];
+        ++outstanding_;
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket ticket,
+                        bool resume_task) override {
+        SuspendedTask parent;
+        {
+            std::lock_guard lock(mtx_);
+            assert(tickets_[ticket] > 0 && outstanding_ > 0);
+            --tickets_[ticket];
+            --outstanding_;
+            if (resume_task) {
+                enqueue(ticket);
+                woken_ = true;
+                parent = std::move(parent_);
+            } else {
+                if (tickets_[ticket] == 0) {
+                    enqueue(ticket);
+                }
+                if (outstanding_ == 0 && !woken_) {
+                    parent = std::move(parent_);
+                }
+            }
+        }
+
+        if (resume_task) {
+            parent.resume_task();
+        } else {
+            parent.reset();
+        }
+        unref();
+    }
+
+private:
+    ~JoinWaker() override = default;
+
+    void enqueue(std::size_t index) BIPOLAR_REQUIRES(mtx_) {
+        if (!queued_[index]) {
+            queued_[index] = true;
+            ready_.push_back(index);
+        }
+    }
+
+    void release() {
+        SuspendedTask parent;
+        {
+            std::lock_guard lock(mtx_);
+            parent = std::move(parent_);
+        }
+        parent.reset();
+        unref();
+    }
+
+    void unref() {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+private:
+    std::atomic<std::size_t> refs_{1};
+
+    std::mutex mtx_;
+    std::vector<std::uint32_t> tickets_ BIPOLAR_GUARDED_BY(mtx_);
+    std::size_t outstanding_ BIPOLAR_GUARDED_BY(mtx_) = 0;
+    std::vector<std::size_t> ready_ BIPOLAR_GUARDED_BY(mtx_);
+    std::vector<bool> queued_ BIPOLAR_GUARDED_BY(mtx_);
+    bool woken_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    SuspendedTask parent_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+// The context a join passes to each of its branches
+//
+// `Context::as()` converts the join's own context, so that branches still
+// reach the executor specific context. Tickets obtained from that context
+// resume the whole join rather than the branch.
+class JoinContext final : public Context {
+public:
+    JoinContext(Context& parent, JoinWaker& waker, std::size_t index) noexcept
+        : parent_(parent), waker_(waker), index_(index) {}
+
+    ~JoinContext() override = default;
+
+    Executor* get_executor() const override {
+        return parent_.get_executor();
+    }
+
+    SuspendedTask suspend_task() override {
+        ++suspend_count_;
+        return waker_.suspend(index_);
+    }
+
+    Context& executor_context() noexcept override {
+        return parent_.executor_context();
+    }
+
+    // Returns true if the branch obtained a ticket through this context
+    bool suspended() const noexcept {
+        return suspend_count_ > 0;
+    }
+
+private:
+    Context& parent_;
+    JoinWaker& waker_;
+    const std::size_t index_;
+    std::size_t suspend_count_ = 0;
+};
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
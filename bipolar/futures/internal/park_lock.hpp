@@ -0,0 +1,62 @@
+#ifndef BIPOLAR_FUTURES_INTERNAL_PARK_LOCK_HPP_
+#define BIPOLAR_FUTURES_INTERNAL_PARK_LOCK_HPP_
+
+#include <mutex>
+#include <utility>
+
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+
+namespace bipolar {
+namespace internal {
+// ParkLock
+//
+// Locks the mutex guarding where a task waits for some event, holding a
+// ticket of the task of `ctx`. The caller checks for the event under the
+// lock, then parks the task, resumes it, or lets it go.
+//
+// The ticket is obtained before locking since the executor may take its own
+// lock to issue it. The ticket left in the guard, either unused or replaced
+// by `park()`, is released after unlocking since its resolver may take the
+// mutex.
+class BIPOLAR_SCOPED_CAPABILITY ParkLock {
+public:
+    ParkLock(Context& ctx, std::mutex& mtx) BIPOLAR_ACQUIRE(mtx)
+        : task_(ctx.suspend_task()), lock_(mtx) {}
+
+    ParkLock(const ParkLock&) = delete;
+    ParkLock& operator=(const ParkLock&) = delete;
+
+    ~ParkLock() BIPOLAR_RELEASE() {
+        lock_.unlock();
+        if (resume_) {
+            task_.resume_task();
+        }
+    }
+
+    // Parks the task in `waiter`, whose previous ticket is released
+    void park(SuspendedTask& waiter) noexcept {
+        std::swap(waiter, task_);
+    }
+
+    // Takes the ticket of the task
+    SuspendedTask take() noexcept {
+        return std::move(task_);
+    }
+
+    // Resumes the task once unlocked, so that it's polled again
+    void resume() noexcept {
+        resume_ = true;
+    }
+
+private:
+    SuspendedTask task_;
+    std::unique_lock<std::mutex> lock_;
+    bool resume_ = false;
+};
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,419 @@
+//! Parallel algorithms
+//!
+//! - `parallel_for`
+//! - `parallel_map_reduce`
+//! - `parallel_sort`
+//!
+//! They return unboxed promises which, once polled, split the work into
+//! tasks scheduled on a `ThreadPoolExecutor`, and complete once those tasks
+//! are done. The promises may be polled by any executor, including the
+//! pool itself: they suspend their task instead of blocking.
+//!
+//! The work can't be cancelled: dropping the promise before completion
+//! leaves the tasks running, the functors must outlive them.
+//!
+
+#ifndef BIPOLAR_FUTURES_PARALLEL_HPP_
+#define BIPOLAR_FUTURES_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/internal/park_lock.hpp"
+#include "bipolar/futures/pending_task.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+#include "bipolar/futures/thread_pool_executor.hpp"
+
+namespace bipolar {
+namespace internal {
+// Counts the tasks of a parallel algorithm down, the last one resumes the
+// task waiting for them instead of having it polled again and again
+class ParallelJoin final : public boost::noncopyable {
+public:
+    explicit ParallelJoin(std::size_t count) noexcept : remaining_(count) {}
+
+    void arrive() {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            SuspendedTask waiter;
+            {
+                std::lock_guard lock(mtx_);
+                waiter = std::move(waiter_);
+            }
+            waiter.resume_task();
+        }
+    }
+
+    // Returns true once every task arrived
+    bool poll(Context& ctx) {
+        if (remaining_.load(std::memory_order_acquire) == 0) {
+            return true;
+        }
+
+        ParkLock lock(ctx, mtx_);
+        if (remaining_.load(std::memory_order_acquire) == 0) {
+            return true;
+        }
+        lock.park(waiter_);
+        return false;
+    }
+
+private:
+    std::atomic<std::size_t> remaining_;
+    std::mutex mtx_;
+    SuspendedTask waiter_;
+};
+
+// Hands out chunks of `[first, last)` with guided self-scheduling: a chunk
+// is a share of what remains, so the chunks get smaller towards the end and
+// the workers finish at about the same time even if the items don't cost
+// the same.
+class ChunkCursor final : public boost::noncopyable {
+public:
+    ChunkCursor(std::size_t first, std::size_t last, std::size_t grain,
+                std::size_t workers) noexcept
+        : next_(first), last_(last), grain_(std::max<std::size_t>(grain, 1)),
+          divisor_(2 * workers) {}
+
+    // Claims the next chunk, returns false once there's none
+    bool claim(std::size_t* begin, std::size_t* end) noexcept {
+        std::size_t cur = next_.load(std::memory_order_relaxed);
+        std::size_t n;
+        do {
+            if (cur >= last_) {
+                return false;
+            }
+            const std::size_t remaining = last_ - cur;
+            n = std::min(std::max(grain_, remaining / divisor_), remaining);
+        } while (!next_.compare_exchange_weak(cur, cur + n,
+                                              std::memory_order_relaxed));
+
+        *begin = cur;
+        *end = cur + n;
+        return true;
+    }
+
+    // Returns the number of workers worth running for `[first, last)`
+    static std::size_t workers(std::size_t first, std::size_t last,
+                               std::size_t grain, std::size_t threads) {
+        if (first >= last) {
+            return 0;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        return std::min(threads, (last - first + grain - 1) / grain);
+    }
+
+private:
+    std::atomic<std::size_t> next_;
+    const std::size_t last_;
+    const std::size_t grain_;
+    const std::size_t divisor_;
+};
+
+// The continuation of the parallel algorithms, starting `State` when first
+// polled.
+//
+// `State` provides `start()`, `join()` and `result()`.
+template <typename State>
+class ParallelContinuation {
+public:
+    explicit ParallelContinuation(std::shared_ptr<State> state) noexcept
+        : state_(std::move(state)) {}
+
+    auto operator()(Context& ctx) -> decltype(std::declval<State&>().result()) {
+        if (!started_) {
+            started_ = true;
+            state_->start(state_);
+        }
+        if (!state_->join().poll(ctx)) {
+            return Pending{};
+        }
+        return state_->result();
+    }
+
+private:
+    std::shared_ptr<State> state_;
+    bool started_ = false;
+};
+
+template <typename F>
+class ForState final : public boost::noncopyable {
+public:
+    ForState(ThreadPoolExecutor* pool, std::size_t first, std::size_t last,
+             F f, std::size_t grain)
+        : pool_(pool),
+          workers_(ChunkCursor::workers(first, last, grain,
+                                        pool->thread_count())),
+          cursor_(first, last, grain, workers_), join_(workers_),
+          f_(std::move(f)) {}
+
+    void start(const std::shared_ptr<ForState>& self) {
+        for (std::size_t i = 0; i < workers_; ++i) {
+            pool_->schedule_task(PendingTask(make_promise([self] {
+                self->work();
+                return Ok(Void{});
+            })));
+        }
+    }
+
+    ParallelJoin& join() noexcept {
+        return join_;
+    }
+
+    Result<Void, Void> result() {
+        return Ok(Void{});
+    }
+
+private:
+    void work() {
+        std::size_t begin, end;
+        while (cursor_.claim(&begin, &end)) {
+            for (std::size_t i = begin; i < end; ++i) {
+                f_(i);
+            }
+        }
+        join_.arrive();
+    }
+
+    ThreadPoolExecutor* const pool_;
+    const std::size_t workers_;
+    ChunkCursor cursor_;
+    ParallelJoin join_;
+    F f_;
+};
+
+template <typename T, typename Map, typename Reduce>
+class MapReduceState final : public boost::noncopyable {
+public:
+    MapReduceState(ThreadPoolExecutor* pool, std::size_t first,
+                   std::size_t last, T identity, Map map, Reduce reduce,
+                   std::size_t grain)
+        : pool_(pool),
+          workers_(ChunkCursor::workers(first, last, grain,
+                                        pool->thread_count())),
+          cursor_(first, last, grain, workers_), join_(workers_),
+          identity_(std::move(identity)), map_(std::move(map)),
+          reduce_(std::move(reduce)), partials_(workers_) {}
+
+    void start(const std::shared_ptr<MapReduceState>& self) {
+        for (std::size_t i = 0; i < workers_; ++i) {
+            pool_->schedule_task(PendingTask(make_promise([self, i] {
+                self->work(i);
+                return Ok(Void{});
+            })));
+        }
+    }
+
+    ParallelJoin& join() noexcept {
+        return join_;
+    }
+
+    Result<T, Void> result() {
+        T acc = identity_;
+        for (auto& partial : partials_) {
+            acc = reduce_(std::move(acc), std::move(partial.value()));
+        }
+        return Ok(std::move(acc));
+    }
+
+private:
+    void work(std::size_t worker) {
+        // accumulates in a local, the partials share cache lines
+        T acc = identity_;
+        std::size_t begin, end;
+        while (cursor_.claim(&begin, &end)) {
+            for (std::size_t i = begin; i < end; ++i) {
+                acc = reduce_(std::move(acc), map_(i));
+            }
+        }
+        partials_[worker].emplace(std::move(acc));
+        join_.arrive();
+    }
+
+    ThreadPoolExecutor* const pool_;
+    const std::size_t workers_;
+    ChunkCursor cursor_;
+    ParallelJoin join_;
+    const T identity_;
+    Map map_;
+    Reduce reduce_;
+    std::vector<Option<T>> partials_;
+};
+
+// Sorts blocks in parallel, then merges them pairwise in rounds. The last
+// task of a round schedules the next one.
+template <typename RandomIt, typename Compare>
+class SortState final : public boost::noncopyable {
+public:
+    // Below this, a block isn't worth a task
+    static constexpr std::size_t kMinBlockSize = 4096;
+
+    SortState(ThreadPoolExecutor* pool, RandomIt first, RandomIt last,
+              Compare comp)
+        : pool_(pool), first_(first), comp_(std::move(comp)), join_(1) {
+        const auto n = static_cast<std::size_t>(last - first);
+
+        // a power of 2 so that every round merges pairs
+        std::size_t blocks = 1;
+        while (blocks < pool->thread_count() &&
+               n / (blocks * 2) >= kMinBlockSize) {
+            blocks *= 2;
+        }
+        bounds_.resize(blocks + 1);
+        for (std::size_t i = 0; i <= blocks; ++i) {
+            bounds_[i] = n * i / blocks;
+        }
+    }
+
+    void start(const std::shared_ptr<SortState>& self) {
+        self_ = self;
+        const std::size_t blocks = bounds_.size() - 1;
+        pending_.store(blocks, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < blocks; ++i) {
+            schedule([this, i] {
+                std::sort(first_ + bounds_[i], first_ + bounds_[i + 1],
+                          comp_);
+            });
+        }
+    }
+
+    ParallelJoin& join() noexcept {
+        return join_;
+    }
+
+    Result<Void, Void> result() {
+        return Ok(Void{});
+    }
+
+private:
+    template <typename Step>
+    void schedule(Step step) {
+        pool_->schedule_task(
+            PendingTask(make_promise([self = self_, step = std::move(step)] {
+                step();
+                self->arrive();
+                return Ok(Void{});
+            })));
+    }
+
+    void arrive() {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        // merges twice as large runs, made of `width_` blocks each
+        const std::size_t blocks = bounds_.size() - 1;
+        if (width_ >= blocks) {
+            self_.reset();
+            join_.arrive();
+            return;
+        }
+
+        const std::size_t width = width_;
+        width_ *= 2;
+        pending_.store(blocks / width_, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < blocks; i += width_) {
+            schedule([this, i, width] {
+                std::inplace_merge(first_ + bounds_[i],
+                                   first_ + bounds_[i + width],
+                                   first_ + bounds_[i + 2 * width], comp_);
+            });
+        }
+    }
+
+    ThreadPoolExecutor* const pool_;
+    const RandomIt first_;
+    const Compare comp_;
+    std::vector<std::size_t> bounds_;
+    ParallelJoin join_;
+
+    // the tasks of the current round which haven't arrived yet
+    std::atomic<std::size_t> pending_{0};
+    // only touched by the last task of a round, before scheduling the next
+    std::size_t width_ = 1;
+    // released by the last round
+    std::shared_ptr<SortState> self_;
+};
+
+} // namespace internal
+
+/// Returns an unboxed promise which calls `f(i)` for each `i` in
+/// `[first, last)` on the workers of `pool`, completing once done.
+///
+/// The indices are split into chunks of at least `grain` indices, shrinking
+/// as the work runs out. `f` is called concurrently, so a mutable `f` must
+/// update its state safely.
+///
+/// # Examples
+///
+/// ```
+/// ThreadPoolExecutor pool;
+/// executor.schedule_task(PendingTask(
+///     parallel_for(&pool, 0, frames.size(),
+///                  [&](std::size_t i) { decode(frames[i]); })));
+/// ```
+template <typename F>
+auto parallel_for(ThreadPoolExecutor* pool, std::size_t first,
+                  std::size_t last, F f, std::size_t grain = 1) {
+    using State = internal::ForState<F>;
+    return PromiseImpl(internal::ParallelContinuation<State>(
+        std::make_shared<State>(pool, first, last, std::move(f), grain)));
+}
+
+/// Returns an unboxed promise which produces the reduction of `map(i)` for
+/// each `i` in `[first, last)`, computed on the workers of `pool`.
+///
+/// `reduce(T, T)` must be associative and commutative with `identity` as
+/// its identity element, since each worker reduces the chunks it claims
+/// before the partial results are reduced. `map` and `reduce` are called
+/// concurrently, so mutable ones must update their state safely.
+///
+/// # Examples
+///
+/// ```
+/// auto total = parallel_map_reduce(
+///     &pool, 0, rows.size(), std::uint64_t(0),
+///     [&](std::size_t i) { return rows[i].bytes; },
+///     [](std::uint64_t a, std::uint64_t b) { return a + b; });
+/// ```
+template <typename T, typename Map, typename Reduce>
+auto parallel_map_reduce(ThreadPoolExecutor* pool, std::size_t first,
+                         std::size_t last, T identity, Map map, Reduce reduce,
+                         std::size_t grain = 1) {
+    using State = internal::MapReduceState<T, Map, Reduce>;
+    return PromiseImpl(
+        internal::ParallelContinuation<State>(std::make_shared<State>(
+            pool, first, last, std::move(identity), std::move(map),
+            std::move(reduce), grain)));
+}
+
+/// Returns an unboxed promise which sorts `[first, last)` with `comp` on the
+/// workers of `pool`, not stable.
+///
+/// Blocks are sorted in parallel then merged pairwise, so the last merge
+/// runs on a single worker. The range must not be touched until the
+/// promise completes.
+template <typename RandomIt, typename Compare = std::less<>>
+auto parallel_sort(ThreadPoolExecutor* pool, RandomIt first, RandomIt last,
+                   Compare comp = Compare()) {
+    using State = internal::SortState<RandomIt, Compare>;
+    return PromiseImpl(internal::ParallelContinuation<State>(
+        std::make_shared<State>(pool, first, last, std::move(comp))));
+}
+
+} // namespace bipolar
+
+#endif
@@ -6,6 +6,7 @@
 #ifndef BIPOLAR_FUTURES_PENDING_TASK_HPP_
 #define BIPOLAR_FUTURES_PENDING_TASK_HPP_
 
+#include <chrono>
 #include <cstdint>
 #include <utility>
 
@@ -15,6 +16,17 @@
 #include "bipolar/futures/promise.hpp"
 
 namespace bipolar {
+/// TaskPriority
+///
+/// Selects the lane in which an executor queues a runnable task
+enum class TaskPriority : std::uint8_t {
+    /// For latency sensitive work such as request handling, runs first
+    NORMAL,
+    /// For throughput oriented work such as compaction, runs when the
+    /// normal lane leaves room for it but is never starved
+    BULK,
+};
+
 /// PendingTask
 ///
 /// A pending task holds a `Promise` that can be scheduled to run on an
@@ -26,6 +38,8 @@ namespace bipolar {
 /// combinator such as `then()` to capture it prior to wrapping the promise
 /// into a pending task.
 ///
+/// A pending task carries a `TaskPriority`, kept across suspensions.
+///
 /// See documentation of `Promise` for more information.
 class PendingTask final : public Movable {
 public:
@@ -37,14 +51,18 @@ public:
 
     /// Creates a pending task that wraps an already boxed promise that returns
     /// `AsyncResult<Void, Void>`
-    explicit PendingTask(promise_type p) noexcept : promise_(std::move(p)) {}
+    explicit PendingTask(promise_type p,
+                         TaskPriority priority = TaskPriority::NORMAL) noexcept
+        : promise_(std::move(p)), priority_(priority) {}
 
     /// Creates a pending task that wraps any kind of promise, boxed or unboxed,
     /// regardless of its result type and with any context that is assignable
     /// from this task's context type
     template <typename Continuation>
-    explicit PendingTask(PromiseImpl<Continuation> p) noexcept
-        : promise_(p ? p.discard_result().box() : promise_type{}) {}
+    explicit PendingTask(PromiseImpl<Continuation> p,
+                         TaskPriority priority = TaskPriority::NORMAL) noexcept
+        : promise_(p ? p.discard_result().box() : promise_type{}),
+          priority_(priority) {}
 
     PendingTask(PendingTask&&) noexcept = default;
     PendingTask& operator=(PendingTask&&) noexcept = default;
@@ -68,13 +86,33 @@ public:
         return !promise_(ctx).is_pending();
     }
 
+    /// Returns the priority of the task
+    TaskPriority priority() const noexcept {
+        return priority_;
+    }
+
     /// Extracts the pending task's promise
     promise_type take_promise() noexcept {
         return std::move(promise_);
     }
 
+#ifdef BIPOLAR_FUTURES_METRICS
+    /// Returns when the task last became runnable, set by `Scheduler`
+    std::chrono::steady_clock::time_point runnable_since() const noexcept {
+        return runnable_since_;
+    }
+
+    void set_runnable_since(std::chrono::steady_clock::time_point t) noexcept {
+        runnable_since_ = t;
+    }
+#endif
+
 private:
     promise_type promise_;
+    TaskPriority priority_ = TaskPriority::NORMAL;
+#ifdef BIPOLAR_FUTURES_METRICS
+    std::chrono::steady_clock::time_point runnable_since_;
+#endif
 };
 
 } // namespace bipolar
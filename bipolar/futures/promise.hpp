@@ -876,6 +876,14 @@ constexpr auto make_error_promise(const E& error) {
 /// Returns a promise that produces a `std::tuple` containing the result
 /// of each promise once they all complete.
 ///
+/// Each promise is given its own suspension ticket, so once the join has been
+/// suspended only the promises which were resumed are evaluated again.
+///
+/// NOTE: the joined promises receive a `Context` of their own, whose
+/// `get_executor()` and `as()` forward to the join's context. A promise which
+/// suspends through the context returned by `as()` gets a ticket resuming the
+/// whole join, which then evaluates that promise each time it's evaluated.
+///
 /// # Examples
 ///
 /// ```
@@ -906,6 +914,15 @@ constexpr auto join_promises(Promises... promises) {
 /// Returns a promise that produces a `std::vector` containing the result
 /// of each promise once the all complete.
 ///
+/// Each promise is given its own suspension ticket, so once the join has been
+/// suspended only the promises which were resumed are evaluated again. Joining
+/// N promises that complete one at a time costs O(N) evaluations.
+///
+/// NOTE: the joined promises receive a `Context` of their own, whose
+/// `get_executor()` and `as()` forward to the join's context. A promise which
+/// suspends through the context returned by `as()` gets a ticket resuming the
+/// whole join, which then evaluates that promise each time it's evaluated.
+///
 /// # Examples
 ///
 /// ```
@@ -1,12 +1,13 @@
 #include "bipolar/futures/scheduler.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
 namespace bipolar {
 void Scheduler::schedule_task(PendingTask task) {
     assert(task);
-    runnable_tasks_.push(std::move(task));
+    push_runnable(std::move(task));
 }
 
 SuspendedTask::Ticket Scheduler::obtain_ticket(std::uint32_t initial_refs) {
@@ -30,7 +31,7 @@ void Scheduler::finalize_ticket(SuspendedTask::Ticket ticket,
         // task already finished
     } else if (iter->second.was_resumed) {
         // task immediately became runnable
-        runnable_tasks_.push(std::move(*task));
+        push_runnable(std::move(*task));
     } else if (iter->second.ref_count > 0) {
         // task remains suspended
         iter->second.task = std::move(*task);
@@ -83,7 +84,7 @@ bool Scheduler::resume_task_with_ticket(SuspendedTask::Ticket ticket) {
             did_resume = true;
             assert(suspended_task_count_ > 0);
             --suspended_task_count_;
-            runnable_tasks_.push(std::move(iter->second.task));
+            push_runnable(std::move(iter->second.task));
         }
     }
 
@@ -96,12 +97,40 @@ bool Scheduler::resume_task_with_ticket(SuspendedTask::Ticket ticket) {
 void Scheduler::take_runnable_tasks(TaskQueue* tasks) {
     assert(tasks && tasks->empty());
     runnable_tasks_.swap(*tasks);
+    while (!bulk_tasks_.empty()) {
+        tasks->push(std::move(bulk_tasks_.front()));
+        bulk_tasks_.pop();
+    }
+}
+
+void Scheduler::take_runnable_tasks(TaskQueue* tasks, std::size_t max) {
+    assert(tasks && tasks->empty());
+    assert(max >= 1);
+
+    std::size_t normal = std::min(runnable_tasks_.size(), max);
+    if (normal == max && max > 1 && !bulk_tasks_.empty()) {
+        // leaves room for a bulk task
+        --normal;
+    }
+    if (normal == runnable_tasks_.size() && bulk_tasks_.empty()) {
+        runnable_tasks_.swap(*tasks);
+        return;
+    }
+
+    for (std::size_t i = 0; i < normal; ++i) {
+        tasks->push(std::move(runnable_tasks_.front()));
+        runnable_tasks_.pop();
+    }
+    while (tasks->size() < max && !bulk_tasks_.empty()) {
+        tasks->push(std::move(bulk_tasks_.front()));
+        bulk_tasks_.pop();
+    }
 }
 
 void Scheduler::take_all_tasks(TaskQueue* tasks) {
     assert(tasks && tasks->empty());
 
-    runnable_tasks_.swap(*tasks);
+    take_runnable_tasks(tasks);
     if (suspended_task_count_ > 0) {
         for (auto& item : tickets_) {
             assert(suspended_task_count_ > 0);
@@ -111,4 +140,15 @@ void Scheduler::take_all_tasks(TaskQueue* tasks) {
     }
 }
 
+void Scheduler::push_runnable(PendingTask task) {
+#ifdef BIPOLAR_FUTURES_METRICS
+    task.set_runnable_since(std::chrono::steady_clock::now());
+#endif
+    if (task.priority() == TaskPriority::BULK) {
+        bulk_tasks_.push(std::move(task));
+    } else {
+        runnable_tasks_.push(std::move(task));
+    }
+}
+
 } // namespace bipolar
@@ -5,6 +5,7 @@
 #ifndef BIPOLAR_FUTURES_SCHEDULER_HPP_
 #define BIPOLAR_FUTURES_SCHEDULER_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <queue>
@@ -22,6 +23,10 @@ namespace bipolar {
 /// This is low-level building block for implementing executors.
 /// For a concrete implementation, see `SingleThreadedExecutor`.
 ///
+/// Runnable tasks are queued in one lane per `TaskPriority`. Tasks of the
+/// normal lane are taken first but every batch taken leaves room for a bulk
+/// task, so that bulk tasks make progress under load.
+///
 /// Instance of this object are not thread-safe. Its client is responsible
 /// for providing all necessary synchronization.
 class Scheduler final : public boost::noncopyable {
@@ -31,7 +36,7 @@ public:
     Scheduler() = default;
     ~Scheduler() = default;
 
-    /// Adds a task to the runnable queue.
+    /// Adds a task to the runnable queue of its priority.
     ///
     /// Preconditions:
     /// - `task` must tbe non-empty
@@ -95,12 +100,20 @@ public:
     /// - the ticket's ref-count must be non-zero (positive)
     bool resume_task_with_ticket(SuspendedTask::Ticket ticket);
 
-    /// Takes all tasks in the runnable queue.
+    /// Takes all tasks in the runnable queues, normal ones first.
     ///
     /// Preconditions:
     /// - `tasks` must be non-null and empty
     void take_runnable_tasks(TaskQueue* tasks);
 
+    /// Takes at most `max` tasks in the runnable queues, normal ones first
+    /// but at least one bulk task if any and `max` is greater than 1.
+    ///
+    /// Preconditions:
+    /// - `tasks` must be non-null and empty
+    /// - `max` must be at least 1
+    void take_runnable_tasks(TaskQueue* tasks, std::size_t max);
+
     /// Takes all remaining tasks, regardless of whether they are runnable
     /// or suspended.
     ///
@@ -112,7 +125,12 @@ public:
 
     /// Returns true if there are any runnable tasks.
     bool has_runnable_tasks() const noexcept {
-        return !runnable_tasks_.empty();
+        return !runnable_tasks_.empty() || !bulk_tasks_.empty();
+    }
+
+    /// Returns the number of runnable tasks.
+    std::size_t runnable_task_count() const noexcept {
+        return runnable_tasks_.size() + bulk_tasks_.size();
     }
 
     /// Returns true if there are any suspended tasks that have yet to
@@ -126,7 +144,20 @@ public:
         return !tickets_.empty();
     }
 
+    /// Returns the number of suspended tasks that have yet to be resumed.
+    std::size_t suspended_task_count() const noexcept {
+        return suspended_task_count_;
+    }
+
+    /// Returns the number of tickets that have yet to be finalized.
+    std::size_t outstanding_ticket_count() const noexcept {
+        return tickets_.size();
+    }
+
 private:
+    // Queues `task` in the lane of its priority
+    void push_runnable(PendingTask task);
+
     struct TicketRecord {
         TicketRecord(std::uint32_t initial_refs) noexcept
             : ref_count(initial_refs), was_resumed(false) {}
@@ -145,6 +176,7 @@ private:
     };
 
     TaskQueue runnable_tasks_;
+    TaskQueue bulk_tasks_;
     std::map<SuspendedTask::Ticket, TicketRecord> tickets_;
     std::uint64_t suspended_task_count_ = 0;
     SuspendedTask::Ticket next_ticket_ = 1;
@@ -0,0 +1,355 @@
+//! SharedFuture
+//!
+//! See `SharedFuture` for details.
+//!
+
+#ifndef BIPOLAR_FUTURES_SHARED_FUTURE_HPP_
+#define BIPOLAR_FUTURES_SHARED_FUTURE_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/internal/park_lock.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+
+#include <boost/noncopyable.hpp>
+
+namespace bipolar {
+namespace internal {
+// The state shared by the copies of a `SharedFuture`.
+//
+// The consumer polling first drives the promise while the others park
+// their tasks. The promise is polled with a context of its own whose
+// tickets, once resumed, resume every parked consumer: whichever polls
+// first drives the promise next, so that a consumer going away doesn't
+// stall the others. A wakeup during a poll makes the driver resume itself
+// instead of polling again in place, leaving its executor a chance to run
+// other tasks.
+//
+// It's the resolver of the promise's tickets, which keep it alive.
+template <typename T, typename E>
+class SharedState final
+    : public SuspendedTask::Resolver,
+      public std::enable_shared_from_this<SharedState<T, E>>,
+      public boost::noncopyable {
+public:
+    using result_type = Result<T, E>;
+
+    explicit SharedState(Promise<T, E> promise) noexcept
+        : promise_(std::move(promise)) {}
+
+    bool is_ready() const noexcept {
+        return ready_.load(std::memory_order_acquire);
+    }
+
+    // Asserts that the result is ready
+    const result_type& result() const noexcept {
+        assert(is_ready());
+        return result_;
+    }
+
+    // Returns true if the result is ready, otherwise parks the task of `ctx`
+    bool poll(Context& ctx) {
+        if (is_ready()) {
+            return true;
+        }
+
+        // kept to be parked or resumed once the promise is polled
+        SuspendedTask task;
+        {
+            ParkLock lock(ctx, mtx_);
+            if (is_ready()) {
+                return true;
+            }
+            if (polling_ || parked_) {
+                waiters_.push_back(lock.take());
+                return false;
+            }
+            if (!promise_) {
+                // abandoned, the task is abandoned as well
+                return false;
+            }
+
+            polling_ = true;
+            notified_ = false;
+            task = lock.take();
+        }
+
+        // other consumers wait while the promise is polled without the lock
+        InnerContext inner(ctx.get_executor(), this);
+        result_type result = promise_(inner);
+
+        std::vector<SuspendedTask> waiters;
+        Promise<T, E> dropped;
+        bool resume = true;
+        {
+            std::lock_guard lock(mtx_);
+            if (!result.is_pending()) {
+                result_ = std::move(result);
+                dropped = std::move(promise_);
+                ready_.store(true, std::memory_order_release);
+                waiters.swap(waiters_);
+            } else if (notified_) {
+                // woken up while being polled, polls again along with the
+                // others
+                waiters.swap(waiters_);
+                waiters.push_back(std::move(task));
+            } else if (tickets_ == 0) {
+                // nothing can wake the promise up anymore, the waiters are
+                // abandoned
+                dropped = std::move(promise_);
+                waiters.swap(waiters_);
+                resume = false;
+            } else {
+                parked_ = true;
+                waiters_.push_back(std::move(task));
+            }
+            polling_ = false;
+        }
+
+        if (resume) {
+            for (auto& waiter : waiters) {
+                waiter.resume_task();
+            }
+        }
+        return is_ready();
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        std::lock_guard lock(mtx_);
+        ++tickets_;
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket, bool resume_task) override {
+        // released outside the lock, the last one may destroy `this`
+        std::shared_ptr<SharedState> self;
+        std::vector<SuspendedTask> waiters;
+        Promise<T, E> dropped;
+        {
+            std::lock_guard lock(mtx_);
+            if (resume_task) {
+                if (polling_) {
+                    notified_ = true;
+                } else {
+                    parked_ = false;
+                    waiters.swap(waiters_);
+                }
+            }
+
+            assert(tickets_ > 0);
+            if (--tickets_ == 0) {
+                self = std::move(self_);
+                if (!resume_task && parked_) {
+                    // nothing can wake the promise up anymore
+                    dropped = std::move(promise_);
+                    waiters.swap(waiters_);
+                }
+            }
+        }
+
+        if (resume_task) {
+            for (auto& waiter : waiters) {
+                waiter.resume_task();
+            }
+        }
+        waiters.clear();
+        dropped = nullptr;
+    }
+
+private:
+    // The context in which the promise runs
+    class InnerContext final : public Context {
+    public:
+        InnerContext(Executor* executor, SharedState* state) noexcept
+            : executor_(executor), state_(state) {}
+
+        Executor* get_executor() const override {
+            return executor_;
+        }
+
+        SuspendedTask suspend_task() override {
+            std::lock_guard lock(state_->mtx_);
+            if (state_->tickets_++ == 0) {
+                state_->self_ = state_->shared_from_this();
+            }
+            return SuspendedTask(state_, 0);
+        }
+
+    private:
+        Executor* const executor_;
+        SharedState* const state_;
+    };
+
+    std::atomic<bool> ready_{false};
+    // only touched by the consumer driving the promise, or once ready
+    Promise<T, E> promise_;
+    result_type result_;
+
+    std::mutex mtx_;
+    bool polling_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    bool notified_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    // pending until one of its tickets is resumed
+    bool parked_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    std::uint64_t tickets_ BIPOLAR_GUARDED_BY(mtx_) = 0;
+    std::shared_ptr<SharedState> self_ BIPOLAR_GUARDED_BY(mtx_);
+    std::vector<SuspendedTask> waiters_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+} // namespace internal
+
+/// SharedFuture
+///
+/// A copyable handle to the result of a promise which is evaluated only
+/// once, however many consumers wait for it.
+///
+/// Every copy is polled with `operator()` like a `Future`. The first
+/// consumer polling drives the promise while the others are suspended,
+/// they're all resumed once the result is ready and read it by const
+/// reference, without copies. Copies may be polled concurrently from
+/// different executors.
+///
+/// If the promise is abandoned (it returns pending without any way to be
+/// resumed), so are its consumers.
+///
+/// # Examples
+///
+/// ```
+/// SharedFuture<Config, int> config = make_shared_future(fetch_config());
+///
+/// for (auto& executor : executors) {
+///     executor.schedule_task(PendingTask(config.wait().and_then(
+///         [](const SharedFuture<Config, int>& config) -> Result<Void, Void> {
+///             if (config.is_ok()) {
+///                 use(config.value());
+///             }
+///             return Ok(Void{});
+///         })));
+/// }
+/// ```
+template <typename T = Void, typename E = Void>
+class SharedFuture final {
+    using State = internal::SharedState<T, E>;
+
+public:
+    /// The result type of the promise
+    using result_type = Result<T, E>;
+
+    /// The type of value produced when the promise completes successfully
+    using value_type = T;
+
+    /// The type of value produced when the promise completes with an error
+    using error_type = E;
+
+    /// Creates an empty shared future
+    SharedFuture() noexcept = default;
+    explicit SharedFuture(std::nullptr_t) noexcept : SharedFuture() {}
+
+    /// Creates a shared future evaluating `p`.
+    /// If the promise is empty, the shared future is empty.
+    template <typename Continuation>
+    explicit SharedFuture(PromiseImpl<Continuation> p)
+        : state_(p ? std::make_shared<State>(p.box()) : nullptr) {
+        static_assert(
+            std::is_same_v<typename PromiseImpl<Continuation>::result_type,
+                           result_type>,
+            "The promise must produce Result<T, E>");
+    }
+
+    SharedFuture(const SharedFuture&) = default;
+    SharedFuture(SharedFuture&&) noexcept = default;
+    SharedFuture& operator=(const SharedFuture&) = default;
+    SharedFuture& operator=(SharedFuture&&) noexcept = default;
+    ~SharedFuture() = default;
+
+    /// Returns true if the shared future isn't empty
+    explicit operator bool() const noexcept {
+        return static_cast<bool>(state_);
+    }
+
+    /// Returns true if the result is ready
+    bool is_ready() const noexcept {
+        return state_ && state_->is_ready();
+    }
+
+    /// Returns true if the promise completed successfully
+    bool is_ok() const noexcept {
+        return is_ready() && state_->result().is_ok();
+    }
+
+    /// Returns true if the promise completed with an error
+    bool is_error() const noexcept {
+        return is_ready() && state_->result().is_error();
+    }
+
+    /// Evaluates the shared future and returns true if its result is ready.
+    ///
+    /// Otherwise the task of `ctx` is suspended until the result is ready.
+    bool operator()(Context& ctx) {
+        return state_ && state_->poll(ctx);
+    }
+
+    /// Gets a reference to the result.
+    /// Asserts that the result is ready.
+    const result_type& result() const {
+        assert(is_ready());
+        return state_->result();
+    }
+
+    /// Gets a reference to the value.
+    /// Asserts that the promise completed successfully.
+    const value_type& value() const {
+        assert(is_ok());
+        return state_->result().value();
+    }
+
+    /// Gets a reference to the error.
+    /// Asserts that the promise completed with an error.
+    const error_type& error() const {
+        assert(is_error());
+        return state_->result().error();
+    }
+
+    /// Returns an unboxed promise which completes with a copy of this shared
+    /// future once its result is ready
+    auto wait() const {
+        return make_promise([self = *this](Context& ctx) mutable
+                            -> Result<SharedFuture, Void> {
+            if (self(ctx)) {
+                return Ok(self);
+            }
+            return Pending{};
+        });
+    }
+
+    void swap(SharedFuture& rhs) noexcept {
+        state_.swap(rhs.state_);
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+/// Makes a shared future evaluating the specified promise
+template <typename Continuation>
+inline auto make_shared_future(PromiseImpl<Continuation> p) {
+    using result_type = typename PromiseImpl<Continuation>::result_type;
+    return SharedFuture<typename result_type::value_type,
+                        typename result_type::error_type>(std::move(p));
+}
+
+} // namespace bipolar
+
+#endif
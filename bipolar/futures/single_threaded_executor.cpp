@@ -1,6 +1,7 @@
 #include "bipolar/futures/single_threaded_executor.hpp"
 
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 
@@ -20,7 +21,10 @@ namespace bipolar {
 //   outstanding suspended task tickets tracked by `scheduler_`
 class SingleThreadedExecutor::DispatcherImpl : public SuspendedTask::Resolver {
 public:
-    DispatcherImpl() = default;
+    explicit DispatcherImpl(std::size_t poll_budget) noexcept
+        : poll_budget_(poll_budget) {
+        assert(poll_budget_ >= 2);
+    }
 
     ~DispatcherImpl() {
         std::lock_guard lock(mtx_);
@@ -51,6 +55,7 @@ public:
             std::lock_guard lock(mtx_);
             assert(!was_shutdown_);
             scheduler_.schedule_task(std::move(task));
+            metrics_.on_schedule();
             if (!need_wake_) {
                 // don't need to wake
                 return;
@@ -62,20 +67,37 @@ public:
         wake_.notify_one();
     }
 
-    void run(ContextImpl& ctx) {
+    // Returns true once no task remains, false if `deadline` is reached
+    bool run(ContextImpl& ctx, std::chrono::steady_clock::time_point deadline) {
         Scheduler::TaskQueue tasks;
         while (true) {
-            wait_for_runnable_tasks(&tasks);
+            if (!wait_for_runnable_tasks(&tasks, deadline)) {
+                return false;
+            }
             if (tasks.empty()) {
-                return;
+                return true;
             }
 
-            do {
-                run_task(&tasks.front(), ctx);
-                tasks.pop(); // the task may be destroyed here if it's not
-                             // suspended
-            } while (!tasks.empty());
+            run_tasks(&tasks, ctx);
+            if (deadline != kNoDeadline &&
+                std::chrono::steady_clock::now() >= deadline) {
+                return !has_tasks();
+            }
+        }
+    }
+
+    bool run_until_idle(ContextImpl& ctx) {
+        Scheduler::TaskQueue tasks;
+        {
+            std::lock_guard lock(mtx_);
+            assert(!was_shutdown_);
+            scheduler_.take_runnable_tasks(&tasks, poll_budget_);
         }
+
+        run_tasks(&tasks, ctx);
+
+        std::lock_guard lock(mtx_);
+        return !scheduler_.has_runnable_tasks();
     }
 
     // Must only be called while `run_task()` is running a task.
@@ -103,13 +125,17 @@ public:
     void resolve_ticket(SuspendedTask::Ticket ticket,
                         bool resume_task) override {
         PendingTask abandoned_task;
-        bool do_wake = false;
         {
             std::lock_guard lock(mtx_);
             if (resume_task) {
-                scheduler_.resume_task_with_ticket(ticket);
+                if (scheduler_.resume_task_with_ticket(ticket)) {
+                    metrics_.on_wake();
+                }
             } else {
                 abandoned_task = scheduler_.release_ticket(ticket);
+                if (abandoned_task) {
+                    metrics_.on_abandon();
+                }
             }
 
             if (was_shutdown_) {
@@ -120,47 +146,87 @@ public:
                 }
             } else if (need_wake_ && (scheduler_.has_runnable_tasks() ||
                                       !scheduler_.has_suspended_tasks())) {
+                // notified under the lock since the executor may be
+                // destroyed as soon as `run()` returns
                 need_wake_ = false;
-                do_wake = true;
+                wake_.notify_one();
+                return;
             } else {
                 // nothing else to do
                 return;
             }
         }
 
-        if (do_wake) {
-            wake_.notify_one();
-        } else {
-            delete this;
+        delete this;
+    }
+
+    ExecutorMetricsSnapshot metrics() const {
+        ExecutorMetricsSnapshot snapshot;
+        {
+            std::lock_guard lock(mtx_);
+            snapshot.runnable_tasks = scheduler_.runnable_task_count();
+            snapshot.suspended_tasks = scheduler_.suspended_task_count();
+            snapshot.outstanding_tickets =
+                scheduler_.outstanding_ticket_count();
         }
+        metrics_.fill(&snapshot);
+        return snapshot;
     }
 
 private:
-    void wait_for_runnable_tasks(Scheduler::TaskQueue* tasks)
+    // Returns false if `deadline` is reached before any task is runnable
+    bool wait_for_runnable_tasks(Scheduler::TaskQueue* tasks,
+                                 std::chrono::steady_clock::time_point deadline)
         BIPOLAR_NO_THREAD_SAFETY_ANALYSIS {
         std::unique_lock lock(mtx_);
         while (true) {
             assert(!was_shutdown_);
-            scheduler_.take_runnable_tasks(tasks);
+            scheduler_.take_runnable_tasks(tasks, poll_budget_);
             if (!tasks->empty()) {
-                return;
+                return true;
             }
             if (!scheduler_.has_suspended_tasks()) {
-                return;
+                return true;
             }
+
             need_wake_ = true;
-            wake_.wait(lock);
+            if (deadline == kNoDeadline) {
+                wake_.wait(lock);
+            } else if (wake_.wait_until(lock, deadline) ==
+                       std::cv_status::timeout) {
+                need_wake_ = false;
+                scheduler_.take_runnable_tasks(tasks, poll_budget_);
+                return !tasks->empty();
+            }
             need_wake_ = false;
         }
     }
 
+    bool has_tasks() {
+        std::lock_guard lock(mtx_);
+        return scheduler_.has_runnable_tasks() ||
+               scheduler_.has_suspended_tasks();
+    }
+
+    void run_tasks(Scheduler::TaskQueue* tasks, Context& ctx) {
+        while (!tasks->empty()) {
+            run_task(&tasks->front(), ctx);
+            tasks->pop(); // the task may be destroyed here if it's not
+                          // suspended
+        }
+    }
+
     void run_task(PendingTask* task, Context& ctx) {
         assert(current_task_ticket_ == 0);
+        const auto start = ExecutorMetrics::now();
         const bool finished = (*task)(ctx);
         assert(!*task == finished);
-        (void)finished;
+        metrics_.on_poll(*task, start, finished);
         if (current_task_ticket_ == 0) {
             // task was not suspended, no ticket was produced
+            if (!finished) {
+                metrics_.on_abandon();
+            }
             return;
         }
 
@@ -168,22 +234,30 @@ private:
         assert(!was_shutdown_);
         scheduler_.finalize_ticket(current_task_ticket_, task);
         current_task_ticket_ = 0;
+        if (*task) {
+            metrics_.on_abandon();
+        }
     }
 
 private:
+    static constexpr auto kNoDeadline =
+        std::chrono::steady_clock::time_point::max();
+
+    const std::size_t poll_budget_;
     SuspendedTask::Ticket current_task_ticket_ = 0;
     std::condition_variable wake_;
+    ExecutorMetrics metrics_;
 
     // A bunch of state that is guarded by a mutex
-    std::mutex mtx_;
+    mutable std::mutex mtx_;
     bool was_shutdown_ BIPOLAR_GUARDED_BY(mtx_) = false;
     bool need_wake_ BIPOLAR_GUARDED_BY(mtx_) = false;
     Scheduler scheduler_ BIPOLAR_GUARDED_BY(mtx_);
 };
 
 // FIXME unique_ptr
-SingleThreadedExecutor::SingleThreadedExecutor()
-    : ctx_(this), dispatcher_(new DispatcherImpl()) {}
+SingleThreadedExecutor::SingleThreadedExecutor(std::size_t poll_budget)
+    : ctx_(this), dispatcher_(new DispatcherImpl(poll_budget)) {}
 
 SingleThreadedExecutor::~SingleThreadedExecutor() {
     dispatcher_->shutdown();
@@ -195,7 +269,20 @@ void SingleThreadedExecutor::schedule_task(PendingTask task) {
 }
 
 void SingleThreadedExecutor::run() {
-    dispatcher_->run(ctx_);
+    dispatcher_->run(ctx_, std::chrono::steady_clock::time_point::max());
+}
+
+bool SingleThreadedExecutor::run_until_idle() {
+    return dispatcher_->run_until_idle(ctx_);
+}
+
+bool SingleThreadedExecutor::run_until(
+    std::chrono::steady_clock::time_point deadline) {
+    return dispatcher_->run(ctx_, deadline);
+}
+
+ExecutorMetricsSnapshot SingleThreadedExecutor::metrics() const {
+    return dispatcher_->metrics();
 }
 
 SuspendedTask SingleThreadedExecutor::ContextImpl::suspend_task() {
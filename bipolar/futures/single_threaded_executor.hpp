@@ -6,9 +6,12 @@
 #define BIPOLAR_FUTURES_SINGLE_THREADED_EXECUTOR_HPP_
 
 #include "bipolar/futures/executor.hpp"
+#include "bipolar/futures/executor_metrics.hpp"
 #include "bipolar/futures/promise.hpp"
 #include "bipolar/futures/scheduler.hpp"
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 
 #include <boost/noncopyable.hpp>
@@ -20,11 +23,25 @@ namespace bipolar {
 /// platform-independent applications. It may be less efficient or provide
 /// fewer features than more specialized or platform-dependent executors.
 ///
+/// Runnable tasks are polled in batches of at most `poll_budget` tasks,
+/// taken in priority order (see `Scheduler`). A task resuming itself goes
+/// back to the end of its lane, so between two batches newly resumed
+/// normal tasks get ahead of the bulk ones and an embedding event loop
+/// gets a turn with `run_until_idle()`.
+///
 /// See documentation of `Promise` for more information.
 class SingleThreadedExecutor final : public Executor,
                                      public boost::noncopyable {
 public:
-    SingleThreadedExecutor();
+    /// The default maximum number of tasks polled per batch
+    static constexpr std::size_t kDefaultPollBudget = 64;
+
+    /// Constructs an executor polling at most `poll_budget` tasks per batch.
+    ///
+    /// Preconditions:
+    /// - `poll_budget` must be at least 2, leaving room for a bulk task
+    explicit SingleThreadedExecutor(
+        std::size_t poll_budget = kDefaultPollBudget);
 
     /// Destroys the executor along with all of its remaining scheduled tasks
     /// that have yet to complete
@@ -42,6 +59,42 @@ public:
     /// thread at a time
     void run();
 
+    /// Runs a single batch of runnable tasks without waiting for suspended
+    /// ones, so that the executor can be driven by a foreign event loop.
+    ///
+    /// Returns true if no task is runnable anymore, false if the budget ran
+    /// out first and the caller should call again soon.
+    ///
+    /// Same thread-safety as `run()`.
+    bool run_until_idle();
+
+    /// Runs tasks like `run()` until none remain or `deadline` is reached.
+    ///
+    /// Returns true if no task remains.
+    ///
+    /// Same thread-safety as `run()`.
+    bool run_until(std::chrono::steady_clock::time_point deadline);
+
+    /// Runs tasks like `run()` until none remain or `timeout` has elapsed.
+    ///
+    /// Returns true if no task remains.
+    ///
+    /// Same thread-safety as `run()`.
+    template <typename Rep, typename Period>
+    bool run_for(std::chrono::duration<Rep, Period> timeout) {
+        return run_until(
+            std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                timeout));
+    }
+
+    /// Returns a snapshot of the executor's queues, along with its counters
+    /// and histograms if the instrumentation is compiled in (see
+    /// `ExecutorMetrics`).
+    ///
+    /// This method is thread-safe.
+    ExecutorMetricsSnapshot metrics() const;
+
 private:
     class DispatcherImpl;
 
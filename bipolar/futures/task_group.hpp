@@ -0,0 +1,471 @@
+//! TaskGroup
+//!
+//! See `TaskGroup` for details.
+//!
+
+#ifndef BIPOLAR_FUTURES_TASK_GROUP_HPP_
+#define BIPOLAR_FUTURES_TASK_GROUP_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/thread_safety.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/executor.hpp"
+#include "bipolar/futures/internal/park_lock.hpp"
+#include "bipolar/futures/pending_task.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+
+namespace bipolar {
+namespace internal {
+// The state shared by a `TaskGroup` and its children, which may outlive the
+// group on their executors.
+//
+// A child is polled with a context of its own, whose tickets are resolved
+// by its node: the node holds the ticket of the child's task while the
+// child's tickets are outstanding, which lets `cancel()` resume it while
+// the task is still abandoned once the child can't be woken up anymore.
+//
+// Nodes are recycled through a freelist, which holds at most as many nodes
+// as children ran at once. A node whose tickets outlive its child is
+// retired instead, it deletes itself on the last one. The pending task of
+// a child only holds a pointer to the state and one to its node, so it's
+// stored inline.
+template <typename E>
+class TaskGroupState final
+    : public std::enable_shared_from_this<TaskGroupState<E>>,
+      public boost::noncopyable {
+    class Child final : public SuspendedTask::Resolver {
+    public:
+        explicit Child(TaskGroupState* group) noexcept : group_(group) {}
+
+        SuspendedTask::Ticket
+        duplicate_ticket(SuspendedTask::Ticket ticket) override {
+            std::lock_guard lock(mtx_);
+            ++tickets_;
+            return ticket;
+        }
+
+        void resolve_ticket(SuspendedTask::Ticket, bool resume_task) override {
+            // released outside the lock
+            std::shared_ptr<TaskGroupState> group;
+            SuspendedTask task;
+            bool retired = false;
+            {
+                std::lock_guard lock(mtx_);
+                if (resume_task) {
+                    if (polling_) {
+                        woken_ = true;
+                    } else {
+                        task = std::move(task_);
+                    }
+                }
+
+                assert(tickets_ > 0);
+                if (--tickets_ == 0) {
+                    group = std::move(keepalive_);
+                    retired = retired_;
+                    if (!resume_task && !polling_) {
+                        // abandoned along with the task
+                        task = std::move(task_);
+                    }
+                }
+            }
+
+            if (resume_task) {
+                task.resume_task();
+            } else {
+                task.reset();
+            }
+            if (retired) {
+                delete this;
+            }
+        }
+
+        Promise<Void, E> promise;
+        // position in `children_`
+        std::size_t slot = 0;
+
+    private:
+        friend class TaskGroupState;
+
+        // The context in which the child runs
+        class ChildContext final : public Context {
+        public:
+            ChildContext(Executor* executor, Child* child) noexcept
+                : executor_(executor), child_(child) {}
+
+            Executor* get_executor() const override {
+                return executor_;
+            }
+
+            SuspendedTask suspend_task() override {
+                std::lock_guard lock(child_->mtx_);
+                if (child_->tickets_++ == 0) {
+                    child_->keepalive_ = child_->group_->shared_from_this();
+                }
+                return SuspendedTask(child_, 0);
+            }
+
+        private:
+            Executor* const executor_;
+            Child* const child_;
+        };
+
+        TaskGroupState* const group_;
+
+        std::mutex mtx_;
+        // the ticket of the task, held while the child has tickets
+        SuspendedTask task_ BIPOLAR_GUARDED_BY(mtx_);
+        std::size_t tickets_ BIPOLAR_GUARDED_BY(mtx_) = 0;
+        bool polling_ BIPOLAR_GUARDED_BY(mtx_) = false;
+        bool woken_ BIPOLAR_GUARDED_BY(mtx_) = false;
+        bool retired_ BIPOLAR_GUARDED_BY(mtx_) = false;
+        std::shared_ptr<TaskGroupState> keepalive_ BIPOLAR_GUARDED_BY(mtx_);
+    };
+
+    // The continuation of the pending task of a child
+    class ChildContinuation {
+    public:
+        ChildContinuation(std::shared_ptr<TaskGroupState> state,
+                          Child* child) noexcept
+            : state_(std::move(state)), child_(child) {}
+
+        ChildContinuation(ChildContinuation&& rhs) noexcept
+            : state_(std::move(rhs.state_)),
+              child_(std::exchange(rhs.child_, nullptr)) {}
+
+        ChildContinuation& operator=(ChildContinuation&&) = delete;
+
+        ~ChildContinuation() {
+            // abandoned or dropped by its executor before completion
+            if (child_) {
+                state_->finish(std::exchange(child_, nullptr), nullptr);
+            }
+        }
+
+        Result<Void, Void> operator()(Context& ctx) {
+            if (state_->run(ctx, child_)) {
+                child_ = nullptr;
+                return Ok(Void{});
+            }
+            return Pending{};
+        }
+
+    private:
+        std::shared_ptr<TaskGroupState> state_;
+        Child* child_;
+    };
+
+public:
+    explicit TaskGroupState(Executor* executor) noexcept
+        : executor_(executor) {}
+
+    ~TaskGroupState() {
+        assert(children_.empty());
+    }
+
+    void spawn(Promise<Void, E> promise, TaskPriority priority) {
+        Child* child = nullptr;
+        {
+            std::lock_guard lock(mtx_);
+            // if cancelled, `promise` is destroyed outside the lock
+            if (!cancelled_.load(std::memory_order_relaxed)) {
+                std::unique_ptr<Child> node;
+                if (pool_.empty()) {
+                    node = std::make_unique<Child>(this);
+                } else {
+                    node = std::move(pool_.back());
+                    pool_.pop_back();
+                }
+                node->promise = std::move(promise);
+                node->slot = children_.size();
+                child = node.get();
+                children_.push_back(std::move(node));
+                ++spawned_;
+            }
+        }
+
+        if (child) {
+            executor_->schedule_task(PendingTask(
+                PromiseImpl(ChildContinuation(this->shared_from_this(), child))
+                    .box(),
+                priority));
+        }
+    }
+
+    void cancel() {
+        std::vector<SuspendedTask> tasks;
+        {
+            std::lock_guard lock(mtx_);
+            cancel_children(tasks);
+        }
+        for (auto& task : tasks) {
+            task.resume_task();
+        }
+    }
+
+    bool is_cancelled() const noexcept {
+        return cancelled_.load(std::memory_order_acquire);
+    }
+
+    std::size_t active() const {
+        std::lock_guard lock(mtx_);
+        return children_.size();
+    }
+
+    std::size_t spawned() const {
+        std::lock_guard lock(mtx_);
+        return spawned_;
+    }
+
+    Result<Void, E> poll_join(Context& ctx) {
+        ParkLock lock(ctx, mtx_);
+        if (children_.empty()) {
+            if (error_.has_value()) {
+                return Err(error_.value());
+            }
+            return Ok(Void{});
+        }
+
+        lock.park(joiner_);
+        return Pending{};
+    }
+
+private:
+    // Polls `child`, returns true if it's done
+    bool run(Context& ctx, Child* child) {
+        if (is_cancelled()) {
+            // the promise is dropped unfinished
+            finish(child, nullptr);
+            return true;
+        }
+
+        {
+            std::lock_guard lock(child->mtx_);
+            child->polling_ = true;
+            child->woken_ = false;
+        }
+
+        typename Child::ChildContext inner(ctx.get_executor(), child);
+        auto result = child->promise(inner);
+        if (!result.is_pending()) {
+            {
+                std::lock_guard lock(child->mtx_);
+                child->polling_ = false;
+            }
+            finish(child, &result);
+            return true;
+        }
+
+        ParkLock lock(ctx, child->mtx_);
+        child->polling_ = false;
+        if (child->woken_ || is_cancelled()) {
+            // polled again, or dropped by the next poll
+            lock.resume();
+        } else if (child->tickets_ > 0) {
+            lock.park(child->task_);
+        }
+        // otherwise the task is abandoned
+        return false;
+    }
+
+    // Retires `child`, completed with `result` or cancelled if null
+    void finish(Child* child, Result<Void, E>* result) {
+        // its tickets are likely released along with it
+        child->promise = nullptr;
+
+        std::vector<SuspendedTask> tasks;
+        SuspendedTask joiner;
+        SuspendedTask task;
+        {
+            std::lock_guard lock(mtx_);
+            if (result && result->is_error() &&
+                !cancelled_.load(std::memory_order_relaxed)) {
+                error_.emplace(std::move(result->error()));
+                cancel_children(tasks);
+            }
+
+            // swap-removes the node
+            const std::size_t slot = child->slot;
+            std::swap(children_[slot], children_.back());
+            children_[slot]->slot = slot;
+            std::unique_ptr<Child> node = std::move(children_.back());
+            children_.pop_back();
+
+            {
+                std::lock_guard child_lock(node->mtx_);
+                task = std::move(node->task_);
+                if (node->tickets_ > 0) {
+                    node->retired_ = true;
+                    node.release();
+                }
+            }
+            if (node) {
+                pool_.push_back(std::move(node));
+            }
+
+            if (children_.empty()) {
+                joiner = std::move(joiner_);
+            }
+        }
+
+        for (auto& t : tasks) {
+            t.resume_task();
+        }
+        if (joiner) {
+            joiner.resume_task();
+        }
+    }
+
+    void cancel_children(std::vector<SuspendedTask>& tasks)
+        BIPOLAR_REQUIRES(mtx_) {
+        cancelled_.store(true, std::memory_order_release);
+        for (auto& child : children_) {
+            std::lock_guard lock(child->mtx_);
+            if (child->task_) {
+                tasks.push_back(std::move(child->task_));
+            }
+        }
+    }
+
+    Executor* const executor_;
+    std::atomic<bool> cancelled_{false};
+
+    mutable std::mutex mtx_;
+    std::vector<std::unique_ptr<Child>> children_ BIPOLAR_GUARDED_BY(mtx_);
+    std::vector<std::unique_ptr<Child>> pool_ BIPOLAR_GUARDED_BY(mtx_);
+    std::size_t spawned_ BIPOLAR_GUARDED_BY(mtx_) = 0;
+    Option<E> error_ BIPOLAR_GUARDED_BY(mtx_);
+    SuspendedTask joiner_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+} // namespace internal
+
+/// TaskGroup
+///
+/// A scope for child promises spawned onto an `Executor`, which bounds
+/// their lifetime instead of leaving them fire-and-forget.
+///
+/// `join()` returns a promise completing once every child finished. The
+/// first child failing cancels the others and its error is what `join()`
+/// produces. A cancelled child is dropped before its next poll, the
+/// suspended ones are resumed for that. Destroying the group cancels the
+/// children still running, they're dropped by their executor afterwards.
+/// A child which can't be woken up anymore is abandoned as usual, it
+/// counts as finished.
+///
+/// The children only keep their error, their values are discarded. The
+/// storage of finished children is recycled for the next ones.
+///
+/// All methods are thread-safe, the children may run on any executor.
+///
+/// # Examples
+///
+/// ```
+/// TaskGroup<int> group(&executor);
+/// for (auto& shard : shards) {
+///     group.spawn(fetch(shard));
+/// }
+///
+/// executor.schedule_task(PendingTask(group.join().or_else(
+///     [](const int& error) {
+///         // the other fetches were cancelled
+///         return Err(error);
+///     })));
+/// ```
+template <typename E = Void>
+class TaskGroup final : public boost::noncopyable {
+    using State = internal::TaskGroupState<E>;
+
+public:
+    /// The type of error produced by the children
+    using error_type = E;
+
+    /// Creates a group spawning its children onto `executor`, which must
+    /// outlive the children
+    explicit TaskGroup(Executor* executor)
+        : state_(std::make_shared<State>(executor)) {
+        assert(executor);
+    }
+
+    /// Cancels the remaining children
+    ~TaskGroup() {
+        state_->cancel();
+    }
+
+    /// Spawns a promise producing `Result<T, E>` as a child.
+    /// Dropped right away if the group was cancelled.
+    template <typename Continuation>
+    void spawn(PromiseImpl<Continuation> promise,
+               TaskPriority priority = TaskPriority::NORMAL) {
+        using result_type = typename PromiseImpl<Continuation>::result_type;
+        static_assert(
+            std::is_same_v<typename result_type::error_type, error_type>,
+            "The children must fail with the error type of the group");
+
+        assert(promise);
+        if constexpr (std::is_same_v<result_type, Result<Void, E>>) {
+            state_->spawn(std::move(promise), priority);
+        } else {
+            state_->spawn(
+                promise.then([](result_type& result) -> Result<Void, E> {
+                    if (result.is_error()) {
+                        return Err(std::move(result.error()));
+                    }
+                    return Ok(Void{});
+                }),
+                priority);
+        }
+    }
+
+    /// Cancels the remaining children without an error
+    void cancel() {
+        state_->cancel();
+    }
+
+    /// Returns true if the group was cancelled, either by `cancel()` or by
+    /// a failing child
+    bool is_cancelled() const noexcept {
+        return state_->is_cancelled();
+    }
+
+    /// Returns the number of children which haven't finished yet
+    std::size_t active() const {
+        return state_->active();
+    }
+
+    /// Returns the number of children spawned so far
+    std::size_t spawned() const {
+        return state_->spawned();
+    }
+
+    /// Returns an unboxed promise which completes once every child spawned
+    /// so far finished, with the error of the first failing one if any.
+    ///
+    /// Only one `join()` promise may wait at a time.
+    auto join() const {
+        return make_promise([state = state_](Context& ctx) {
+            return state->poll_join(ctx);
+        });
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+} // namespace bipolar
+
+#endif
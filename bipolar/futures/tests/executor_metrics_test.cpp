@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <sstream>
+
+#include "bipolar/futures/executor_metrics.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::literals;
+
+TEST(SingleThreadedExecutor, metrics) {
+    SingleThreadedExecutor executor;
+    SuspendedTask suspended;
+
+    executor.schedule_task(
+        PendingTask(make_promise([&](Context& ctx) -> Result<Void, Void> {
+            if (suspended) {
+                return Ok(Void{});
+            }
+            suspended = ctx.suspend_task();
+            return Pending{};
+        })));
+    executor.schedule_task(PendingTask(make_promise([]() {
+        return Ok(Void{});
+    })));
+
+    auto snapshot = executor.metrics();
+    EXPECT_EQ(snapshot.enabled, ExecutorMetrics::kEnabled);
+    EXPECT_EQ(snapshot.runnable_tasks, 2);
+    EXPECT_EQ(snapshot.suspended_tasks, 0);
+
+    EXPECT_TRUE(executor.run_until_idle());
+    snapshot = executor.metrics();
+    EXPECT_EQ(snapshot.runnable_tasks, 0);
+    EXPECT_EQ(snapshot.suspended_tasks, 1);
+    EXPECT_EQ(snapshot.outstanding_tickets, 1);
+
+    SuspendedTask(suspended).resume_task();
+    executor.run();
+    snapshot = executor.metrics();
+    EXPECT_EQ(snapshot.suspended_tasks, 0);
+
+    std::ostringstream os;
+    os << snapshot;
+    EXPECT_NE(os.str().find("runnable=0"), std::string::npos);
+
+    if (ExecutorMetrics::kEnabled) {
+        EXPECT_EQ(snapshot.scheduled, 2);
+        EXPECT_EQ(snapshot.polls, 3);
+        EXPECT_EQ(snapshot.completed, 2);
+        EXPECT_EQ(snapshot.wakes, 1);
+        EXPECT_EQ(snapshot.abandoned, 0);
+        EXPECT_EQ(snapshot.poll_latency.count, 3);
+        EXPECT_EQ(snapshot.schedule_delay.count, 3);
+        EXPECT_NE(os.str().find("poll_latency_ns"), std::string::npos);
+    } else {
+        EXPECT_EQ(snapshot.polls, 0);
+        EXPECT_EQ(snapshot.poll_latency.count, 0);
+    }
+}
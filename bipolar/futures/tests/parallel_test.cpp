@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bipolar/futures/parallel.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+namespace {
+// Runs `promise` to completion on the calling thread
+template <typename Promise>
+auto block_on(Promise promise) {
+    using result_type = typename Promise::result_type;
+
+    SingleThreadedExecutor executor;
+    result_type result;
+    executor.schedule_task(PendingTask(
+        promise.then([&](result_type& r) -> Result<Void, Void> {
+            result = std::move(r);
+            return Ok(Void{});
+        })));
+    executor.run();
+    return result;
+}
+
+} // namespace
+
+TEST(Parallel, parallel_for) {
+    ThreadPoolExecutor pool(4);
+
+    for (std::size_t n : {0, 1, 7, 1000, 100000}) {
+        std::vector<std::atomic<int>> hits(n);
+        auto result = block_on(parallel_for(
+            &pool, 0, n, [&](std::size_t i) { hits[i].fetch_add(1); }));
+
+        EXPECT_TRUE(result.is_ok());
+        for (auto& hit : hits) {
+            ASSERT_EQ(hit.load(), 1);
+        }
+    }
+}
+
+TEST(Parallel, parallel_for_grain) {
+    ThreadPoolExecutor pool(4);
+
+    std::vector<std::atomic<int>> hits(1000);
+    auto result = block_on(parallel_for(
+        &pool, 100, 900, [&](std::size_t i) { hits[i].fetch_add(1); }, 64));
+
+    EXPECT_TRUE(result.is_ok());
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), i >= 100 && i < 900) << i;
+    }
+}
+
+TEST(Parallel, mutable_functors) {
+    ThreadPoolExecutor pool(2);
+
+    std::atomic<int> calls{0};
+    auto result = block_on(parallel_for(
+        &pool, 0, 100, [counter = &calls](std::size_t) mutable {
+            counter->fetch_add(1);
+        }));
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ(calls.load(), 100);
+
+    auto sum = block_on(parallel_map_reduce(
+        &pool, 0, 10, 0, [](std::size_t i) mutable { return int(i); },
+        [](int a, int b) mutable { return a + b; }));
+    ASSERT_TRUE(sum.is_ok());
+    EXPECT_EQ(sum.value(), 45);
+}
+
+TEST(Parallel, parallel_map_reduce) {
+    ThreadPoolExecutor pool(3);
+
+    auto sum = block_on(parallel_map_reduce(
+        &pool, 0, 100001, std::uint64_t(0),
+        [](std::size_t i) { return std::uint64_t(i); },
+        [](std::uint64_t a, std::uint64_t b) { return a + b; }));
+    ASSERT_TRUE(sum.is_ok());
+    EXPECT_EQ(sum.value(), 100000ull * 100001 / 2);
+
+    auto empty = block_on(parallel_map_reduce(
+        &pool, 5, 5, 42, [](std::size_t) { return 1; },
+        [](int a, int b) { return a + b; }));
+    ASSERT_TRUE(empty.is_ok());
+    EXPECT_EQ(empty.value(), 42);
+
+    auto longest = block_on(parallel_map_reduce(
+        &pool, 0, 1000, std::vector<std::size_t>(),
+        [](std::size_t i) { return std::vector<std::size_t>(i % 37, i); },
+        [](std::vector<std::size_t> a, std::vector<std::size_t> b) {
+            return a.size() >= b.size() ? a : b;
+        }));
+    ASSERT_TRUE(longest.is_ok());
+    EXPECT_EQ(longest.value().size(), 36);
+}
+
+TEST(Parallel, parallel_sort) {
+    ThreadPoolExecutor pool(4);
+    std::mt19937 gen(42);
+
+    for (std::size_t n : {0, 1, 100, 5000, 100000, 333333}) {
+        std::vector<int> v(n);
+        for (auto& x : v) {
+            x = static_cast<int>(gen() % 1000);
+        }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+
+        auto result = block_on(
+            parallel_sort(&pool, v.begin(), v.end(), std::greater<>()));
+        EXPECT_TRUE(result.is_ok());
+        EXPECT_EQ(v, expected);
+    }
+}
+
+TEST(Parallel, polled_by_the_pool) {
+    ThreadPoolExecutor pool(2);
+    std::vector<int> v(50000);
+    std::iota(v.rbegin(), v.rend(), 0);
+
+    // the outer task waits on the pool it's running on without blocking it
+    std::atomic<bool> done{false};
+    Result<std::uint64_t, Void> result;
+    pool.schedule_task(PendingTask(
+        parallel_sort(&pool, v.begin(), v.end())
+            .and_then([&](const Void&) {
+                return parallel_map_reduce(
+                    &pool, 0, v.size(), std::uint64_t(0),
+                    [&](std::size_t i) { return std::uint64_t(v[i]); },
+                    [](std::uint64_t a, std::uint64_t b) { return a + b; });
+            })
+            .then([&](Result<std::uint64_t, Void>& r) {
+                result = std::move(r);
+                done.store(true);
+                return Ok(Void{});
+            })));
+
+    while (!done.load()) {
+        std::this_thread::yield();
+    }
+    ASSERT_TRUE(result.is_ok());
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+    EXPECT_EQ(result.value(), 49999ull * 50000 / 2);
+}
@@ -95,3 +95,15 @@ TEST(PendingTask, non_empty_task) {
         EXPECT_FALSE(promise);
     }
 }
+
+TEST(PendingTask, priority) {
+    PendingTask normal(make_promise([]() { return Ok(Void{}); }));
+    EXPECT_EQ(normal.priority(), TaskPriority::NORMAL);
+
+    PendingTask bulk(make_promise([]() { return Ok(Void{}); }),
+                     TaskPriority::BULK);
+    EXPECT_EQ(bulk.priority(), TaskPriority::BULK);
+
+    PendingTask moved(std::move(bulk));
+    EXPECT_EQ(moved.priority(), TaskPriority::BULK);
+}
@@ -1,9 +1,12 @@
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "bipolar/futures/context.hpp"
 #include "bipolar/futures/executor.hpp"
 #include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
 
 #include <gtest/gtest.h>
 
@@ -615,3 +618,146 @@ TEST(Promise, join_vector_promise) {
     EXPECT_EQ(result.value()[0].value(), 42);
     EXPECT_EQ(result.value()[1].error(), -1);
 }
+
+TEST(Promise, join_promise_vector_polls_resumed_only) {
+    constexpr std::size_t N = 64;
+    std::vector<SuspendedTask> handles(N);
+    std::vector<std::uint64_t> polls(N);
+    std::vector<bool> fired(N);
+
+    std::vector<Promise<std::size_t, Void>> promises;
+    for (std::size_t i = 0; i < N; ++i) {
+        promises.push_back(make_promise(
+            [&, i](Context& ctx) -> Result<std::size_t, Void> {
+                ++polls[i];
+                if (fired[i]) {
+                    return Ok(i);
+                }
+                handles[i] = ctx.suspend_task();
+                return Pending{};
+            }));
+    }
+
+    SingleThreadedExecutor executor;
+    bool joined = false;
+    executor.schedule_task(PendingTask(
+        join_promise_vector(std::move(promises))
+            .and_then([&](std::vector<Result<std::size_t, Void>>& results) {
+                for (std::size_t i = 0; i < N; ++i) {
+                    EXPECT_EQ(results[i].value(), i);
+                }
+                joined = true;
+                return Ok(Void{});
+            })));
+
+    // Resumes the branches one at a time, in reverse order
+    executor.schedule_task(PendingTask(make_promise(
+        [&, i = N](Context& ctx) mutable -> Result<Void, Void> {
+            --i;
+            fired[i] = true;
+            handles[i].resume_task();
+            if (i == 0) {
+                return Ok(Void{});
+            }
+            ctx.suspend_task().resume_task();
+            return Pending{};
+        })));
+
+    executor.run();
+    EXPECT_TRUE(joined);
+    for (std::size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(polls[i], 2);
+    }
+}
+
+TEST(Promise, join_promises_polls_resumed_only) {
+    std::uint64_t polls[2] = {};
+    SuspendedTask handles[2];
+    bool fired[2] = {};
+
+    auto branch = [&](std::size_t i) {
+        return make_promise([&, i](Context& ctx) -> Result<int, Void> {
+            ++polls[i];
+            if (fired[i]) {
+                return Ok(static_cast<int>(i));
+            }
+            handles[i] = ctx.suspend_task();
+            return Pending{};
+        });
+    };
+
+    SingleThreadedExecutor executor;
+    bool joined = false;
+    executor.schedule_task(PendingTask(
+        join_promises(branch(0), branch(1))
+            .and_then([&](std::tuple<Result<int, Void>, Result<int, Void>>&
+                              results) {
+                EXPECT_EQ(std::get<0>(results).value(), 0);
+                EXPECT_EQ(std::get<1>(results).value(), 1);
+                joined = true;
+                return Ok(Void{});
+            })));
+
+    // Resumes the second branch from another thread, then the first one
+    executor.schedule_task(PendingTask(make_promise(
+        [&, step = 0](Context& ctx) mutable -> Result<Void, Void> {
+            if (step++ == 0) {
+                fired[1] = true;
+                std::thread([&, s = ctx.suspend_task()]() mutable {
+                    handles[1].resume_task();
+                    s.resume_task();
+                }).join();
+                return Pending{};
+            }
+            fired[0] = true;
+            handles[0].resume_task();
+            return Ok(Void{});
+        })));
+
+    executor.run();
+    EXPECT_TRUE(joined);
+    EXPECT_EQ(polls[0], 2);
+    EXPECT_EQ(polls[1], 2);
+}
+
+TEST(Promise, join_promise_vector_abandoned) {
+    std::uint64_t polls = 0;
+
+    std::vector<Promise<int, Void>> promises;
+    promises.push_back(make_ok_promise<int, Void>(42));
+    promises.push_back(make_promise([&](Context& ctx) -> Result<int, Void> {
+        ++polls;
+        ctx.suspend_task(); // dropped immediately
+        return Pending{};
+    }));
+
+    SingleThreadedExecutor executor;
+    bool joined = false;
+    executor.schedule_task(
+        PendingTask(join_promise_vector(std::move(promises))
+                        .and_then([&](std::vector<Result<int, Void>>&) {
+                            joined = true;
+                            return Ok(Void{});
+                        })));
+
+    // The join must be abandoned instead of hanging the executor
+    executor.run();
+    EXPECT_FALSE(joined);
+    EXPECT_EQ(polls, 1);
+}
+
+TEST(Promise, join_promises_context_as) {
+    // the branches reach the executor specific context
+    const auto check = [](Context& context) -> Result<int, int> {
+        EXPECT_EQ(&context.as<DummyContext>(), &ctx);
+        return Ok(1);
+    };
+
+    auto p = join_promises(make_promise(check), make_promise(check));
+    EXPECT_TRUE(p(ctx).is_ok());
+
+    std::vector<Promise<int, int>> promises;
+    promises.push_back(make_promise(check));
+    auto q = join_promise_vector(std::move(promises));
+    EXPECT_TRUE(q(ctx).is_ok());
+}
@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <vector>
 
 #include "bipolar/futures/scheduler.hpp"
 
@@ -329,3 +330,66 @@ TEST(Scheduler, take_all_tasks) {
     // EXPECT_TRUE(scheduler.has_outstanding_tickets());
     // EXPECT_TRUE(tasks.empty());
 }
+
+TEST(Scheduler, priority_lanes) {
+    Scheduler scheduler;
+    Scheduler::TaskQueue tasks;
+    FakeContext ctx;
+    std::vector<int> order;
+
+    auto make_task = [&](int id, TaskPriority priority) {
+        return PendingTask(make_promise([&order, id]() -> Result<Void, Void> {
+                               order.push_back(id);
+                               return Ok(Void{});
+                           }),
+                           priority);
+    };
+
+    scheduler.schedule_task(make_task(0, TaskPriority::BULK));
+    scheduler.schedule_task(make_task(1, TaskPriority::NORMAL));
+    scheduler.schedule_task(make_task(2, TaskPriority::BULK));
+    scheduler.schedule_task(make_task(3, TaskPriority::NORMAL));
+    scheduler.schedule_task(make_task(4, TaskPriority::NORMAL));
+    EXPECT_EQ(scheduler.runnable_task_count(), 5);
+
+    // Normal tasks come first but a bulk task is taken in every batch
+    scheduler.take_runnable_tasks(&tasks, 2);
+    EXPECT_EQ(tasks.size(), 2);
+    while (!tasks.empty()) {
+        tasks.front()(ctx);
+        tasks.pop();
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 0}));
+
+    scheduler.take_runnable_tasks(&tasks, 8);
+    EXPECT_EQ(tasks.size(), 3);
+    while (!tasks.empty()) {
+        tasks.front()(ctx);
+        tasks.pop();
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 0, 3, 4, 2}));
+    EXPECT_FALSE(scheduler.has_runnable_tasks());
+}
+
+TEST(Scheduler, resumed_task_keeps_priority) {
+    Scheduler scheduler;
+    Scheduler::TaskQueue tasks;
+    std::uint64_t cnt[2] = {};
+
+    PendingTask bulk(make_promise([&]() -> Result<Void, Void> {
+                         ++cnt[0];
+                         return Ok(Void{});
+                     }),
+                     TaskPriority::BULK);
+    SuspendedTask::Ticket t = scheduler.obtain_ticket(2);
+    scheduler.finalize_ticket(t, &bulk);
+    EXPECT_TRUE(scheduler.has_suspended_tasks());
+
+    scheduler.schedule_task(make_pending_task(&cnt[1]));
+    scheduler.resume_task_with_ticket(t);
+    scheduler.take_runnable_tasks(&tasks);
+    EXPECT_EQ(tasks.size(), 2);
+    EXPECT_EQ(tasks.front().priority(), TaskPriority::NORMAL);
+    tasks.pop();
+    EXPECT_EQ(tasks.front().priority(), TaskPriority::BULK);
+}
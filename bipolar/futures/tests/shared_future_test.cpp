@@ -0,0 +1,205 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bipolar/futures/shared_future.hpp"
+#include "bipolar/futures/single_threaded_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::literals;
+
+TEST(SharedFuture, empty) {
+    SharedFuture<int, int> f;
+    EXPECT_FALSE(f);
+    EXPECT_FALSE(f.is_ready());
+
+    SharedFuture<int, int> g(Promise<int, int>(nullptr));
+    EXPECT_FALSE(g);
+}
+
+TEST(SharedFuture, evaluates_the_promise_once) {
+    SingleThreadedExecutor executor;
+    int runs = 0;
+    SuspendedTask inner;
+
+    auto f = make_shared_future(
+        make_promise([&](Context& ctx) -> Result<std::string, int> {
+            if (++runs == 1) {
+                inner = ctx.suspend_task();
+                return Pending{};
+            }
+            return Ok("hello"s);
+        }));
+    EXPECT_TRUE(f);
+
+    std::vector<const std::string*> seen;
+    for (int i = 0; i < 5; ++i) {
+        executor.schedule_task(PendingTask(
+            f.wait().and_then([&](const SharedFuture<std::string, int>& r) {
+                seen.push_back(&r.value());
+                return Ok(Void{});
+            })));
+    }
+
+    executor.run_until_idle();
+    EXPECT_EQ(runs, 1);
+    EXPECT_TRUE(seen.empty());
+    EXPECT_FALSE(f.is_ready());
+
+    executor.schedule_task(PendingTask(make_promise([&] {
+        inner.resume_task();
+        return Ok(Void{});
+    })));
+    executor.run();
+
+    EXPECT_EQ(runs, 2);
+    EXPECT_TRUE(f.is_ready());
+    EXPECT_TRUE(f.is_ok());
+    EXPECT_EQ(f.value(), "hello");
+
+    // every consumer sees the same object
+    ASSERT_EQ(seen.size(), 5);
+    for (auto p : seen) {
+        EXPECT_EQ(p, &f.value());
+    }
+}
+
+TEST(SharedFuture, error) {
+    SingleThreadedExecutor executor;
+    auto f = make_shared_future(
+        make_promise([]() -> Result<Void, int> { return Err(42); }));
+
+    int errors = 0;
+    for (int i = 0; i < 3; ++i) {
+        executor.schedule_task(PendingTask(
+            f.wait().and_then([&](const SharedFuture<Void, int>& r) {
+                EXPECT_TRUE(r.is_error());
+                errors += r.error();
+                return Ok(Void{});
+            })));
+    }
+    executor.run();
+
+    EXPECT_EQ(errors, 126);
+    EXPECT_TRUE(f.result().is_error());
+}
+
+TEST(SharedFuture, driver_going_away) {
+    SingleThreadedExecutor executor;
+    SuspendedTask inner;
+    bool completed = false;
+
+    auto f = make_shared_future(
+        make_promise([&, runs = 0](Context& ctx) mutable -> Result<int, Void> {
+            if (++runs == 1) {
+                inner = ctx.suspend_task();
+                return Pending{};
+            }
+            return Ok(1);
+        }));
+
+    {
+        // drives the promise first, then is destroyed
+        SingleThreadedExecutor driver;
+        driver.schedule_task(PendingTask(f.wait().discard_result()));
+        driver.run_until_idle();
+    }
+
+    executor.schedule_task(PendingTask(
+        f.wait().and_then([&](const SharedFuture<int, Void>& r) {
+            completed = r.value() == 1;
+            return Ok(Void{});
+        })));
+    executor.run_until_idle();
+    EXPECT_FALSE(completed);
+
+    executor.schedule_task(PendingTask(make_promise([&] {
+        inner.resume_task();
+        return Ok(Void{});
+    })));
+    executor.run();
+    EXPECT_TRUE(completed);
+}
+
+TEST(SharedFuture, abandoned_promise) {
+    SingleThreadedExecutor executor;
+    bool destroyed = false;
+    struct Guard {
+        explicit Guard(bool* flag) : destroyed(flag) {}
+        ~Guard() {
+            *destroyed = true;
+        }
+        bool* destroyed;
+    };
+    auto guard = std::make_shared<Guard>(&destroyed);
+
+    SharedFuture<Void, Void> f(make_promise(
+        [&, guard = std::move(guard)](Context& ctx) -> Result<Void, Void> {
+            // the ticket is dropped right away
+            ctx.suspend_task();
+            return Pending{};
+        }));
+
+    int completed = 0;
+    for (int i = 0; i < 3; ++i) {
+        executor.schedule_task(
+            PendingTask(f.wait().and_then(
+                [&](const SharedFuture<Void, Void>&) {
+                    ++completed;
+                    return Ok(Void{});
+                })));
+    }
+    EXPECT_FALSE(destroyed);
+    executor.run();
+
+    EXPECT_EQ(completed, 0);
+    EXPECT_TRUE(destroyed);
+    EXPECT_FALSE(f.is_ready());
+}
+
+TEST(SharedFuture, multiple_threads) {
+    constexpr int kThreads = 4;
+    constexpr int kConsumers = 100;
+
+    std::atomic<int> runs{0};
+    std::atomic<bool> go{false};
+    auto f = make_shared_future(
+        make_promise([&](Context& ctx) -> Result<std::vector<int>, Void> {
+            runs.fetch_add(1);
+            if (!go.load()) {
+                // spins through the executors until released
+                ctx.suspend_task().resume_task();
+                return Pending{};
+            }
+            return Ok(std::vector<int>{1, 2, 3});
+        }));
+
+    std::atomic<int> sum{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            SingleThreadedExecutor executor;
+            for (int j = 0; j < kConsumers; ++j) {
+                executor.schedule_task(PendingTask(f.wait().and_then(
+                    [&](const SharedFuture<std::vector<int>, Void>& r) {
+                        sum.fetch_add(r.value()[2]);
+                        return Ok(Void{});
+                    })));
+            }
+            executor.run();
+        });
+    }
+
+    std::this_thread::sleep_for(10ms);
+    go.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(sum.load(), kThreads * kConsumers * 3);
+    EXPECT_TRUE(f.is_ok());
+    EXPECT_EQ(f.value().size(), 3);
+}
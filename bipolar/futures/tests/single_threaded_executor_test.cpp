@@ -1,5 +1,7 @@
 #include <cstdint>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "bipolar/futures/single_threaded_executor.hpp"
 
@@ -182,3 +184,88 @@ TEST(SingleThreadedExecutor, abandoning_tasks) {
     EXPECT_EQ(run_cnt[2], 1);
     EXPECT_EQ(run_cnt[3], 1);
 }
+
+TEST(SingleThreadedExecutor, bulk_tasks_yield_to_normal_ones) {
+    SingleThreadedExecutor executor(4);
+    std::vector<char> trace;
+
+    // Each task resumes itself until it has run 3 times
+    auto make_task = [&](char tag, TaskPriority priority) {
+        return PendingTask(
+            make_promise([&, tag, n = 0](Context& ctx) mutable
+                         -> Result<Void, Void> {
+                trace.push_back(tag);
+                if (++n == 3) {
+                    return Ok(Void{});
+                }
+                ctx.suspend_task().resume_task();
+                return Pending{};
+            }),
+            priority);
+    };
+
+    executor.schedule_task(make_task('b', TaskPriority::BULK));
+    executor.schedule_task(make_task('B', TaskPriority::BULK));
+    for (int i = 0; i < 3; ++i) {
+        executor.schedule_task(make_task('n', TaskPriority::NORMAL));
+    }
+    executor.run();
+
+    // Batches of 4: normal tasks first but one bulk task per batch
+    EXPECT_EQ(std::string(trace.begin(), trace.end()), "nnnbnnnBnnnbBbB");
+}
+
+TEST(SingleThreadedExecutor, run_until_idle) {
+    SingleThreadedExecutor executor(8);
+    std::uint64_t polls = 0;
+
+    // A task resuming itself forever would starve an embedding event loop
+    executor.schedule_task(
+        PendingTask(make_promise([&](Context& ctx) -> Result<Void, Void> {
+            if (++polls == 20) {
+                return Ok(Void{});
+            }
+            ctx.suspend_task().resume_task();
+            return Pending{};
+        })));
+
+    EXPECT_FALSE(executor.run_until_idle());
+    EXPECT_EQ(polls, 1);
+
+    // The task is polled once per call since it's only runnable again after
+    // each poll
+    std::uint64_t calls = 1;
+    do {
+        ++calls;
+    } while (!executor.run_until_idle());
+    EXPECT_EQ(polls, 20);
+    EXPECT_EQ(calls, 20);
+    EXPECT_TRUE(executor.run_until_idle());
+}
+
+TEST(SingleThreadedExecutor, run_for) {
+    SingleThreadedExecutor executor;
+    SuspendedTask suspended;
+    std::uint64_t polls = 0;
+
+    executor.schedule_task(
+        PendingTask(make_promise([&](Context& ctx) -> Result<Void, Void> {
+            if (++polls == 2) {
+                return Ok(Void{});
+            }
+            suspended = ctx.suspend_task();
+            return Pending{};
+        })));
+
+    // Gives up while the task is suspended
+    EXPECT_FALSE(executor.run_for(10ms));
+    EXPECT_EQ(polls, 1);
+
+    std::thread t([&]() {
+        std::this_thread::sleep_for(10ms);
+        suspended.resume_task();
+    });
+    EXPECT_TRUE(executor.run_for(10s));
+    t.join();
+    EXPECT_EQ(polls, 2);
+}
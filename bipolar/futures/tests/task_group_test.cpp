@@ -0,0 +1,244 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bipolar/futures/single_threaded_executor.hpp"
+#include "bipolar/futures/task_group.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+namespace {
+// Sets a flag when destroyed, to observe children being dropped
+struct DropGuard {
+    explicit DropGuard(bool* flag) : dropped(flag) {}
+
+    ~DropGuard() {
+        *dropped = true;
+    }
+
+    bool* dropped;
+};
+
+} // namespace
+
+TEST(TaskGroup, joining_children) {
+    SingleThreadedExecutor executor;
+    TaskGroup<int> group(&executor);
+    int sum = 0;
+
+    for (int i = 1; i <= 10; ++i) {
+        group.spawn(make_promise([&sum, i]() -> Result<int, int> {
+            sum += i;
+            return Ok(i);
+        }));
+    }
+    EXPECT_EQ(group.spawned(), 10);
+    EXPECT_EQ(group.active(), 10);
+
+    Option<Result<Void, int>> joined;
+    executor.schedule_task(
+        PendingTask(group.join().then([&](Result<Void, int>& result) {
+            joined.emplace(std::move(result));
+            return Ok(Void{});
+        })));
+    executor.run();
+
+    EXPECT_EQ(sum, 55);
+    EXPECT_EQ(group.active(), 0);
+    ASSERT_TRUE(joined.has_value());
+    EXPECT_TRUE(joined.value().is_ok());
+    EXPECT_FALSE(group.is_cancelled());
+}
+
+TEST(TaskGroup, waking_children) {
+    SingleThreadedExecutor executor;
+    TaskGroup<> group(&executor);
+    std::vector<SuspendedTask> tickets;
+    int completed = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        group.spawn(make_promise(
+            [&, runs = 0](Context& ctx) mutable -> Result<Void, Void> {
+                if (++runs == 1) {
+                    tickets.push_back(ctx.suspend_task());
+                    return Pending{};
+                }
+                ++completed;
+                return Ok(Void{});
+            }));
+    }
+
+    bool joined = false;
+    executor.schedule_task(PendingTask(group.join().and_then([&](const Void&) {
+        joined = true;
+        return Ok(Void{});
+    })));
+    executor.run_until_idle();
+    EXPECT_EQ(completed, 0);
+    EXPECT_EQ(group.active(), 3);
+    EXPECT_FALSE(joined);
+
+    executor.schedule_task(PendingTask(make_promise([&] {
+        for (auto& ticket : tickets) {
+            ticket.resume_task();
+        }
+        return Ok(Void{});
+    })));
+    executor.run();
+
+    EXPECT_EQ(completed, 3);
+    EXPECT_TRUE(joined);
+}
+
+TEST(TaskGroup, first_error_cancels_the_rest) {
+    SingleThreadedExecutor executor;
+    TaskGroup<int> group(&executor);
+    SuspendedTask ticket;
+    bool dropped = false;
+
+    // waits forever unless cancelled
+    group.spawn(make_promise(
+        [&, guard = std::make_shared<DropGuard>(&dropped)](
+            Context& ctx) -> Result<Void, int> {
+            ticket = ctx.suspend_task();
+            return Pending{};
+        }));
+    executor.run_until_idle();
+    EXPECT_FALSE(dropped);
+
+    group.spawn(make_promise([]() -> Result<Void, int> { return Err(1); }));
+    group.spawn(make_promise([]() -> Result<Void, int> { return Err(2); }));
+
+    Option<Result<Void, int>> joined;
+    executor.schedule_task(
+        PendingTask(group.join().then([&](Result<Void, int>& result) {
+            joined.emplace(std::move(result));
+            return Ok(Void{});
+        })));
+    executor.run();
+
+    EXPECT_TRUE(dropped);
+    EXPECT_TRUE(group.is_cancelled());
+    EXPECT_EQ(group.active(), 0);
+    ASSERT_TRUE(joined.has_value());
+    ASSERT_TRUE(joined.value().is_error());
+    EXPECT_EQ(joined.value().error(), 1);
+
+    // the late ones are dropped right away
+    group.spawn(make_promise([]() -> Result<Void, int> { return Ok(Void{}); }));
+    EXPECT_EQ(group.active(), 0);
+    EXPECT_EQ(group.spawned(), 3);
+}
+
+TEST(TaskGroup, cancellation) {
+    SingleThreadedExecutor executor;
+    bool dropped = false;
+    SuspendedTask ticket;
+
+    {
+        TaskGroup<> group(&executor);
+        group.spawn(make_promise(
+            [&, guard = std::make_shared<DropGuard>(&dropped)](
+                Context& ctx) -> Result<Void, Void> {
+                ticket = ctx.suspend_task();
+                return Pending{};
+            }));
+        executor.run_until_idle();
+        EXPECT_EQ(group.active(), 1);
+    }
+
+    // destroying the group cancelled its child
+    executor.run();
+    EXPECT_TRUE(dropped);
+
+    // the ticket outlives its child
+    ticket.resume_task();
+}
+
+TEST(TaskGroup, abandoned_children) {
+    SingleThreadedExecutor executor;
+    TaskGroup<> group(&executor);
+    bool dropped = false;
+
+    group.spawn(make_promise(
+        [&, guard = std::make_shared<DropGuard>(&dropped)](
+            Context& ctx) -> Result<Void, Void> {
+            // the ticket is released right away
+            ctx.suspend_task();
+            return Pending{};
+        }));
+
+    bool joined = false;
+    executor.schedule_task(PendingTask(group.join().and_then([&](const Void&) {
+        joined = true;
+        return Ok(Void{});
+    })));
+    executor.run();
+
+    EXPECT_TRUE(dropped);
+    EXPECT_TRUE(joined);
+    EXPECT_FALSE(group.is_cancelled());
+}
+
+TEST(TaskGroup, recycling_children) {
+    SingleThreadedExecutor executor;
+    TaskGroup<> group(&executor);
+    int completed = 0;
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            group.spawn(make_promise([&] {
+                ++completed;
+                return Ok(Void{});
+            }));
+        }
+        executor.run();
+        EXPECT_EQ(group.active(), 0);
+    }
+
+    EXPECT_EQ(completed, 12);
+    EXPECT_EQ(group.spawned(), 12);
+}
+
+TEST(TaskGroup, multiple_threads) {
+    constexpr int kChildren = 200;
+
+    SingleThreadedExecutor executor;
+    TaskGroup<int> group(&executor);
+    std::vector<SuspendedTask> tickets(kChildren);
+    std::atomic<int> completed{0};
+
+    for (int i = 0; i < kChildren; ++i) {
+        group.spawn(make_promise(
+            [&, i, runs = 0](Context& ctx) mutable -> Result<Void, int> {
+                if (++runs == 1) {
+                    tickets[i] = ctx.suspend_task();
+                    return Pending{};
+                }
+                completed.fetch_add(1);
+                return Ok(Void{});
+            }));
+    }
+    while (!executor.run_until_idle()) {
+    }
+    ASSERT_EQ(group.active(), kChildren);
+
+    bool joined = false;
+    executor.schedule_task(PendingTask(group.join().and_then([&](const Void&) {
+        joined = true;
+        return Ok(Void{});
+    })));
+
+    std::thread waker([&] {
+        for (auto& ticket : tickets) {
+            ticket.resume_task();
+        }
+    });
+    executor.run();
+    waker.join();
+
+    EXPECT_EQ(completed.load(), kChildren);
+    EXPECT_TRUE(joined);
+}
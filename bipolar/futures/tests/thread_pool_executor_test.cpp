@@ -0,0 +1,125 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bipolar/futures/single_threaded_executor.hpp"
+#include "bipolar/futures/thread_pool_executor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+TEST(ThreadPoolExecutor, running_tasks) {
+    constexpr int kTasks = 1000;
+
+    std::atomic<int> cnt{0};
+    {
+        ThreadPoolExecutor pool(4);
+        EXPECT_EQ(pool.thread_count(), 4);
+
+        // completes once every task ran, resumed from the workers
+        std::atomic<int> remaining{kTasks};
+        SingleThreadedExecutor executor;
+        SuspendedTask waiter;
+        std::mutex mtx;
+        executor.schedule_task(PendingTask(
+            make_promise([&](Context& ctx) -> Result<Void, Void> {
+                std::lock_guard lock(mtx);
+                if (remaining.load() == 0) {
+                    return Ok(Void{});
+                }
+                waiter = ctx.suspend_task();
+                return Pending{};
+            })));
+        executor.run_until_idle();
+
+        for (int i = 0; i < kTasks; ++i) {
+            pool.schedule_task(PendingTask(make_promise([&] {
+                cnt.fetch_add(1);
+                if (remaining.fetch_sub(1) == 1) {
+                    std::lock_guard lock(mtx);
+                    waiter.resume_task();
+                }
+                return Ok(Void{});
+            })));
+        }
+        executor.run();
+    }
+
+    EXPECT_EQ(cnt.load(), kTasks);
+}
+
+TEST(ThreadPoolExecutor, suspending_and_resuming_tasks) {
+    std::atomic<int> done{0};
+    std::vector<SuspendedTask> tickets(8);
+    std::atomic<int> suspended{0};
+
+    ThreadPoolExecutor pool(2);
+    for (int i = 0; i < 8; ++i) {
+        pool.schedule_task(PendingTask(
+            make_promise([&, i, runs = 0](Context& ctx) mutable
+                         -> Result<Void, Void> {
+                EXPECT_EQ(ctx.get_executor(), &pool);
+                if (++runs == 1) {
+                    tickets[i] = ctx.suspend_task();
+                    suspended.fetch_add(1);
+                    return Pending{};
+                }
+                done.fetch_add(1);
+                return Ok(Void{});
+            })));
+    }
+
+    while (suspended.load() < 8) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(done.load(), 0);
+
+    for (auto& ticket : tickets) {
+        ticket.resume_task();
+    }
+    while (done.load() < 8) {
+        std::this_thread::yield();
+    }
+}
+
+TEST(ThreadPoolExecutor, abandoning_tasks) {
+    std::atomic<int> destroyed{0};
+    struct Guard {
+        explicit Guard(std::atomic<int>* cnt) : cnt(cnt) {}
+        ~Guard() {
+            cnt->fetch_add(1);
+        }
+        std::atomic<int>* cnt;
+    };
+
+    SuspendedTask kept;
+    {
+        ThreadPoolExecutor pool(2);
+        std::atomic<int> polled{0};
+        for (int i = 0; i < 2; ++i) {
+            pool.schedule_task(PendingTask(
+                make_promise([&, i, guard = std::make_shared<Guard>(&destroyed)](
+                                 Context& ctx) -> Result<Void, Void> {
+                    if (i == 0) {
+                        // abandoned right away
+                        ctx.suspend_task();
+                    } else {
+                        // destroyed along with the executor
+                        kept = ctx.suspend_task();
+                    }
+                    polled.fetch_add(1);
+                    return Pending{};
+                })));
+        }
+
+        while (polled.load() < 2 || destroyed.load() < 1) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(destroyed.load(), 1);
+    }
+
+    EXPECT_EQ(destroyed.load(), 2);
+    // outlives the executor
+    kept.resume_task();
+}
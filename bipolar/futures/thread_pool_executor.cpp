@@ -0,0 +1,204 @@
+#include "bipolar/futures/thread_pool_executor.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+
+#include "bipolar/core/thread_safety.hpp"
+
+namespace bipolar {
+// The dispatcher runs tasks and provides the suspended task resolver.
+//
+// Same lifetime as the one of `SingleThreadedExecutor`: it's deleted by
+// `shutdown()`, or by the release of the last outstanding ticket after
+// that.
+class ThreadPoolExecutor::DispatcherImpl : public SuspendedTask::Resolver {
+public:
+    ~DispatcherImpl() {
+        std::lock_guard lock(mtx_);
+        assert(was_shutdown_);
+        assert(!scheduler_.has_runnable_tasks());
+        assert(!scheduler_.has_suspended_tasks());
+        assert(!scheduler_.has_outstanding_tickets());
+    }
+
+    // Makes the workers return once done with their current task
+    void stop() {
+        {
+            std::lock_guard lock(mtx_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+    }
+
+    // Must only be called once the workers returned
+    void shutdown() {
+        Scheduler::TaskQueue tasks;
+        {
+            std::lock_guard lock(mtx_);
+            assert(!was_shutdown_);
+            was_shutdown_ = true;
+            scheduler_.take_all_tasks(&tasks);
+            if (scheduler_.has_outstanding_tickets()) {
+                // cannot delete self yet
+                return;
+            }
+        }
+
+        delete this;
+    }
+
+    void schedule_task(PendingTask task) {
+        {
+            std::lock_guard lock(mtx_);
+            assert(!was_shutdown_);
+            scheduler_.schedule_task(std::move(task));
+            if (idle_workers_ == 0) {
+                // don't need to wake
+                return;
+            }
+        }
+
+        // It's more efficient to notify outside the lock
+        wake_.notify_one();
+    }
+
+    void run_worker(ContextImpl& ctx) {
+        Scheduler::TaskQueue tasks;
+        while (wait_for_runnable_task(&tasks)) {
+            run_task(&tasks.front(), ctx);
+            tasks.pop(); // the task may be destroyed here if it's not
+                         // suspended
+        }
+    }
+
+    // Must only be called while `run_task()` is running a task on the
+    // worker of `ctx`.
+    SuspendedTask suspend_current_task(ContextImpl& ctx) {
+        std::lock_guard lock(mtx_);
+        assert(!was_shutdown_);
+        if (ctx.ticket_ == 0) {
+            ctx.ticket_ = scheduler_.obtain_ticket(/*initial_refs = */ 2);
+        } else {
+            scheduler_.duplicate_ticket(ctx.ticket_);
+        }
+        return SuspendedTask(this, ctx.ticket_);
+    }
+
+    SuspendedTask::Ticket
+    duplicate_ticket(SuspendedTask::Ticket ticket) override {
+        std::lock_guard lock(mtx_);
+        scheduler_.duplicate_ticket(ticket);
+        return ticket;
+    }
+
+    void resolve_ticket(SuspendedTask::Ticket ticket,
+                        bool resume_task) override {
+        PendingTask abandoned_task;
+        {
+            std::lock_guard lock(mtx_);
+            if (resume_task) {
+                scheduler_.resume_task_with_ticket(ticket);
+            } else {
+                abandoned_task = scheduler_.release_ticket(ticket);
+            }
+
+            if (!was_shutdown_) {
+                if (idle_workers_ > 0 && scheduler_.has_runnable_tasks()) {
+                    // notified under the lock since the executor may be
+                    // destroyed as soon as the workers return
+                    wake_.notify_one();
+                }
+                return;
+            }
+            if (scheduler_.has_outstanding_tickets()) {
+                // cannot shutdown yet
+                return;
+            }
+        }
+
+        delete this;
+    }
+
+private:
+    // Returns false once the workers are stopping
+    bool wait_for_runnable_task(Scheduler::TaskQueue* tasks)
+        BIPOLAR_NO_THREAD_SAFETY_ANALYSIS {
+        std::unique_lock lock(mtx_);
+        while (!stopping_) {
+            // one at a time, leaving the others to the idle workers
+            scheduler_.take_runnable_tasks(tasks, 1);
+            if (!tasks->empty()) {
+                return true;
+            }
+
+            ++idle_workers_;
+            wake_.wait(lock);
+            --idle_workers_;
+        }
+        return false;
+    }
+
+    void run_task(PendingTask* task, ContextImpl& ctx) {
+        assert(ctx.ticket_ == 0);
+        (*task)(ctx);
+        if (ctx.ticket_ == 0) {
+            // task was not suspended, no ticket was produced
+            return;
+        }
+
+        bool wake = false;
+        {
+            std::lock_guard lock(mtx_);
+            assert(!was_shutdown_);
+            scheduler_.finalize_ticket(ctx.ticket_, task);
+            ctx.ticket_ = 0;
+            // resumed while running, possibly stays runnable for another
+            // worker
+            wake = idle_workers_ > 0 && scheduler_.has_runnable_tasks();
+        }
+        if (wake) {
+            wake_.notify_one();
+        }
+    }
+
+    std::condition_variable wake_;
+
+    // A bunch of state that is guarded by a mutex
+    mutable std::mutex mtx_;
+    bool was_shutdown_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    bool stopping_ BIPOLAR_GUARDED_BY(mtx_) = false;
+    std::size_t idle_workers_ BIPOLAR_GUARDED_BY(mtx_) = 0;
+    Scheduler scheduler_ BIPOLAR_GUARDED_BY(mtx_);
+};
+
+ThreadPoolExecutor::ThreadPoolExecutor(std::size_t threads)
+    : dispatcher_(new DispatcherImpl) {
+    assert(threads >= 1);
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] {
+            ContextImpl ctx(this);
+            dispatcher_->run_worker(ctx);
+        });
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    dispatcher_->stop();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    dispatcher_->shutdown();
+}
+
+void ThreadPoolExecutor::schedule_task(PendingTask task) {
+    assert(task);
+    dispatcher_->schedule_task(std::move(task));
+}
+
+SuspendedTask ThreadPoolExecutor::ContextImpl::suspend_task() {
+    return executor_->dispatcher_->suspend_current_task(*this);
+}
+
+} // namespace bipolar
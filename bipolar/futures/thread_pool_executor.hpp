@@ -0,0 +1,84 @@
+//! ThreadPoolExecutor
+//!
+//! See `ThreadPoolExecutor` for details.
+//!
+
+#ifndef BIPOLAR_FUTURES_THREAD_POOL_EXECUTOR_HPP_
+#define BIPOLAR_FUTURES_THREAD_POOL_EXECUTOR_HPP_
+
+#include "bipolar/futures/executor.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/scheduler.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace bipolar {
+/// A platform-independent multi-threaded asynchronous task executor.
+///
+/// A fixed number of worker threads, started by the constructor, poll the
+/// runnable tasks one at a time in priority order (see `Scheduler`). A task
+/// runs on one worker at a time, but may be resumed on any of them.
+///
+/// There's no `run()`: the workers run until the executor is destroyed.
+///
+/// See documentation of `Promise` for more information.
+class ThreadPoolExecutor final : public Executor, public boost::noncopyable {
+public:
+    /// Constructs an executor running `threads` worker threads.
+    ///
+    /// Preconditions:
+    /// - `threads` must be at least 1
+    explicit ThreadPoolExecutor(std::size_t threads = std::max(
+                                    1u, std::thread::hardware_concurrency()));
+
+    /// Waits for the tasks being polled, then stops the workers and destroys
+    /// the remaining tasks that have yet to complete
+    ~ThreadPoolExecutor() override;
+
+    /// Schedules a task for eventual execution by a worker.
+    ///
+    /// This method is thread-safe.
+    void schedule_task(PendingTask task) override;
+
+    /// Returns the number of worker threads
+    std::size_t thread_count() const noexcept {
+        return workers_.size();
+    }
+
+private:
+    class DispatcherImpl;
+
+    // The task context of a worker, for the task it runs
+    class ContextImpl : public Context {
+    public:
+        ContextImpl(ThreadPoolExecutor* executor) : executor_(executor) {}
+
+        ~ContextImpl() override = default;
+
+        ThreadPoolExecutor* get_executor() const override {
+            return executor_;
+        }
+
+        SuspendedTask suspend_task() override;
+
+    private:
+        friend class DispatcherImpl;
+
+        ThreadPoolExecutor* const executor_;
+        // the ticket of the running task, 0 if it wasn't suspended
+        SuspendedTask::Ticket ticket_ = 0;
+    };
+
+    DispatcherImpl* const dispatcher_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,24 @@
+#include "bipolar/io/async_tcp.hpp"
+
+#include "bipolar/io/internal/blocking.hpp"
+
+namespace bipolar {
+AsyncTcpStream::AsyncTcpStream(IOUring& ring, TcpStream stream) noexcept
+    : ring_(&ring), stream_(std::move(stream)) {
+    internal::set_blocking(stream_.as_fd());
+}
+
+AsyncTcpListener::AsyncTcpListener(IOUring& ring,
+                                   TcpListener listener) noexcept
+    : ring_(&ring), listener_(std::move(listener)) {
+    internal::set_blocking(listener_.as_fd());
+}
+
+Result<AsyncTcpListener, int>
+AsyncTcpListener::bind(IOUring& ring, const SocketAddress& sa) noexcept {
+    return TcpListener::bind(sa).map([&ring](TcpListener&& listener) {
+        return AsyncTcpListener(ring, std::move(listener));
+    });
+}
+
+} // namespace bipolar
@@ -0,0 +1,221 @@
+/// \file async_tcp.hpp
+/// TCP sockets driven by \c IOUring
+///
+/// - \c AsyncTcpStream
+/// - \c AsyncTcpListener
+
+#ifndef BIPOLAR_IO_ASYNC_TCP_HPP_
+#define BIPOLAR_IO_ASYNC_TCP_HPP_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "bipolar/core/movable.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/io/io_uring.hpp"
+#include "bipolar/io/io_uring_promise.hpp"
+#include "bipolar/net/compact_socket_address.hpp"
+#include "bipolar/net/socket_address.hpp"
+#include "bipolar/net/tcp.hpp"
+
+namespace bipolar {
+/// \class AsyncTcpStream
+/// \brief A \c TcpStream whose I/O is submitted to an \c IOUring.
+///
+/// Every operation returns a promise, which submits its SQE once polled
+/// and produces a \c Result with the errno on failure.
+/// \see make_io_uring_promise
+///
+/// \code
+/// AsyncTcpStream::connect(ring, addr)
+///     .and_then([buf](AsyncTcpStream& stream) {
+///         return stream.write(buf, 4);
+///     });
+/// \endcode
+///
+/// \note The stream and the buffers must outlive the operations
+class AsyncTcpStream final : public Movable {
+public:
+    /// \brief Wraps \c stream, moving it to blocking mode: io_uring reports
+    /// \c EAGAIN on nonblocking sockets instead of waiting for readiness
+    AsyncTcpStream(IOUring& ring, TcpStream stream) noexcept;
+
+    /// \brief Connects a new TCP stream to \c sa, whose socket is opened
+    /// once polled
+    /// \return a promise of <tt>Result<AsyncTcpStream, int></tt>
+    static auto connect(IOUring& ring, const SocketAddress& sa) {
+        return make_io_uring_promise(
+            ring,
+            [sa](IOUringSQE& sqe, IOUringCompletion& op) -> int {
+                op.addr = NativeSocketAddress(sa);
+                op.fd = ::socket(op.addr.family(), SOCK_STREAM | SOCK_CLOEXEC,
+                                 0);
+                if (op.fd == -1) {
+                    return errno;
+                }
+                sqe.connect(op.fd, op.addr.get(), op.addr.size());
+                return 0;
+            },
+            [ring = &ring](
+                IOUringCompletion& op) -> Result<AsyncTcpStream, int> {
+                if (op.res < 0) {
+                    return Err(-op.res);
+                }
+                return Ok(AsyncTcpStream(
+                    *ring, TcpStream(std::exchange(op.fd, -1))));
+            });
+    }
+
+    /// \brief Sends data to the peer
+    /// \return a promise of the number of bytes written
+    auto send(const void* buf, std::size_t len, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_, [fd = fd(), buf, len, flags](IOUringSQE& sqe,
+                                                 IOUringCompletion&) {
+                sqe.send(fd, buf, len, flags);
+            });
+    }
+
+    /// \brief An alias of \c send
+    auto write(const void* buf, std::size_t len) {
+        return send(buf, len);
+    }
+
+    /// \brief Sends data to the peer
+    /// \return a promise of the number of bytes written
+    auto writev(const struct iovec* iov, std::size_t vlen) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), iov, vlen](IOUringSQE& sqe, IOUringCompletion&) {
+                sqe.writev(fd, iov, vlen, 0);
+            });
+    }
+
+    /// \brief Sends a message to the peer
+    /// \return a promise of the number of bytes written
+    auto sendmsg(const struct msghdr* msg, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), msg, flags](IOUringSQE& sqe, IOUringCompletion&) {
+                sqe.sendmsg(fd, msg, 1);
+                sqe.msg_flags = flags;
+            });
+    }
+
+    /// \brief Receives data from the peer
+    /// \return a promise of the number of bytes read, 0 on EOF
+    auto recv(void* buf, std::size_t len, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_, [fd = fd(), buf, len, flags](IOUringSQE& sqe,
+                                                 IOUringCompletion&) {
+                sqe.recv(fd, buf, len, flags);
+            });
+    }
+
+    /// \brief An alias of \c recv
+    auto read(void* buf, std::size_t len) {
+        return recv(buf, len);
+    }
+
+    /// \brief Receives data from the peer
+    /// \return a promise of the number of bytes read, 0 on EOF
+    auto readv(struct iovec* iov, std::size_t vlen) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), iov, vlen](IOUringSQE& sqe, IOUringCompletion&) {
+                sqe.readv(fd, iov, vlen, 0);
+            });
+    }
+
+    /// \brief Receives a message from the peer
+    /// \return a promise of the number of bytes read, 0 on EOF
+    auto recvmsg(struct msghdr* msg, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), msg, flags](IOUringSQE& sqe, IOUringCompletion&) {
+                sqe.recvmsg(fd, msg, 1);
+                sqe.msg_flags = flags;
+            });
+    }
+
+    /// \brief Returns the synchronous stream, for options and addresses
+    TcpStream& stream() noexcept {
+        return stream_;
+    }
+
+    /// \brief Returns the ring
+    IOUring& ring() const noexcept {
+        return *ring_;
+    }
+
+private:
+    int fd() const noexcept {
+        return stream_.as_fd();
+    }
+
+    IOUring* ring_;
+    TcpStream stream_;
+};
+
+/// \class AsyncTcpListener
+/// \brief A \c TcpListener accepting connections through an \c IOUring
+///
+/// \note The listener must outlive the \c accept promises
+class AsyncTcpListener final : public Movable {
+public:
+    /// \brief Wraps \c listener, moving it to blocking mode
+    /// \see AsyncTcpStream::AsyncTcpStream
+    AsyncTcpListener(IOUring& ring, TcpListener listener) noexcept;
+
+    /// \brief Binds a new TCP listener to \c sa
+    /// \see TcpListener::bind
+    static Result<AsyncTcpListener, int> bind(IOUring& ring,
+                                              const SocketAddress& sa) noexcept;
+
+    /// \brief Accepts a new connection
+    /// \return a promise of <tt>Result<std::tuple<AsyncTcpStream,
+    /// SocketAddress>, int></tt>
+    auto accept() {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = listener_.as_fd()](IOUringSQE& sqe, IOUringCompletion& op) {
+                sqe.accept(fd, op.addr.get(), &op.addrlen, SOCK_CLOEXEC);
+            },
+            [ring = ring_](IOUringCompletion& op)
+                -> Result<std::tuple<AsyncTcpStream, SocketAddress>, int> {
+                if (op.res < 0) {
+                    return Err(-op.res);
+                }
+
+                AsyncTcpStream stream(*ring, TcpStream(op.res));
+                auto addr = op.addr.to_socket_address(op.addrlen);
+                if (addr.is_error()) {
+                    return Err(addr.error());
+                }
+                return Ok(std::make_tuple(std::move(stream), addr.value()));
+            });
+    }
+
+    /// \brief Returns the synchronous listener, for options and addresses
+    TcpListener& listener() noexcept {
+        return listener_;
+    }
+
+    /// \brief Returns the ring
+    IOUring& ring() const noexcept {
+        return *ring_;
+    }
+
+private:
+    IOUring* ring_;
+    TcpListener listener_;
+};
+
+} // namespace bipolar
+
+#endif
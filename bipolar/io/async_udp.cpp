@@ -0,0 +1,18 @@
+#include "bipolar/io/async_udp.hpp"
+
+#include "bipolar/io/internal/blocking.hpp"
+
+namespace bipolar {
+AsyncUdpSocket::AsyncUdpSocket(IOUring& ring, UdpSocket socket) noexcept
+    : ring_(&ring), socket_(std::move(socket)) {
+    internal::set_blocking(socket_.as_fd());
+}
+
+Result<AsyncUdpSocket, int>
+AsyncUdpSocket::bind(IOUring& ring, const SocketAddress& sa) noexcept {
+    return UdpSocket::bind(sa).map([&ring](UdpSocket&& socket) {
+        return AsyncUdpSocket(ring, std::move(socket));
+    });
+}
+
+} // namespace bipolar
@@ -0,0 +1,167 @@
+/// \file async_udp.hpp
+/// UDP sockets driven by \c IOUring
+
+#ifndef BIPOLAR_IO_ASYNC_UDP_HPP_
+#define BIPOLAR_IO_ASYNC_UDP_HPP_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+#include "bipolar/core/movable.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/io/io_uring.hpp"
+#include "bipolar/io/io_uring_promise.hpp"
+#include "bipolar/net/compact_socket_address.hpp"
+#include "bipolar/net/socket_address.hpp"
+#include "bipolar/net/udp.hpp"
+
+namespace bipolar {
+/// \class AsyncUdpSocket
+/// \brief A \c UdpSocket whose I/O is submitted to an \c IOUring.
+///
+/// Every operation returns a promise, which submits its SQE once polled
+/// and produces a \c Result with the errno on failure.
+/// \see make_io_uring_promise
+///
+/// \note The socket and the buffers must outlive the operations
+class AsyncUdpSocket final : public Movable {
+public:
+    /// \brief Wraps \c socket, moving it to blocking mode: io_uring reports
+    /// \c EAGAIN on nonblocking sockets instead of waiting for readiness
+    AsyncUdpSocket(IOUring& ring, UdpSocket socket) noexcept;
+
+    /// \brief Binds a new UDP socket to \c sa
+    /// \see UdpSocket::bind
+    static Result<AsyncUdpSocket, int> bind(IOUring& ring,
+                                            const SocketAddress& sa) noexcept;
+
+    /// \brief Sends data to the connected peer
+    /// \return a promise of the number of bytes written
+    auto send(const void* buf, std::size_t len, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_, [fd = fd(), buf, len, flags](IOUringSQE& sqe,
+                                                 IOUringCompletion&) {
+                sqe.send(fd, buf, len, flags);
+            });
+    }
+
+    /// \brief An alias of \c send
+    auto write(const void* buf, std::size_t len) {
+        return send(buf, len);
+    }
+
+    /// \brief Sends data to \c sa
+    /// \return a promise of the number of bytes written
+    auto send_to(const void* buf, std::size_t len, const SocketAddress& sa,
+                 int flags = 0) {
+        return make_io_uring_promise(
+            *ring_, [fd = fd(), buf, len, sa, flags](IOUringSQE& sqe,
+                                                     IOUringCompletion& op) {
+                op.addr = NativeSocketAddress(sa);
+                op.iov = {const_cast<void*>(buf), len};
+                std::memset(&op.msg, 0, sizeof(op.msg));
+                op.msg.msg_name = op.addr.get();
+                op.msg.msg_namelen = op.addr.size();
+                op.msg.msg_iov = &op.iov;
+                op.msg.msg_iovlen = 1;
+                sqe.sendmsg(fd, &op.msg, 1);
+                sqe.msg_flags = flags;
+            });
+    }
+
+    /// \brief Sends a message
+    /// \return a promise of the number of bytes written
+    auto sendmsg(const struct msghdr* msg, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), msg, flags](IOUringSQE& sqe, IOUringCompletion&) {
+                sqe.sendmsg(fd, msg, 1);
+                sqe.msg_flags = flags;
+            });
+    }
+
+    /// \brief Receives a datagram from the connected peer
+    /// \return a promise of the number of bytes read
+    auto recv(void* buf, std::size_t len, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_, [fd = fd(), buf, len, flags](IOUringSQE& sqe,
+                                                 IOUringCompletion&) {
+                sqe.recv(fd, buf, len, flags);
+            });
+    }
+
+    /// \brief An alias of \c recv
+    auto read(void* buf, std::size_t len) {
+        return recv(buf, len);
+    }
+
+    /// \brief Receives a datagram
+    /// \return a promise of <tt>Result<std::tuple<std::size_t,
+    /// SocketAddress>, int></tt>, the number of bytes read and the sender
+    auto recv_from(void* buf, std::size_t len, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), buf, len, flags](IOUringSQE& sqe,
+                                         IOUringCompletion& op) {
+                op.iov = {buf, len};
+                std::memset(&op.msg, 0, sizeof(op.msg));
+                op.msg.msg_name = op.addr.get();
+                op.msg.msg_namelen = NativeSocketAddress::capacity();
+                op.msg.msg_iov = &op.iov;
+                op.msg.msg_iovlen = 1;
+                sqe.recvmsg(fd, &op.msg, 1);
+                sqe.msg_flags = flags;
+            },
+            [](IOUringCompletion& op)
+                -> Result<std::tuple<std::size_t, SocketAddress>, int> {
+                if (op.res < 0) {
+                    return Err(-op.res);
+                }
+
+                auto addr = op.addr.to_socket_address(op.msg.msg_namelen);
+                if (addr.is_error()) {
+                    return Err(addr.error());
+                }
+                return Ok(std::make_tuple(static_cast<std::size_t>(op.res),
+                                          addr.value()));
+            });
+    }
+
+    /// \brief Receives a message
+    /// \return a promise of the number of bytes read
+    auto recvmsg(struct msghdr* msg, int flags = 0) {
+        return make_io_uring_promise(
+            *ring_,
+            [fd = fd(), msg, flags](IOUringSQE& sqe, IOUringCompletion&) {
+                sqe.recvmsg(fd, msg, 1);
+                sqe.msg_flags = flags;
+            });
+    }
+
+    /// \brief Returns the synchronous socket, for options and addresses
+    UdpSocket& socket() noexcept {
+        return socket_;
+    }
+
+    /// \brief Returns the ring
+    IOUring& ring() const noexcept {
+        return *ring_;
+    }
+
+private:
+    int fd() const noexcept {
+        return socket_.as_fd();
+    }
+
+    IOUring* ring_;
+    UdpSocket socket_;
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,52 @@
+#include "bipolar/io/io_uring.hpp"
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+using namespace bipolar;
+
+namespace {
+// Queue depths × kernel mapped or hugepage rings
+void depths(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"depth", "huge_pages"});
+    for (const std::int64_t depth : {256, 4096, 32768}) {
+        b->Args({depth, 0});
+        b->Args({depth, 1});
+    }
+}
+
+} // namespace
+
+// Fills the whole SQ with NOPs, submits them at once, then reaps every CQE,
+// so that SQE writes and CQE reads sweep the rings
+static void BM_SubmitReap(benchmark::State& state) {
+    const auto depth = static_cast<unsigned>(state.range(0));
+    IOUringOptions options;
+    options.entries = depth;
+    options.huge_pages = state.range(1);
+    IOUring ring(options);
+    if (options.huge_pages && !ring.huge_pages()) {
+        state.SkipWithError("no hugepage reserved, see vm.nr_hugepages");
+        return;
+    }
+
+    for (auto _ : state) {
+        for (unsigned i = 0; i < depth; ++i) {
+            IOUringSQE& sqe = ring.get_submission_entry().value();
+            sqe.nop();
+            sqe.user_data = i;
+        }
+        ring.submit(depth);
+
+        std::uint64_t sum = 0;
+        for (unsigned i = 0; i < depth; ++i) {
+            auto cqe = ring.get_completion_entry();
+            sum += cqe.value().get().user_data;
+            ring.seen(1);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_SubmitReap)->Apply(depths);
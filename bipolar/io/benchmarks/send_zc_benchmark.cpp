@@ -0,0 +1,131 @@
+#include "bipolar/io/io_uring_send_buffers.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bipolar;
+
+namespace {
+constexpr std::size_t kBuffers = 16;
+
+// A TCP connection over loopback whose receiving side is drained by a
+// thread
+class Connection {
+public:
+    explicit Connection(std::size_t size) {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrlen = sizeof(addr);
+        if (listener < 0 ||
+            bind(listener, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+            listen(listener, 1) < 0 ||
+            getsockname(listener, (struct sockaddr*)&addr, &addrlen) < 0) {
+            std::abort();
+        }
+
+        sender_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(sender_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            std::abort();
+        }
+        receiver_ = accept(listener, nullptr, nullptr);
+        close(listener);
+
+        drainer_ = std::thread([fd = receiver_, size] {
+            std::vector<char> buf(size);
+            while (read(fd, buf.data(), buf.size()) > 0) {
+            }
+        });
+    }
+
+    ~Connection() {
+        shutdown(sender_, SHUT_WR);
+        drainer_.join();
+        close(sender_);
+        close(receiver_);
+    }
+
+    int sender() const noexcept {
+        return sender_;
+    }
+
+private:
+    int sender_;
+    int receiver_;
+    std::thread drainer_;
+};
+
+// Sends `kBuffers` buffers per batch, then waits for their last CQEs
+template <typename Prep>
+void send_batches(benchmark::State& state, Prep prep) {
+    const std::size_t size = state.range(0);
+    struct io_uring_params p {};
+    IOUring ring(kBuffers, &p);
+    ring.set_cq_high_watermark(kBuffers);
+    IOUringSendBuffers buffers(kBuffers, size);
+    for (std::uint16_t i = 0; i < kBuffers; ++i) {
+        std::memset(buffers.data(i), 'x', size);
+    }
+    Connection conn(size);
+
+    for (auto _ : state) {
+        while (auto index = buffers.acquire()) {
+            IOUringSQE sqe;
+            prep(sqe, conn.sender(), index.value(),
+                 buffers.data(index.value()), size);
+            sqe.user_data = index.value();
+            ring.queue_submission_entry(sqe);
+        }
+        ring.submit();
+
+        while (buffers.available() < kBuffers) {
+            auto res = ring.get_completion_entry();
+            if (res.is_error()) {
+                state.SkipWithError("get_completion_entry failed");
+                return;
+            }
+            IOUringCQE& cqe = res.value();
+            if (cqe.res < 0) {
+                state.SkipWithError(std::strerror(-cqe.res));
+                return;
+            }
+            buffers.complete(cqe, cqe.user_data);
+            ring.seen(1);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * kBuffers * size);
+}
+
+void BM_writev(benchmark::State& state) {
+    // read when submitted
+    struct iovec iovs[kBuffers];
+    send_batches(state, [&iovs](IOUringSQE& sqe, int fd, std::uint16_t index,
+                                void* buf, std::size_t size) {
+        iovs[index].iov_base = buf;
+        iovs[index].iov_len = size;
+        sqe.writev(fd, &iovs[index], 1, 0);
+    });
+}
+
+void BM_send_zc(benchmark::State& state) {
+    send_batches(state, [](IOUringSQE& sqe, int fd, std::uint16_t,
+                           void* buf, std::size_t size) {
+        sqe.send_zc(fd, buf, size, 0);
+    });
+}
+
+} // namespace
+
+BENCHMARK(BM_writev)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+BENCHMARK(BM_send_zc)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
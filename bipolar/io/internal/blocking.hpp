@@ -0,0 +1,20 @@
+#ifndef BIPOLAR_IO_INTERNAL_BLOCKING_HPP_
+#define BIPOLAR_IO_INTERNAL_BLOCKING_HPP_
+
+#include <fcntl.h>
+
+namespace bipolar {
+namespace internal {
+// io_uring completes operations on nonblocking sockets with `EAGAIN`
+// instead of waiting for their readiness
+inline void set_blocking(int fd) noexcept {
+    const int flags = ::fcntl(fd, F_GETFL);
+    if (flags != -1 && (flags & O_NONBLOCK)) {
+        ::fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+    }
+}
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
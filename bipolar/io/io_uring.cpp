@@ -3,23 +3,212 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include <cerrno>
 #include <cstring>
 #include <cassert>
+#include <iterator>
 #include <system_error>
+#include <thread>
+#include <tuple>
 
 
 namespace bipolar {
+namespace {
+struct __kernel_timespec to_kernel_timespec(std::chrono::nanoseconds d) {
+    struct __kernel_timespec ts {};
+    ts.tv_sec = d.count() / 1000000000;
+    ts.tv_nsec = d.count() % 1000000000;
+    return ts;
+}
+
+constexpr std::size_t kHugePageSize = 2 << 20;
+constexpr int kMapHuge2MB = 21 << MAP_HUGE_SHIFT;
+
+// An upper bound of struct io_rings, which precedes the CQEs
+constexpr std::size_t kRingsHeaderSize = 1024;
+
+unsigned round_up_pow2(unsigned n) {
+    unsigned x = 1;
+    while (x < n) {
+        x <<= 1;
+    }
+    return x;
+}
+
+void* map_huge_page() {
+    return mmap(nullptr, kHugePageSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_ANONYMOUS | MAP_HUGETLB | kMapHuge2MB |
+                    MAP_POPULATE,
+                -1, 0);
+}
+
+// The IORING_SETUP_* flags asked by the options
+std::uint32_t requested_flags(const IOUringOptions& options) {
+    std::uint32_t flags = 0;
+    if (options.huge_pages) {
+        flags |= IORING_SETUP_NO_MMAP;
+    }
+    if (options.cq_entries) {
+        flags |= IORING_SETUP_CQSIZE;
+    }
+    if (options.coop_taskrun) {
+        flags |= IORING_SETUP_COOP_TASKRUN;
+    }
+    if (options.single_issuer || options.defer_taskrun) {
+        flags |= IORING_SETUP_SINGLE_ISSUER;
+    }
+    if (options.defer_taskrun) {
+        flags |= IORING_SETUP_DEFER_TASKRUN;
+    }
+    return flags;
+}
+
+// Sets up the ring, dropping the modes unknown to the kernel from the
+// newest one. Returns the ring fd or -errno like io_uring_setup, that of
+// the requested flags if it isn't caused by an unknown mode.
+int setup(const IOUringOptions& options, struct io_uring_params* p,
+          IOUringRingMemory& memory) {
+    // or it'd be taken for an unknown flag
+    if (options.cq_entries && options.cq_entries < options.entries) {
+        return -EINVAL;
+    }
+
+    std::uint32_t flags = requested_flags(options) & ~IORING_SETUP_NO_MMAP;
+    if (options.huge_pages) {
+        const unsigned sq_entries = round_up_pow2(options.entries);
+        const unsigned cq_entries = options.cq_entries
+                                        ? round_up_pow2(options.cq_entries)
+                                        : sq_entries * 2;
+        if (auto res = IOUringRingMemory::allocate(sq_entries, cq_entries);
+            res.is_ok()) {
+            memory = std::move(res.value());
+            flags |= IORING_SETUP_NO_MMAP;
+            p->sq_off.user_addr = (std::uint64_t)memory.sqes();
+            p->cq_off.user_addr = (std::uint64_t)memory.rings();
+        }
+    }
+    p->cq_entries = options.cq_entries;
+
+    // Linux 6.5, 6.1, 6.0 then 5.19. IORING_SETUP_CQSIZE isn't a mode: an
+    // unknown one would silently shrink the CQ.
+    constexpr std::uint32_t fallbacks[] = {
+        IORING_SETUP_NO_MMAP,
+        IORING_SETUP_DEFER_TASKRUN,
+        IORING_SETUP_SINGLE_ISSUER,
+        IORING_SETUP_COOP_TASKRUN,
+    };
+    int err = 0;
+    for (std::size_t i = 0;; ++i) {
+        p->flags = flags;
+        const int ret = io_uring_setup(options.entries, p);
+        if (ret >= 0) {
+            return ret;
+        }
+        // the kernel may also refuse the memory, e.g. before Linux 6.13 the
+        // rings must fit in a single hugepage
+        if (ret != -EINVAL && !(flags & IORING_SETUP_NO_MMAP)) {
+            return ret;
+        }
+        if (err == 0) {
+            err = ret;
+        }
+
+        while (i < std::size(fallbacks) && !(flags & fallbacks[i])) {
+            ++i;
+        }
+        if (i == std::size(fallbacks)) {
+            // rejected regardless of the modes, e.g. too many entries
+            return err;
+        }
+        flags &= ~fallbacks[i];
+        if (!(flags & IORING_SETUP_NO_MMAP)) {
+            memory = IOUringRingMemory();
+        }
+        std::memset(p, 0, sizeof(*p));
+        p->cq_entries = options.cq_entries;
+    }
+}
+
+// Throws if io_uring_setup failed
+int check_setup(int fd) {
+    if (fd < 0) {
+        throw std::system_error(-fd, std::system_category());
+    }
+    return fd;
+}
+
+// io_uring_register returns -errno, and leaves errno alone
+Result<Void, int> register_op(int fd, unsigned opcode, const void* arg,
+                              unsigned nr_args) {
+    const int ret = io_uring_register(fd, opcode, arg, nr_args);
+    if (ret < 0) {
+        return Err(-ret);
+    }
+    return Ok(Void{});
+}
+
+} // namespace
+
+Result<IOUringRingMemory, int>
+IOUringRingMemory::allocate(unsigned sq_entries, unsigned cq_entries) noexcept {
+    const std::size_t page_size = sysconf(_SC_PAGESIZE);
+    const std::size_t sqes_size =
+        (sq_entries * sizeof(IOUringSQE) + page_size - 1) & ~(page_size - 1);
+    const std::size_t rings_size = kRingsHeaderSize +
+                                   cq_entries * sizeof(IOUringCQE) +
+                                   sq_entries * sizeof(std::uint32_t);
+    if (sqes_size > kHugePageSize || rings_size > kHugePageSize) {
+        return Err(EINVAL);
+    }
+
+    IOUringRingMemory memory;
+    void* ptr = map_huge_page();
+    if (ptr == MAP_FAILED) {
+        return Err(errno);
+    }
+    memory.sqes_ = ptr;
+    memory.sqes_size_ = kHugePageSize;
+
+    if (sqes_size + rings_size <= kHugePageSize) {
+        memory.rings_ = (char*)ptr + sqes_size;
+        return Ok(std::move(memory));
+    }
+
+    ptr = map_huge_page();
+    if (ptr == MAP_FAILED) {
+        return Err(errno);
+    }
+    memory.rings_ = ptr;
+    memory.rings_size_ = kHugePageSize;
+    return Ok(std::move(memory));
+}
+
+IOUringRingMemory::~IOUringRingMemory() {
+    if (rings_size_) {
+        munmap(rings_, rings_size_);
+    }
+    if (sqes_size_) {
+        munmap(sqes_, sqes_size_);
+    }
+}
+
 IOUringSQ::IOUringSQ(int fd, const struct io_uring_params* p) {
     assert(p);
 
-    ring_sz_ = p->sq_off.array + p->sq_entries * sizeof(std::uint32_t);
-    ring_ptr_ = mmap(0, ring_sz_, PROT_READ | PROT_WRITE,
-                     MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
-    if (ring_ptr_ == MAP_FAILED) {
-        throw std::system_error(errno, std::system_category());
+    if (p->flags & IORING_SETUP_NO_MMAP) {
+        // owned by IOUringRingMemory
+        ring_sz_ = 0;
+        ring_ptr_ = (void*)p->cq_off.user_addr;
+    } else {
+        ring_sz_ = p->sq_off.array + p->sq_entries * sizeof(std::uint32_t);
+        ring_ptr_ = mmap(0, ring_sz_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (ring_ptr_ == MAP_FAILED) {
+            throw std::system_error(errno, std::system_category());
+        }
     }
 
     char* ptr = (char*)ring_ptr_;
@@ -31,8 +220,13 @@ IOUringSQ::IOUringSQ(int fd, const struct io_uring_params* p) {
     kdropped_ = (std::uint32_t*)(ptr + p->sq_off.dropped);
     array_ = (std::uint32_t*)(ptr + p->sq_off.array);
 
-    const std::size_t size = p->sq_entries * sizeof(IOUringSQE);
     sqe_head_ = sqe_tail_ = 0;
+    if (!ring_sz_) {
+        sqes_ = (IOUringSQE*)p->sq_off.user_addr;
+        return;
+    }
+
+    const std::size_t size = p->sq_entries * sizeof(IOUringSQE);
     sqes_ = (IOUringSQE*)mmap(0, size, PROT_READ | PROT_WRITE,
                               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
     if (sqes_ == MAP_FAILED) {
@@ -43,6 +237,9 @@ IOUringSQ::IOUringSQ(int fd, const struct io_uring_params* p) {
 }
 
 IOUringSQ::~IOUringSQ() {
+    if (!ring_sz_) {
+        return;
+    }
     munmap(sqes_, *kring_entries_ * sizeof(IOUringSQE));
     munmap(ring_ptr_, ring_sz_);
 }
@@ -50,11 +247,17 @@ IOUringSQ::~IOUringSQ() {
 IOUringCQ::IOUringCQ(int fd, const struct io_uring_params* p) {
     assert(p);
 
-    ring_sz_ = p->cq_off.cqes + p->cq_entries * sizeof(IOUringCQE);
-    ring_ptr_ = mmap(0, ring_sz_, PROT_READ | PROT_WRITE,
-                     MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
-    if (ring_ptr_ == MAP_FAILED) {
-        throw std::system_error(errno, std::system_category());
+    if (p->flags & IORING_SETUP_NO_MMAP) {
+        // owned by IOUringRingMemory
+        ring_sz_ = 0;
+        ring_ptr_ = (void*)p->cq_off.user_addr;
+    } else {
+        ring_sz_ = p->cq_off.cqes + p->cq_entries * sizeof(IOUringCQE);
+        ring_ptr_ = mmap(0, ring_sz_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring_ptr_ == MAP_FAILED) {
+            throw std::system_error(errno, std::system_category());
+        }
     }
 
     char* ptr = (char*)ring_ptr_;
@@ -67,98 +270,325 @@ IOUringCQ::IOUringCQ(int fd, const struct io_uring_params* p) {
 }
 
 IOUringCQ::~IOUringCQ() {
-    munmap(ring_ptr_, ring_sz_);
+    if (ring_sz_) {
+        munmap(ring_ptr_, ring_sz_);
+    }
 }
 
 IOUring::IOUring(unsigned entries, struct io_uring_params* p)
-    : ring_fd_(({
-          int ret = io_uring_setup(entries, (assert(p), p)); // a tricky assert
-          if (ret == -1) {
-              throw std::system_error(errno, std::system_category());
-          }
-          ret;
-      })),
-      flags_(p->flags), sq_(ring_fd_, p), cq_(ring_fd_, p) {}
+    : IOUring(check_setup(io_uring_setup(entries, (assert(p), p))), *p) {}
+
+IOUring::IOUring(const IOUringOptions& options, struct io_uring_params&& p,
+                 IOUringRingMemory&& memory)
+    : IOUring(check_setup(setup(options, &p, memory)), p) {
+    ring_memory_ = std::move(memory);
+    dropped_flags_ = requested_flags(options) & ~flags_;
+    if (!options.register_ring_fd) {
+        return;
+    }
+
+    // Falls back to the plain fd
+    struct io_uring_rsrc_update update {};
+    update.offset = -1U;
+    update.data = ring_fd_;
+    const int ret =
+        io_uring_register(ring_fd_, IORING_REGISTER_RING_FDS, &update, 1);
+    if (ret == 1) {
+        enter_fd_ = update.offset;
+        ring_fd_registered_ = true;
+        registering_thread_ = std::this_thread::get_id();
+    }
+}
+
+IOUring::IOUring(int ring_fd, const struct io_uring_params& p)
+    : ring_fd_(ring_fd), flags_(p.flags), features_(p.features),
+      sq_(ring_fd_, &p), cq_(ring_fd_, &p), enter_fd_(ring_fd_),
+      ring_fd_registered_(false), dropped_flags_(0), inflight_(0),
+      cq_high_watermark_(*cq_.kring_entries_), cq_counted_(*cq_.khead_),
+      cq_reserved_(0) {}
 
 IOUring::~IOUring() {
+    // The registered fds are per thread, so only the registering thread can
+    // unregister it. Otherwise the ring lives as long as that thread.
+    if (ring_fd_registered_ &&
+        registering_thread_ == std::this_thread::get_id()) {
+        struct io_uring_rsrc_update update {};
+        update.offset = enter_fd_;
+        io_uring_register(ring_fd_, IORING_UNREGISTER_RING_FDS, &update, 1);
+    }
     close(ring_fd_);
 }
 
+int IOUring::enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+                   const void* arg, std::size_t argsz) {
+    if (ring_fd_registered_) {
+        flags |= IORING_ENTER_REGISTERED_RING;
+    }
+    const int ret = syscall(__NR_io_uring_enter, enter_fd_, to_submit,
+                            min_complete, flags, arg, argsz);
+    metrics_.on_enter(ret < 0 ? errno : 0);
+    return ret;
+}
+
 Result<Void, int> IOUring::register_buffer(const struct iovec* iovecs,
                                            std::size_t n) {
-    if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, iovecs, n) < 0) {
-        return Err(errno);
-    }
-    return Ok(Void{});
+    return register_op(ring_fd_, IORING_REGISTER_BUFFERS, iovecs, n);
 }
 
 Result<Void, int> IOUring::unregister_buffer() {
-    if (io_uring_register(ring_fd_, IORING_UNREGISTER_BUFFERS, NULL, 0) < 0) {
-        return Err(errno);
-    }
-    return Ok(Void{});
+    return register_op(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
 }
 
 Result<Void, int> IOUring::register_files(const int *files, std::size_t n) {
-    if (io_uring_register(ring_fd_, IORING_REGISTER_FILES, files, n) < 0) {
-        return Err(errno);
-    }
-    return Ok(Void{});
+    return register_op(ring_fd_, IORING_REGISTER_FILES, files, n);
 }
 
 Result<Void, int> IOUring::unregister_files() {
-    if (io_uring_register(ring_fd_, IORING_UNREGISTER_FILES, NULL, 0) < 0) {
-        return Err(errno);
-    }
-    return Ok(Void{});
+    return register_op(ring_fd_, IORING_UNREGISTER_FILES, nullptr, 0);
+}
+
+Result<Void, int> IOUring::update_files(std::uint32_t offset,
+                                       const int files[], std::size_t n) {
+    struct io_uring_files_update update {};
+    update.offset = offset;
+    update.fds = (std::uint64_t)files;
+    return register_op(ring_fd_, IORING_REGISTER_FILES_UPDATE, &update, n);
 }
 
 Result<Void, int> IOUring::register_eventfd(int evfd) {
-    if (io_uring_register(ring_fd_, IORING_REGISTER_EVENTFD, &evfd, 1) < 0) {
-        return Err(errno);
-    }
-    return Ok(Void{});
+    return register_op(ring_fd_, IORING_REGISTER_EVENTFD, &evfd, 1);
 }
 
 Result<Void, int> IOUring::unregister_eventfd() {
-    if (io_uring_register(ring_fd_, IORING_UNREGISTER_EVENTFD, NULL, 0) < 0) {
-        return Err(errno);
-    }
-    return Ok(Void{});
+    return register_op(ring_fd_, IORING_UNREGISTER_EVENTFD, nullptr, 0);
 }
 
 Result<std::reference_wrapper<IOUringSQE>, Void>
 IOUring::get_submission_entry() {
+    // the SQ is as good as full while the backlog waits for it
+    IOUringSQE* sqe = backlog_.empty() ? next_submission_entry() : nullptr;
+    if (!sqe) {
+        metrics_.on_sq_full();
+        return Err(Void{});
+    }
+    return Ok(std::ref(*sqe));
+}
+
+IOUringSQE* IOUring::next_submission_entry() {
     const std::uint32_t next = sq_.sqe_tail_ + 1;
     if (next - sq_.sqe_head_ > *sq_.kring_entries_) {
-        return Err(Void{});
+        return nullptr;
     }
 
-    IOUringSQE& sqe = sq_.sqes_[sq_.sqe_tail_ & *sq_.kring_mask_];
+    IOUringSQE* sqe = &sq_.sqes_[sq_.sqe_tail_ & *sq_.kring_mask_];
     sq_.sqe_tail_ = next;
-    return Ok(std::ref(sqe));
+    return sqe;
 }
 
 Result<std::reference_wrapper<IOUringCQE>, int>
 IOUring::get_completion_entry(bool wait) {
+    bool flushed = false;
     for (;;) {
         const std::uint32_t head = *cq_.khead_;
 
         if (__atomic_load_n(cq_.ktail_, __ATOMIC_ACQUIRE) != head) {
-            return Ok(std::ref(cq_.cqes_[head & *cq_.kring_mask_]));
+            IOUringCQE& cqe = cq_.cqes_[head & *cq_.kring_mask_];
+            if (cqe.user_data == kReservedUserData) {
+                seen(1);
+                continue;
+            }
+            return Ok(std::ref(cqe));
+        }
+
+        // The CQ is drained, brings back the CQEs held by the kernel, and
+        // runs the deferred completion work
+        if (!flushed && (cq_overflow_pending() ||
+                         (flags_ & IORING_SETUP_DEFER_TASKRUN))) {
+            if (cq_overflow_pending()) {
+                metrics_.on_cq_overflow();
+            }
+            if (enter(0, 0, IORING_ENTER_GETEVENTS) < 0) {
+                return Err(errno);
+            }
+            flushed = true;
+            continue;
         }
 
         if (!wait) {
             return Err(EAGAIN);
         }
 
-        if (io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, NULL) < 0) {
+        if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+            return Err(errno);
+        }
+    }
+}
+
+std::pair<std::uint32_t, std::uint32_t> IOUring::available_completions() {
+    const std::uint32_t mask = *cq_.kring_mask_;
+    const std::uint32_t tail = __atomic_load_n(cq_.ktail_, __ATOMIC_ACQUIRE);
+    const std::uint32_t head = *cq_.khead_;
+
+    for (; cq_counted_ != tail; ++cq_counted_) {
+        cq_reserved_ +=
+            cq_.cqes_[cq_counted_ & mask].user_data == kReservedUserData;
+    }
+    return {tail - head - cq_reserved_, cq_reserved_};
+}
+
+Result<std::size_t, int> IOUring::wait_completions(std::size_t min_complete) {
+    for (;;) {
+        const auto [ready, reserved] = available_completions();
+        if (ready >= min_complete) {
+            return Ok(static_cast<std::size_t>(ready));
+        }
+
+        // The kernel counts the reserved CQEs too
+        if (enter(0, min_complete + reserved, IORING_ENTER_GETEVENTS) < 0) {
             return Err(errno);
         }
     }
 }
 
+Result<std::size_t, int>
+IOUring::wait_completions(std::size_t min_complete,
+                          std::chrono::nanoseconds timeout) {
+    if (!(features_ & IORING_FEAT_EXT_ARG)) {
+        return wait_completions_with_sqe(min_complete, timeout);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        const auto [ready, reserved] = available_completions();
+        if (ready >= min_complete) {
+            return Ok(static_cast<std::size_t>(ready));
+        }
+
+        const auto left = deadline - std::chrono::steady_clock::now();
+        if (left <= std::chrono::nanoseconds::zero()) {
+            return Ok(static_cast<std::size_t>(ready));
+        }
+
+        const struct __kernel_timespec ts = to_kernel_timespec(left);
+        struct io_uring_getevents_arg arg {};
+        arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+        if (enter(0, min_complete + reserved,
+                  IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg,
+                  sizeof(arg)) < 0) {
+            if (errno == ETIME) {
+                return Ok(static_cast<std::size_t>(
+                    available_completions().first));
+            }
+            return Err(errno);
+        }
+    }
+}
+
+Result<std::size_t, int>
+IOUring::wait_completions_with_sqe(std::size_t min_complete,
+                                   std::chrono::nanoseconds timeout) {
+    auto [ready, reserved] = available_completions();
+    if (ready >= min_complete) {
+        return Ok(static_cast<std::size_t>(ready));
+    }
+
+    // or it'd be linked to the unfinished chain
+    if (!backlog_.empty() &&
+        (backlog_.back().sqe_flags() &
+         (IOSQE_IO_LINK | IOSQE_IO_HARDLINK))) {
+        return Err(EBUSY);
+    }
+
+    // Completes once the missing CQEs are posted, or on timeout. Read by
+    // the kernel when submitted. Queued behind the backlog, which keeps the
+    // order of submissions and the CQ high watermark.
+    const struct __kernel_timespec ts = to_kernel_timespec(timeout);
+    IOUringSQE sqe;
+    sqe.timeout(&ts, min_complete - ready, 0);
+    sqe.user_data = kReservedUserData;
+    backlog_.push_back(sqe);
+    auto res = submit();
+    // held back by the CQ high watermark, nothing would time the wait out
+    const bool held = !backlog_.empty() &&
+                      backlog_.back().user_data == kReservedUserData;
+    if (held) {
+        backlog_.pop_back();
+    }
+    if (res.is_error()) {
+        return Err(res.error());
+    }
+    if (held) {
+        return Err(EBUSY);
+    }
+
+    // Wakes up on every CQE until the reserved one shows up. Nothing
+    // consumes CQEs meanwhile, the earlier reserved ones stay counted.
+    for (const std::uint32_t stale = reserved;;) {
+        if (enter(0, 1 + ready + reserved, IORING_ENTER_GETEVENTS) < 0) {
+            return Err(errno);
+        }
+
+        std::tie(ready, reserved) = available_completions();
+        if (ready >= min_complete || reserved > stale) {
+            return Ok(static_cast<std::size_t>(ready));
+        }
+    }
+}
+
+IOUringMetricsSnapshot IOUring::metrics() const noexcept {
+    IOUringMetricsSnapshot snapshot;
+    snapshot.inflight = inflight_;
+    snapshot.backlog = backlog_.size();
+    snapshot.cq_dropped = cq_dropped();
+    metrics_.fill(&snapshot);
+    return snapshot;
+}
+
+Result<Void, int> IOUring::flush_cq_overflow() {
+    if (cq_overflow_pending()) {
+        metrics_.on_cq_overflow();
+    }
+    if (enter(0, 0, IORING_ENTER_GETEVENTS) < 0) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+void IOUring::drain_backlog() {
+    const std::uint32_t entries = *sq_.kring_entries_;
+    const std::uint32_t mask = *sq_.kring_mask_;
+    while (!backlog_.empty()) {
+        // The chain at the front, unless its last SQE isn't queued yet
+        std::size_t chain = 0;
+        while (chain < backlog_.size() &&
+               (backlog_[chain].sqe_flags() &
+                (IOSQE_IO_LINK | IOSQE_IO_HARDLINK))) {
+            ++chain;
+        }
+        if (chain == backlog_.size()) {
+            return;
+        }
+        ++chain;
+
+        const std::uint32_t queued = sq_.sqe_tail_ - sq_.sqe_head_;
+        if (queued + inflight_ == 0) {
+            // always makes progress, even if the chain has to be broken
+            chain = std::min<std::size_t>(chain, entries);
+        } else if (queued + chain > entries ||
+                   queued + inflight_ + chain > cq_high_watermark_) {
+            return;
+        }
+
+        while (chain--) {
+            sq_.sqes_[sq_.sqe_tail_ & mask] = backlog_.front();
+            ++sq_.sqe_tail_;
+            backlog_.pop_front();
+        }
+    }
+}
+
 Result<int, int> IOUring::submit(std::size_t wait) {
+    drain_backlog();
     if (sq_.sqe_head_ == sq_.sqe_tail_) {
         return Ok(0);
     }
@@ -169,6 +599,10 @@ Result<int, int> IOUring::submit(std::size_t wait) {
     std::uint32_t submitted = 0;
     std::uint32_t ktail = *sq_.ktail_;
     while (to_submit--) {
+        const IOUringSQE& sqe = sq_.sqes_[sq_.sqe_head_ & mask];
+        if (sqe.user_data != kReservedUserData) {
+            metrics_.on_sqe(sqe.user_data, sqe.opcode);
+        }
         sq_.array_[ktail & mask] = sq_.sqe_head_ & mask;
         ++ktail;
         ++sq_.sqe_head_;
@@ -181,6 +615,8 @@ Result<int, int> IOUring::submit(std::size_t wait) {
 
     // Ensure that kernel sees the SQE updates before it sees the tail update
     __atomic_store_n(sq_.ktail_, ktail, __ATOMIC_RELEASE);
+    inflight_ += submitted;
+    metrics_.on_submit(submitted);
 
     if (unsigned flags = 0; wait || needs_enter(flags)) {
         if (wait) {
@@ -190,7 +626,7 @@ Result<int, int> IOUring::submit(std::size_t wait) {
             flags |= IORING_ENTER_GETEVENTS;
         }
 
-        if (io_uring_enter(ring_fd_, submitted, wait, flags, NULL) < 0) {
+        if (enter(submitted, wait, flags) < 0) {
             return Err(errno);
         }
     }
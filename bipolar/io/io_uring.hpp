@@ -5,79 +5,117 @@
 #ifndef BIPOLAR_IO_IOURING_HPP_
 #define BIPOLAR_IO_IOURING_HPP_
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <csignal>
 #include <cstring>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <thread>
+#include <utility>
 
 #include "bipolar/core/void.hpp"
 #include "bipolar/core/option.hpp"
 #include "bipolar/core/result.hpp"
+#include "bipolar/io/io_uring_metrics.hpp"
 
 #include "liburing.h"
 
 namespace bipolar {
+/// \struct IOUringFixedFile
+/// \brief Index of a registered file
+/// \see IOUringFileTable
+struct IOUringFixedFile {
+    std::uint32_t index;
+};
+
+/// \class IOUringFile
+/// \brief The file targeted by a SQE, either a fd or a registered file.
+/// SQEs targeting a registered file get \c IOSQE_FIXED_FILE, kept by
+/// \c IOUringSQE::set_flags
+class IOUringFile {
+public:
+    IOUringFile(int fd) noexcept : fd_(fd), fixed_(false) {}
+
+    IOUringFile(IOUringFixedFile file) noexcept
+        : fd_(static_cast<int>(file.index)), fixed_(true) {}
+
+    int fd() const noexcept {
+        return fd_;
+    }
+
+    bool fixed() const noexcept {
+        return fixed_;
+    }
+
+private:
+    int fd_;
+    bool fixed_;
+};
+
 /// \struct IOUringSQE
 /// \brief IO submission queue entry
 struct IOUringSQE : io_uring_sqe {
     /// \brief Vectored read
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param iovecs[] pointer to iovecs
     /// \param n number of iovecs
     /// \param offset offset into file
-    void readv(int fd, const struct iovec iovecs[], std::size_t n,
+    void readv(IOUringFile file, const struct iovec iovecs[], std::size_t n,
                off_t offset) {
-        prep_rw(IORING_OP_READV, fd, iovecs, n, offset);
+        prep_rw(IORING_OP_READV, file, iovecs, n, offset);
     }
 
     /// \brief Fixed read
     /// \c buf should be \c register_buffer ed
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param buf buffer
     /// \param n buffer size
     /// \param offset offset into file
     /// \param buf_index index into fixed buffer
-    void read_fixed(int fd, void* buf, std::size_t n, off_t offset,
-                    std::uint16_t buf_index) {
-        prep_rw(IORING_OP_READ_FIXED, fd, buf, n, offset);
+    void read_fixed(IOUringFile file, void* buf, std::size_t n,
+                    off_t offset, std::uint16_t buf_index) {
+        prep_rw(IORING_OP_READ_FIXED, file, buf, n, offset);
         this->buf_index = buf_index;
     }
 
     /// \brief Vectored write
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param iovecs[] pointer to iovecs
     /// \param n number of iovecs
     /// \param offset offset into file
-    void writev(int fd, const struct iovec iovecs[], std::size_t n,
-                off_t offset) {
-        prep_rw(IORING_OP_WRITEV, fd, iovecs, n, offset);
+    void writev(IOUringFile file, const struct iovec iovecs[],
+                std::size_t n, off_t offset) {
+        prep_rw(IORING_OP_WRITEV, file, iovecs, n, offset);
     }
 
     /// \brief Fixed write
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param buf buffer
     /// \param n buffer size
     /// \param offset offset into file
     /// \param buf_index index into fixed buffer
-    void write_fixed(int fd, const void* buf, std::size_t n, off_t offset,
-                     std::uint16_t buf_index) {
-        prep_rw(IORING_OP_WRITE_FIXED, fd, buf, n, offset);
+    void write_fixed(IOUringFile file, const void* buf, std::size_t n,
+                     off_t offset, std::uint16_t buf_index) {
+        prep_rw(IORING_OP_WRITE_FIXED, file, buf, n, offset);
         this->buf_index = buf_index;
     }
 
     /// \brief Poll the \c fd
     /// \note It works like an \c epoll with \c EPOLLONESHOT
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param poll_events poll events
-    void poll_add(int fd, std::uint16_t poll_events) {
+    void poll_add(IOUringFile file, std::uint16_t poll_events) {
         clear();
         this->opcode = IORING_OP_POLL_ADD;
-        this->fd = fd;
+        set_file(file);
         this->poll_events = poll_events;
     }
 
@@ -93,27 +131,27 @@ struct IOUringSQE : io_uring_sqe {
     /// \brief File sync
     /// \note IORING_FSYNC_DATASYNC makes it behave like \c fdatasync
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param fsync_flags fsync flags
     /// \see fsync
-    void fsync(int fd, std::uint32_t fsync_flags) {
+    void fsync(IOUringFile file, std::uint32_t fsync_flags) {
         clear();
         this->opcode = IORING_OP_FSYNC;
-        this->fd = fd;
+        set_file(file);
         this->fsync_flags = fsync_flags;
     }
 
     /// \brief Sync file range
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param offset offset into file
     /// \param nbytes range length
     /// \param flags flags
-    void sync_file_range(int fd, off_t offset, off_t nbytes,
+    void sync_file_range(IOUringFile file, off_t offset, off_t nbytes,
                          std::uint32_t flags) {
         clear();
         this->opcode = IORING_OP_SYNC_FILE_RANGE;
-        this->fd = fd;
+        set_file(file);
         this->off = offset;
         this->len = nbytes;
         this->sync_range_flags = flags;
@@ -121,30 +159,175 @@ struct IOUringSQE : io_uring_sqe {
 
     /// \brief Recv msg
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param msgs[] pointer to msgs
     /// \param n msgs size
-    void recvmsg(int fd, struct msghdr msgs[], std::size_t n) {
+    void recvmsg(IOUringFile file, struct msghdr msgs[], std::size_t n) {
         clear();
         this->opcode = IORING_OP_RECVMSG;
-        this->fd = fd;
+        set_file(file);
         this->addr = (std::uint64_t)msgs;
         this->len = n;
     }
 
     /// \brief Send msg
     ///
-    /// \param fd target fd
+    /// \param file target file
     /// \param msgs[] pointer to msgs
     /// \param n msgs size
-    void sendmsg(int fd, const struct msghdr msgs[], std::size_t n) {
+    void sendmsg(IOUringFile file, const struct msghdr msgs[],
+                 std::size_t n) {
         clear();
         this->opcode = IORING_OP_SENDMSG;
-        this->fd = fd;
+        set_file(file);
         this->addr = (std::uint64_t)msgs;
         this->len = n;
     }
 
+    /// \brief Zero-copy send
+    /// It completes with the send result, flagged \c IORING_CQE_F_MORE if a
+    /// notification (\c IORING_CQE_F_NOTIF) follows once the kernel is done
+    /// with \c buf, which must stay untouched until then.
+    ///
+    /// \param file target socket
+    /// \param buf buffer
+    /// \param n buffer size
+    /// \param msg_flags send flags
+    /// \see IOUringSendBuffers
+    void send_zc(IOUringFile file, const void* buf, std::size_t n,
+                 int msg_flags) {
+        prep_rw(IORING_OP_SEND_ZC, file, buf, n, 0);
+        this->msg_flags = msg_flags;
+    }
+
+    /// \brief Zero-copy send from a fixed buffer
+    /// \c buf should be \c register_buffer ed
+    ///
+    /// \param file target socket
+    /// \param buf buffer
+    /// \param n buffer size
+    /// \param msg_flags send flags
+    /// \param buf_index index into fixed buffer
+    /// \see send_zc
+    void send_zc_fixed(IOUringFile file, const void* buf, std::size_t n,
+                       int msg_flags, std::uint16_t buf_index) {
+        send_zc(file, buf, n, msg_flags);
+        this->ioprio = IORING_RECVSEND_FIXED_BUF;
+        this->buf_index = buf_index;
+    }
+
+    /// \brief Zero-copy send msg
+    ///
+    /// \param file target socket
+    /// \param msg msg, whose buffers must stay untouched until the
+    /// notification
+    /// \param msg_flags send flags
+    /// \see send_zc
+    void sendmsg_zc(IOUringFile file, const struct msghdr* msg,
+                    int msg_flags) {
+        prep_rw(IORING_OP_SENDMSG_ZC, file, msg, 1, 0);
+        this->msg_flags = msg_flags;
+    }
+
+    /// \brief Send
+    ///
+    /// \param file target socket
+    /// \param buf buffer
+    /// \param n buffer size
+    /// \param msg_flags send flags
+    void send(IOUringFile file, const void* buf, std::size_t n,
+              int msg_flags) {
+        prep_rw(IORING_OP_SEND, file, buf, n, 0);
+        this->msg_flags = msg_flags;
+    }
+
+    /// \brief Recv
+    ///
+    /// \param file target socket
+    /// \param buf buffer
+    /// \param n buffer size
+    /// \param msg_flags recv flags
+    void recv(IOUringFile file, void* buf, std::size_t n, int msg_flags) {
+        prep_rw(IORING_OP_RECV, file, buf, n, 0);
+        this->msg_flags = msg_flags;
+    }
+
+    /// \brief Connect a socket
+    ///
+    /// \param file target socket
+    /// \param addr peer address, which must stay valid until completion
+    /// \param addrlen size of \c addr
+    void connect(IOUringFile file, const struct sockaddr* addr,
+                 socklen_t addrlen) {
+        prep_rw(IORING_OP_CONNECT, file, addr, 0, addrlen);
+    }
+
+    /// \brief Accept a connection
+    ///
+    /// \param file listening socket
+    /// \param addr peer address, nullable
+    /// \param addrlen size of \c addr, nullable
+    /// \param flags \c accept4 flags
+    void accept(IOUringFile file, struct sockaddr* addr, socklen_t* addrlen,
+                int flags) {
+        prep_rw(IORING_OP_ACCEPT, file, addr, 0, (std::uint64_t)addrlen);
+        this->accept_flags = flags;
+    }
+
+    /// \brief Accept a connection into the registered file \c slot instead
+    /// of a fd (direct descriptor)
+    ///
+    /// \param file listening socket
+    /// \param addr peer address, nullable
+    /// \param addrlen size of \c addr, nullable
+    /// \param flags \c accept4 flags
+    /// \param slot vacant registered file
+    /// \see IOUringFileTable::reserve
+    void accept_direct(IOUringFile file, struct sockaddr* addr,
+                       socklen_t* addrlen, int flags, IOUringFixedFile slot) {
+        accept(file, addr, addrlen, flags);
+        this->file_index = slot.index + 1;
+    }
+
+    /// \brief Open a file
+    ///
+    /// \param dfd directory fd of relative paths
+    /// \param path pathname, read when submitted
+    /// \param flags open flags
+    /// \param mode mode of created files
+    void openat(int dfd, const char* path, int flags, mode_t mode) {
+        prep_rw(IORING_OP_OPENAT, dfd, path, mode, 0);
+        this->open_flags = flags;
+    }
+
+    /// \brief Open a file into the registered file \c slot instead of a fd
+    /// (direct descriptor)
+    ///
+    /// \param dfd directory fd of relative paths
+    /// \param path pathname, read when submitted
+    /// \param flags open flags
+    /// \param mode mode of created files
+    /// \param slot vacant registered file
+    /// \see IOUringFileTable::reserve
+    void openat_direct(int dfd, const char* path, int flags, mode_t mode,
+                       IOUringFixedFile slot) {
+        openat(dfd, path, flags, mode);
+        this->file_index = slot.index + 1;
+    }
+
+    /// \brief Timeout
+    /// It completes with \c -ETIME once \c ts elapsed, or with 0 once
+    /// \c count other completions happened
+    ///
+    /// \param ts relative timeout, read when submitted
+    /// \param count number of completions, 0 for a pure timer
+    /// \param flags timeout flags
+    void timeout(const struct __kernel_timespec* ts, std::uint32_t count,
+                 std::uint32_t flags) {
+        prep_rw(IORING_OP_TIMEOUT, -1, ts, 1, count);
+        this->timeout_flags = flags;
+    }
+
     /// \brief Don't perform any I/O
     void nop() {
         clear();
@@ -156,12 +339,42 @@ struct IOUringSQE : io_uring_sqe {
         std::memset(this, 0, sizeof(*this));
     }
 
+    /// \brief Returns the \c IOSQE_* flags
+    std::uint8_t sqe_flags() const noexcept {
+        return this->flags;
+    }
+
+    /// \brief Sets the \c IOSQE_* flags, keeping the \c IOSQE_FIXED_FILE of
+    /// a registered file set when preparing the SQE
+    ///
+    /// \param flags \c IOSQE_* flags other than \c IOSQE_FIXED_FILE
+    void set_flags(std::uint8_t flags) noexcept {
+        this->flags = (this->flags & IOSQE_FIXED_FILE) | flags;
+    }
+
+    /// \brief Adds \c IOSQE_* flags
+    ///
+    /// \param flags \c IOSQE_* flags
+    void add_flags(std::uint8_t flags) noexcept {
+        this->flags |= flags;
+    }
+
 private:
-    void prep_rw(int op, int fd, const void* addr, std::size_t len,
-                 off_t offset) {
+    // or assigning it would drop IOSQE_FIXED_FILE
+    using io_uring_sqe::flags;
+
+    void set_file(IOUringFile file) {
+        this->fd = file.fd();
+        if (file.fixed()) {
+            this->flags |= IOSQE_FIXED_FILE;
+        }
+    }
+
+    void prep_rw(int op, IOUringFile file, const void* addr, std::size_t len,
+                 std::uint64_t offset) {
         clear();
         this->opcode = op;
-        this->fd = fd;
+        set_file(file);
         this->off = offset;
         this->addr = (std::uint64_t)addr;
         this->len = len;
@@ -170,7 +383,19 @@ private:
 
 /// \struct IOUringCQE
 /// \brief IO completion queue entry
-struct IOUringCQE : io_uring_cqe {};
+struct IOUringCQE : io_uring_cqe {
+    /// \brief Returns true if more CQEs of the same SQE follow
+    /// (\c IORING_CQE_F_MORE)
+    bool has_more() const noexcept {
+        return flags & IORING_CQE_F_MORE;
+    }
+
+    /// \brief Returns true if it notifies that a zero-copy send released its
+    /// buffers (\c IORING_CQE_F_NOTIF), rather than the send result
+    bool is_notification() const noexcept {
+        return flags & IORING_CQE_F_NOTIF;
+    }
+};
 
 /// \class IOUringSQ
 /// \brief IO submission queue
@@ -203,7 +428,7 @@ private:
     std::uint32_t sqe_head_; ///< Head offset into the SQEs ring
     std::uint32_t sqe_tail_; ///< Tail offset into the SQEs ring
 
-    std::size_t ring_sz_;
+    std::size_t ring_sz_; ///< 0 if provided by the application
     void* ring_ptr_;
 };
 
@@ -233,14 +458,118 @@ private:
     std::uint32_t* koverflow_;     ///< Number of overflowed completion events
     IOUringCQE* cqes_;             ///< Ring buffer of completion events
 
-    std::size_t ring_sz_;
+    std::size_t ring_sz_; ///< 0 if provided by the application
     void* ring_ptr_;
 };
 
+/// \struct IOUringOptions
+/// \brief Typed setup options of \c IOUring.
+/// The modes unknown to the kernel are dropped, from the newest one, see
+/// \c IOUring::setup_flags for the ones in effect and
+/// \c IOUring::dropped_setup_flags for the dropped ones
+struct IOUringOptions {
+    /// \brief The number of SQ entries
+    unsigned entries = 128;
+
+    /// \brief The number of CQ entries (\c IORING_SETUP_CQSIZE, Linux 5.5),
+    /// at least \c entries, or 0 for twice the SQ entries. Never dropped,
+    /// the construction fails if the kernel rejects it
+    unsigned cq_entries = 0;
+
+    /// \brief Only the thread constructing the ring submits to it
+    /// (\c IORING_SETUP_SINGLE_ISSUER)
+    bool single_issuer = false;
+
+    /// \brief Runs the completion work only when entering the ring to get
+    /// events (\c IORING_SETUP_DEFER_TASKRUN), implies \c single_issuer
+    bool defer_taskrun = false;
+
+    /// \brief Doesn't interrupt the thread to run the completion work
+    /// (\c IORING_SETUP_COOP_TASKRUN)
+    bool coop_taskrun = false;
+
+    /// \brief Enters the ring through its registered fd, skipping the fd
+    /// table lookup (\c IORING_REGISTER_RING_FDS).
+    /// The registration belongs to the thread constructing the ring, which
+    /// must be the only one to use it, and should destroy it: destroyed on
+    /// another thread, the ring stays registered, and open, as long as the
+    /// constructing thread lives
+    bool register_ring_fd = false;
+
+    /// \brief Places the SQEs and the rings in prefaulted 2MiB hugepages
+    /// (\c IORING_SETUP_NO_MMAP), sparing the TLB misses of large rings.
+    /// Falls back to the rings mapped from the kernel when no hugepage is
+    /// reserved (\c vm.nr_hugepages) or the flag is unknown
+    bool huge_pages = false;
+};
+
+/// \class IOUringRingMemory
+/// \brief The SQEs and the rings provided by the application
+/// \see IOUringOptions::huge_pages
+class IOUringRingMemory {
+public:
+    /// \brief Constructs an empty memory
+    IOUringRingMemory() noexcept = default;
+
+    /// \brief Maps the hugepages holding \c sq_entries SQEs and the rings of
+    /// \c sq_entries and \c cq_entries entries, a single one if they fit
+    ///
+    /// \return \c Err with errno if they don't fit or aren't available
+    static Result<IOUringRingMemory, int>
+    allocate(unsigned sq_entries, unsigned cq_entries) noexcept;
+
+    IOUringRingMemory(IOUringRingMemory&& rhs) noexcept
+        : sqes_(std::exchange(rhs.sqes_, nullptr)),
+          sqes_size_(std::exchange(rhs.sqes_size_, 0)),
+          rings_(std::exchange(rhs.rings_, nullptr)),
+          rings_size_(std::exchange(rhs.rings_size_, 0)) {}
+
+    IOUringRingMemory& operator=(IOUringRingMemory&& rhs) noexcept {
+        IOUringRingMemory(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /// \brief Unmaps the hugepages
+    ~IOUringRingMemory();
+
+    /// \brief Returns the address of the SQEs
+    void* sqes() const noexcept {
+        return sqes_;
+    }
+
+    /// \brief Returns the address of the rings
+    void* rings() const noexcept {
+        return rings_;
+    }
+
+    /// \brief Returns true if nothing is mapped
+    bool empty() const noexcept {
+        return sqes_ == nullptr;
+    }
+
+    void swap(IOUringRingMemory& rhs) noexcept {
+        std::swap(sqes_, rhs.sqes_);
+        std::swap(sqes_size_, rhs.sqes_size_);
+        std::swap(rings_, rhs.rings_);
+        std::swap(rings_size_, rhs.rings_size_);
+    }
+
+private:
+    void* sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+    // 0 if the rings follow the SQEs in the same hugepage
+    void* rings_ = nullptr;
+    std::size_t rings_size_ = 0;
+};
+
 /// \class IOUring
 /// \brief IO uring
 class IOUring {
 public:
+    /// \brief The \c user_data of the SQEs submitted by \c IOUring itself,
+    /// whose CQEs are never returned
+    static constexpr std::uint64_t kReservedUserData = ~std::uint64_t(0);
+
     /// \brief Constructs a \c IOUring
     /// \note Only \c io_uring_params.flags, \c io_uring_params.sq_thread_cpu
     /// and \c io_uring_params.sq_thread_idle are user-configurable
@@ -251,9 +580,46 @@ public:
     /// \see io_uring_setup
     IOUring(unsigned entries, struct io_uring_params* p);
 
+    /// \brief Constructs a \c IOUring from typed options, with the modes
+    /// supported by the kernel
+    ///
+    /// \param options
+    /// \throw std::system_error
+    /// \see IOUringOptions
+    explicit IOUring(const IOUringOptions& options)
+        : IOUring(options, io_uring_params{}, IOUringRingMemory()) {}
+
     /// \brief Destructs a \c IOUring
     ~IOUring();
 
+    /// \brief Returns the \c IORING_SETUP_* flags in effect
+    std::uint32_t setup_flags() const noexcept {
+        return flags_;
+    }
+
+    /// \brief Returns the \c IORING_SETUP_* flags asked by the
+    /// \c IOUringOptions but dropped, unknown to the kernel or, for
+    /// \c IORING_SETUP_NO_MMAP, without hugepages
+    std::uint32_t dropped_setup_flags() const noexcept {
+        return dropped_flags_;
+    }
+
+    /// \brief Returns the \c IORING_FEAT_* features of the kernel
+    std::uint32_t features() const noexcept {
+        return features_;
+    }
+
+    /// \brief Returns true if the ring is entered through its registered fd
+    bool ring_fd_registered() const noexcept {
+        return ring_fd_registered_;
+    }
+
+    /// \brief Returns true if the SQEs and the rings are in hugepages
+    /// \see IOUringOptions::huge_pages
+    bool huge_pages() const noexcept {
+        return !ring_memory_.empty();
+    }
+
     /// @{
     /// \brief Registers user buffer
     ///
@@ -277,6 +643,17 @@ public:
     Result<Void, int> unregister_files();
     /// @}
 
+    /// \brief Replaces registered files, -1 leaving the slot vacant
+    ///
+    /// \param offset index of the first file to replace
+    /// \param files[] pointer to files
+    /// \param n files size
+    ///
+    /// \return \c Err with errno on failure; \c Ok on success
+    /// \see IOUringFileTable
+    Result<Void, int> update_files(std::uint32_t offset, const int files[],
+                                   std::size_t n);
+
     /// @{
     /// \brief Register eventfd
     ///
@@ -291,12 +668,35 @@ public:
     /// Application must later call \c submit when it's ready to tell the 
     /// kernel about it. The caller may call this function multiple times
     /// before calling \c submit
+    /// \note It fails while the backlog isn't empty, to keep the order of
+    /// submissions. It isn't throttled by the CQ high watermark
+    /// \note The \c user_data of the SQE mustn't be \c kReservedUserData,
+    /// or its CQE would be swallowed
     ///
     /// \return an \c Ok with vacant SQE or \c Err Void
     /// \see submit
+    /// \see queue_submission_entry
     Result<std::reference_wrapper<IOUringSQE>, Void> get_submission_entry();
 
+    /// \brief Queues a copy of \c sqe in the userspace backlog.
+    /// Unlike \c get_submission_entry it never fails when the SQ is full:
+    /// \c submit moves the backlog to the SQ as long as the in-flight SQEs
+    /// stay below the CQ high watermark, and the rest waits for their
+    /// completions to be \c seen.
+    /// \note Linked SQEs are moved as a whole chain, a chain is held back
+    /// until its last SQE is queued
+    ///
+    /// \param sqe the filled SQE, whose \c user_data isn't
+    /// \c kReservedUserData
+    /// \see submit
+    void queue_submission_entry(const IOUringSQE& sqe) {
+        assert(sqe.user_data != kReservedUserData);
+        backlog_.push_back(sqe);
+    }
+
     /// \brief Returns an IO CQE, if available.
+    /// The CQEs held by the kernel on CQ overflow are flushed to the CQ
+    /// once it's drained.
     ///
     /// \param wait Will it wait until completion event available?
     ///
@@ -310,7 +710,28 @@ public:
         return get_completion_entry(/* wait = */ false);
     }
 
+    /// @{
+    /// \brief Waits until at least \c min_complete CQEs are available, or
+    /// \c timeout elapsed, in a single wakeup.
+    /// The timeout uses \c IORING_ENTER_EXT_ARG when supported. Otherwise a
+    /// timeout SQE is queued behind the backlog and submitted along with it,
+    /// and the wait wakes up on every completion until either happens. It
+    /// fails with \c EBUSY if the timeout SQE is held back by the CQ high
+    /// watermark or by an unfinished chain.
+    ///
+    /// \param min_complete number of CQEs to wait for
+    /// \param timeout relative timeout
+    ///
+    /// \return an \c Ok with the number of available CQEs, fewer than
+    /// \c min_complete on timeout, or \c Err with errno
+    Result<std::size_t, int> wait_completions(std::size_t min_complete);
+    Result<std::size_t, int>
+    wait_completions(std::size_t min_complete,
+                     std::chrono::nanoseconds timeout);
+    /// @}
+
     /// \brief Submit SQEs acquired from \c get_submission_entry to the kernel
+    /// along with the backlog allowed by the CQ high watermark.
     /// If \c nr_wait > 0, allows waiting for events as well.
     /// Default behavisor is no wait.
     ///
@@ -322,14 +743,122 @@ public:
     ///
     /// \param n advance length
     void seen(std::size_t n) {
-        __atomic_add_fetch(cq_.khead_, n, __ATOMIC_RELEASE);
+        // A SQE is in flight until its last CQE
+        const std::uint32_t head = *cq_.khead_;
+        const std::uint32_t counted = cq_counted_ - head;
+        std::size_t done = 0;
+        for (std::uint32_t i = 0; i < n; ++i) {
+            const IOUringCQE& cqe = cq_.cqes_[(head + i) & *cq_.kring_mask_];
+            done += !cqe.has_more();
+            if (i < counted) {
+                cq_reserved_ -= cqe.user_data == kReservedUserData;
+            }
+            metrics_.on_cqe(cqe.res);
+        }
+
+        __atomic_store_n(cq_.khead_, head + n, __ATOMIC_RELEASE);
+        if (counted < n) {
+            cq_counted_ = head + n;
+        }
+        inflight_ -= std::min(inflight_, done);
+    }
+
+    /// \brief Returns the number of SQEs submitted whose CQEs aren't seen
+    std::size_t inflight() const noexcept {
+        return inflight_;
+    }
+
+    /// \brief Returns the number of SQEs waiting in the userspace backlog
+    std::size_t backlog() const noexcept {
+        return backlog_.size();
+    }
+
+    /// @{
+    /// \brief The maximum number of in-flight SQEs the backlog is submitted
+    /// up to, defaults to the CQ size so that the CQ never overflows.
+    /// It should be halved for zero-copy sends, which post 2 CQEs
+    std::size_t cq_high_watermark() const noexcept {
+        return cq_high_watermark_;
+    }
+    void set_cq_high_watermark(std::size_t n) noexcept {
+        cq_high_watermark_ = std::max<std::size_t>(n, 1);
+    }
+    /// @}
+
+    /// \brief Returns true if the kernel holds CQEs which didn't fit in the
+    /// CQ, to be flushed once there's room
+    /// \see IORING_FEAT_NODROP
+    bool cq_overflow_pending() const noexcept {
+        return __atomic_load_n(sq_.kflags_, __ATOMIC_ACQUIRE) &
+               IORING_SQ_CQ_OVERFLOW;
+    }
+
+    /// \brief Returns the number of CQEs dropped by the kernel because the CQ
+    /// was full, which may only happen without \c IORING_FEAT_NODROP
+    std::uint32_t cq_dropped() const noexcept {
+        return __atomic_load_n(cq_.koverflow_, __ATOMIC_ACQUIRE);
+    }
+
+    /// \brief Flushes the CQEs held by the kernel to the CQ, as many as fit
+    ///
+    /// \return \c Err with errno on failure; \c Ok on success
+    /// \see cq_overflow_pending
+    Result<Void, int> flush_cq_overflow();
+
+    /// \brief Returns the gauges of the ring, along with its counters and
+    /// histograms if built with \c BIPOLAR_IO_METRICS
+    /// \see IOUringMetricsSnapshot
+    IOUringMetricsSnapshot metrics() const noexcept;
+
+    /// \brief Stamps the SQEs at submission, to measure the latency of
+    /// their operations by opcode. No-op without \c BIPOLAR_IO_METRICS
+    /// \note Every SQE must belong to an \c IOUringOp, whose completions
+    /// are dispatched by \c dispatch_completions
+    ///
+    /// \param enable
+    void track_ops(bool enable) noexcept {
+        metrics_.track_ops(enable);
     }
 
 private:
+    friend std::size_t dispatch_completions(IOUring& ring, std::size_t max);
+
+    IOUring(const IOUringOptions& options, struct io_uring_params&& p,
+            IOUringRingMemory&& memory);
+
+    IOUring(int ring_fd, const struct io_uring_params& p);
+
+    // io_uring_enter through the registered ring fd, if any
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+              const void* arg = nullptr, std::size_t argsz = _NSIG / 8);
+
+    // Returns the next vacant SQE, or nullptr if the SQ is full
+    IOUringSQE* next_submission_entry();
+
+    // Returns the number of available CQEs, and of the ones of
+    // kReservedUserData which aren't counted as available. Only the CQEs
+    // posted since the last call are looked at
+    std::pair<std::uint32_t, std::uint32_t> available_completions();
+
+    // wait_completions with a timeout SQE, for kernels without
+    // IORING_FEAT_EXT_ARG
+    Result<std::size_t, int>
+    wait_completions_with_sqe(std::size_t min_complete,
+                              std::chrono::nanoseconds timeout);
+
+    // Moves the whole chains of the backlog that fit in the SQ, up to the
+    // CQ high watermark
+    void drain_backlog();
+
     // Returns true if we're not using SQ thread (thus nobody submits but us)
     // or if IORING_SQ_NEED_WAKEUP is set, so submit thread must be explicitly
     // awakened. For the latter case, we set the thread wakeup flag.
+    // CQEs held by the kernel are flushed by IORING_ENTER_GETEVENTS.
     bool needs_enter(unsigned& flags) {
+        if (cq_overflow_pending()) {
+            flags |= IORING_ENTER_GETEVENTS;
+            return true;
+        }
         if (!(flags_ & IORING_SETUP_SQPOLL)) {
             return true;
         }
@@ -343,8 +872,23 @@ private:
 private:
     int ring_fd_;
     std::uint32_t flags_;
+    std::uint32_t features_;
     IOUringSQ sq_;
     IOUringCQ cq_;
+    int enter_fd_;
+    bool ring_fd_registered_;
+    std::thread::id registering_thread_;
+    std::uint32_t dropped_flags_;
+    IOUringRingMemory ring_memory_;
+
+    std::deque<IOUringSQE> backlog_;
+    std::size_t inflight_;
+    std::size_t cq_high_watermark_;
+    // The CQEs in [head, cq_counted_) are looked at by
+    // available_completions, cq_reserved_ of which are kReservedUserData
+    std::uint32_t cq_counted_;
+    std::uint32_t cq_reserved_;
+    IOUringMetrics metrics_;
 };
 
 } // namespace bipolar
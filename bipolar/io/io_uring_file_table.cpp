@@ -0,0 +1,64 @@
+#include "bipolar/io/io_uring_file_table.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <system_error>
+
+namespace bipolar {
+IOUringFileTable::IOUringFileTable(IOUring& ring, std::uint32_t slots)
+    : ring_(ring), capacity_(slots) {
+    assert(slots > 0);
+
+    // -1 leaves a slot vacant
+    const std::vector<int> files(slots, -1);
+    if (auto res = ring_.register_files(files.data(), files.size());
+        res.is_error()) {
+        throw std::system_error(res.error(), std::system_category());
+    }
+
+    free_.reserve(slots);
+    for (std::uint32_t i = slots; i > 0; --i) {
+        free_.push_back(i - 1);
+    }
+}
+
+IOUringFileTable::~IOUringFileTable() {
+    ring_.unregister_files();
+}
+
+Result<IOUringFixedFile, int> IOUringFileTable::install(int fd) {
+    if (free_.empty()) {
+        return Err(ENFILE);
+    }
+
+    const std::uint32_t slot = free_.back();
+    if (auto res = ring_.update_files(slot, &fd, 1); res.is_error()) {
+        return Err(res.error());
+    }
+    free_.pop_back();
+    return Ok(IOUringFixedFile{slot});
+}
+
+Result<IOUringFixedFile, int> IOUringFileTable::reserve() {
+    if (free_.empty()) {
+        return Err(ENFILE);
+    }
+
+    const std::uint32_t slot = free_.back();
+    free_.pop_back();
+    return Ok(IOUringFixedFile{slot});
+}
+
+Result<Void, int> IOUringFileTable::release(IOUringFixedFile file) {
+    assert(file.index < capacity_);
+
+    const int vacant = -1;
+    if (auto res = ring_.update_files(file.index, &vacant, 1);
+        res.is_error()) {
+        return Err(res.error());
+    }
+    free_.push_back(file.index);
+    return Ok(Void{});
+}
+
+} // namespace bipolar
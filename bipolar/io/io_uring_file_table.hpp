@@ -0,0 +1,91 @@
+/// \file io_uring_file_table.hpp
+/// Registered files of \c IOUring as connections come and go
+
+#ifndef BIPOLAR_IO_IOURING_FILE_TABLE_HPP_
+#define BIPOLAR_IO_IOURING_FILE_TABLE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/io/io_uring.hpp"
+
+namespace bipolar {
+/// \class IOUringFileTable
+/// \brief Allocator of the registered files of a \c IOUring
+///
+/// A sparse table is registered once, then its slots are filled and
+/// vacated with \c IORING_REGISTER_FILES_UPDATE. A slot either holds a
+/// fd installed by \c install, or is reserved by \c reserve for a direct
+/// accept or open (\c IOUringSQE::accept_direct,
+/// \c IOUringSQE::openat_direct) that never creates a fd.
+///
+/// SQEs built with an \c IOUringFixedFile get \c IOSQE_FIXED_FILE, which
+/// saves the file lookup and reference counting of every operation.
+///
+/// \code
+/// IOUringFileTable table(ring, 1024);
+///
+/// auto slot = table.reserve().value();
+/// sqe.accept_direct(listener, nullptr, nullptr, 0, slot);
+/// // ... once accepted
+/// sqe.recvmsg(slot, &msg, 1);
+/// // ... once closed
+/// table.release(slot);
+/// \endcode
+class IOUringFileTable {
+public:
+    /// \brief Registers a table of \c slots vacant files
+    /// \note A ring has at most one table of registered files
+    ///
+    /// \param ring the ring to register to
+    /// \param slots size of the table
+    /// \throw std::system_error
+    IOUringFileTable(IOUring& ring, std::uint32_t slots);
+
+    /// \brief Unregisters the table, closing the files held by it
+    ~IOUringFileTable();
+
+    IOUringFileTable(const IOUringFileTable&) = delete;
+    IOUringFileTable& operator=(const IOUringFileTable&) = delete;
+
+    /// \brief Registers a file in a vacant slot.
+    /// The slot holds its own reference, \c fd may be closed afterwards
+    ///
+    /// \param fd the file to register
+    /// \return an \c Ok with the slot, or \c Err with errno, \c ENFILE if
+    /// there's no vacant slot
+    Result<IOUringFixedFile, int> install(int fd);
+
+    /// \brief Reserves a vacant slot for a direct accept or open
+    ///
+    /// \return an \c Ok with the slot, or \c Err with \c ENFILE if there's
+    /// no vacant slot
+    Result<IOUringFixedFile, int> reserve();
+
+    /// \brief Vacates an installed or reserved slot, closing its file
+    ///
+    /// \param file the slot
+    /// \return \c Err with errno on failure; \c Ok on success
+    Result<Void, int> release(IOUringFixedFile file);
+
+    /// \brief Returns the size of the table
+    std::uint32_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    /// \brief Returns the number of installed or reserved slots
+    std::uint32_t used() const noexcept {
+        return capacity_ - static_cast<std::uint32_t>(free_.size());
+    }
+
+private:
+    IOUring& ring_;
+    std::uint32_t capacity_;
+    std::vector<std::uint32_t> free_; ///< Vacant slots, lowest last
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,28 @@
+#include "bipolar/io/io_uring_metrics.hpp"
+
+namespace bipolar {
+std::ostream& operator<<(std::ostream& os,
+                         const IOUringMetricsSnapshot& snapshot) {
+    os << "inflight=" << snapshot.inflight << " backlog=" << snapshot.backlog
+       << " cq_dropped=" << snapshot.cq_dropped;
+    if (!snapshot.enabled) {
+        return os;
+    }
+
+    os << " enters=" << snapshot.enters
+       << " submitted=" << snapshot.submitted
+       << " completed=" << snapshot.completed
+       << " sq_full=" << snapshot.sq_full
+       << " cq_overflows=" << snapshot.cq_overflows
+       << " eagain=" << snapshot.eagain << " ebusy=" << snapshot.ebusy << "\n"
+       << "submit_batch: " << snapshot.submit_batch;
+    for (std::size_t i = 0; i < snapshot.op_latency.size(); ++i) {
+        if (snapshot.op_latency[i].count > 0) {
+            os << "\n"
+               << "op_latency_ns[" << i << "]: " << snapshot.op_latency[i];
+        }
+    }
+    return os;
+}
+
+} // namespace bipolar
@@ -0,0 +1,219 @@
+/// \file io_uring_metrics.hpp
+/// Instrumentation of \c IOUring
+///
+/// It's compiled in only if \c BIPOLAR_IO_METRICS is defined, e.g. by
+/// building with <tt>--define bipolar_io_metrics=true</tt>. Otherwise
+/// recording compiles to nothing and snapshots only carry the gauges.
+///
+/// The define changes the layout of \c IOUring, so every translation unit
+/// must agree on it: //bipolar/io exports it to its dependents, other
+/// builds must pass it to the whole program.
+
+#ifndef BIPOLAR_IO_IOURING_METRICS_HPP_
+#define BIPOLAR_IO_IOURING_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "bipolar/core/histogram.hpp"
+
+namespace bipolar {
+/// \struct IOUringOpStamp
+/// \brief The submission of an \c IOUringOp, recorded by its ring
+/// \see IOUring::track_ops
+struct IOUringOpStamp {
+    std::chrono::steady_clock::time_point submitted;
+    std::uint8_t opcode = 0;
+};
+
+/// \struct IOUringMetricsSnapshot
+/// \brief The state of an \c IOUring at some point in time
+/// \see IOUring::metrics
+struct IOUringMetricsSnapshot {
+    /// \brief The number of opcodes with a latency histogram
+    static constexpr std::size_t kOpcodes = 64;
+
+    /// \brief False if the instrumentation is compiled out, only the gauges
+    /// are filled then
+    bool enabled = false;
+
+    /// @{
+    /// \brief Gauges
+    std::size_t inflight = 0;
+    std::size_t backlog = 0;
+    std::uint32_t cq_dropped = 0;
+    /// @}
+
+    /// @{
+    /// \brief Counters since the ring was created
+    std::uint64_t enters = 0;    ///< \c io_uring_enter calls
+    std::uint64_t submitted = 0; ///< SQEs submitted
+    std::uint64_t completed = 0; ///< CQEs seen
+    std::uint64_t sq_full = 0;   ///< \c get_submission_entry failures
+    std::uint64_t cq_overflows = 0; ///< CQ overflows flushed
+    std::uint64_t eagain = 0; ///< \c EAGAIN of \c io_uring_enter and CQEs
+    std::uint64_t ebusy = 0;  ///< \c EBUSY of \c io_uring_enter and CQEs
+    /// @}
+
+    /// \brief The number of SQEs per submission
+    HistogramSnapshot submit_batch;
+
+    /// \brief Nanoseconds from submission to the last CQE of the tracked
+    /// operations, by opcode
+    std::array<HistogramSnapshot, kOpcodes> op_latency;
+};
+
+/// \brief Prints the counters and the histograms of the opcodes seen
+std::ostream& operator<<(std::ostream& os,
+                         const IOUringMetricsSnapshot& snapshot);
+
+/// \class IOUringMetrics
+/// \brief The instrumentation points of an \c IOUring.
+///
+/// Every method is a no-op unless \c BIPOLAR_IO_METRICS is defined, in which
+/// case the object also holds the counters and histograms. They're recorded
+/// by the thread driving the ring, snapshots may be taken by any thread.
+class IOUringMetrics final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    IOUringMetrics() = default;
+    IOUringMetrics(const IOUringMetrics&) = delete;
+    IOUringMetrics& operator=(const IOUringMetrics&) = delete;
+
+#ifdef BIPOLAR_IO_METRICS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    /// \brief Stamps the \c IOUringOp at \c user_data if ops are tracked
+    void on_sqe([[maybe_unused]] std::uint64_t user_data,
+                [[maybe_unused]] std::uint8_t opcode) noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        if (track_ops_) {
+            auto* stamp = reinterpret_cast<IOUringOpStamp*>(
+                static_cast<std::uintptr_t>(user_data));
+            stamp->submitted = Clock::now();
+            stamp->opcode = opcode;
+        }
+#endif
+    }
+
+    void on_submit([[maybe_unused]] std::size_t n) noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        bump(submitted_, n);
+        submit_batch_.record(n);
+#endif
+    }
+
+    /// \brief Records an \c io_uring_enter which failed with \c err, or 0
+    void on_enter([[maybe_unused]] int err) noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        bump(enters_, 1);
+        count_error(err);
+#endif
+    }
+
+    void on_sq_full() noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        bump(sq_full_, 1);
+#endif
+    }
+
+    void on_cq_overflow() noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        bump(cq_overflows_, 1);
+#endif
+    }
+
+    /// \brief Records a CQE whose result is \c res
+    void on_cqe([[maybe_unused]] int res) noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        bump(completed_, 1);
+        count_error(-res);
+#endif
+    }
+
+    /// \brief Records the latency of an operation stamped by \c on_sqe
+    void on_op_completion(
+        [[maybe_unused]] const IOUringOpStamp& stamp) noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        if (track_ops_ && stamp.opcode < IOUringMetricsSnapshot::kOpcodes) {
+            op_latency_[stamp.opcode].record(Clock::now() - stamp.submitted);
+        }
+#endif
+    }
+
+    /// \brief Returns true if the SQEs submitted are stamped
+    bool tracking_ops() const noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        return track_ops_;
+#else
+        return false;
+#endif
+    }
+
+    void track_ops([[maybe_unused]] bool enable) noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        track_ops_ = enable;
+#endif
+    }
+
+    /// \brief Fills the counters and histograms of \c snapshot
+    void fill([[maybe_unused]] IOUringMetricsSnapshot* snapshot) const
+        noexcept {
+#ifdef BIPOLAR_IO_METRICS
+        snapshot->enabled = true;
+        snapshot->enters = enters_.load(std::memory_order_relaxed);
+        snapshot->submitted = submitted_.load(std::memory_order_relaxed);
+        snapshot->completed = completed_.load(std::memory_order_relaxed);
+        snapshot->sq_full = sq_full_.load(std::memory_order_relaxed);
+        snapshot->cq_overflows = cq_overflows_.load(std::memory_order_relaxed);
+        snapshot->eagain = eagain_.load(std::memory_order_relaxed);
+        snapshot->ebusy = ebusy_.load(std::memory_order_relaxed);
+        snapshot->submit_batch = submit_batch_.snapshot();
+        for (std::size_t i = 0; i < op_latency_.size(); ++i) {
+            snapshot->op_latency[i] = op_latency_[i].snapshot();
+        }
+#endif
+    }
+
+private:
+#ifdef BIPOLAR_IO_METRICS
+    // a single writer doesn't need read-modify-write instructions
+    static void bump(std::atomic<std::uint64_t>& counter,
+                     std::uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+    }
+
+    void count_error(int err) noexcept {
+        if (err == EAGAIN) {
+            bump(eagain_, 1);
+        } else if (err == EBUSY) {
+            bump(ebusy_, 1);
+        }
+    }
+
+    bool track_ops_ = false;
+    std::atomic<std::uint64_t> enters_{0};
+    std::atomic<std::uint64_t> submitted_{0};
+    std::atomic<std::uint64_t> completed_{0};
+    std::atomic<std::uint64_t> sq_full_{0};
+    std::atomic<std::uint64_t> cq_overflows_{0};
+    std::atomic<std::uint64_t> eagain_{0};
+    std::atomic<std::uint64_t> ebusy_{0};
+    Histogram submit_batch_;
+    std::array<Histogram, IOUringMetricsSnapshot::kOpcodes> op_latency_;
+#endif
+};
+
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,28 @@
+#include "bipolar/io/io_uring_op.hpp"
+
+namespace bipolar {
+std::size_t dispatch_completions(IOUring& ring, std::size_t max) {
+    std::size_t n = 0;
+    for (; n < max; ++n) {
+        auto res = ring.peek_completion_entry();
+        if (res.is_error()) {
+            break;
+        }
+
+        // the slot may be reused once seen
+        const IOUringCQE cqe = res.value();
+        ring.seen(1);
+
+        IOUringOp& op = IOUringOp::from(cqe);
+        assert(op.handler);
+#ifdef BIPOLAR_IO_METRICS
+        if (!cqe.has_more()) {
+            ring.metrics_.on_op_completion(op.stamp);
+        }
+#endif
+        op.handler(op, cqe);
+    }
+    return n;
+}
+
+} // namespace bipolar
@@ -0,0 +1,196 @@
+/// \file io_uring_op.hpp
+/// Operations dispatching the completions of \c IOUring
+
+#ifndef BIPOLAR_IO_IOURING_OP_HPP_
+#define BIPOLAR_IO_IOURING_OP_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bipolar/io/io_uring.hpp"
+
+namespace bipolar {
+/// \struct IOUringOp
+/// \brief An operation in flight, whose address is the \c user_data of
+/// its SQEs.
+///
+/// \c dispatch_completions calls its handler for every CQE, with a single
+/// indirect call. It's either embedded in an object outliving the
+/// operation, or taken from an \c IOUringOpPool.
+///
+/// \code
+/// struct Connection {
+///     IOUringOp recv;
+///     // ...
+/// };
+///
+/// conn.recv.handler = [](IOUringOp& op, const IOUringCQE& cqe) {
+///     auto& conn = *reinterpret_cast<Connection*>(&op);
+///     // ...
+/// };
+/// sqe.recvmsg(conn.fd, &conn.msg, 1);
+/// sqe.user_data = conn.recv.user_data();
+/// \endcode
+struct IOUringOp {
+    /// \brief Completion handler.
+    /// The CQE is a copy, already seen, so that the handler may submit,
+    /// wait, or release its operation.
+    using Handler = void (*)(IOUringOp& op, const IOUringCQE& cqe);
+
+    /// \brief Stamped at submission if built with \c BIPOLAR_IO_METRICS,
+    /// the address of the operation being the one of its stamp. Unused
+    /// otherwise, so that the layout doesn't depend on the define
+    /// \see IOUring::track_ops
+    IOUringOpStamp stamp;
+
+    Handler handler = nullptr;
+
+    /// \brief Returns the \c user_data of the SQEs of this operation
+    std::uint64_t user_data() noexcept {
+        return reinterpret_cast<std::uintptr_t>(this);
+    }
+
+    /// \brief Returns the operation of a CQE
+    static IOUringOp& from(const IOUringCQE& cqe) noexcept {
+        return *reinterpret_cast<IOUringOp*>(
+            static_cast<std::uintptr_t>(cqe.user_data));
+    }
+};
+
+/// \brief Calls the handlers of the available CQEs, up to \c max
+/// \note Every SQE must belong to an \c IOUringOp
+///
+/// \param ring the ring
+/// \param max maximum number of CQEs
+/// \return the number of CQEs dispatched
+std::size_t
+dispatch_completions(IOUring& ring,
+                     std::size_t max = std::numeric_limits<std::size_t>::max());
+
+/// \class IOUringOpPool
+/// \brief A freelist of operations holding a \c State each.
+///
+/// Operations are allocated by chunks and recycled, so that there's no
+/// allocation per operation once the pool is warm.
+///
+/// \code
+/// IOUringOpPool<Read> pool;
+///
+/// void on_read(IOUringOpPool<Read>::Op& op, const IOUringCQE& cqe) {
+///     // use op.state() and cqe.res
+///     pool.release(&op);
+/// }
+///
+/// auto* op = pool.acquire<on_read>(fd, buf);
+/// sqe.readv(fd, &op->state().iov, 1, 0);
+/// sqe.user_data = op->user_data();
+/// \endcode
+template <typename State>
+class IOUringOpPool {
+public:
+    /// \brief An operation of the pool
+    class Op : public IOUringOp {
+    public:
+        State& state() noexcept {
+            return *std::launder(reinterpret_cast<State*>(&storage_));
+        }
+
+    private:
+        friend class IOUringOpPool;
+
+        std::aligned_storage_t<sizeof(State), alignof(State)> storage_;
+        Op* next_ = nullptr;
+    };
+
+    /// \brief Typed completion handler
+    using Handler = void (*)(Op& op, const IOUringCQE& cqe);
+
+    /// \brief Constructs an empty pool, growing by \c chunk operations
+    explicit IOUringOpPool(std::size_t chunk = 64) : chunk_(chunk) {
+        assert(chunk > 0);
+    }
+
+    /// \brief Frees the operations
+    /// \note Every operation must have been released
+    ~IOUringOpPool() {
+        assert(in_use_ == 0);
+    }
+
+    IOUringOpPool(const IOUringOpPool&) = delete;
+    IOUringOpPool& operator=(const IOUringOpPool&) = delete;
+
+    /// \brief Takes an operation completed by \c Fn, and constructs its state
+    /// from \c args
+    template <Handler Fn, typename... Args>
+    Op* acquire(Args&&... args) {
+        if (!free_) {
+            grow();
+        }
+
+        Op* op = free_;
+        if constexpr (std::is_aggregate_v<State>) {
+            new (&op->storage_) State{std::forward<Args>(args)...};
+        } else {
+            new (&op->storage_) State(std::forward<Args>(args)...);
+        }
+        free_ = op->next_;
+        bind<Fn>(*op);
+        ++in_use_;
+        return op;
+    }
+
+    /// \brief Sets the handler of an operation to \c Fn, e.g. when moving
+    /// to the next step of a state machine
+    template <Handler Fn>
+    static void bind(Op& op) noexcept {
+        op.handler = [](IOUringOp& base, const IOUringCQE& cqe) {
+            Fn(static_cast<Op&>(base), cqe);
+        };
+    }
+
+    /// \brief Destroys the state of an operation and recycles it
+    void release(Op* op) noexcept {
+        assert(op && in_use_ > 0);
+        op->state().~State();
+        op->handler = nullptr;
+        op->next_ = free_;
+        free_ = op;
+        --in_use_;
+    }
+
+    /// \brief Returns the number of operations taken
+    std::size_t in_use() const noexcept {
+        return in_use_;
+    }
+
+    /// \brief Returns the number of operations allocated
+    std::size_t capacity() const noexcept {
+        return chunks_.size() * chunk_;
+    }
+
+private:
+    void grow() {
+        chunks_.push_back(std::make_unique<Op[]>(chunk_));
+        Op* ops = chunks_.back().get();
+        for (std::size_t i = chunk_; i > 0; --i) {
+            ops[i - 1].next_ = free_;
+            free_ = &ops[i - 1];
+        }
+    }
+
+    std::size_t chunk_;
+    std::vector<std::unique_ptr<Op[]>> chunks_;
+    Op* free_ = nullptr;
+    std::size_t in_use_ = 0;
+};
+
+} // namespace bipolar
+
+#endif
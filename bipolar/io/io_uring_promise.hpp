@@ -0,0 +1,240 @@
+/// \file io_uring_promise.hpp
+/// Promises completed by \c IOUring
+
+#ifndef BIPOLAR_IO_IOURING_PROMISE_HPP_
+#define BIPOLAR_IO_IOURING_PROMISE_HPP_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <type_traits>
+#include <utility>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/futures/context.hpp"
+#include "bipolar/futures/promise.hpp"
+#include "bipolar/futures/suspended_task.hpp"
+#include "bipolar/io/io_uring.hpp"
+#include "bipolar/io/io_uring_op.hpp"
+#include "bipolar/net/compact_socket_address.hpp"
+
+namespace bipolar {
+class IOUringCompletion;
+
+namespace internal {
+class IOUringCompletionHandle;
+
+// The operations of make_io_uring_promise, which are driven on the thread
+// polling them
+inline IOUringOpPool<IOUringCompletion>& io_uring_completion_pool() {
+    thread_local IOUringOpPool<IOUringCompletion> pool;
+    return pool;
+}
+
+} // namespace internal
+
+/// \class IOUringCompletion
+/// \brief An operation submitted by \c make_io_uring_promise, taken from a
+/// per-thread \c IOUringOpPool.
+///
+/// Besides the result, it holds the storage of the arguments the kernel
+/// may read or write after the submission, such as addresses and message
+/// headers, so that they live as long as the operation.
+class IOUringCompletion {
+public:
+    IOUringCompletion() noexcept = default;
+
+    IOUringCompletion(const IOUringCompletion&) = delete;
+    IOUringCompletion& operator=(const IOUringCompletion&) = delete;
+
+    /// \brief Closes \c fd unless taken
+    ~IOUringCompletion() {
+        if (fd != -1) {
+            ::close(fd);
+        }
+    }
+
+    /// \c cqe.res once completed
+    int res = 0;
+
+    /// A fd opened by \c prep, closed along with the operation unless taken
+    /// by \c map
+    int fd = -1;
+
+    NativeSocketAddress addr;
+    socklen_t addrlen = NativeSocketAddress::capacity();
+    struct iovec iov;
+    struct msghdr msg;
+
+private:
+    using Op = IOUringOpPool<IOUringCompletion>::Op;
+
+    template <typename Prep, typename Map>
+    friend auto make_io_uring_promise(IOUring& ring, Prep prep, Map map);
+    friend class internal::IOUringCompletionHandle;
+
+    static void complete(Op& op, const IOUringCQE& cqe) {
+        IOUringCompletion& self = op.state();
+        self.res = cqe.res;
+        self.done = true;
+
+        // the promise is gone already
+        if (self.dropped) {
+            internal::io_uring_completion_pool().release(&op);
+            return;
+        }
+        SuspendedTask waiter = std::move(self.waiter);
+        waiter.resume_task();
+    }
+
+    bool done = false;
+    bool dropped = false;
+    SuspendedTask waiter;
+};
+
+namespace internal {
+// The share of the promise in its operation, which is released to the pool
+// by the last of the promise and the completion
+class IOUringCompletionHandle {
+public:
+    using Op = IOUringCompletion::Op;
+
+    IOUringCompletionHandle() noexcept = default;
+
+    explicit IOUringCompletionHandle(Op* op) noexcept : op_(op) {}
+
+    IOUringCompletionHandle(IOUringCompletionHandle&& rhs) noexcept
+        : op_(std::exchange(rhs.op_, nullptr)) {}
+
+    IOUringCompletionHandle& operator=(IOUringCompletionHandle&& rhs) noexcept {
+        if (this != &rhs) {
+            reset();
+            op_ = std::exchange(rhs.op_, nullptr);
+        }
+        return *this;
+    }
+
+    ~IOUringCompletionHandle() {
+        reset();
+    }
+
+    void reset() noexcept {
+        if (!op_) {
+            return;
+        }
+
+        IOUringCompletion& completion = op_->state();
+        if (completion.done) {
+            io_uring_completion_pool().release(op_);
+        } else {
+            completion.waiter.reset();
+            completion.dropped = true;
+        }
+        op_ = nullptr;
+    }
+
+    Op* get() const noexcept {
+        return op_;
+    }
+
+    IOUringCompletion* operator->() const noexcept {
+        return &op_->state();
+    }
+
+    IOUringCompletion& operator*() const noexcept {
+        return op_->state();
+    }
+
+    explicit operator bool() const noexcept {
+        return op_ != nullptr;
+    }
+
+private:
+    Op* op_ = nullptr;
+};
+
+} // namespace internal
+
+/// \brief Returns a promise submitting an operation to \c ring once polled,
+/// which produces \c map of its completion.
+///
+/// \c prep fills the SQE, given the \c IOUringCompletion whose storage it
+/// may use. It may also return an errno, the promise then fails with it
+/// without submitting anything. The SQE is queued with
+/// \c queue_submission_entry: the promise completes once the loop driving
+/// \c ring has submitted it and dispatched its CQE.
+///
+/// \code
+/// while (true) {
+///     executor.run_until_idle();
+///     ring.submit();
+///     ring.wait_completions(1);
+///     dispatch_completions(ring);
+/// }
+/// \endcode
+///
+/// \note The operation lives until its completion even if the promise is
+/// dropped, the buffers it refers to must too. The ring must be driven on
+/// the thread polling the promise, whose pool the operation is taken from.
+///
+/// \param ring the ring
+/// \param prep <tt>void(IOUringSQE&, IOUringCompletion&)</tt> or
+/// <tt>int(IOUringSQE&, IOUringCompletion&)</tt>, 0 to submit
+/// \param map <tt>Result<T, int>(IOUringCompletion&)</tt>
+template <typename Prep, typename Map>
+auto make_io_uring_promise(IOUring& ring, Prep prep, Map map) {
+    using result_type = std::invoke_result_t<Map&, IOUringCompletion&>;
+    using prep_type =
+        std::invoke_result_t<Prep&, IOUringSQE&, IOUringCompletion&>;
+
+    return make_promise(
+        [ring = &ring, prep = std::move(prep), map = std::move(map),
+         op = internal::IOUringCompletionHandle()](
+            Context& ctx) mutable -> result_type {
+            if (!op) {
+                op = internal::IOUringCompletionHandle(
+                    internal::io_uring_completion_pool()
+                        .acquire<&IOUringCompletion::complete>());
+
+                IOUringSQE sqe;
+                if constexpr (std::is_void_v<prep_type>) {
+                    prep(sqe, *op);
+                } else if (const int err = prep(sqe, *op); err != 0) {
+                    op->res = -err;
+                    op->done = true;
+                    return map(*op);
+                }
+                sqe.user_data = op.get()->user_data();
+                ring->queue_submission_entry(sqe);
+
+                op->waiter = ctx.suspend_task();
+                return Pending{};
+            }
+
+            if (!op->done) {
+                op->waiter = ctx.suspend_task();
+                return Pending{};
+            }
+            return map(*op);
+        });
+}
+
+/// \brief Returns a promise of \c res as a size, or its errno
+/// \see make_io_uring_promise
+template <typename Prep>
+auto make_io_uring_promise(IOUring& ring, Prep prep) {
+    return make_io_uring_promise(
+        ring, std::move(prep),
+        [](IOUringCompletion& op) -> Result<std::size_t, int> {
+            if (op.res < 0) {
+                return Err(-op.res);
+            }
+            return Ok(static_cast<std::size_t>(op.res));
+        });
+}
+
+} // namespace bipolar
+
+#endif
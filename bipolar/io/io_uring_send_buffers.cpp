@@ -0,0 +1,52 @@
+#include "bipolar/io/io_uring_send_buffers.hpp"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace bipolar {
+IOUringSendBuffers::IOUringSendBuffers(std::size_t count, std::size_t size)
+    : count_(count), size_(size), mem_(nullptr) {
+    assert(count > 0 && count <= 65536);
+    assert(size > 0);
+
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    const std::size_t bytes = (count * size + page - 1) / page * page;
+    mem_ = std::aligned_alloc(page, bytes);
+    if (!mem_) {
+        throw std::bad_alloc();
+    }
+
+    free_.reserve(count);
+    for (std::size_t i = count; i > 0; --i) {
+        free_.push_back(static_cast<std::uint16_t>(i - 1));
+    }
+}
+
+IOUringSendBuffers::~IOUringSendBuffers() {
+    std::free(mem_);
+}
+
+Result<Void, int> IOUringSendBuffers::register_to(IOUring& ring) {
+    std::vector<struct iovec> iovecs(count_);
+    for (std::size_t i = 0; i < count_; ++i) {
+        iovecs[i].iov_base = data(static_cast<std::uint16_t>(i));
+        iovecs[i].iov_len = size_;
+    }
+    return ring.register_buffer(iovecs.data(), iovecs.size());
+}
+
+Option<std::uint16_t> IOUringSendBuffers::acquire() {
+    if (free_.empty()) {
+        return None;
+    }
+
+    std::uint16_t index = free_.back();
+    free_.pop_back();
+    return Some(std::move(index));
+}
+
+} // namespace bipolar
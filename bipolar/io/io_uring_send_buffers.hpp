@@ -0,0 +1,111 @@
+/// \file io_uring_send_buffers.hpp
+/// Buffers of zero-copy sends
+
+#ifndef BIPOLAR_IO_IOURING_SEND_BUFFERS_HPP_
+#define BIPOLAR_IO_IOURING_SEND_BUFFERS_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/io/io_uring.hpp"
+
+namespace bipolar {
+/// \class IOUringSendBuffers
+/// \brief A pool of buffers for zero-copy sends
+///
+/// The kernel reads the buffer of a zero-copy send until its notification,
+/// after the send result. \c complete only returns a buffer to the pool
+/// with the last CQE of its send, so that it's never reused while the
+/// kernel may still read it.
+///
+/// \code
+/// IOUringSendBuffers buffers(64, 64 * 1024);
+/// buffers.register_to(ring);
+///
+/// auto index = buffers.acquire().value();
+/// // fill buffers.data(index)
+/// sqe.send_zc_fixed(sock, buffers.data(index), n, 0, index);
+/// sqe.user_data = index;
+/// // ... for every CQE of the send
+/// buffers.complete(cqe, cqe.user_data);
+/// \endcode
+class IOUringSendBuffers {
+public:
+    /// \brief Allocates \c count page-aligned buffers of \c size bytes
+    ///
+    /// \param count number of buffers, at most 65536
+    /// \param size size of every buffer
+    /// \throw std::bad_alloc
+    IOUringSendBuffers(std::size_t count, std::size_t size);
+
+    /// \brief Frees the buffers
+    /// \note The sends using them must have been completed
+    ~IOUringSendBuffers();
+
+    IOUringSendBuffers(const IOUringSendBuffers&) = delete;
+    IOUringSendBuffers& operator=(const IOUringSendBuffers&) = delete;
+
+    /// \brief Registers the buffers as the fixed buffers of \c ring, whose
+    /// indexes are the ones of the pool
+    ///
+    /// \return \c Err with errno on failure; \c Ok on success
+    /// \see IOUringSQE::send_zc_fixed
+    Result<Void, int> register_to(IOUring& ring);
+
+    /// \brief Takes a vacant buffer
+    ///
+    /// \return the index of the buffer, or \c None if all are in use
+    Option<std::uint16_t> acquire();
+
+    /// \brief Returns the buffer of a zero-copy send once \c cqe is its last
+    /// CQE, either the notification or a result without one
+    ///
+    /// \param cqe a CQE of the send
+    /// \param index the buffer of the send
+    /// \return true if the buffer was returned
+    bool complete(const IOUringCQE& cqe, std::uint16_t index) {
+        if (cqe.has_more()) {
+            // waits for the notification
+            return false;
+        }
+        release(index);
+        return true;
+    }
+
+    /// \brief Returns a buffer the kernel isn't reading
+    void release(std::uint16_t index) {
+        assert(index < count_);
+        free_.push_back(index);
+    }
+
+    /// \brief Returns the address of a buffer
+    void* data(std::uint16_t index) const noexcept {
+        assert(index < count_);
+        return static_cast<char*>(mem_) + index * size_;
+    }
+
+    /// \brief Returns the size of every buffer
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// \brief Returns the number of vacant buffers
+    std::size_t available() const noexcept {
+        return free_.size();
+    }
+
+private:
+    std::size_t count_;
+    std::size_t size_;
+    void* mem_;
+    std::vector<std::uint16_t> free_; ///< Vacant buffers, lowest last
+};
+
+} // namespace bipolar
+
+#endif
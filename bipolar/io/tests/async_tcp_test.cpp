@@ -0,0 +1,193 @@
+#include "bipolar/io/async_tcp.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <tuple>
+
+#include "bipolar/futures/single_threaded_executor.hpp"
+#include "bipolar/io/io_uring_op.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+namespace {
+class FakeContext : public Context {
+public:
+    Executor* get_executor() const override {
+        return nullptr;
+    }
+
+    SuspendedTask suspend_task() override {
+        return {};
+    }
+};
+
+// The lowest fd available
+int next_fd() {
+    const int fd = ::dup(0);
+    ::close(fd);
+    return fd;
+}
+
+inline constexpr auto anonymous_addr =
+    SocketAddress(IPv4Address(127, 0, 0, 1), 0);
+
+// Runs the tasks and the ring until `done`
+template <typename Pred>
+void drive(IOUring& ring, SingleThreadedExecutor& executor, Pred done) {
+    while (true) {
+        executor.run_until_idle();
+        if (done()) {
+            return;
+        }
+        ASSERT_TRUE(ring.submit().is_ok());
+        ASSERT_TRUE(ring.wait_completions(1).is_ok());
+        dispatch_completions(ring);
+    }
+}
+
+} // namespace
+
+TEST(AsyncTcp, connect_accept_echo) {
+    struct io_uring_params p{};
+    IOUring ring(16, &p);
+    SingleThreadedExecutor executor;
+
+    auto listener = AsyncTcpListener::bind(ring, anonymous_addr)
+                        .expect("bind to 127.0.0.1:0 failed");
+    const auto server_addr = listener.listener().local_addr().value();
+
+    Option<AsyncTcpStream> server;
+    Option<AsyncTcpStream> client;
+    executor.schedule_task(PendingTask(listener.accept().and_then(
+        [&](std::tuple<AsyncTcpStream, SocketAddress>& conn) {
+            EXPECT_TRUE(std::get<1>(conn).addr().is_loopback());
+            server.emplace(std::move(std::get<0>(conn)));
+            return Ok(Void{});
+        })));
+    executor.schedule_task(PendingTask(
+        AsyncTcpStream::connect(ring, server_addr)
+            .and_then([&](AsyncTcpStream& stream) {
+                client.emplace(std::move(stream));
+                return Ok(Void{});
+            })));
+    drive(ring, executor,
+          [&] { return server.has_value() && client.has_value(); });
+    ASSERT_TRUE(server.has_value());
+    ASSERT_TRUE(client.has_value());
+    EXPECT_EQ(client.value().stream().peer_addr().value(), server_addr);
+
+    // the read is submitted before the data is written
+    char rbuf[16] = {};
+    std::size_t nread = 0;
+    executor.schedule_task(PendingTask(
+        server.value().read(rbuf, sizeof(rbuf)).and_then([&](std::size_t& n) {
+            nread = n;
+            return Ok(Void{});
+        })));
+    executor.run_until_idle();
+    ASSERT_TRUE(ring.submit().is_ok());
+
+    std::size_t nwritten = 0;
+    executor.schedule_task(PendingTask(
+        client.value().write("hello", 5).and_then([&](std::size_t& n) {
+            nwritten = n;
+            return Ok(Void{});
+        })));
+    drive(ring, executor, [&] { return nread > 0 && nwritten > 0; });
+    EXPECT_EQ(nwritten, 5);
+    EXPECT_EQ(nread, 5);
+    EXPECT_EQ(std::string(rbuf, nread), "hello");
+
+    // EOF
+    client.clear();
+    bool eof = false;
+    executor.schedule_task(PendingTask(
+        server.value().recv(rbuf, sizeof(rbuf)).and_then([&](std::size_t& n) {
+            eof = n == 0;
+            return Ok(Void{});
+        })));
+    drive(ring, executor, [&] { return eof; });
+    EXPECT_TRUE(eof);
+
+    // recycled
+    EXPECT_EQ(internal::io_uring_completion_pool().in_use(), 0);
+}
+
+TEST(AsyncTcp, connect_refused) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    SingleThreadedExecutor executor;
+
+    // a port nobody listens on
+    SocketAddress addr(IPv4Address(127, 0, 0, 1), 0);
+    {
+        auto listener = TcpListener::bind(anonymous_addr).value();
+        addr = listener.local_addr().value();
+    }
+
+    Option<int> error;
+    executor.schedule_task(PendingTask(
+        AsyncTcpStream::connect(ring, addr).or_else([&](const int& e) {
+            error.emplace(e);
+            return Ok(Void{});
+        })));
+    drive(ring, executor, [&] { return error.has_value(); });
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error.value(), ECONNREFUSED);
+}
+
+TEST(AsyncTcp, connect_lazy) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    SingleThreadedExecutor executor;
+
+    auto listener = TcpListener::bind(anonymous_addr).value();
+    const int fd = next_fd();
+    auto connect =
+        AsyncTcpStream::connect(ring, listener.local_addr().value());
+    // no socket until polled
+    EXPECT_EQ(next_fd(), fd);
+    EXPECT_EQ(ring.backlog(), 0);
+
+    Option<AsyncTcpStream> client;
+    executor.schedule_task(
+        PendingTask(std::move(connect).and_then([&](AsyncTcpStream& stream) {
+            client.emplace(std::move(stream));
+            return Ok(Void{});
+        })));
+    drive(ring, executor, [&] { return client.has_value(); });
+    ASSERT_TRUE(client.has_value());
+    EXPECT_EQ(client.value().stream().as_fd(), fd);
+    EXPECT_EQ(internal::io_uring_completion_pool().in_use(), 0);
+}
+
+TEST(AsyncTcp, dropped_in_flight) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    FakeContext ctx;
+
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    AsyncTcpStream stream(ring, TcpStream(fds[0]));
+
+    char buf[8];
+    {
+        auto read = stream.read(buf, sizeof(buf));
+        EXPECT_TRUE(read(ctx).is_pending());
+        EXPECT_EQ(internal::io_uring_completion_pool().in_use(), 1);
+        ASSERT_EQ(ring.submit().value(), 1);
+    }
+    // the operation outlives the promise until its completion
+    EXPECT_EQ(internal::io_uring_completion_pool().in_use(), 1);
+
+    ASSERT_EQ(::write(fds[1], "x", 1), 1);
+    ASSERT_TRUE(ring.wait_completions(1).is_ok());
+    EXPECT_EQ(dispatch_completions(ring), 1);
+    EXPECT_EQ(internal::io_uring_completion_pool().in_use(), 0);
+    ::close(fds[1]);
+}
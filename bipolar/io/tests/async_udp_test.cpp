@@ -0,0 +1,51 @@
+#include "bipolar/io/async_udp.hpp"
+
+#include <string>
+#include <tuple>
+
+#include "bipolar/futures/single_threaded_executor.hpp"
+#include "bipolar/io/io_uring_op.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+TEST(AsyncUdp, send_to_recv_from) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    SingleThreadedExecutor executor;
+
+    const auto anonymous_addr = SocketAddress(IPv4Address(127, 0, 0, 1), 0);
+    auto a = AsyncUdpSocket::bind(ring, anonymous_addr).value();
+    auto b = AsyncUdpSocket::bind(ring, anonymous_addr).value();
+    const auto a_addr = a.socket().local_addr().value();
+    const auto b_addr = b.socket().local_addr().value();
+
+    char buf[16] = {};
+    Option<std::tuple<std::size_t, SocketAddress>> received;
+    std::size_t sent = 0;
+    executor.schedule_task(PendingTask(
+        b.recv_from(buf, sizeof(buf))
+            .and_then([&](std::tuple<std::size_t, SocketAddress>& r) {
+                received.emplace(r);
+                return Ok(Void{});
+            })));
+    executor.schedule_task(PendingTask(
+        a.send_to("ping", 4, b_addr).and_then([&](std::size_t& n) {
+            sent = n;
+            return Ok(Void{});
+        })));
+
+    while (!received.has_value() || sent == 0) {
+        executor.run_until_idle();
+        ASSERT_TRUE(ring.submit().is_ok());
+        ASSERT_TRUE(ring.wait_completions(1).is_ok());
+        dispatch_completions(ring);
+        executor.run_until_idle();
+    }
+
+    EXPECT_EQ(sent, 4);
+    EXPECT_EQ(std::get<0>(received.value()), 4);
+    EXPECT_EQ(std::get<1>(received.value()), a_addr);
+    EXPECT_EQ(std::string(buf, 4), "ping");
+}
@@ -0,0 +1,108 @@
+#include "bipolar/io/io_uring.hpp"
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+static void queue_nop(IOUring& ring, std::uint64_t user_data,
+                      std::uint8_t flags = 0) {
+    IOUringSQE sqe;
+    sqe.nop();
+    sqe.user_data = user_data;
+    sqe.set_flags(flags);
+    ring.queue_submission_entry(sqe);
+}
+
+TEST(IOUring, Backlog) {
+    struct io_uring_params p{};
+    IOUring ring(4, &p);
+    EXPECT_EQ(ring.cq_high_watermark(), p.cq_entries);
+
+    for (std::uint64_t i = 0; i < 32; ++i) {
+        queue_nop(ring, i);
+    }
+    EXPECT_EQ(ring.backlog(), 32);
+    // the order of submissions is kept
+    EXPECT_TRUE(ring.get_submission_entry().is_error());
+
+    // throttled by the CQ high watermark
+    while (ring.submit().value() > 0) {
+    }
+    EXPECT_EQ(ring.inflight(), p.cq_entries);
+    EXPECT_EQ(ring.backlog(), 32 - p.cq_entries);
+
+    std::uint64_t next = 0;
+    while (next < 32) {
+        auto res = ring.submit();
+        ASSERT_TRUE(res.is_ok());
+        EXPECT_LE(ring.inflight(), p.cq_entries);
+
+        while (auto cqe = ring.peek_completion_entry()) {
+            if (cqe.is_error()) {
+                break;
+            }
+            EXPECT_EQ(cqe.value().get().user_data, next++);
+            ring.seen(1);
+        }
+    }
+
+    EXPECT_EQ(ring.backlog(), 0);
+    EXPECT_EQ(ring.inflight(), 0);
+    EXPECT_FALSE(ring.cq_overflow_pending());
+    EXPECT_EQ(ring.cq_dropped(), 0);
+    EXPECT_TRUE(ring.get_submission_entry().is_ok());
+}
+
+TEST(IOUring, BacklogChain) {
+    struct io_uring_params p{};
+    IOUring ring(4, &p);
+    ring.set_cq_high_watermark(4);
+
+    // waits for the end of the chain
+    queue_nop(ring, 0, IOSQE_IO_LINK);
+    EXPECT_EQ(ring.submit().value(), 0);
+    queue_nop(ring, 1, IOSQE_IO_LINK);
+    queue_nop(ring, 2);
+    queue_nop(ring, 3);
+    queue_nop(ring, 4, IOSQE_IO_LINK);
+    queue_nop(ring, 5, IOSQE_IO_LINK);
+    queue_nop(ring, 6);
+
+    // the second chain doesn't fit
+    EXPECT_EQ(ring.submit().value(), 4);
+    EXPECT_EQ(ring.backlog(), 3);
+
+    // a chain may complete after the SQEs following it
+    std::uint64_t completed = 0;
+    for (std::uint64_t i = 0; i < 4; ++i) {
+        auto cqe = ring.get_completion_entry();
+        ASSERT_TRUE(cqe.is_ok());
+        EXPECT_EQ(cqe.value().get().res, 0);
+        completed |= 1U << cqe.value().get().user_data;
+        ring.seen(1);
+    }
+    EXPECT_EQ(completed, 0x0f);
+
+    EXPECT_EQ(ring.submit().value(), 3);
+    for (std::uint64_t i = 4; i < 7; ++i) {
+        auto cqe = ring.get_completion_entry();
+        ASSERT_TRUE(cqe.is_ok());
+        EXPECT_EQ(cqe.value().get().res, 0);
+        completed |= 1U << cqe.value().get().user_data;
+        ring.seen(1);
+    }
+    EXPECT_EQ(completed, 0x7f);
+    EXPECT_EQ(ring.inflight(), 0);
+}
+
+TEST(IOUring, BacklogReservedUserData) {
+    ASSERT_DEATH(
+        {
+            struct io_uring_params p{};
+            IOUring ring(4, &p);
+            queue_nop(ring, IOUring::kReservedUserData);
+        },
+        "");
+}
@@ -1,6 +1,4 @@
-#define private public
 #include "bipolar/io/io_uring.hpp"
-#undef private
 
 #include <cstdio>
 
@@ -11,12 +9,12 @@ using namespace bipolar;
 static void queue_n_nops(IOUring& ring, std::size_t n) {
     for (std::size_t i = 0; i < n; ++i) {
         auto res = ring.get_submission_entry();
-        EXPECT_TRUE(bool(res));
+        EXPECT_TRUE(res.is_ok());
         res.value().get().nop();
     }
 
     auto res = ring.submit();
-    EXPECT_TRUE(bool(res));
+    EXPECT_TRUE(res.is_ok());
     EXPECT_EQ(res.value(), n);
 }
 
@@ -29,11 +27,19 @@ TEST(IOUring, CqFull) {
     queue_n_nops(ring, 4);
 
     std::size_t i = 0;
-    while (auto res = ring.peek_completion_entry()) {
+    while (ring.peek_completion_entry().is_ok()) {
         ring.seen(1);
         ++i;
     }
 
-    EXPECT_EQ(i, 8);
-    EXPECT_EQ(*ring.cq_.koverflow_, 4);
+    if (p.features & IORING_FEAT_NODROP) {
+        // held by the kernel, then flushed once the CQ is drained
+        EXPECT_EQ(i, 12);
+        EXPECT_EQ(ring.cq_dropped(), 0);
+    } else {
+        EXPECT_EQ(i, 8);
+        EXPECT_EQ(ring.cq_dropped(), 4);
+    }
+    EXPECT_FALSE(ring.cq_overflow_pending());
+    EXPECT_EQ(ring.inflight(), 0);
 }
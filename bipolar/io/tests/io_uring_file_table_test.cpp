@@ -0,0 +1,147 @@
+#include "bipolar/io/io_uring_file_table.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <boost/scope_exit.hpp>
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+static IOUringCQE& complete(IOUring& ring) {
+    EXPECT_TRUE(ring.submit().is_ok());
+    auto res = ring.get_completion_entry();
+    EXPECT_TRUE(res.is_ok());
+    return res.value();
+}
+
+TEST(IOUring, FileTableInstall) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    IOUringFileTable table(ring, 2);
+    EXPECT_EQ(table.capacity(), 2);
+    EXPECT_EQ(table.used(), 0);
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    auto slot = table.install(fds[1]);
+    ASSERT_TRUE(slot.is_ok());
+    EXPECT_EQ(slot.value().index, 0);
+    // the table holds its own reference
+    close(fds[1]);
+
+    char buf[] = "foo";
+    struct iovec iov = {
+        .iov_base = buf,
+        .iov_len = 3,
+    };
+    IOUringSQE& sqe = ring.get_submission_entry().value();
+    sqe.writev(slot.value(), &iov, 1, 0);
+    EXPECT_TRUE(sqe.sqe_flags() & IOSQE_FIXED_FILE);
+    // kept when setting the other flags
+    sqe.set_flags(IOSQE_IO_DRAIN);
+    EXPECT_EQ(sqe.sqe_flags(), IOSQE_FIXED_FILE | IOSQE_IO_DRAIN);
+    EXPECT_EQ(complete(ring).res, 3);
+    ring.seen(1);
+
+    char out[4] = {};
+    EXPECT_EQ(read(fds[0], out, 3), 3);
+    EXPECT_STREQ(out, "foo");
+
+    EXPECT_TRUE(table.reserve().is_ok());
+    EXPECT_EQ(table.used(), 2);
+    EXPECT_EQ(table.install(fds[0]).error(), ENFILE);
+    EXPECT_EQ(table.reserve().error(), ENFILE);
+
+    // closes the write end
+    EXPECT_TRUE(table.release(slot.value()).is_ok());
+    EXPECT_EQ(table.used(), 1);
+    EXPECT_EQ(read(fds[0], out, 3), 0);
+    close(fds[0]);
+
+    EXPECT_EQ(table.install(0).value().index, 0);
+}
+
+TEST(IOUring, FileTableDirect) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    IOUringFileTable table(ring, 4);
+
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    BOOST_SCOPE_EXIT_ALL(&) {
+        close(listener);
+    };
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrlen = sizeof(addr);
+    ASSERT_EQ(bind(listener, (struct sockaddr*)&addr, sizeof(addr)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+    ASSERT_EQ(getsockname(listener, (struct sockaddr*)&addr, &addrlen), 0);
+
+    const int client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(client, 0);
+    BOOST_SCOPE_EXIT_ALL(&) {
+        close(client);
+    };
+    ASSERT_EQ(connect(client, (struct sockaddr*)&addr, sizeof(addr)), 0);
+
+    const auto slot = table.reserve().value();
+    ring.get_submission_entry().value().get().accept_direct(
+        listener, nullptr, nullptr, 0, slot);
+    IOUringCQE& cqe = complete(ring);
+    if (cqe.res == -EINVAL) {
+        EXPECT_FALSE("Direct descriptors not supported");
+        return;
+    }
+    // no fd was created
+    EXPECT_EQ(cqe.res, 0);
+    ring.seen(1);
+
+    ASSERT_EQ(write(client, "bar", 3), 3);
+    char buf[4] = {};
+    struct iovec iov = {
+        .iov_base = buf,
+        .iov_len = 3,
+    };
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    ring.get_submission_entry().value().get().recvmsg(slot, &msg, 1);
+    EXPECT_EQ(complete(ring).res, 3);
+    ring.seen(1);
+    EXPECT_STREQ(buf, "bar");
+
+    // closes the connection
+    EXPECT_TRUE(table.release(slot).is_ok());
+    EXPECT_EQ(read(client, buf, 3), 0);
+
+    // opened into a slot
+    char path[] = "./XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    BOOST_SCOPE_EXIT_ALL(&) {
+        unlink(path);
+    };
+
+    const auto file = table.reserve().value();
+    ring.get_submission_entry().value().get().openat_direct(
+        AT_FDCWD, path, O_WRONLY, 0, file);
+    EXPECT_EQ(complete(ring).res, 0);
+    ring.seen(1);
+
+    iov.iov_base = (void*)"baz";
+    ring.get_submission_entry().value().get().writev(file, &iov, 1, 0);
+    EXPECT_EQ(complete(ring).res, 3);
+    ring.seen(1);
+    EXPECT_TRUE(table.release(file).is_ok());
+}
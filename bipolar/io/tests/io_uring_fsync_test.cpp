@@ -85,7 +85,7 @@ TEST(IOUring, BarrierFsync) {
     IOUringSQE& sqe = sub_res.value();
     sqe.fsync(fd, IORING_FSYNC_DATASYNC);
     sqe.user_data = 1;
-    sqe.flags = IOSQE_IO_DRAIN;
+    sqe.set_flags(IOSQE_IO_DRAIN);
 
     auto res = ring.submit();
     EXPECT_TRUE(bool(res));
@@ -23,7 +23,7 @@ TEST(IOUring, SingleLink) {
 
     IOUringSQE& sqe = sub_res.value();
     sqe.nop();
-    sqe.flags |= IOSQE_IO_LINK;
+    sqe.add_flags(IOSQE_IO_LINK);
 
     sub_res = ring.get_submission_entry();
     EXPECT_TRUE(bool(sub_res));
@@ -54,14 +54,14 @@ TEST(IOUring, DoubleLink) {
 
     IOUringSQE& sqe = sub_res.value();
     sqe.nop();
-    sqe.flags |= IOSQE_IO_LINK;
+    sqe.add_flags(IOSQE_IO_LINK);
 
     sub_res = ring.get_submission_entry();
     EXPECT_TRUE(bool(sub_res));
 
     IOUringSQE& sqe2 = sub_res.value();
     sqe2.nop();
-    sqe2.flags |= IOSQE_IO_LINK;
+    sqe2.add_flags(IOSQE_IO_LINK);
 
     sub_res = ring.get_submission_entry();
     EXPECT_TRUE(bool(sub_res));
@@ -92,7 +92,7 @@ TEST(IOUring, DoubleChain) {
 
     IOUringSQE& sqe = sub_res.value();
     sqe.nop();
-    sqe.flags |= IOSQE_IO_LINK;
+    sqe.add_flags(IOSQE_IO_LINK);
 
     sub_res = ring.get_submission_entry();
     EXPECT_TRUE(bool(sub_res));
@@ -105,7 +105,7 @@ TEST(IOUring, DoubleChain) {
 
     IOUringSQE& sqe3 = sub_res.value();
     sqe3.nop();
-    sqe3.flags |= IOSQE_IO_LINK;
+    sqe3.add_flags(IOSQE_IO_LINK);
 
     sub_res = ring.get_submission_entry();
     EXPECT_TRUE(bool(sub_res));
@@ -136,7 +136,7 @@ TEST(IOUring, SingleLinkFail) {
 
     IOUringSQE& sqe = sub_res.value();
     sqe.nop();
-    sqe.flags |= IOSQE_IO_LINK;
+    sqe.add_flags(IOSQE_IO_LINK);
 
     auto sub_res2 = ring.get_submission_entry();
     EXPECT_TRUE(bool(sub_res2));
@@ -0,0 +1,97 @@
+#include "bipolar/io/io_uring_op.hpp"
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+namespace {
+struct Nop {
+    int* done;
+};
+
+IOUringOpPool<Nop>* nop_pool;
+
+void on_nop(IOUringOpPool<Nop>::Op& op, const IOUringCQE& cqe) {
+    EXPECT_EQ(cqe.res, 0);
+    ++*op.state().done;
+    nop_pool->release(&op);
+}
+
+} // namespace
+
+TEST(IOUring, Metrics) {
+    IOUringOptions options;
+    options.entries = 4;
+    IOUring ring(options);
+    ring.track_ops(true);
+
+    IOUringOpPool<Nop> pool;
+    nop_pool = &pool;
+
+    int done = 0;
+    for (int i = 0; i < 6; ++i) {
+        IOUringSQE sqe;
+        sqe.nop();
+        sqe.user_data = pool.acquire<on_nop>(&done)->user_data();
+        ring.queue_submission_entry(sqe);
+    }
+
+    auto snapshot = ring.metrics();
+    EXPECT_EQ(snapshot.enabled, IOUringMetrics::kEnabled);
+    EXPECT_EQ(snapshot.backlog, 6);
+    EXPECT_EQ(snapshot.inflight, 0);
+
+    // the SQ is full, then the rest of the backlog is submitted
+    EXPECT_EQ(ring.submit(4).value(), 4);
+    EXPECT_TRUE(ring.get_submission_entry().is_error());
+    snapshot = ring.metrics();
+    EXPECT_EQ(snapshot.backlog, 2);
+    EXPECT_EQ(snapshot.inflight, 4);
+
+    EXPECT_EQ(dispatch_completions(ring), 4);
+    EXPECT_EQ(ring.submit(2).value(), 2);
+    EXPECT_EQ(dispatch_completions(ring), 2);
+    EXPECT_EQ(done, 6);
+
+    snapshot = ring.metrics();
+    EXPECT_EQ(snapshot.backlog, 0);
+    EXPECT_EQ(snapshot.inflight, 0);
+    EXPECT_EQ(snapshot.cq_dropped, 0);
+
+    std::ostringstream os;
+    os << snapshot;
+    EXPECT_NE(os.str().find("inflight=0"), std::string::npos);
+
+    if (IOUringMetrics::kEnabled) {
+        EXPECT_GE(snapshot.enters, 2);
+        EXPECT_EQ(snapshot.submitted, 6);
+        EXPECT_EQ(snapshot.completed, 6);
+        EXPECT_EQ(snapshot.sq_full, 1);
+        EXPECT_EQ(snapshot.submit_batch.count, 2);
+        EXPECT_EQ(snapshot.submit_batch.max, 4);
+        EXPECT_EQ(snapshot.op_latency[IORING_OP_NOP].count, 6);
+        EXPECT_EQ(snapshot.op_latency[IORING_OP_READV].count, 0);
+        EXPECT_NE(os.str().find("op_latency_ns"), std::string::npos);
+    } else {
+        EXPECT_EQ(snapshot.submitted, 0);
+        EXPECT_EQ(os.str().find("submitted="), std::string::npos);
+    }
+}
+
+TEST(IOUring, MetricsEnterErrors) {
+    IOUringOptions options;
+    options.entries = 4;
+    IOUring ring(options);
+
+    // nothing to wait for
+    auto res = ring.wait_completions(1, std::chrono::milliseconds(1));
+    EXPECT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 0);
+
+    const auto snapshot = ring.metrics();
+    if (IOUringMetrics::kEnabled) {
+        EXPECT_GE(snapshot.enters, 1);
+    }
+}
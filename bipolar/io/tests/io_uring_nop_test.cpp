@@ -29,7 +29,7 @@ TEST(IOUring, BarrierNop) {
         IOUringSQE& sqe = res.value();
         sqe.nop();
         if (i == 4) {
-            sqe.flags = IOSQE_IO_DRAIN;
+            sqe.set_flags(IOSQE_IO_DRAIN);
         }
     }
 
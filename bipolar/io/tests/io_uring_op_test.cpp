@@ -0,0 +1,125 @@
+#include "bipolar/io/io_uring_op.hpp"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+namespace {
+struct Nop {
+    int id;
+    std::vector<int>* done;
+};
+
+IOUringOpPool<Nop>* nop_pool;
+
+void on_nop(IOUringOpPool<Nop>::Op& op, const IOUringCQE& cqe) {
+    EXPECT_EQ(cqe.res, 0);
+    op.state().done->push_back(op.state().id);
+    nop_pool->release(&op);
+}
+
+struct Transfer {
+    int fds[2];
+    char buf[16];
+    struct iovec iov;
+    std::string* received;
+};
+
+IOUring* transfer_ring;
+IOUringOpPool<Transfer>* transfer_pool;
+
+void on_read(IOUringOpPool<Transfer>::Op& op, const IOUringCQE& cqe) {
+    ASSERT_EQ(cqe.res, 5);
+    op.state().received->assign(op.state().buf, cqe.res);
+    transfer_pool->release(&op);
+}
+
+void on_write(IOUringOpPool<Transfer>::Op& op, const IOUringCQE& cqe) {
+    ASSERT_EQ(cqe.res, 5);
+
+    // the next step reuses the operation
+    Transfer& t = op.state();
+    t.iov = {t.buf, sizeof(t.buf)};
+    IOUringOpPool<Transfer>::bind<on_read>(op);
+    IOUringSQE& sqe = transfer_ring->get_submission_entry().value();
+    sqe.readv(t.fds[0], &t.iov, 1, 0);
+    sqe.user_data = op.user_data();
+    EXPECT_TRUE(transfer_ring->submit().is_ok());
+}
+
+} // namespace
+
+TEST(IOUring, OpDispatch) {
+    struct io_uring_params p{};
+    IOUring ring(16, &p);
+    IOUringOpPool<Nop> pool(4);
+    nop_pool = &pool;
+
+    std::vector<int> done;
+    for (int i = 0; i < 10; ++i) {
+        auto* op = pool.acquire<on_nop>(i, &done);
+        IOUringSQE& sqe = ring.get_submission_entry().value();
+        sqe.nop();
+        sqe.user_data = op->user_data();
+    }
+    EXPECT_EQ(pool.in_use(), 10);
+    EXPECT_EQ(pool.capacity(), 12);
+
+    EXPECT_TRUE(ring.submit(10).is_ok());
+    EXPECT_EQ(dispatch_completions(ring, 4), 4);
+    EXPECT_EQ(dispatch_completions(ring), 6);
+    EXPECT_EQ(dispatch_completions(ring), 0);
+    EXPECT_EQ(done.size(), 10);
+    EXPECT_EQ(pool.in_use(), 0);
+
+    // recycled before growing
+    std::vector<IOUringOpPool<Nop>::Op*> ops;
+    for (int i = 0; i < 12; ++i) {
+        ops.push_back(pool.acquire<on_nop>(i, &done));
+    }
+    EXPECT_EQ(pool.capacity(), 12);
+    ops.push_back(pool.acquire<on_nop>(12, &done));
+    EXPECT_EQ(pool.capacity(), 16);
+    for (auto* op : ops) {
+        pool.release(op);
+    }
+    EXPECT_EQ(pool.in_use(), 0);
+}
+
+TEST(IOUring, OpStateMachine) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    IOUringOpPool<Transfer> pool;
+    transfer_ring = &ring;
+    transfer_pool = &pool;
+
+    std::string received;
+    auto* op = pool.acquire<on_write>();
+    Transfer& t = op->state();
+    ASSERT_EQ(::pipe(t.fds), 0);
+    std::memcpy(t.buf, "hello", 5);
+    t.iov = {t.buf, 5};
+    t.received = &received;
+
+    IOUringSQE& sqe = ring.get_submission_entry().value();
+    sqe.writev(t.fds[1], &t.iov, 1, 0);
+    sqe.user_data = op->user_data();
+    EXPECT_TRUE(ring.submit().is_ok());
+
+    const int fds[2] = {t.fds[0], t.fds[1]};
+    while (pool.in_use() > 0) {
+        ASSERT_TRUE(ring.wait_completions(1).is_ok());
+        dispatch_completions(ring);
+    }
+    EXPECT_EQ(received, "hello");
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
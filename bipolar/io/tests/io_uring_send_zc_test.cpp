@@ -0,0 +1,144 @@
+#include "bipolar/io/io_uring_send_buffers.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <boost/scope_exit.hpp>
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+// A connected pair of TCP sockets over loopback
+static void tcp_pair(int fds[2]) {
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    BOOST_SCOPE_EXIT_ALL(&) {
+        close(listener);
+    };
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrlen = sizeof(addr);
+    ASSERT_EQ(bind(listener, (struct sockaddr*)&addr, sizeof(addr)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+    ASSERT_EQ(getsockname(listener, (struct sockaddr*)&addr, &addrlen), 0);
+
+    fds[0] = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fds[0], 0);
+    ASSERT_EQ(connect(fds[0], (struct sockaddr*)&addr, sizeof(addr)), 0);
+    fds[1] = accept(listener, nullptr, nullptr);
+    ASSERT_GE(fds[1], 0);
+}
+
+TEST(IOUring, SendZc) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+
+    int fds[2];
+    tcp_pair(fds);
+    BOOST_SCOPE_EXIT_ALL(&) {
+        close(fds[0]);
+        close(fds[1]);
+    };
+
+    IOUringSendBuffers buffers(2, 4096);
+    EXPECT_EQ(buffers.available(), 2);
+    const bool fixed = buffers.register_to(ring).is_ok();
+
+    for (std::uint16_t i = 0; i < 3; ++i) {
+        auto index = buffers.acquire();
+        ASSERT_TRUE(index.has_value());
+        const std::string msg = "zc" + std::to_string(i);
+        std::memcpy(buffers.data(index.value()), msg.data(), msg.size());
+
+        IOUringSQE& sqe = ring.get_submission_entry().value();
+        if (fixed && i == 1) {
+            sqe.send_zc_fixed(fds[0], buffers.data(index.value()),
+                              msg.size(), 0, index.value());
+        } else {
+            sqe.send_zc(fds[0], buffers.data(index.value()), msg.size(), 0);
+        }
+        sqe.user_data = index.value();
+        EXPECT_EQ(ring.submit().value(), 1);
+
+        // the result, then the notification
+        std::size_t cqes = 0;
+        bool returned = false;
+        while (!returned) {
+            auto res = ring.get_completion_entry();
+            ASSERT_TRUE(res.is_ok());
+            IOUringCQE& cqe = res.value();
+            if (cqe.res == -EINVAL) {
+                EXPECT_FALSE("Zero-copy send not supported");
+                return;
+            }
+            EXPECT_EQ(cqe.user_data, index.value());
+            if (cqe.is_notification()) {
+                EXPECT_GE(cqes, 1);
+            } else {
+                EXPECT_EQ(cqe.res, msg.size());
+            }
+
+            ++cqes;
+            returned = buffers.complete(cqe, cqe.user_data);
+            ring.seen(1);
+            EXPECT_EQ(ring.inflight(), returned ? 0 : 1);
+        }
+        EXPECT_EQ(buffers.available(), 2);
+
+        char buf[16] = {};
+        EXPECT_EQ(read(fds[1], buf, sizeof(buf)), msg.size());
+        EXPECT_EQ(std::string(buf), msg);
+    }
+}
+
+TEST(IOUring, SendmsgZc) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+
+    int fds[2];
+    tcp_pair(fds);
+    BOOST_SCOPE_EXIT_ALL(&) {
+        close(fds[0]);
+        close(fds[1]);
+    };
+
+    char head[] = "foo";
+    char body[] = "bar";
+    struct iovec iovs[] = {
+        {.iov_base = head, .iov_len = 3},
+        {.iov_base = body, .iov_len = 3},
+    };
+    struct msghdr msg{};
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = 2;
+    ring.get_submission_entry().value().get().sendmsg_zc(fds[0], &msg, 0);
+    EXPECT_EQ(ring.submit().value(), 1);
+
+    bool last = false;
+    while (!last) {
+        auto res = ring.get_completion_entry();
+        ASSERT_TRUE(res.is_ok());
+        IOUringCQE& cqe = res.value();
+        if (cqe.res == -EINVAL) {
+            EXPECT_FALSE("Zero-copy send not supported");
+            return;
+        }
+        if (!cqe.is_notification()) {
+            EXPECT_EQ(cqe.res, 6);
+        }
+        last = !cqe.has_more();
+        ring.seen(1);
+    }
+
+    char buf[8] = {};
+    EXPECT_EQ(read(fds[1], buf, sizeof(buf)), 6);
+    EXPECT_STREQ(buf, "foobar");
+}
@@ -0,0 +1,109 @@
+#include "bipolar/io/io_uring.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <system_error>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::literals;
+
+static void nops(IOUring& ring, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        auto res = ring.get_submission_entry();
+        ASSERT_TRUE(res.is_ok());
+        res.value().get().nop();
+        res.value().get().user_data = i;
+    }
+    EXPECT_EQ(ring.submit().value(), n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        auto res = ring.get_completion_entry();
+        ASSERT_TRUE(res.is_ok());
+        EXPECT_EQ(res.value().get().user_data, i);
+        ring.seen(1);
+    }
+}
+
+TEST(IOUring, SetupOptions) {
+    IOUringOptions options;
+    options.entries = 8;
+    options.cq_entries = 64;
+    IOUring ring(options);
+    if (ring.setup_flags() & IORING_SETUP_CQSIZE) {
+        EXPECT_EQ(ring.cq_high_watermark(), 64);
+    }
+    EXPECT_FALSE(ring.ring_fd_registered());
+    EXPECT_EQ(ring.dropped_setup_flags() & IORING_SETUP_CQSIZE, 0);
+    nops(ring, 8);
+}
+
+TEST(IOUring, SetupOversizedCQ) {
+    IOUringOptions options;
+    options.entries = 8;
+    options.cq_entries = 1U << 30;
+    options.defer_taskrun = true;
+    // not mistaken for unknown modes, which would shrink the CQ
+    EXPECT_THROW(IOUring ring(options), std::system_error);
+}
+
+TEST(IOUring, SetupThreadPerCore) {
+    IOUringOptions options;
+    options.entries = 8;
+    options.defer_taskrun = true;
+    options.coop_taskrun = true;
+    options.register_ring_fd = true;
+    IOUring ring(options);
+
+    // implied
+    if (ring.setup_flags() & IORING_SETUP_DEFER_TASKRUN) {
+        EXPECT_TRUE(ring.setup_flags() & IORING_SETUP_SINGLE_ISSUER);
+    }
+    const std::uint32_t requested = IORING_SETUP_DEFER_TASKRUN |
+                                    IORING_SETUP_SINGLE_ISSUER |
+                                    IORING_SETUP_COOP_TASKRUN;
+    EXPECT_EQ(ring.setup_flags() | ring.dropped_setup_flags(), requested);
+    nops(ring, 8);
+
+    // the deferred completions are run when peeking
+    auto sqe = ring.get_submission_entry();
+    ASSERT_TRUE(sqe.is_ok());
+    sqe.value().get().nop();
+    EXPECT_EQ(ring.submit().value(), 1);
+    EXPECT_TRUE(ring.peek_completion_entry().is_ok());
+    ring.seen(1);
+
+    auto res = ring.wait_completions(1, 10ms);
+    ASSERT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 0);
+}
+
+TEST(IOUring, SetupHugePages) {
+    IOUringOptions options;
+    options.entries = 4096;
+    options.huge_pages = true;
+    IOUring ring(options);
+
+    // falls back without reserved hugepages
+    EXPECT_EQ(ring.huge_pages(),
+              bool(ring.setup_flags() & IORING_SETUP_NO_MMAP));
+    EXPECT_NE(ring.huge_pages(),
+              bool(ring.dropped_setup_flags() & IORING_SETUP_NO_MMAP));
+    for (int i = 0; i < 4; ++i) {
+        nops(ring, 4096);
+    }
+}
+
+TEST(IOUring, SetupRegisteredRingOtherThread) {
+    IOUringOptions options;
+    options.entries = 8;
+    options.register_ring_fd = true;
+    auto ring = std::make_unique<IOUring>(options);
+    nops(*ring, 8);
+
+    // the registration of this thread is left alone
+    std::thread([&] { ring.reset(); }).join();
+}
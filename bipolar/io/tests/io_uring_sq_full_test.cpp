@@ -11,7 +11,7 @@ TEST(IOUring, SqFull) {
     IOUring ring(8, &p);
 
     std::size_t i = 0;
-    while (auto res = ring.get_submission_entry()) {
+    while (ring.get_submission_entry().is_ok()) {
         ++i;
     }
     EXPECT_EQ(i, 8);
@@ -0,0 +1,103 @@
+#define private public
+#include "bipolar/io/io_uring.hpp"
+#undef private
+
+#include <chrono>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::literals;
+
+static void queue_n_nops(IOUring& ring, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        auto res = ring.get_submission_entry();
+        ASSERT_TRUE(res.is_ok());
+        res.value().get().nop();
+    }
+    EXPECT_EQ(ring.submit().value(), n);
+}
+
+static void wait_completions(IOUring& ring) {
+    // times out
+    auto start = std::chrono::steady_clock::now();
+    auto res = ring.wait_completions(1, 20ms);
+    ASSERT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 0);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+
+    // a batch
+    queue_n_nops(ring, 4);
+    res = ring.wait_completions(4, 10s);
+    ASSERT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 4);
+
+    // fewer on timeout
+    queue_n_nops(ring, 2);
+    res = ring.wait_completions(8, 20ms);
+    ASSERT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 6);
+
+    std::size_t n = 0;
+    while (ring.peek_completion_entry().is_ok()) {
+        ring.seen(1);
+        ++n;
+    }
+    EXPECT_EQ(n, 6);
+
+    queue_n_nops(ring, 3);
+    res = ring.wait_completions(3);
+    ASSERT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 3);
+}
+
+TEST(IOUring, WaitCompletions) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    wait_completions(ring);
+}
+
+TEST(IOUring, WaitCompletionsWithSqe) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    // as on kernels without IORING_ENTER_EXT_ARG
+    ring.features_ &= ~IORING_FEAT_EXT_ARG;
+    wait_completions(ring);
+}
+
+TEST(IOUring, WaitCompletionsWithSqeBacklog) {
+    struct io_uring_params p{};
+    IOUring ring(8, &p);
+    ring.features_ &= ~IORING_FEAT_EXT_ARG;
+    ring.set_cq_high_watermark(2);
+
+    IOUringSQE sqe;
+    sqe.nop();
+    for (int i = 0; i < 3; ++i) {
+        ring.queue_submission_entry(sqe);
+    }
+
+    // the timeout SQE waits behind the backlog, held back by the watermark
+    auto res = ring.wait_completions(8, 20ms);
+    ASSERT_TRUE(res.is_error());
+    EXPECT_EQ(res.error(), EBUSY);
+    EXPECT_EQ(ring.inflight(), 2);
+    EXPECT_EQ(ring.backlog(), 1);
+
+    // the reserved CQEs already looked at stay counted while seen
+    ring.set_cq_high_watermark(8);
+    res = ring.wait_completions(8, 20ms);
+    ASSERT_TRUE(res.is_ok());
+    EXPECT_EQ(res.value(), 3);
+    EXPECT_EQ(ring.cq_reserved_, 1);
+
+    std::size_t n = 0;
+    while (ring.peek_completion_entry().is_ok()) {
+        ring.seen(1);
+        ++n;
+    }
+    EXPECT_EQ(n, 3);
+    EXPECT_EQ(ring.cq_reserved_, 0);
+    EXPECT_EQ(ring.wait_completions(1, 1ms).value(), 0);
+}
@@ -0,0 +1,183 @@
+#include "bipolar/net/ip_address.hpp"
+#include "bipolar/net/socket_address.hpp"
+
+#include <arpa/inet.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bipolar;
+
+namespace {
+constexpr std::size_t kAddresses = 1024;
+
+std::vector<IPv4Address> random_ipv4s() {
+    std::mt19937 gen(42);
+    std::vector<IPv4Address> addrs;
+    for (std::size_t i = 0; i < kAddresses; ++i) {
+        addrs.emplace_back(static_cast<std::uint32_t>(gen()));
+    }
+    return addrs;
+}
+
+// Like client addresses: a /64 prefix and a random interface identifier
+std::vector<IPv6Address> random_ipv6s() {
+    std::mt19937 gen(42);
+    std::vector<IPv6Address> addrs;
+    for (std::size_t i = 0; i < kAddresses; ++i) {
+        addrs.emplace_back(hton(std::uint32_t(0x20010db8)), gen() & 0xffff,
+                           static_cast<std::uint32_t>(gen()),
+                           static_cast<std::uint32_t>(gen()));
+    }
+    return addrs;
+}
+
+template <typename Addresses>
+std::vector<std::string> strs(const Addresses& addrs) {
+    std::vector<std::string> ret;
+    for (const auto& addr : addrs) {
+        ret.push_back(addr.str());
+    }
+    return ret;
+}
+
+} // namespace
+
+static void BM_IPv4FromStr(benchmark::State& state) {
+    const auto inputs = strs(random_ipv4s());
+    for (auto _ : state) {
+        for (const auto& s : inputs) {
+            benchmark::DoNotOptimize(IPv4Address::from_str(s));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_IPv4FromStr);
+
+static void BM_IPv4InetPton(benchmark::State& state) {
+    const auto inputs = strs(random_ipv4s());
+    for (auto _ : state) {
+        for (const auto& s : inputs) {
+            struct in_addr addr;
+            benchmark::DoNotOptimize(::inet_pton(AF_INET, s.c_str(), &addr));
+            benchmark::DoNotOptimize(addr);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_IPv4InetPton);
+
+static void BM_IPv6FromStr(benchmark::State& state) {
+    const auto inputs = strs(random_ipv6s());
+    for (auto _ : state) {
+        for (const auto& s : inputs) {
+            benchmark::DoNotOptimize(IPv6Address::from_str(s));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_IPv6FromStr);
+
+static void BM_IPv6InetPton(benchmark::State& state) {
+    const auto inputs = strs(random_ipv6s());
+    for (auto _ : state) {
+        for (const auto& s : inputs) {
+            struct in6_addr addr;
+            benchmark::DoNotOptimize(::inet_pton(AF_INET6, s.c_str(), &addr));
+            benchmark::DoNotOptimize(addr);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_IPv6InetPton);
+
+static void BM_SocketAddressFromStr(benchmark::State& state) {
+    std::vector<std::string> inputs;
+    std::mt19937 gen(42);
+    for (const auto& s : strs(random_ipv4s())) {
+        inputs.push_back(s + ':' + std::to_string(gen() & 0xffff));
+    }
+    for (auto _ : state) {
+        for (const auto& s : inputs) {
+            benchmark::DoNotOptimize(SocketAddress::from_str(s));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_SocketAddressFromStr);
+
+static void BM_IPv4ToChars(benchmark::State& state) {
+    const auto addrs = random_ipv4s();
+    char buf[IPv4Address::kMaxStrLen];
+    for (auto _ : state) {
+        for (const auto& addr : addrs) {
+            benchmark::DoNotOptimize(addr.to_chars(buf, buf + sizeof(buf)));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+BENCHMARK(BM_IPv4ToChars);
+
+static void BM_IPv4InetNtop(benchmark::State& state) {
+    const auto addrs = random_ipv4s();
+    char buf[INET_ADDRSTRLEN];
+    for (auto _ : state) {
+        for (const auto& addr : addrs) {
+            const struct in_addr native = addr.native();
+            benchmark::DoNotOptimize(
+                ::inet_ntop(AF_INET, &native, buf, sizeof(buf)));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+BENCHMARK(BM_IPv4InetNtop);
+
+static void BM_IPv6ToChars(benchmark::State& state) {
+    const auto addrs = random_ipv6s();
+    char buf[IPv6Address::kMaxStrLen];
+    for (auto _ : state) {
+        for (const auto& addr : addrs) {
+            benchmark::DoNotOptimize(addr.to_chars(buf, buf + sizeof(buf)));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+BENCHMARK(BM_IPv6ToChars);
+
+static void BM_IPv6InetNtop(benchmark::State& state) {
+    const auto addrs = random_ipv6s();
+    char buf[INET6_ADDRSTRLEN];
+    for (auto _ : state) {
+        for (const auto& addr : addrs) {
+            const struct in6_addr native = addr.native();
+            benchmark::DoNotOptimize(
+                ::inet_ntop(AF_INET6, &native, buf, sizeof(buf)));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+BENCHMARK(BM_IPv6InetNtop);
+
+static void BM_SocketAddressToChars(benchmark::State& state) {
+    std::vector<SocketAddress> addrs;
+    for (const auto& addr : random_ipv6s()) {
+        addrs.emplace_back(addr, hton(std::uint16_t(443)));
+    }
+    char buf[SocketAddress::kMaxStrLen];
+    for (auto _ : state) {
+        for (const auto& addr : addrs) {
+            benchmark::DoNotOptimize(addr.to_chars(buf, buf + sizeof(buf)));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+BENCHMARK(BM_SocketAddressToChars);
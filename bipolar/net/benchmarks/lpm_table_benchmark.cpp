@@ -0,0 +1,164 @@
+#include "bipolar/net/lpm_table.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bipolar/core/byteorder.hpp"
+
+using namespace bipolar;
+
+namespace {
+constexpr std::size_t kIPv4Prefixes = 1000000;
+constexpr std::size_t kIPv6Prefixes = 200000;
+constexpr std::size_t kAddresses = 1 << 20;
+
+// Prefix lengths distributed like a full BGP table: mostly /24s, a fifth
+// /22-/23, the rest /8-/21 and a few host routes
+std::uint8_t bgp_ipv4_len(std::mt19937& gen) {
+    const auto x = gen() % 100;
+    if (x < 58) {
+        return 24;
+    }
+    if (x < 78) {
+        return static_cast<std::uint8_t>(22 + x % 2);
+    }
+    if (x < 98) {
+        return static_cast<std::uint8_t>(8 + x % 14);
+    }
+    return static_cast<std::uint8_t>(25 + x % 8);
+}
+
+// Mostly /32-/48 allocations, some /64s and host routes
+std::uint8_t bgp_ipv6_len(std::mt19937& gen) {
+    const auto x = gen() % 100;
+    if (x < 90) {
+        return static_cast<std::uint8_t>(32 + x % 17);
+    }
+    if (x < 98) {
+        return 64;
+    }
+    return 128;
+}
+
+IPv6Address random_ipv6(std::mt19937& gen) {
+    // global unicast 2000::/3
+    const auto high = 0x20000000 | static_cast<std::uint32_t>(gen()) >> 3;
+    return IPv6Address(hton(high), static_cast<std::uint32_t>(gen()),
+                       static_cast<std::uint32_t>(gen()),
+                       static_cast<std::uint32_t>(gen()));
+}
+
+const LpmSnapshot& ipv4_table() {
+    static const auto snapshot = [] {
+        std::mt19937 gen(42);
+        LpmTable table;
+        while (table.size() < kIPv4Prefixes) {
+            const IPv4Address addr(static_cast<std::uint32_t>(gen()));
+            table.insert(IPNetwork(addr, bgp_ipv4_len(gen)),
+                         static_cast<std::uint32_t>(table.size()));
+        }
+        table.commit();
+        return table.snapshot();
+    }();
+    return *snapshot;
+}
+
+const LpmSnapshot& ipv6_table() {
+    static const auto snapshot = [] {
+        std::mt19937 gen(42);
+        LpmTable table;
+        while (table.size() < kIPv6Prefixes) {
+            table.insert(IPNetwork(random_ipv6(gen), bgp_ipv6_len(gen)),
+                         static_cast<std::uint32_t>(table.size()));
+        }
+        table.commit();
+        return table.snapshot();
+    }();
+    return *snapshot;
+}
+
+// Uniformly random, so that every lookup misses the caches
+std::vector<IPv4Address> random_ipv4s() {
+    std::mt19937 gen(7);
+    std::vector<IPv4Address> addrs;
+    for (std::size_t i = 0; i < kAddresses; ++i) {
+        addrs.emplace_back(static_cast<std::uint32_t>(gen()));
+    }
+    return addrs;
+}
+
+std::vector<IPv6Address> random_ipv6s() {
+    std::mt19937 gen(7);
+    std::vector<IPv6Address> addrs;
+    for (std::size_t i = 0; i < kAddresses; ++i) {
+        addrs.push_back(random_ipv6(gen));
+    }
+    return addrs;
+}
+
+template <typename Address>
+void lookup(benchmark::State& state, const LpmSnapshot& snapshot,
+            const std::vector<Address>& addrs) {
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.lookup(addrs[i]));
+        i = (i + 1) % addrs.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Address>
+void lookup_burst(benchmark::State& state, const LpmSnapshot& snapshot,
+                  const std::vector<Address>& addrs) {
+    std::uint32_t values[LpmSnapshot::kBurst];
+    std::size_t i = 0;
+    for (auto _ : state) {
+        snapshot.lookup(&addrs[i], LpmSnapshot::kBurst, values);
+        benchmark::DoNotOptimize(values);
+        i = (i + LpmSnapshot::kBurst) % addrs.size();
+    }
+    state.SetItemsProcessed(state.iterations() * LpmSnapshot::kBurst);
+}
+
+} // namespace
+
+static void BM_IPv4Lookup(benchmark::State& state) {
+    const auto& snapshot = ipv4_table();
+    lookup(state, snapshot, random_ipv4s());
+}
+BENCHMARK(BM_IPv4Lookup);
+
+static void BM_IPv4LookupBurst(benchmark::State& state) {
+    const auto& snapshot = ipv4_table();
+    lookup_burst(state, snapshot, random_ipv4s());
+}
+BENCHMARK(BM_IPv4LookupBurst);
+
+static void BM_IPv6Lookup(benchmark::State& state) {
+    const auto& snapshot = ipv6_table();
+    lookup(state, snapshot, random_ipv6s());
+}
+BENCHMARK(BM_IPv6Lookup);
+
+static void BM_IPv6LookupBurst(benchmark::State& state) {
+    const auto& snapshot = ipv6_table();
+    lookup_burst(state, snapshot, random_ipv6s());
+}
+BENCHMARK(BM_IPv6LookupBurst);
+
+// Rebuilds the 1M prefixes, the cost of an update
+static void BM_IPv4Commit(benchmark::State& state) {
+    std::mt19937 gen(42);
+    LpmTable table;
+    while (table.size() < kIPv4Prefixes) {
+        const IPv4Address addr(static_cast<std::uint32_t>(gen()));
+        table.insert(IPNetwork(addr, bgp_ipv4_len(gen)), 0);
+    }
+    for (auto _ : state) {
+        table.commit();
+    }
+}
+BENCHMARK(BM_IPv4Commit)->Unit(benchmark::kMillisecond);
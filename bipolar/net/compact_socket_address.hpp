@@ -0,0 +1,327 @@
+//! CompactSocketAddress and NativeSocketAddress
+//!
+//! see `CompactSocketAddress` and `NativeSocketAddress` for details
+
+#ifndef BIPOLAR_NET_COMPACT_SOCKET_ADDRESS_HPP_
+#define BIPOLAR_NET_COMPACT_SOCKET_ADDRESS_HPP_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/net/ip_address.hpp"
+#include "bipolar/net/socket_address.hpp"
+
+namespace bipolar {
+/// CompactSocketAddress
+///
+/// # Brief
+///
+/// A trivially copyable internet socket address of 20 bytes, for the
+/// addresses kept by the million: per-packet peers of `recvmmsg` batches,
+/// flow tables, etc.
+///
+/// The IP address is stored as IPv6, an IPv4 address `a.b.c.d` being the
+/// IPv4-mapped `::ffff:a.b.c.d`, followed by the port and the family, so
+/// that equality and hashing are branchless over 2 64-bit words and a
+/// 32-bit word. The family tells an IPv4 address from an IPv4-mapped IPv6
+/// one, as reported by dual-stack sockets.
+///
+/// `SocketAddress` is the one to use in interfaces, both convert to each
+/// other and to `NativeSocketAddress` for system calls.
+///
+/// # Examples
+///
+/// ```
+/// CompactSocketAddress addr(SocketAddress::from_str("10.0.0.1:53").value());
+/// assert(addr.is_ipv4());
+/// assert(addr.to_socket_address().str() == "10.0.0.1:53");
+///
+/// std::unordered_map<CompactSocketAddress, Flow> flows;
+/// ```
+class CompactSocketAddress {
+public:
+    /// Creates an unspecified address, whose family is `AF_UNSPEC`
+    constexpr CompactSocketAddress() noexcept = default;
+
+    /// Creates a new `CompactSocketAddress` from a `SocketAddress`
+    explicit CompactSocketAddress(const SocketAddress& sa) noexcept
+        : port_(sa.port()),
+          family_(static_cast<std::uint16_t>(sa.addr().family())) {
+        if (sa.addr().is_ipv4()) {
+            set_ipv4(sa.addr().as_ipv4().to_long());
+        } else if (sa.addr().is_ipv6()) {
+            const auto octets = sa.addr().as_ipv6().octets();
+            std::memcpy(addr_, octets.data(), sizeof(addr_));
+        }
+    }
+
+    /// Creates a new `CompactSocketAddress` from the native `sockaddr_in`
+    explicit CompactSocketAddress(const struct sockaddr_in* addr) noexcept
+        : port_(addr->sin_port), family_(AF_INET) {
+        set_ipv4(addr->sin_addr.s_addr);
+    }
+
+    /// Creates a new `CompactSocketAddress` from the native `sockaddr_in6`
+    explicit CompactSocketAddress(const struct sockaddr_in6* addr) noexcept
+        : port_(addr->sin6_port), family_(AF_INET6) {
+        std::memcpy(addr_, &addr->sin6_addr, sizeof(addr_));
+    }
+
+    /// Creates a new `CompactSocketAddress` from a native address of `len`
+    /// bytes, filled by `recvfrom`, `recvmmsg`, `accept`, etc.
+    ///
+    /// Returns `EINVAL` if it's neither an IPv4 nor an IPv6 address.
+    static Result<CompactSocketAddress, int>
+    from_native(const struct sockaddr* addr, socklen_t len) noexcept {
+        if (addr->sa_family == AF_INET && len >= sizeof(struct sockaddr_in)) {
+            return Ok(CompactSocketAddress(
+                reinterpret_cast<const struct sockaddr_in*>(addr)));
+        }
+        if (addr->sa_family == AF_INET6 &&
+            len >= sizeof(struct sockaddr_in6)) {
+            return Ok(CompactSocketAddress(
+                reinterpret_cast<const struct sockaddr_in6*>(addr)));
+        }
+        return Err(EINVAL);
+    }
+
+    /// Returns the address family, `AF_UNSPEC`, `AF_INET` or `AF_INET6`
+    [[nodiscard]] constexpr int family() const noexcept {
+        return family_;
+    }
+
+    /// Returns `true` if this address is an IPv4 address
+    [[nodiscard]] constexpr bool is_ipv4() const noexcept {
+        return family_ == AF_INET;
+    }
+
+    /// Returns `true` if this address is an IPv6 address
+    [[nodiscard]] constexpr bool is_ipv6() const noexcept {
+        return family_ == AF_INET6;
+    }
+
+    /// Returns the port number in network byteorder
+    [[nodiscard]] constexpr std::uint16_t port() const noexcept {
+        return port_;
+    }
+
+    /// Returns the 16 bytes of the IPv6 address, IPv4-mapped for an IPv4
+    /// address
+    [[nodiscard]] const std::uint8_t* ipv6_bytes() const noexcept {
+        return addr_;
+    }
+
+    /// Returns the `IPAddress`
+    [[nodiscard]] IPAddress ip() const noexcept {
+        if (is_ipv4()) {
+            std::uint32_t v4;
+            std::memcpy(&v4, addr_ + 12, sizeof(v4));
+            return IPv4Address(v4);
+        }
+        if (is_ipv6()) {
+            struct in6_addr v6;
+            std::memcpy(&v6, addr_, sizeof(v6));
+            return IPv6Address(v6);
+        }
+        return IPAddress();
+    }
+
+    /// Converts to `SocketAddress`
+    [[nodiscard]] SocketAddress to_socket_address() const noexcept {
+        return SocketAddress(ip(), port_);
+    }
+
+    /// Writes the textual representation into `[first, last)`
+    ///
+    /// see `SocketAddress::to_chars` for details
+    std::to_chars_result to_chars(char* first, char* last) const noexcept {
+        return to_socket_address().to_chars(first, last);
+    }
+
+    /// Stringify the address and the port number
+    ///
+    /// see `SocketAddress::str` for details
+    [[nodiscard]] std::string str() const {
+        return to_socket_address().str();
+    }
+
+    /// Returns a hash of the address, mixing its 3 words
+    [[nodiscard]] std::size_t hash() const noexcept {
+        std::uint64_t lo, hi;
+        std::uint32_t tail;
+        load(&lo, &hi, &tail);
+        std::uint64_t h = (lo ^ (std::uint64_t(tail) << 32 | tail)) *
+                          0x9e3779b97f4a7c15;
+        h = (h ^ (h >> 29) ^ hi) * 0xbf58476d1ce4e5b9;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    /// Compares the 20 bytes without branches
+    friend bool operator==(const CompactSocketAddress& lhs,
+                           const CompactSocketAddress& rhs) noexcept {
+        std::uint64_t lhs_lo, lhs_hi, rhs_lo, rhs_hi;
+        std::uint32_t lhs_tail, rhs_tail;
+        lhs.load(&lhs_lo, &lhs_hi, &lhs_tail);
+        rhs.load(&rhs_lo, &rhs_hi, &rhs_tail);
+        return ((lhs_lo ^ rhs_lo) | (lhs_hi ^ rhs_hi) |
+                (lhs_tail ^ rhs_tail)) == 0;
+    }
+
+    friend bool operator!=(const CompactSocketAddress& lhs,
+                           const CompactSocketAddress& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    void set_ipv4(std::uint32_t v4) noexcept {
+        addr_[10] = addr_[11] = 0xff;
+        std::memcpy(addr_ + 12, &v4, sizeof(v4));
+    }
+
+    // the object representation as 3 words
+    void load(std::uint64_t* lo, std::uint64_t* hi,
+              std::uint32_t* tail) const noexcept {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(this);
+        std::memcpy(lo, bytes, sizeof(*lo));
+        std::memcpy(hi, bytes + 8, sizeof(*hi));
+        std::memcpy(tail, bytes + 16, sizeof(*tail));
+    }
+
+    std::uint8_t addr_[16] = {};
+    std::uint16_t port_ = 0;
+    std::uint16_t family_ = AF_UNSPEC;
+};
+
+static_assert(sizeof(CompactSocketAddress) == 20);
+static_assert(std::is_trivially_copyable_v<CompactSocketAddress>);
+
+/// NativeSocketAddress
+///
+/// # Brief
+///
+/// The native address passed to and filled by system calls, i.e. a
+/// `sockaddr_in` or a `sockaddr_in6`.
+///
+/// It's 28 bytes instead of the 128 of `sockaddr_storage`, and knows its
+/// own length, so that `bind`, `connect`, `sendto`, or the `msg_name` of
+/// `sendmmsg`, take it as is.
+///
+/// # Examples
+///
+/// ```
+/// NativeSocketAddress dst(CompactSocketAddress(...));
+/// ::sendto(fd, buf, len, 0, dst.get(), dst.size());
+///
+/// NativeSocketAddress src;
+/// socklen_t src_len = NativeSocketAddress::capacity();
+/// ::recvfrom(fd, buf, len, 0, src.get(), &src_len);
+/// auto peer = CompactSocketAddress::from_native(src.get(), src_len);
+/// ```
+class NativeSocketAddress {
+public:
+    /// Creates an unspecified address, to be filled by a system call
+    NativeSocketAddress() noexcept : v6_() {}
+
+    /// Creates a new `NativeSocketAddress` from a `SocketAddress`
+    explicit NativeSocketAddress(const SocketAddress& sa) noexcept : v6_() {
+        if (sa.addr().is_ipv4()) {
+            v4_ = sa.addr().as_ipv4().to_sockaddr();
+            v4_.sin_port = sa.port();
+        } else if (sa.addr().is_ipv6()) {
+            v6_ = sa.addr().as_ipv6().to_sockaddr();
+            v6_.sin6_port = sa.port();
+        }
+    }
+
+    /// Creates a new `NativeSocketAddress` from a `CompactSocketAddress`
+    explicit NativeSocketAddress(const CompactSocketAddress& sa) noexcept
+        : v6_() {
+        if (sa.is_ipv4()) {
+            v4_.sin_family = AF_INET;
+            v4_.sin_port = sa.port();
+            std::memcpy(&v4_.sin_addr, sa.ipv6_bytes() + 12,
+                        sizeof(v4_.sin_addr));
+        } else if (sa.is_ipv6()) {
+            v6_.sin6_family = AF_INET6;
+            v6_.sin6_port = sa.port();
+            std::memcpy(&v6_.sin6_addr, sa.ipv6_bytes(),
+                        sizeof(v6_.sin6_addr));
+        }
+    }
+
+    /// Returns the number of bytes system calls may fill
+    static constexpr socklen_t capacity() noexcept {
+        return sizeof(struct sockaddr_in6);
+    }
+
+    /// Returns the address family
+    [[nodiscard]] int family() const noexcept {
+        return sa_.sa_family;
+    }
+
+    /// Returns the length of the address of its family
+    [[nodiscard]] socklen_t size() const noexcept {
+        return sa_.sa_family == AF_INET ? sizeof(struct sockaddr_in)
+                                        : sizeof(struct sockaddr_in6);
+    }
+
+    /// @{
+    /// Returns the address to pass to system calls
+    [[nodiscard]] const struct sockaddr* get() const noexcept {
+        return &sa_;
+    }
+    [[nodiscard]] struct sockaddr* get() noexcept {
+        return &sa_;
+    }
+    /// @}
+
+    /// Converts an address of `len` bytes filled by a system call to
+    /// `SocketAddress`
+    ///
+    /// Returns `EINVAL` if it's neither an IPv4 nor an IPv6 address.
+    [[nodiscard]] Result<SocketAddress, int>
+    to_socket_address(socklen_t len) const noexcept {
+        if (sa_.sa_family == AF_INET && len >= sizeof(struct sockaddr_in)) {
+            return Ok(SocketAddress(&v4_));
+        }
+        if (sa_.sa_family == AF_INET6 && len >= sizeof(struct sockaddr_in6)) {
+            return Ok(SocketAddress(&v6_));
+        }
+        return Err(EINVAL);
+    }
+
+private:
+    union {
+        struct sockaddr sa_;
+        struct sockaddr_in v4_;
+        struct sockaddr_in6 v6_;
+    };
+};
+
+static_assert(sizeof(NativeSocketAddress) == sizeof(struct sockaddr_in6));
+static_assert(std::is_trivially_copyable_v<NativeSocketAddress>);
+
+} // namespace bipolar
+
+namespace std {
+template <>
+struct hash<bipolar::CompactSocketAddress> {
+    std::size_t operator()(const bipolar::CompactSocketAddress& addr) const
+        noexcept {
+        return addr.hash();
+    }
+};
+
+} // namespace std
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef BIPOLAR_NET_INTERNAL_LPM_TRIE_HPP_
+#define BIPOLAR_NET_INTERNAL_LPM_TRIE_HPP_
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace bipolar {
+namespace internal {
+/// Allocates the arrays of 2MB or more from anonymous mappings advised to
+/// be backed by transparent huge pages, so that random lookups into a table
+/// of tens of MB don't miss the TLB every time
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    static constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        const std::size_t bytes = n * sizeof(T);
+        if (bytes < kHugePageSize) {
+            return static_cast<T*>(::operator new(bytes));
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        ::madvise(p, bytes, MADV_HUGEPAGE);
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (bytes < kHugePageSize) {
+            ::operator delete(p);
+        } else {
+            ::munmap(p, bytes);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+/// A multibit trie over the bytes of a key, whose root is indexed by its
+/// first `RootBytes` bytes and the other levels by a byte each, i.e.
+/// DIR-24-8 for IPv4 keys with 3 root bytes.
+///
+/// Each level is an array of entries: 0 for no match, `kGroup | index` for
+/// the next level, the 256 entries at `index << 8`, or the value + 1 of the
+/// longest prefix covering it. Prefixes are expanded into the entries they
+/// cover, so that a lookup is a load per level without any comparison.
+template <std::size_t RootBytes, std::size_t KeyBytes>
+class LpmTrie {
+public:
+    static_assert(RootBytes < 4 && RootBytes < KeyBytes && KeyBytes >= 4);
+
+    static constexpr std::size_t kRootBits = RootBytes * 8;
+    static constexpr std::size_t kRootSize = std::size_t(1) << kRootBits;
+    static constexpr std::uint32_t kGroup = std::uint32_t(1) << 31;
+    static constexpr std::uint32_t kMaxValue = kGroup - 2;
+
+    /// Adds a prefix, which must not be shorter than any prefix added
+    /// before, so that it overrides the shorter ones it overlaps
+    void insert(const std::uint8_t* key, std::size_t len,
+                std::uint32_t value) {
+        assert(len <= KeyBytes * 8 && value <= kMaxValue);
+        if (entries_.empty()) {
+            entries_.assign(kRootSize, 0);
+        }
+
+        const std::uint32_t leaf = value + 1;
+        std::size_t pos = root_index(key);
+        if (len <= kRootBits) {
+            const std::size_t span = std::size_t(1) << (kRootBits - len);
+            std::fill_n(&entries_[pos & ~(span - 1)], span, leaf);
+            return;
+        }
+
+        len -= kRootBits;
+        for (std::size_t depth = RootBytes;; ++depth) {
+            if (!(entries_[pos] & kGroup)) {
+                // the new level inherits the prefix covering its parent
+                const std::uint32_t parent = entries_[pos];
+                const std::size_t group = entries_.size() >> 8;
+                entries_.resize(entries_.size() + 256, parent);
+                entries_[pos] = kGroup | static_cast<std::uint32_t>(group);
+            }
+            const std::size_t base = std::size_t(entries_[pos] & ~kGroup) << 8;
+            if (len <= 8) {
+                const std::size_t span = std::size_t(1) << (8 - len);
+                std::fill_n(&entries_[base + (key[depth] & ~(span - 1))],
+                            span, leaf);
+                return;
+            }
+            pos = base + key[depth];
+            len -= 8;
+        }
+    }
+
+    /// Returns the entry of the longest prefix matching `key`, 0 if none
+    std::uint32_t find(const std::uint8_t* key) const noexcept {
+        if (entries_.empty()) {
+            return 0;
+        }
+        const std::uint32_t* entries = entries_.data();
+        std::uint32_t entry = entries[root_index(key)];
+        for (std::size_t depth = RootBytes; entry & kGroup; ++depth) {
+            entry = entries[next_index(entry, key[depth])];
+        }
+        return entry;
+    }
+
+    /// Finds the entries of `n` contiguous keys, at most 32, a level at a
+    /// time: the entries of every key at a level are prefetched before any
+    /// is loaded, so that the cache misses of the burst overlap
+    void find(const std::uint8_t* keys, std::size_t n,
+              std::uint32_t* out) const noexcept {
+        assert(n <= 32);
+        if (entries_.empty()) {
+            std::fill_n(out, n, 0);
+            return;
+        }
+
+        const std::uint32_t* entries = entries_.data();
+        std::size_t pos[32];
+        for (std::size_t i = 0; i < n; ++i) {
+            pos[i] = root_index(keys + i * KeyBytes);
+            __builtin_prefetch(entries + pos[i]);
+        }
+        // the keys with another level to walk
+        std::uint32_t pending = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = entries[pos[i]];
+            pending |= (out[i] >> 31) << i;
+        }
+
+        for (std::size_t depth = RootBytes; pending != 0; ++depth) {
+            for (std::uint32_t lanes = pending; lanes != 0;
+                 lanes &= lanes - 1) {
+                const std::size_t i = __builtin_ctz(lanes);
+                pos[i] = next_index(out[i], keys[i * KeyBytes + depth]);
+                __builtin_prefetch(entries + pos[i]);
+            }
+            for (std::uint32_t lanes = pending; lanes != 0;
+                 lanes &= lanes - 1) {
+                const std::size_t i = __builtin_ctz(lanes);
+                out[i] = entries[pos[i]];
+                if (!(out[i] & kGroup)) {
+                    pending &= ~(std::uint32_t(1) << i);
+                }
+            }
+        }
+    }
+
+    std::size_t memory_usage() const noexcept {
+        return entries_.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    // the first `RootBytes` bytes of the key, by a big endian load of 4
+    static std::size_t root_index(const std::uint8_t* key) noexcept {
+        std::uint32_t prefix;
+        std::memcpy(&prefix, key, sizeof(prefix));
+        if constexpr (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) {
+            prefix = __builtin_bswap32(prefix);
+        }
+        return prefix >> (32 - kRootBits);
+    }
+
+    static std::size_t next_index(std::uint32_t entry,
+                                  std::uint8_t byte) noexcept {
+        return std::size_t(entry & ~kGroup) << 8 | byte;
+    }
+
+    std::vector<std::uint32_t, HugePageAllocator<std::uint32_t>> entries_;
+};
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
@@ -1,17 +1,299 @@
 #include "bipolar/net/ip_address.hpp"
 
-#include <arpa/inet.h>
-
-#include <cstdio>
+#include <array>
+#include <cstring>
 
 namespace bipolar {
+namespace {
+constexpr std::size_t kNoGap = 16;
+
+constexpr std::uint64_t kLowBytes = 0x0101010101010101;
+constexpr std::uint64_t kHighBits = 0x8080808080808080;
+
+// SWAR: sets the high bit of the bytes of `x` equal to `ch`
+constexpr std::uint64_t bytes_equal(std::uint64_t x, char ch) noexcept {
+    const std::uint64_t y = x ^ (kLowBytes * static_cast<std::uint8_t>(ch));
+    return ~(((y & ~kHighBits) + ~kHighBits) | y) & kHighBits;
+}
+
+// SWAR: sets the high bit of the bytes of `x` in ['0', '9']
+constexpr std::uint64_t decimal_bytes(std::uint64_t x) noexcept {
+    const std::uint64_t y = x ^ (kLowBytes * '0');
+    return ~(((y & ~kHighBits) + kLowBytes * (0x80 - 10)) | y) & kHighBits;
+}
+
+// Gathers the high bits of the bytes of `x` into bits [0, 8), the first
+// byte in memory being bit 0
+inline std::uint32_t movemask(std::uint64_t x) noexcept {
+    return static_cast<std::uint32_t>(((x >> 7) * 0x0102040810204080) >> 56);
+}
+
+inline std::uint64_t load_le(const char* p) noexcept {
+    std::uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    if constexpr (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) {
+        x = __builtin_bswap64(x);
+    }
+    return x;
+}
+
+constexpr std::array<std::int8_t, 256> kHexValues = [] {
+    std::array<std::int8_t, 256> values{};
+    for (auto& v : values) {
+        v = -1;
+    }
+    for (int i = 0; i < 10; ++i) {
+        values['0' + i] = static_cast<std::int8_t>(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        values['a' + i] = values['A' + i] = static_cast<std::int8_t>(10 + i);
+    }
+    return values;
+}();
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// Parses a dotted quad as `inet_pton` does. The string is classified by 2
+// overlapping 8-byte loads, which find its dots and reject the invalid
+// characters without a branch per character.
+bool parse_ipv4(std::string_view sv, std::uint8_t* octets) noexcept {
+    const std::size_t size = sv.size();
+    if (size < 7 || size > IPv4Address::kMaxStrLen) {
+        return false;
+    }
+
+    const char* s = sv.data();
+    std::uint64_t lo = 0, hi = 0;
+    std::uint32_t shift = 0;
+    if (size >= 8) {
+        lo = load_le(s);
+        hi = load_le(s + size - 8);
+        shift = size - 8;
+    } else {
+        char buf[8] = {};
+        std::memcpy(buf, s, size);
+        lo = load_le(buf);
+    }
+
+    // a bit per character
+    std::uint32_t dots = movemask(bytes_equal(lo, '.')) |
+                         movemask(bytes_equal(hi, '.')) << shift;
+    const std::uint32_t digits =
+        movemask(decimal_bytes(lo)) | movemask(decimal_bytes(hi)) << shift;
+    if ((dots | digits) != (std::uint32_t(1) << size) - 1 ||
+        __builtin_popcount(dots) != 3) {
+        return false;
+    }
+    // no leading, trailing or adjacent dots, so that no octet is empty
+    if ((dots & 1) != 0 || (dots >> (size - 1)) != 0 ||
+        (dots & dots >> 1) != 0) {
+        return false;
+    }
+
+    bool valid = true;
+    std::size_t begin = 0;
+    for (int i = 0; i < 4; ++i) {
+        const std::size_t end = i < 3 ? __builtin_ctz(dots) : size;
+        dots &= dots - 1;
+
+        const std::size_t len = end - begin;
+        unsigned octet = s[begin] - '0';
+        if (len > 1) {
+            octet = octet * 10 + (s[begin + 1] - '0');
+        }
+        if (len > 2) {
+            octet = octet * 10 + (s[begin + 2] - '0');
+        }
+        valid &= len <= 3 && (len == 1 || s[begin] != '0') && octet <= 255;
+        octets[i] = static_cast<std::uint8_t>(octet);
+        begin = end + 1;
+    }
+    return valid;
+}
+
+// Parses the hexadecimal groups, a `::` and a trailing dotted quad as
+// `inet_pton` does
+bool parse_ipv6(std::string_view sv, std::uint8_t* bytes) noexcept {
+    if (sv.size() < 2 || sv.size() > IPv6Address::kMaxStrLen) {
+        return false;
+    }
+
+    std::size_t i = 0;
+    if (sv[0] == ':') {
+        if (sv[1] != ':') {
+            return false;
+        }
+        ++i;
+    }
+
+    std::size_t n = 0;
+    std::size_t gap = kNoGap;
+    std::size_t group = i;
+    std::size_t digits = 0;
+    unsigned value = 0;
+    while (i < sv.size()) {
+        const char ch = sv[i++];
+        const int hex = kHexValues[static_cast<std::uint8_t>(ch)];
+        if (hex >= 0) {
+            if (++digits > 4) {
+                return false;
+            }
+            value = value << 4 | hex;
+            continue;
+        }
+
+        if (ch == ':') {
+            group = i;
+            if (digits == 0) {
+                if (gap != kNoGap) {
+                    return false;
+                }
+                gap = n;
+                continue;
+            }
+            if (i == sv.size() || n + 2 > 16) {
+                return false;
+            }
+            bytes[n++] = static_cast<std::uint8_t>(value >> 8);
+            bytes[n++] = static_cast<std::uint8_t>(value);
+            digits = 0;
+            value = 0;
+            continue;
+        }
+
+        if (ch == '.' && n + 4 <= 16 &&
+            parse_ipv4(sv.substr(group), bytes + n)) {
+            n += 4;
+            digits = 0;
+            break;
+        }
+        return false;
+    }
+
+    if (digits > 0) {
+        if (n + 2 > 16) {
+            return false;
+        }
+        bytes[n++] = static_cast<std::uint8_t>(value >> 8);
+        bytes[n++] = static_cast<std::uint8_t>(value);
+    }
+
+    if (gap != kNoGap) {
+        // `::` stands for one group at least
+        if (n == 16) {
+            return false;
+        }
+        const std::size_t tail = n - gap;
+        std::memmove(bytes + 16 - tail, bytes + gap, tail);
+        std::memset(bytes + gap, 0, 16 - n);
+        n = 16;
+    }
+    return n == 16;
+}
+
+char* format_octet(char* p, unsigned octet) noexcept {
+    if (octet >= 100) {
+        *p++ = static_cast<char>('0' + octet / 100);
+        octet %= 100;
+        *p++ = static_cast<char>('0' + octet / 10);
+        octet %= 10;
+    } else if (octet >= 10) {
+        *p++ = static_cast<char>('0' + octet / 10);
+        octet %= 10;
+    }
+    *p++ = static_cast<char>('0' + octet);
+    return p;
+}
+
+char* format_ipv4(char* p, const std::uint8_t* octets) noexcept {
+    p = format_octet(p, octets[0]);
+    for (int i = 1; i < 4; ++i) {
+        *p++ = '.';
+        p = format_octet(p, octets[i]);
+    }
+    return p;
+}
+
+char* format_group(char* p, unsigned group) noexcept {
+    int shift = 12;
+    while (shift > 0 && (group >> shift) == 0) {
+        shift -= 4;
+    }
+    for (; shift >= 0; shift -= 4) {
+        *p++ = kHexDigits[(group >> shift) & 0xf];
+    }
+    return p;
+}
+
+// Formats as `inet_ntop` does: the first longest run of 2 zero groups at
+// least is compressed, and IPv4-mapped or compatible addresses end with a
+// dotted quad
+char* format_ipv6(char* p, const std::uint8_t* bytes) noexcept {
+    unsigned groups[8];
+    for (int i = 0; i < 8; ++i) {
+        groups[i] = unsigned(bytes[2 * i]) << 8 | bytes[2 * i + 1];
+    }
+
+    int best = -1, best_len = 0;
+    for (int i = 0; i < 8;) {
+        if (groups[i] != 0) {
+            ++i;
+            continue;
+        }
+        int j = i;
+        while (j < 8 && groups[j] == 0) {
+            ++j;
+        }
+        if (j - i > best_len) {
+            best = i;
+            best_len = j - i;
+        }
+        i = j;
+    }
+    if (best_len < 2) {
+        best = -1;
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        if (best >= 0 && i >= best && i < best + best_len) {
+            if (i == best) {
+                *p++ = ':';
+            }
+            continue;
+        }
+        if (i != 0) {
+            *p++ = ':';
+        }
+        if (i == 6 && best == 0 &&
+            (best_len == 6 || (best_len == 5 && groups[5] == 0xffff))) {
+            return format_ipv4(p, bytes + 12);
+        }
+        p = format_group(p, groups[i]);
+    }
+    if (best >= 0 && best + best_len == 8) {
+        *p++ = ':';
+    }
+    return p;
+}
+
+std::to_chars_result copy_chars(const char* buf, std::size_t len,
+                                char* first, char* last) noexcept {
+    if (static_cast<std::size_t>(last - first) < len) {
+        return {last, std::errc::value_too_large};
+    }
+    std::memcpy(first, buf, len);
+    return {first + len, std::errc()};
+}
+
+} // namespace
+
 Result<IPv6Address, IPAddressFormatError>
 IPv6Address::from_str(std::string_view sv) noexcept {
-    struct in6_addr addr;
-    if (::inet_pton(AF_INET6, sv.data(), &addr) != 1) {
+    AddressStorage addr(0, 0, 0, 0);
+    if (!parse_ipv6(sv, addr.addr8)) {
         return Err(IPAddressFormatError::INVALID_IP);
     }
-    return Ok(IPv6Address(addr));
+    return Ok(IPv6Address(addr.native));
 }
 
 Option<IPv4Address> IPv6Address::to_ipv4() const {
@@ -29,43 +311,51 @@ Option<IPv4Address> IPv6Address::to_ipv4() const {
 }
 
 std::string IPv6Address::str() const {
-    char buf[INET6_ADDRSTRLEN] = "";
-    ::inet_ntop(AF_INET6, (const void*)&addr_.native, buf, INET6_ADDRSTRLEN);
-    return std::string(buf);
+    char buf[kMaxStrLen];
+    return std::string(buf, format_ipv6(buf, addr_.addr8));
+}
+
+std::to_chars_result IPv6Address::to_chars(char* first, char* last) const
+    noexcept {
+    char buf[kMaxStrLen];
+    return copy_chars(buf, format_ipv6(buf, addr_.addr8) - buf, first, last);
 }
 
 Result<IPv4Address, IPAddressFormatError>
 IPv4Address::from_str(std::string_view sv) noexcept {
-    struct in_addr addr;
-    if (::inet_pton(AF_INET, sv.data(), &addr) != 1) {
+    AddressStorage addr(0);
+    if (!parse_ipv4(sv, addr.addr8)) {
         return Err(IPAddressFormatError::INVALID_IP);
     }
-    return Ok(IPv4Address(addr));
+    return Ok(IPv4Address(addr.addr32));
 }
 
 std::string IPv4Address::str() const {
-    char buf[INET_ADDRSTRLEN] = "";
-    ::inet_ntop(AF_INET, (const void*)&addr_.native, buf, INET_ADDRSTRLEN);
-    return std::string(buf);
+    char buf[kMaxStrLen];
+    return std::string(buf, format_ipv4(buf, addr_.addr8));
+}
+
+std::to_chars_result IPv4Address::to_chars(char* first, char* last) const
+    noexcept {
+    char buf[kMaxStrLen];
+    return copy_chars(buf, format_ipv4(buf, addr_.addr8) - buf, first, last);
 }
 
 Result<IPAddress, IPAddressFormatError>
-// `map` and `or_else` are not specified as noexcept.
+// `map` is not specified as noexcept.
 // Perhaps `noexcept(auto)` is the hope.
 // See https://www.reddit.com/r/cpp/comments/9ygb73/noexceptauto/ for more
 // information
 // NOLINTNEXTLINE(bugprone-exception-escape)
 IPAddress::from_str(std::string_view sv) noexcept {
-    return IPv4Address::from_str(sv)
-        .map([](const IPv4Address& addr) -> IPAddress {
-            return IPAddress(addr);
-        })
-        .or_else([sv](auto) -> Result<IPAddress, IPAddressFormatError> {
-            return IPv6Address::from_str(sv).map(
-                [](const IPv6Address& addr) -> IPAddress {
-                    return IPAddress(addr);
-                });
-        });
+    if (sv.find(':') == std::string_view::npos) {
+        return IPv4Address::from_str(sv).map(
+            [](const IPv4Address& addr) -> IPAddress {
+                return IPAddress(addr);
+            });
+    }
+    return IPv6Address::from_str(sv).map(
+        [](const IPv6Address& addr) -> IPAddress { return IPAddress(addr); });
 }
 
 } // namespace bipolar
@@ -9,6 +9,8 @@
 
 #include <array>
 #include <cassert>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -32,6 +34,7 @@ class IPv6Address;
 /// IP address format error
 enum class IPAddressFormatError {
     INVALID_IP,
+    INVALID_PREFIX_LEN,
 };
 
 /// IPv6Address
@@ -130,9 +133,8 @@ public:
 
     /// Creates a new IPv6Address from a `string_view`
     ///
-    /// # Note
-    ///
-    /// The string should be null-terminated due to inet_pton restriction
+    /// Accepts what `inet_pton` does, without requiring a null-terminated
+    /// string.
     ///
     /// # Examples
     ///
@@ -242,6 +244,25 @@ public:
     /// ```
     [[nodiscard]] std::string str() const;
 
+    /// The maximum length of the textual representation, e.g.
+    /// `ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255`
+    static constexpr std::size_t kMaxStrLen = 45;
+
+    /// Writes the textual representation of `str` into `[first, last)`,
+    /// without a null terminator
+    ///
+    /// Returns the end of the characters written, or `last` along with
+    /// `std::errc::value_too_large` if they don't fit.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// char buf[IPv6Address::kMaxStrLen];
+    /// auto [end, ec] = IPv6Address().to_chars(buf, buf + sizeof(buf));
+    /// assert(std::string_view(buf, end - buf) == "::");
+    /// ```
+    std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
 private:
     union AddressStorage {
         static_assert(sizeof(struct in6_addr) == sizeof(std::uint32_t) * 4);
@@ -381,9 +402,8 @@ public:
 
     /// Creates a new IPv4Address from a `string_view`
     ///
-    /// # Note
-    ///
-    /// The string should be null-terminated due to inet_pton restriction
+    /// Accepts what `inet_pton` does, i.e. four decimal octets without
+    /// leading zeros, without requiring a null-terminated string.
     ///
     /// # Examples
     ///
@@ -491,6 +511,25 @@ public:
     /// ```
     [[nodiscard]] std::string str() const;
 
+    /// The maximum length of the textual representation, e.g.
+    /// `255.255.255.255`
+    static constexpr std::size_t kMaxStrLen = 15;
+
+    /// Writes the textual representation of `str` into `[first, last)`,
+    /// without a null terminator
+    ///
+    /// Returns the end of the characters written, or `last` along with
+    /// `std::errc::value_too_large` if they don't fit.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// char buf[IPv4Address::kMaxStrLen];
+    /// auto [end, ec] = IPv4Address(127, 0, 0, 1).to_chars(buf, buf + 15);
+    /// assert(std::string_view(buf, end - buf) == "127.0.0.1");
+    /// ```
+    std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
 private:
     union AddressStorage {
         static_assert(sizeof(struct in_addr) == sizeof(std::uint32_t));
@@ -627,9 +666,7 @@ public:
 
     /// Creates a new IPAddress from a `string_view`
     ///
-    /// # Note
-    ///
-    /// The string should be null-terminated due to inet_pton restriction
+    /// It's an IPv6 address if the string contains a `:`.
     ///
     /// # Examples
     ///
@@ -730,6 +767,23 @@ public:
                      [](std::monostate) -> std::string { return ""; }});
     }
 
+    /// The maximum length of the textual representation
+    static constexpr std::size_t kMaxStrLen = IPv6Address::kMaxStrLen;
+
+    /// Writes the textual representation into `[first, last)`
+    ///
+    /// see `IPv4Address::to_chars` and `IPv6Address::to_chars` for details
+    std::to_chars_result to_chars(char* first, char* last) const noexcept {
+        switch (family()) {
+        case AF_INET:
+            return std::get_if<IPv4Address>(&addr_)->to_chars(first, last);
+
+        case AF_INET6:
+            return std::get_if<IPv6Address>(&addr_)->to_chars(first, last);
+        }
+        return {first, std::errc()};
+    }
+
     /// Converts to sockaddr to communicate with system call
     [[nodiscard]] constexpr struct sockaddr_storage
     to_sockaddr(std::uint16_t port) const {
@@ -0,0 +1,119 @@
+#include "bipolar/net/ip_network.hpp"
+
+#include <cstring>
+
+#include "bipolar/core/byteorder.hpp"
+
+namespace bipolar {
+namespace {
+// The mask of the first `prefix_len` bits, in network byteorder
+std::uint32_t ipv4_mask(std::uint8_t prefix_len) noexcept {
+    return prefix_len == 0 ? 0 : hton(~std::uint32_t(0) << (32 - prefix_len));
+}
+
+void mask_ipv6(std::uint8_t* bytes, std::uint8_t prefix_len) noexcept {
+    const std::size_t full = prefix_len / 8;
+    if (full < 16) {
+        bytes[full] &= static_cast<std::uint8_t>(0xff00 >> (prefix_len % 8));
+        std::memset(bytes + full + 1, 0, 15 - full);
+    }
+}
+
+bool prefix_equal(const std::uint8_t* lhs, const std::uint8_t* rhs,
+                  std::uint8_t prefix_len) noexcept {
+    const std::size_t full = prefix_len / 8;
+    if (std::memcmp(lhs, rhs, full) != 0) {
+        return false;
+    }
+    const auto mask = static_cast<std::uint8_t>(0xff00 >> (prefix_len % 8));
+    return full == 16 || ((lhs[full] ^ rhs[full]) & mask) == 0;
+}
+
+} // namespace
+
+IPNetwork::IPNetwork(const IPv4Address& addr, std::uint8_t prefix_len) noexcept
+    : addr_(IPv4Address(addr.to_long() & ipv4_mask(prefix_len))),
+      prefix_len_(prefix_len) {
+    assert(prefix_len <= 32);
+}
+
+IPNetwork::IPNetwork(const IPv6Address& addr, std::uint8_t prefix_len) noexcept
+    : prefix_len_(prefix_len) {
+    assert(prefix_len <= 128);
+    struct in6_addr native = addr.native();
+    mask_ipv6(native.s6_addr, prefix_len);
+    addr_ = IPv6Address(native);
+}
+
+IPNetwork::IPNetwork(const IPAddress& addr, std::uint8_t prefix_len) noexcept {
+    if (addr.is_ipv4()) {
+        *this = IPNetwork(addr.as_ipv4(), prefix_len);
+    } else if (addr.is_ipv6()) {
+        *this = IPNetwork(addr.as_ipv6(), prefix_len);
+    }
+}
+
+Result<IPNetwork, IPAddressFormatError>
+IPNetwork::from_str(std::string_view sv) noexcept {
+    const auto slash = sv.rfind('/');
+    if (slash == std::string_view::npos) {
+        return Err(IPAddressFormatError::INVALID_IP);
+    }
+
+    auto addr = IPAddress::from_str(sv.substr(0, slash));
+    if (addr.is_error()) {
+        return Err(addr.error());
+    }
+
+    // 1 to 3 decimal digits, without a leading zero
+    const std::string_view len = sv.substr(slash + 1);
+    unsigned prefix_len = 0;
+    const auto [end, ec] =
+        std::from_chars(len.data(), len.data() + len.size(), prefix_len);
+    const unsigned max_len = addr.value().is_ipv4() ? 32 : 128;
+    if (ec != std::errc() || end != len.data() + len.size() ||
+        len.size() > 3 || (len.size() > 1 && len[0] == '0') ||
+        prefix_len > max_len) {
+        return Err(IPAddressFormatError::INVALID_PREFIX_LEN);
+    }
+    return Ok(IPNetwork(addr.value(), static_cast<std::uint8_t>(prefix_len)));
+}
+
+bool IPNetwork::contains(const IPAddress& addr) const noexcept {
+    if (addr.family() != family()) {
+        return false;
+    }
+    if (addr.is_ipv4()) {
+        return (addr.as_ipv4().to_long() & ipv4_mask(prefix_len_)) ==
+               addr_.as_ipv4().to_long();
+    }
+    if (addr.is_ipv6()) {
+        const struct in6_addr lhs = addr.as_ipv6().native();
+        const struct in6_addr rhs = addr_.as_ipv6().native();
+        return prefix_equal(lhs.s6_addr, rhs.s6_addr, prefix_len_);
+    }
+    return false;
+}
+
+std::to_chars_result IPNetwork::to_chars(char* first, char* last) const
+    noexcept {
+    if (is_empty()) {
+        return {first, std::errc()};
+    }
+    auto result = addr_.to_chars(first, last);
+    if (result.ec != std::errc()) {
+        return result;
+    }
+    if (result.ptr == last) {
+        return {last, std::errc::value_too_large};
+    }
+    *result.ptr++ = '/';
+    return std::to_chars(result.ptr, last, unsigned(prefix_len_));
+}
+
+std::string IPNetwork::str() const {
+    char buf[kMaxStrLen];
+    return std::string(buf, to_chars(buf, buf + sizeof(buf)).ptr);
+}
+
+} // namespace bipolar
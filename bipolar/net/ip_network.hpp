@@ -0,0 +1,159 @@
+//! IPNetwork
+//!
+//! see `IPNetwork` for details
+
+#ifndef BIPOLAR_NET_IP_NETWORK_HPP_
+#define BIPOLAR_NET_IP_NETWORK_HPP_
+
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/net/ip_address.hpp"
+
+namespace bipolar {
+/// IPNetwork
+///
+/// # Brief
+///
+/// An IP prefix, either IPv4 or IPv6, i.e. an address and the number of
+/// its leading bits which make up the network.
+///
+/// The bits of the address after the prefix length are cleared, so that
+/// `10.1.2.3/8` and `10.0.0.0/8` are the same network.
+///
+/// # Textual representation
+///
+/// The CIDR notation, an address followed by `/` and the prefix length.
+///
+/// # Examples
+///
+/// ```
+/// auto net = IPNetwork::from_str("10.0.0.0/8").value();
+/// assert(net.contains(IPv4Address(10, 1, 2, 3)));
+/// assert(!net.contains(IPv4Address(11, 0, 0, 0)));
+/// assert(net.str() == "10.0.0.0/8");
+/// ```
+class IPNetwork {
+public:
+    /// Creates an empty network, whose protocol is unspecified
+    constexpr IPNetwork() noexcept = default;
+
+    /// Creates a new network from an IPv4 address and a prefix length,
+    /// which must not exceed 32
+    IPNetwork(const IPv4Address& addr, std::uint8_t prefix_len) noexcept;
+
+    /// Creates a new network from an IPv6 address and a prefix length,
+    /// which must not exceed 128
+    IPNetwork(const IPv6Address& addr, std::uint8_t prefix_len) noexcept;
+
+    /// Creates a new network from an `IPAddress` and a prefix length
+    ///
+    /// An empty address makes an empty network.
+    IPNetwork(const IPAddress& addr, std::uint8_t prefix_len) noexcept;
+
+    /// Creates a new `IPNetwork` from a `string_view` in CIDR notation
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// auto r1 = IPNetwork::from_str("2001:db8::/32").value();
+    /// assert(r1.is_ipv6() && r1.prefix_len() == 32);
+    ///
+    /// auto r2 = IPNetwork::from_str("10.0.0.0/33");
+    /// assert(r2.error() == IPAddressFormatError::INVALID_PREFIX_LEN);
+    /// ```
+    static Result<IPNetwork, IPAddressFormatError>
+    from_str(std::string_view sv) noexcept;
+
+    /// Returns the network address, whose host bits are cleared
+    [[nodiscard]] constexpr const IPAddress& addr() const noexcept {
+        return addr_;
+    }
+
+    /// Returns the number of leading bits of the network
+    [[nodiscard]] constexpr std::uint8_t prefix_len() const noexcept {
+        return prefix_len_;
+    }
+
+    /// Returns the address family
+    [[nodiscard]] constexpr int family() const noexcept {
+        return addr_.family();
+    }
+
+    /// Returns `true` if this network's protocol is unspecified
+    [[nodiscard]] constexpr bool is_empty() const noexcept {
+        return addr_.is_empty();
+    }
+
+    /// Returns `true` if this is an IPv4 network
+    [[nodiscard]] constexpr bool is_ipv4() const noexcept {
+        return addr_.is_ipv4();
+    }
+
+    /// Returns `true` if this is an IPv6 network
+    [[nodiscard]] constexpr bool is_ipv6() const noexcept {
+        return addr_.is_ipv6();
+    }
+
+    /// Returns `true` if `addr` belongs to this network
+    ///
+    /// An address of another family never does.
+    [[nodiscard]] bool contains(const IPAddress& addr) const noexcept;
+
+    /// The maximum length of the textual representation
+    static constexpr std::size_t kMaxStrLen = IPAddress::kMaxStrLen + 4;
+
+    /// Writes the textual representation into `[first, last)`, without a
+    /// null terminator
+    ///
+    /// see `IPv4Address::to_chars` for details
+    std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
+    /// Stringify the network in CIDR notation, empty for an empty network
+    [[nodiscard]] std::string str() const;
+
+private:
+    IPAddress addr_;
+    std::uint8_t prefix_len_ = 0;
+};
+
+/// Compares `IPNetwork` with other `IPNetwork`
+inline bool operator==(const IPNetwork& lhs, const IPNetwork& rhs) {
+    return lhs.prefix_len() == rhs.prefix_len() && lhs.addr() == rhs.addr();
+}
+
+inline bool operator!=(const IPNetwork& lhs, const IPNetwork& rhs) {
+    return !(lhs == rhs);
+}
+
+/// Orders by family, address then prefix length
+inline bool operator<(const IPNetwork& lhs, const IPNetwork& rhs) {
+    if (lhs.family() != rhs.family()) {
+        return lhs.family() < rhs.family();
+    }
+    if (lhs.addr() != rhs.addr()) {
+        return lhs.addr() < rhs.addr();
+    }
+    return lhs.prefix_len() < rhs.prefix_len();
+}
+
+inline bool operator>(const IPNetwork& lhs, const IPNetwork& rhs) {
+    return rhs < lhs;
+}
+
+inline bool operator<=(const IPNetwork& lhs, const IPNetwork& rhs) {
+    return !(lhs > rhs);
+}
+
+inline bool operator>=(const IPNetwork& lhs, const IPNetwork& rhs) {
+    return !(lhs < rhs);
+}
+
+} // namespace bipolar
+
+#endif
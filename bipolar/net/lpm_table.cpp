@@ -0,0 +1,59 @@
+#include "bipolar/net/lpm_table.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+namespace bipolar {
+void LpmSnapshot::lookup(const IPv4Address* addrs, std::size_t n,
+                         std::uint32_t* values) const noexcept {
+    lookup_burst(v4_, addrs, n, values);
+}
+
+void LpmSnapshot::lookup(const IPv6Address* addrs, std::size_t n,
+                         std::uint32_t* values) const noexcept {
+    lookup_burst(v6_, addrs, n, values);
+}
+
+bool LpmTable::insert(const IPNetwork& net, std::uint32_t value) {
+    assert(!net.is_empty() && value <= LpmSnapshot::kMaxValue);
+    return rules_.insert_or_assign(net, value).second;
+}
+
+bool LpmTable::erase(const IPNetwork& net) {
+    return rules_.erase(net) != 0;
+}
+
+void LpmTable::commit() {
+    // shorter prefixes first, so that the longer ones override them
+    std::vector<const std::pair<const IPNetwork, std::uint32_t>*> rules;
+    rules.reserve(rules_.size());
+    for (const auto& rule : rules_) {
+        rules.push_back(&rule);
+    }
+    std::stable_sort(rules.begin(), rules.end(),
+                     [](const auto* lhs, const auto* rhs) {
+                         return lhs->first.prefix_len() <
+                                rhs->first.prefix_len();
+                     });
+
+    auto snapshot = std::make_shared<LpmSnapshot>();
+    for (const auto* rule : rules) {
+        const IPNetwork& net = rule->first;
+        if (net.is_ipv4()) {
+            snapshot->v4_.insert(LpmSnapshot::key(net.addr().as_ipv4()),
+                                 net.prefix_len(), rule->second);
+        } else {
+            snapshot->v6_.insert(LpmSnapshot::key(net.addr().as_ipv6()),
+                                 net.prefix_len(), rule->second);
+        }
+    }
+    snapshot->size_ = rules.size();
+
+    std::atomic_store_explicit(
+        &snapshot_, std::shared_ptr<const LpmSnapshot>(std::move(snapshot)),
+        std::memory_order_release);
+}
+
+} // namespace bipolar
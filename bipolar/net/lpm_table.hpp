@@ -0,0 +1,219 @@
+//! LpmTable
+//!
+//! see `LpmTable` and `LpmSnapshot` for details
+
+#ifndef BIPOLAR_NET_LPM_TABLE_HPP_
+#define BIPOLAR_NET_LPM_TABLE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/net/internal/lpm_trie.hpp"
+#include "bipolar/net/ip_address.hpp"
+#include "bipolar/net/ip_network.hpp"
+
+namespace bipolar {
+/// LpmSnapshot
+///
+/// # Brief
+///
+/// An immutable longest prefix match table, built by `LpmTable::commit`,
+/// which maps IP addresses to the value of the longest `IPNetwork`
+/// containing them.
+///
+/// IPv4 is a DIR-24-8 table: a lookup is a load of the entry of the first
+/// 24 bits, and another one of the last 8 bits only if a prefix longer than
+/// 24 bits covers it, whose 64MB are allocated only if there's any IPv4
+/// prefix. IPv6 is a multibit trie indexed by the first 16 bits, then by a
+/// byte per level.
+///
+/// Burst lookups prefetch the entries of all the addresses at a level
+/// before loading any, overlapping their cache misses, so they're the ones
+/// to use on the data path.
+///
+/// # Examples
+///
+/// ```
+/// auto snapshot = table.snapshot();
+/// std::uint32_t verdicts[kBurst];
+/// snapshot->lookup(addrs, kBurst, verdicts);
+/// for (std::size_t i = 0; i < kBurst; ++i) {
+///     if (verdicts[i] == LpmSnapshot::kNoMatch) ...
+/// }
+/// ```
+class LpmSnapshot {
+public:
+    /// The value of the addresses which match no prefix in burst lookups
+    static constexpr std::uint32_t kNoMatch = ~std::uint32_t(0);
+
+    /// The maximum value of a prefix
+    static constexpr std::uint32_t kMaxValue =
+        internal::LpmTrie<3, 4>::kMaxValue;
+
+    /// The maximum number of addresses looked up at a time
+    static constexpr std::size_t kBurst = 16;
+
+    LpmSnapshot() = default;
+    LpmSnapshot(const LpmSnapshot&) = delete;
+    LpmSnapshot& operator=(const LpmSnapshot&) = delete;
+
+    /// Returns the value of the longest prefix containing `addr`
+    Option<std::uint32_t> lookup(const IPv4Address& addr) const noexcept {
+        return to_option(v4_.find(key(addr)));
+    }
+
+    /// Returns the value of the longest prefix containing `addr`
+    Option<std::uint32_t> lookup(const IPv6Address& addr) const noexcept {
+        return to_option(v6_.find(key(addr)));
+    }
+
+    /// Returns the value of the longest prefix containing `addr`, `None`
+    /// for an empty address
+    Option<std::uint32_t> lookup(const IPAddress& addr) const noexcept {
+        if (addr.is_ipv4()) {
+            return lookup(addr.as_ipv4());
+        }
+        if (addr.is_ipv6()) {
+            return lookup(addr.as_ipv6());
+        }
+        return None;
+    }
+
+    /// Looks up `n` addresses, storing the value of `addrs[i]` in
+    /// `values[i]`, `kNoMatch` if no prefix contains it
+    void lookup(const IPv4Address* addrs, std::size_t n,
+                std::uint32_t* values) const noexcept;
+
+    /// Looks up `n` addresses, storing the value of `addrs[i]` in
+    /// `values[i]`, `kNoMatch` if no prefix contains it
+    void lookup(const IPv6Address* addrs, std::size_t n,
+                std::uint32_t* values) const noexcept;
+
+    /// Returns the number of prefixes
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Returns the number of bytes of the tables
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return v4_.memory_usage() + v6_.memory_usage();
+    }
+
+private:
+    friend class LpmTable;
+
+    // The key of an address is its object representation, the address in
+    // network byteorder, so that bursts are looked up in place
+    template <typename Address>
+    static const std::uint8_t* key(const Address& addr) noexcept {
+        static_assert(sizeof(IPv4Address) == 4 && sizeof(IPv6Address) == 16);
+        return reinterpret_cast<const std::uint8_t*>(&addr);
+    }
+
+    template <typename Trie, typename Address>
+    static void lookup_burst(const Trie& trie, const Address* addrs,
+                             std::size_t n, std::uint32_t* values) noexcept {
+        for (std::size_t i = 0; i < n; i += kBurst) {
+            const std::size_t burst = std::min(n - i, kBurst);
+            trie.find(key(addrs[i]), burst, values + i);
+        }
+        // entries are value + 1, so that no match wraps to `kNoMatch`
+        for (std::size_t i = 0; i < n; ++i) {
+            values[i] -= 1;
+        }
+    }
+
+    static Option<std::uint32_t> to_option(std::uint32_t entry) noexcept {
+        if (entry == 0) {
+            return None;
+        }
+        return Some(entry - 1);
+    }
+
+    internal::LpmTrie<3, 4> v4_;
+    internal::LpmTrie<2, 16> v6_;
+    std::size_t size_ = 0;
+};
+
+/// LpmTable
+///
+/// # Brief
+///
+/// The prefixes of an `LpmSnapshot` and their values, e.g. routes or ACL
+/// verdicts.
+///
+/// Updates are staged by `insert` and `erase`, then `commit` builds a new
+/// snapshot and swaps it in atomically. Readers take the current snapshot,
+/// keep it for a burst or more, and are never blocked by the updates: the
+/// old snapshot lives as long as a reader holds it.
+///
+/// A table is updated by one thread at a time, while any thread may call
+/// `snapshot`.
+///
+/// # Examples
+///
+/// ```
+/// LpmTable table;
+/// table.insert(IPNetwork::from_str("10.0.0.0/8").value(), 1);
+/// table.insert(IPNetwork::from_str("10.1.0.0/16").value(), 2);
+/// table.commit();
+///
+/// auto snapshot = table.snapshot();
+/// assert(snapshot->lookup(IPv4Address(10, 1, 2, 3)).value() == 2);
+/// assert(snapshot->lookup(IPv4Address(10, 2, 3, 4)).value() == 1);
+/// assert(!snapshot->lookup(IPv4Address(11, 0, 0, 0)).has_value());
+/// ```
+class LpmTable {
+public:
+    /// Creates an empty table, whose snapshot matches nothing
+    LpmTable() : snapshot_(std::make_shared<const LpmSnapshot>()) {}
+
+    LpmTable(const LpmTable&) = delete;
+    LpmTable& operator=(const LpmTable&) = delete;
+
+    /// Stages a prefix, replacing the value of the same prefix if any
+    ///
+    /// Returns `true` if the prefix is new. `value` must not exceed
+    /// `LpmSnapshot::kMaxValue`, and `net` must not be empty.
+    bool insert(const IPNetwork& net, std::uint32_t value);
+
+    /// Stages the removal of a prefix
+    ///
+    /// Returns `false` if there's no such prefix.
+    bool erase(const IPNetwork& net);
+
+    /// Stages the removal of all the prefixes
+    void clear() noexcept {
+        rules_.clear();
+    }
+
+    /// Returns the number of prefixes, including the staged ones
+    [[nodiscard]] std::size_t size() const noexcept {
+        return rules_.size();
+    }
+
+    /// Builds a snapshot of the prefixes and publishes it
+    ///
+    /// It takes time linear in the size of the tables, about half a second
+    /// for a million IPv4 prefixes, so updates should be batched.
+    void commit();
+
+    /// Returns the last snapshot committed
+    [[nodiscard]] std::shared_ptr<const LpmSnapshot> snapshot() const
+        noexcept {
+        return std::atomic_load_explicit(&snapshot_,
+                                         std::memory_order_acquire);
+    }
+
+private:
+    std::map<IPNetwork, std::uint32_t> rules_;
+    std::shared_ptr<const LpmSnapshot> snapshot_;
+};
+
+} // namespace bipolar
+
+#endif
@@ -1,11 +1,7 @@
 #include "bipolar/net/socket_address.hpp"
 
-#include <arpa/inet.h>
-
-#include <algorithm>
-#include <cctype>
-#include <charconv>
-#include <numeric>
+#include <cstring>
+#include <limits>
 
 #include "bipolar/core/byteorder.hpp"
 
@@ -21,63 +17,68 @@ SocketAddress::from_str(std::string_view sv) noexcept {
         return Err(SocketAddressFormatError::INVALID_FORMAT);
     }
 
-    const std::string_view addr_str = sv.substr(0, pos),
-                           port_str = sv.substr(pos + 1);
+    std::string_view addr_str = sv.substr(0, pos);
+    const std::string_view port_str = sv.substr(pos + 1);
     if (port_str.size() > 5) {
         return Err(SocketAddressFormatError::INVALID_PORT);
     }
-    if (std::any_of(port_str.begin(), port_str.end(),
-                    [](char ch) { return !std::isdigit(ch); })) {
-        return Err(SocketAddressFormatError::INVALID_PORT);
-    }
 
     // the `port_str` will belong to [0, 99999] while `std::uint16_t`
     // belongs to [0, 65535]
     // range checks here
     std::uint32_t port = 0;
-    std::from_chars(port_str.data(), port_str.data() + port_str.size(), port);
+    for (const char ch : port_str) {
+        const unsigned digit = static_cast<unsigned char>(ch) - '0';
+        if (digit > 9) {
+            return Err(SocketAddressFormatError::INVALID_PORT);
+        }
+        port = port * 10 + digit;
+    }
     if (port > std::numeric_limits<std::uint16_t>::max()) {
         return Err(SocketAddressFormatError::INVALID_PORT);
     }
 
-    // due to the restrict of `inet_pton`, the `src` parameter needs to be
-    // null-terminated while `std::string_view` violates.
-    char addr[INET6_ADDRSTRLEN] = "";
-    if (addr_str.front() == '[' && addr_str.back() == ']') {
-        const auto substr = addr_str.substr(1, pos - 2);
-        std::copy(substr.begin(), substr.end(), addr);
-    } else {
-        std::copy(addr_str.begin(), addr_str.end(), addr);
+    if (addr_str.size() >= 2 && addr_str.front() == '[' &&
+        addr_str.back() == ']') {
+        addr_str = addr_str.substr(1, addr_str.size() - 2);
     }
 
-    return IPAddress::from_str(addr)
-        .map([port](const IPAddress& addr) -> SocketAddress {
-            return SocketAddress(addr, hton(static_cast<std::uint16_t>(port)));
-        })
-        .map_err([](auto) -> SocketAddressFormatError {
-            return SocketAddressFormatError::INVALID_ADDRESS;
-        });
+    auto addr = IPAddress::from_str(addr_str);
+    if (addr.is_error()) {
+        return Err(SocketAddressFormatError::INVALID_ADDRESS);
+    }
+    return Ok(
+        SocketAddress(addr.value(), hton(static_cast<std::uint16_t>(port))));
 }
 
-std::string SocketAddress::str() const {
-    std::string ret;
-    if (addr_.is_ipv4()) {
-        ret.assign(addr_.str());
-        ret.append(1, ':');
-    } else if (addr_.is_ipv6()) {
-        ret.append(1, '[');
-        ret.append(addr_.str());
-        ret.append(1, ']');
-        ret.append(1, ':');
-    } else {
-        // empty
-        return "";
+std::to_chars_result SocketAddress::to_chars(char* first, char* last) const
+    noexcept {
+    if (addr_.is_empty()) {
+        return {first, std::errc()};
     }
 
-    char buf[6] = "";
-    const auto [p, _] = std::to_chars(buf, buf + sizeof(buf), ntoh(port_));
-    ret.append(buf, p);
+    char buf[kMaxStrLen];
+    char* p = buf;
+    if (addr_.is_ipv6()) {
+        *p++ = '[';
+    }
+    p = addr_.to_chars(p, buf + sizeof(buf)).ptr;
+    if (addr_.is_ipv6()) {
+        *p++ = ']';
+    }
+    *p++ = ':';
+    p = std::to_chars(p, buf + sizeof(buf), ntoh(port_)).ptr;
+
+    const auto len = static_cast<std::size_t>(p - buf);
+    if (static_cast<std::size_t>(last - first) < len) {
+        return {last, std::errc::value_too_large};
+    }
+    std::memcpy(first, buf, len);
+    return {first + len, std::errc()};
+}
 
-    return ret;
+std::string SocketAddress::str() const {
+    char buf[kMaxStrLen];
+    return std::string(buf, to_chars(buf, buf + sizeof(buf)).ptr);
 }
 } // namespace bipolar
@@ -5,6 +5,8 @@
 #ifndef BIPOLAR_IO_SOCKET_ADDRESS_HPP_
 #define BIPOLAR_IO_SOCKET_ADDRESS_HPP_
 
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <string_view>
@@ -179,6 +181,27 @@ public:
     /// ```
     [[nodiscard]] std::string str() const;
 
+    /// The maximum length of the textual representation, e.g.
+    /// `[ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255]:65535`
+    static constexpr std::size_t kMaxStrLen = IPAddress::kMaxStrLen + 8;
+
+    /// Writes the textual representation of `str` into `[first, last)`,
+    /// without a null terminator
+    ///
+    /// Returns the end of the characters written, or `last` along with
+    /// `std::errc::value_too_large` if they don't fit.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// SocketAddress addr(IPAddress(IPv4Address(127, 0, 0, 1)),
+    ///                    hton(static_cast<std::uint16_t>(8080)));
+    /// char buf[SocketAddress::kMaxStrLen];
+    /// auto [end, ec] = addr.to_chars(buf, buf + sizeof(buf));
+    /// assert(std::string_view(buf, end - buf) == "127.0.0.1:8080");
+    /// ```
+    std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
     /// Converts to sockaddr to communicate with system calls
     [[nodiscard]] constexpr struct sockaddr_storage to_sockaddr() const {
         return addr_.to_sockaddr(port_);
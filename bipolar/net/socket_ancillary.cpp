@@ -0,0 +1,113 @@
+#include "bipolar/net/socket_ancillary.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bipolar {
+struct cmsghdr* SocketAncillary::append(int type, std::size_t len) noexcept {
+    if (len_ + CMSG_SPACE(len) > kCapacity) {
+        return nullptr;
+    }
+
+    auto* cmsg = reinterpret_cast<struct cmsghdr*>(buf_ + len_);
+    std::memset(cmsg, 0, CMSG_SPACE(len));
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = type;
+    cmsg->cmsg_len = CMSG_LEN(len);
+    len_ += CMSG_SPACE(len);
+    return cmsg;
+}
+
+bool SocketAncillary::add_fds(const int* fds, std::size_t n) noexcept {
+    if (n == 0 || n > kMaxFds) {
+        return n == 0;
+    }
+    auto* cmsg = append(SCM_RIGHTS, sizeof(int) * n);
+    if (cmsg == nullptr) {
+        return false;
+    }
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * n);
+    return true;
+}
+
+bool SocketAncillary::add_creds(const UnixCredentials& creds) noexcept {
+    auto* cmsg = append(SCM_CREDENTIALS, sizeof(struct ucred));
+    if (cmsg == nullptr) {
+        return false;
+    }
+    const struct ucred native = {
+        .pid = creds.pid,
+        .uid = creds.uid,
+        .gid = creds.gid,
+    };
+    std::memcpy(CMSG_DATA(cmsg), &native, sizeof(native));
+    return true;
+}
+
+template <typename F>
+void SocketAncillary::for_each(F&& f) const noexcept {
+    // the CMSG_* macros walk a msghdr
+    struct msghdr msg = {};
+    msg.msg_control = const_cast<unsigned char*>(buf_);
+    msg.msg_controllen = len_;
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET) {
+            f(*cmsg, cmsg->cmsg_len - CMSG_LEN(0));
+        }
+    }
+}
+
+std::size_t SocketAncillary::fds(int* fds, std::size_t max) const noexcept {
+    std::size_t n = 0;
+    for_each([&](const struct cmsghdr& cmsg, std::size_t len) {
+        if (cmsg.cmsg_type != SCM_RIGHTS) {
+            return;
+        }
+        const std::size_t count = std::min(len / sizeof(int), max - n);
+        std::memcpy(fds + n, CMSG_DATA(&cmsg), sizeof(int) * count);
+        n += count;
+    });
+    return n;
+}
+
+std::size_t SocketAncillary::fds_count() const noexcept {
+    std::size_t n = 0;
+    for_each([&](const struct cmsghdr& cmsg, std::size_t len) {
+        if (cmsg.cmsg_type == SCM_RIGHTS) {
+            n += len / sizeof(int);
+        }
+    });
+    return n;
+}
+
+Option<UnixCredentials> SocketAncillary::creds() const noexcept {
+    Option<UnixCredentials> ret = None;
+    for_each([&](const struct cmsghdr& cmsg, std::size_t len) {
+        if (cmsg.cmsg_type == SCM_CREDENTIALS &&
+            len >= sizeof(struct ucred)) {
+            struct ucred native;
+            std::memcpy(&native, CMSG_DATA(&cmsg), sizeof(native));
+            ret = Some(UnixCredentials{native.pid, native.uid, native.gid});
+        }
+    });
+    return ret;
+}
+
+void SocketAncillary::prepare_send(struct msghdr* msg) noexcept {
+    msg->msg_control = len_ == 0 ? nullptr : buf_;
+    msg->msg_controllen = len_;
+}
+
+void SocketAncillary::prepare_recv(struct msghdr* msg) noexcept {
+    clear();
+    msg->msg_control = buf_;
+    msg->msg_controllen = sizeof(buf_);
+}
+
+void SocketAncillary::finish_recv(const struct msghdr& msg) noexcept {
+    len_ = msg.msg_controllen;
+    truncated_ = (msg.msg_flags & MSG_CTRUNC) != 0;
+}
+
+} // namespace bipolar
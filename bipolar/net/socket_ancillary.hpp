@@ -0,0 +1,137 @@
+//! SocketAncillary
+//!
+//! see `SocketAncillary` for details
+
+#ifndef BIPOLAR_NET_SOCKET_ANCILLARY_HPP_
+#define BIPOLAR_NET_SOCKET_ANCILLARY_HPP_
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cstddef>
+
+#include "bipolar/core/option.hpp"
+
+namespace bipolar {
+/// The credentials of a process, sent as `SCM_CREDENTIALS` or read by
+/// `SO_PEERCRED`
+struct UnixCredentials {
+    pid_t pid = 0;
+    uid_t uid = 0;
+    gid_t gid = 0;
+};
+
+/// SocketAncillary
+///
+/// # Brief
+///
+/// The ancillary data, aka control messages, sent along with the data of a
+/// Unix domain socket: file descriptors (`SCM_RIGHTS`) and credentials
+/// (`SCM_CREDENTIALS`).
+///
+/// The buffer is inline and holds as many file descriptors as the kernel
+/// passes in a message, `kMaxFds`, and a credentials message.
+///
+/// File descriptors received are owned by the receiver, who must close them.
+/// They're received with `O_CLOEXEC`.
+///
+/// # Examples
+///
+/// Hands a listener over to another process:
+///
+/// ```
+/// SocketAncillary ancillary;
+/// const int fd = listener.as_fd();
+/// ancillary.add_fds(&fd, 1);
+/// char tag = 'L';
+/// stream.send_with_ancillary(&tag, 1, ancillary).expect("handoff failed");
+/// ```
+///
+/// which takes it over:
+///
+/// ```
+/// SocketAncillary ancillary;
+/// char tag;
+/// stream.recv_with_ancillary(&tag, 1, ancillary).expect("handoff failed");
+/// int fd;
+/// if (ancillary.fds(&fd, 1) == 1) {
+///     TcpListener listener(fd);
+///     ...
+/// }
+/// ```
+///
+/// `man 7 unix` and `man 3 cmsg` for more information.
+class SocketAncillary {
+public:
+    /// The maximum number of file descriptors in a message, `SCM_MAX_FD`
+    static constexpr std::size_t kMaxFds = 253;
+
+    SocketAncillary() noexcept = default;
+
+    /// Appends a `SCM_RIGHTS` message of `n` file descriptors
+    ///
+    /// Returns `false` if they don't fit in the buffer.
+    bool add_fds(const int* fds, std::size_t n) noexcept;
+
+    /// Appends a `SCM_CREDENTIALS` message
+    ///
+    /// Unprivileged processes may only send their own pid, uid and gid.
+    /// Returns `false` if it doesn't fit in the buffer.
+    bool add_creds(const UnixCredentials& creds) noexcept;
+
+    /// Copies at most `max` of the file descriptors received into `fds`
+    ///
+    /// Returns the number of file descriptors copied. The others, if any,
+    /// are still to be closed.
+    std::size_t fds(int* fds, std::size_t max) const noexcept;
+
+    /// Returns the number of file descriptors received
+    [[nodiscard]] std::size_t fds_count() const noexcept;
+
+    /// Returns the credentials received, only if `SO_PASSCRED` is set on
+    /// the receiving socket
+    [[nodiscard]] Option<UnixCredentials> creds() const noexcept;
+
+    /// Returns `true` if some control messages didn't fit in the buffer
+    /// when received, the file descriptors they carried being closed by the
+    /// kernel
+    [[nodiscard]] bool truncated() const noexcept {
+        return truncated_;
+    }
+
+    /// Returns `true` if there is no control message
+    [[nodiscard]] bool empty() const noexcept {
+        return len_ == 0;
+    }
+
+    /// Removes all the control messages
+    void clear() noexcept {
+        len_ = 0;
+        truncated_ = false;
+    }
+
+    /// Attaches the messages to `msg` to be sent, or the whole buffer to be
+    /// filled by `recvmsg`
+    void prepare_send(struct msghdr* msg) noexcept;
+    void prepare_recv(struct msghdr* msg) noexcept;
+
+    /// Records the messages `recvmsg` filled in `msg`
+    void finish_recv(const struct msghdr& msg) noexcept;
+
+private:
+    static constexpr std::size_t kCapacity =
+        CMSG_SPACE(sizeof(int) * kMaxFds) + CMSG_SPACE(sizeof(struct ucred));
+
+    struct cmsghdr* append(int type, std::size_t len) noexcept;
+
+    template <typename F>
+    void for_each(F&& f) const noexcept;
+
+    alignas(struct cmsghdr) unsigned char buf_[kCapacity];
+    std::size_t len_ = 0;
+    bool truncated_ = false;
+};
+
+} // namespace bipolar
+
+#endif
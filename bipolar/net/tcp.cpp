@@ -10,7 +10,7 @@
 #include <limits>
 
 #include "bipolar/core/assert.hpp"
-#include "bipolar/net/internal/native_to_socket_address.hpp"
+#include "bipolar/net/compact_socket_address.hpp"
 
 namespace bipolar {
 TcpStream::~TcpStream() noexcept {
@@ -35,10 +35,8 @@ Result<TcpStream, int> TcpStream::connect(const SocketAddress& sa) noexcept {
         return Err(errno);
     }
 
-    const auto addr = sa.to_sockaddr();
-    const socklen_t len = sa.addr().is_ipv4() ? sizeof(struct sockaddr_in)
-                                              : sizeof(struct sockaddr_in6);
-    const int ret = ::connect(sock, (const struct sockaddr*)&addr, len);
+    const NativeSocketAddress addr(sa);
+    const int ret = ::connect(sock, addr.get(), addr.size());
     const int err = errno; // `close` may overwrite errno, so we save a copy
     if (ret == -1 && err != EINPROGRESS) {
         ::close(sock);
@@ -92,26 +90,48 @@ Result<std::size_t, int> TcpStream::recvmsg(struct msghdr* msg,
     return Ok(static_cast<std::size_t>(ret));
 }
 
+Result<std::size_t, int>
+TcpStream::recv_with_timestamps(void* buf, std::size_t len, Timestamps* stamps,
+                                int flags) noexcept {
+    struct iovec iov = {
+        .iov_base = buf,
+        .iov_len = len,
+    };
+    alignas(struct cmsghdr) char control[Timestamps::kControlLen];
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    const ssize_t ret = ::recvmsg(fd_, &msg, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    *stamps = Timestamps::from_msghdr(msg);
+    return Ok(static_cast<std::size_t>(ret));
+}
+
 Result<SocketAddress, int> TcpStream::local_addr() noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
-    const int ret = ::getsockname(fd_, (struct sockaddr*)&addr, &addr_len);
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const int ret = ::getsockname(fd_, addr.get(), &addr_len);
     if (ret == -1) {
         return Err(errno);
     }
 
-    return internal::native_addr_to_socket_address(&addr, addr_len);
+    return addr.to_socket_address(addr_len);
 }
 
 Result<SocketAddress, int> TcpStream::peer_addr() noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
-    const int ret = ::getpeername(fd_, (struct sockaddr*)&addr, &addr_len);
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const int ret = ::getpeername(fd_, addr.get(), &addr_len);
     if (ret == -1) {
         return Err(errno);
     }
 
-    return internal::native_addr_to_socket_address(&addr, addr_len);
+    return addr.to_socket_address(addr_len);
 }
 
 Result<Void, int> TcpStream::close() noexcept {
@@ -214,6 +234,32 @@ Result<struct tcp_info, int> TcpStream::get_tcp_info() noexcept {
     return Ok(info);
 }
 
+Result<Void, int> TcpStream::set_timestamping(std::uint32_t flags) noexcept {
+    const int optval = static_cast<int>(flags);
+    const int ret = ::setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &optval,
+                                 sizeof(optval));
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+Result<std::uint32_t, int> TcpStream::timestamping() noexcept {
+    int optval = 0;
+    socklen_t len = sizeof(optval);
+    const int ret =
+        ::getsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &optval, &len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::uint32_t>(optval));
+}
+
+Result<std::size_t, int>
+TcpStream::take_tx_timestamps(TxTimestamps* out, std::size_t n) noexcept {
+    return internal::recv_tx_timestamps(fd_, out, n);
+}
+
 TcpListener::~TcpListener() noexcept {
     const auto ret = close();
     BIPOLAR_ASSERT(!ret.is_error(), "tcp listener closed with error: {}",
@@ -262,11 +308,8 @@ Result<TcpListener, int> TcpListener::bind(const SocketAddress& sa) noexcept {
         return Err(errno);
     }
 
-    const auto addr = sa.to_sockaddr();
-    const socklen_t addr_len = sa.addr().is_ipv4()
-                                   ? sizeof(struct sockaddr_in)
-                                   : sizeof(struct sockaddr_in6);
-    ret = ::bind(sock, (const struct sockaddr*)&addr, addr_len);
+    const NativeSocketAddress addr(sa);
+    ret = ::bind(sock, addr.get(), addr.size());
     if (ret == -1) {
         ::close(sock);
         return Err(errno);
@@ -284,28 +327,28 @@ Result<TcpListener, int> TcpListener::bind(const SocketAddress& sa) noexcept {
 
 Result<std::tuple<TcpStream, SocketAddress>, int>
 TcpListener::accept() noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
-    const int conn = ::accept4(fd_, (struct sockaddr*)&addr, &addr_len,
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const int conn = ::accept4(fd_, addr.get(), &addr_len,
                                SOCK_NONBLOCK | SOCK_CLOEXEC);
     if (conn == -1) {
         return Err(errno);
     }
-    return internal::native_addr_to_socket_address(&addr, addr_len)
+    return addr.to_socket_address(addr_len)
         .map([conn](SocketAddress sa) {
             return std::make_tuple(TcpStream(conn), sa);
         });
 }
 
 Result<SocketAddress, int> TcpListener::local_addr() noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
-    const int ret = ::getsockname(fd_, (struct sockaddr*)&addr, &addr_len);
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const int ret = ::getsockname(fd_, addr.get(), &addr_len);
     if (ret == -1) {
         return Err(errno);
     }
 
-    return internal::native_addr_to_socket_address(&addr, addr_len);
+    return addr.to_socket_address(addr_len);
 }
 
 Result<int, int> TcpListener::take_error() noexcept {
@@ -10,6 +10,7 @@
 #include <netinet/tcp.h>
 
 #include <chrono>
+#include <cstdint>
 #include <tuple>
 #include <utility>
 
@@ -18,6 +19,7 @@
 #include "bipolar/core/result.hpp"
 #include "bipolar/core/void.hpp"
 #include "bipolar/net/socket_address.hpp"
+#include "bipolar/net/timestamping.hpp"
 
 namespace bipolar {
 /// TcpStream
@@ -157,6 +159,15 @@ public:
     Result<std::size_t, int> recvmsg(struct msghdr* msg,
                                      int flags = 0) noexcept;
 
+    /// Receives data from the peer, storing the kernel timestamps of the
+    /// last segment read in `stamps`.
+    /// On success, returns the number of bytes read.
+    ///
+    /// see `set_timestamping` for details
+    Result<std::size_t, int> recv_with_timestamps(void* buf, std::size_t len,
+                                                  Timestamps* stamps,
+                                                  int flags = 0) noexcept;
+
     /// Returns the socket address of the local half of this TCP connection
     Result<SocketAddress, int> local_addr() noexcept;
 
@@ -212,6 +223,24 @@ public:
     /// Gets the value of the `TCP_INFO` option on this socket.
     Result<struct tcp_info, int> get_tcp_info() noexcept;
 
+    /// Sets the value of the `SO_TIMESTAMPING` option on this socket.
+    ///
+    /// see `UdpSocket::set_timestamping` for details
+    ///
+    /// Besides, `SOF_TIMESTAMPING_TX_ACK` asks for the time the data is
+    /// acknowledged, and `SOF_TIMESTAMPING_OPT_ID` tells the bytes each TX
+    /// timestamp is for: the last byte of each `send`.
+    Result<Void, int> set_timestamping(std::uint32_t flags) noexcept;
+
+    /// Gets the value of the `SO_TIMESTAMPING` option on this socket.
+    Result<std::uint32_t, int> timestamping() noexcept;
+
+    /// Reads at most `n` TX timestamps from the error queue of this socket.
+    ///
+    /// see `UdpSocket::take_tx_timestamps` for details
+    Result<std::size_t, int> take_tx_timestamps(TxTimestamps* out,
+                                                std::size_t n) noexcept;
+
     /// Returns the underlying file descriptor.
     ///
     /// NOTE:
@@ -0,0 +1,103 @@
+#include "bipolar/net/compact_socket_address.hpp"
+
+#include <cstdint>
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+
+#include "bipolar/core/byteorder.hpp"
+
+using namespace bipolar;
+
+TEST(CompactSocketAddress, ipv4) {
+    const auto sa = SocketAddress::from_str("10.0.0.1:53").value();
+    const CompactSocketAddress addr(sa);
+    EXPECT_TRUE(addr.is_ipv4());
+    EXPECT_FALSE(addr.is_ipv6());
+    EXPECT_EQ(addr.port(), hton(static_cast<std::uint16_t>(53)));
+    EXPECT_EQ(addr.to_socket_address(), sa);
+    EXPECT_EQ(addr.str(), "10.0.0.1:53");
+
+    // stored IPv4-mapped
+    const std::uint8_t mapped[16] = {0, 0, 0, 0, 0, 0, 0, 0,
+                                     0, 0, 0xff, 0xff, 10, 0, 0, 1};
+    EXPECT_EQ(std::memcmp(addr.ipv6_bytes(), mapped, sizeof(mapped)), 0);
+
+    // but not equal to the IPv4-mapped IPv6 address
+    const CompactSocketAddress v6(
+        SocketAddress::from_str("[::ffff:10.0.0.1]:53").value());
+    EXPECT_TRUE(v6.is_ipv6());
+    EXPECT_EQ(std::memcmp(v6.ipv6_bytes(), mapped, sizeof(mapped)), 0);
+    EXPECT_NE(addr, v6);
+}
+
+TEST(CompactSocketAddress, ipv6) {
+    const auto sa = SocketAddress::from_str("[fe80::1:2]:8080").value();
+    const CompactSocketAddress addr(sa);
+    EXPECT_TRUE(addr.is_ipv6());
+    EXPECT_EQ(addr.to_socket_address(), sa);
+    EXPECT_EQ(addr.ip(), sa.addr());
+    EXPECT_EQ(addr.str(), "[fe80::1:2]:8080");
+}
+
+TEST(CompactSocketAddress, unspecified) {
+    const CompactSocketAddress addr;
+    EXPECT_EQ(addr.family(), AF_UNSPEC);
+    EXPECT_TRUE(addr.ip().is_empty());
+    EXPECT_EQ(addr, CompactSocketAddress(SocketAddress(IPAddress(), 0)));
+    EXPECT_EQ(addr.str(), "");
+}
+
+TEST(CompactSocketAddress, hash) {
+    std::unordered_set<CompactSocketAddress> addrs;
+    for (std::uint16_t port = 0; port < 256; ++port) {
+        addrs.insert(CompactSocketAddress(
+            SocketAddress(IPv4Address(10, 0, 0, 1), hton(port))));
+        addrs.insert(CompactSocketAddress(
+            SocketAddress(IPv4Address(10, 0, 0, port & 0xff), 0)));
+    }
+    EXPECT_EQ(addrs.size(), 511);
+    EXPECT_EQ(addrs.count(CompactSocketAddress(
+                  SocketAddress::from_str("10.0.0.1:255").value())),
+              1);
+    EXPECT_EQ(addrs.count(CompactSocketAddress(
+                  SocketAddress::from_str("10.0.1.1:255").value())),
+              0);
+}
+
+TEST(NativeSocketAddress, conversions) {
+    for (const char* str : {"127.0.0.1:8080", "[::1]:8080"}) {
+        const auto sa = SocketAddress::from_str(str).value();
+        const NativeSocketAddress native(sa);
+        EXPECT_EQ(native.family(), sa.addr().family());
+        EXPECT_EQ(native.size(), sa.addr().is_ipv4()
+                                     ? sizeof(struct sockaddr_in)
+                                     : sizeof(struct sockaddr_in6));
+
+        // the same bytes as `sockaddr_storage`
+        const auto storage = sa.to_sockaddr();
+        EXPECT_EQ(std::memcmp(native.get(), &storage, native.size()), 0);
+
+        EXPECT_EQ(native.to_socket_address(native.size()).value(), sa);
+        const CompactSocketAddress compact(sa);
+        EXPECT_EQ(CompactSocketAddress::from_native(native.get(),
+                                                    native.size())
+                      .value(),
+                  compact);
+
+        const NativeSocketAddress from_compact(compact);
+        EXPECT_EQ(std::memcmp(from_compact.get(), native.get(),
+                              native.size()),
+                  0);
+    }
+
+    const NativeSocketAddress empty;
+    EXPECT_TRUE(empty.to_socket_address(empty.size()).is_error());
+    EXPECT_TRUE(
+        CompactSocketAddress::from_native(empty.get(), empty.size())
+            .is_error());
+
+    // truncated
+    const NativeSocketAddress v6(SocketAddress::from_str("[::1]:1").value());
+    EXPECT_TRUE(v6.to_socket_address(sizeof(struct sockaddr_in)).is_error());
+}
@@ -1,7 +1,13 @@
 #include "bipolar/net/ip_address.hpp"
 
+#include <arpa/inet.h>
+
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
@@ -169,3 +175,131 @@ TEST(IPv6Address, to_ipv4) {
     EXPECT_TRUE(bool(addr3.to_ipv4()));
     EXPECT_EQ(addr3.to_ipv4().value().str(), "1.2.4.8");
 }
+
+// Empty octets are rejected without reading past the end of the string,
+// which is copied to a buffer of its exact size for ASan to check
+TEST(IPAddress, EmptyOctets) {
+    const std::string_view strs[] = {
+        "1.2.3.",         "1..2.3",         ".1.2.3",
+        "10.20.30.",      "10..20.30",      ".10.20.30",
+        "10.20.30.40.",   "10.20..30.40",   "::ffff:10.20.30.",
+        "::ffff:1..2.3",  "::ffff:10..20.30",
+    };
+
+    for (const auto str : strs) {
+        auto buf = std::make_unique<char[]>(str.size());
+        std::memcpy(buf.get(), str.data(), str.size());
+        const std::string_view sv(buf.get(), str.size());
+        EXPECT_TRUE(IPv4Address::from_str(sv).is_error()) << str;
+        EXPECT_TRUE(IPv6Address::from_str(sv).is_error()) << str;
+        EXPECT_TRUE(IPAddress::from_str(sv).is_error()) << str;
+    }
+}
+
+// The parsers and the formatters agree with `inet_pton` and `inet_ntop`
+TEST(IPAddress, SameAsInet) {
+    const char* strs[] = {
+        "0.0.0.0",       "255.255.255.255", "1.2.3.4",
+        "01.2.3.4",      "1.2.3.04",        "256.1.1.1",
+        "1.2.3.4.",      ".1.2.3.4",        "1..2.3",
+        "1.2.3.",        ".1.2.3",          "1..2.3.4",
+        "10.20.30.",     ".10.20.30",       "10..20.30",
+        "::ffff:1.2.3.", "::ffff:.1.2.3",   "::ffff:1..2.3",
+        "::ffff:10.20.30.", "::ffff:10..20.30",
+        "1.2.3",         "1.2.3.4.5",       "1.2.3.a",
+        "1.2.3.-4",      "1234.1.1.1",      "1.2.3.4 ",
+        "::",            "::1",             "1::",
+        ":::",           "1:::2",           "1::2::3",
+        ":1::2",         "1::2:",           "1:2:3:4:5:6:7:8",
+        "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7::", "::2:3:4:5:6:7:8",
+        "1:2:3:4::5:6:7:8", "12345::",      "fFfF::",
+        "::ffff:1.2.3.4", "::1.2.3.4",      "1:2:3:4:5:6:1.2.3.4",
+        "1:2:3:4:5:6:7:1.2.3.4", "::1.2.3",  "::1.2.3.4:1",
+        "::01.2.3.4",    "1::2:3.4.5.6",    "g::",
+        "ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255",
+    };
+
+    for (const char* str : strs) {
+        unsigned char expected[16];
+        const bool v4 = ::inet_pton(AF_INET, str, expected) == 1;
+        auto r4 = IPv4Address::from_str(str);
+        ASSERT_EQ(r4.is_ok(), v4) << str;
+        if (v4) {
+            const auto octets = r4.value().octets();
+            EXPECT_TRUE(std::equal(octets.begin(), octets.end(), expected))
+                << str;
+        }
+
+        const bool v6 = ::inet_pton(AF_INET6, str, expected) == 1;
+        auto r6 = IPv6Address::from_str(str);
+        ASSERT_EQ(r6.is_ok(), v6) << str;
+        if (v6) {
+            const auto octets = r6.value().octets();
+            EXPECT_TRUE(std::equal(octets.begin(), octets.end(), expected))
+                << str;
+        }
+    }
+
+    std::mt19937 gen(42);
+    for (int i = 0; i < 10000; ++i) {
+        // sparse words, for runs of zeros
+        std::uint8_t bytes[16] = {};
+        for (int j = 0; j < 16; j += 2) {
+            if (gen() % 3 == 0) {
+                bytes[j] = gen() % 2 ? gen() : 0;
+                bytes[j + 1] = gen();
+            }
+        }
+        if (i % 4 == 0) {
+            std::memset(bytes, 0, 10);
+            bytes[10] = bytes[11] = i % 8 == 0 ? 0xff : 0;
+        }
+
+        struct in6_addr native;
+        std::memcpy(&native, bytes, sizeof(native));
+        char expected[INET6_ADDRSTRLEN];
+        ::inet_ntop(AF_INET6, &native, expected, sizeof(expected));
+        EXPECT_EQ(IPv6Address(native).str(), expected);
+        EXPECT_EQ(IPv6Address::from_str(expected).value(),
+                  IPv6Address(native));
+
+        struct in_addr native4;
+        std::memcpy(&native4, bytes + 12, sizeof(native4));
+        ::inet_ntop(AF_INET, &native4, expected, sizeof(expected));
+        EXPECT_EQ(IPv4Address(native4).str(), expected);
+        EXPECT_EQ(IPv4Address::from_str(expected).value(),
+                  IPv4Address(native4));
+    }
+}
+
+TEST(IPAddress, from_str_not_null_terminated) {
+    const std::string_view sv = "10.0.0.1:8080";
+    EXPECT_EQ(IPv4Address::from_str(sv.substr(0, 8)).value(),
+              IPv4Address(10, 0, 0, 1));
+
+    const std::string_view sv6 = "[fe80::1]:8080";
+    EXPECT_EQ(IPAddress::from_str(sv6.substr(1, 7)).value(),
+              IPAddress(IPv6Address::from_str("fe80::1").value()));
+}
+
+TEST(IPAddress, to_chars) {
+    const auto v4 = IPv4Address(255, 255, 255, 255);
+    char buf[IPv6Address::kMaxStrLen];
+    auto [end, ec] = v4.to_chars(buf, buf + IPv4Address::kMaxStrLen);
+    EXPECT_EQ(ec, std::errc());
+    EXPECT_EQ(std::string_view(buf, end - buf), "255.255.255.255");
+
+    auto r = v4.to_chars(buf, buf + 14);
+    EXPECT_EQ(r.ec, std::errc::value_too_large);
+    EXPECT_EQ(r.ptr, buf + 14);
+
+    const IPAddress v6 =
+        IPv6Address::from_str("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")
+            .value();
+    auto r6 = v6.to_chars(buf, buf + sizeof(buf));
+    EXPECT_EQ(r6.ec, std::errc());
+    EXPECT_EQ(std::string_view(buf, r6.ptr - buf), v6.str());
+
+    const IPAddress empty;
+    EXPECT_EQ(empty.to_chars(buf, buf).ptr, buf);
+}
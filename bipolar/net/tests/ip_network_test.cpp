@@ -0,0 +1,97 @@
+#include "bipolar/net/ip_network.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+
+TEST(IPNetwork, ipv4) {
+    const IPNetwork net(IPv4Address(10, 1, 2, 3), 8);
+    EXPECT_TRUE(net.is_ipv4());
+    EXPECT_EQ(net.prefix_len(), 8);
+    EXPECT_EQ(net.addr(), IPAddress(IPv4Address(10, 0, 0, 0)));
+    EXPECT_EQ(net, IPNetwork(IPv4Address(10, 0, 0, 0), 8));
+    EXPECT_NE(net, IPNetwork(IPv4Address(10, 0, 0, 0), 9));
+
+    EXPECT_TRUE(net.contains(IPv4Address(10, 0, 0, 0)));
+    EXPECT_TRUE(net.contains(IPv4Address(10, 255, 255, 255)));
+    EXPECT_FALSE(net.contains(IPv4Address(11, 0, 0, 0)));
+    EXPECT_FALSE(net.contains(IPv6Address::from_str("::a00:0").value()));
+
+    const IPNetwork any(IPv4Address(1, 2, 3, 4), 0);
+    EXPECT_EQ(any.addr(), IPAddress(IPv4Address(0, 0, 0, 0)));
+    EXPECT_TRUE(any.contains(IPv4Address(255, 255, 255, 255)));
+
+    const IPNetwork host(IPv4Address(1, 2, 3, 4), 32);
+    EXPECT_TRUE(host.contains(IPv4Address(1, 2, 3, 4)));
+    EXPECT_FALSE(host.contains(IPv4Address(1, 2, 3, 5)));
+}
+
+TEST(IPNetwork, ipv6) {
+    const auto addr = IPv6Address::from_str("2001:db8:ffff::1").value();
+    const IPNetwork net(addr, 36);
+    EXPECT_TRUE(net.is_ipv6());
+    EXPECT_EQ(net.addr(),
+              IPAddress(IPv6Address::from_str("2001:db8:f000::").value()));
+    EXPECT_TRUE(net.contains(addr));
+    EXPECT_TRUE(
+        net.contains(IPv6Address::from_str("2001:db8:fabc::1").value()));
+    EXPECT_FALSE(
+        net.contains(IPv6Address::from_str("2001:db8:e000::").value()));
+    EXPECT_FALSE(net.contains(IPv4Address(32, 1, 13, 184)));
+
+    const IPNetwork host(addr, 128);
+    EXPECT_EQ(host.addr(), IPAddress(addr));
+    EXPECT_TRUE(host.contains(addr));
+    EXPECT_FALSE(
+        host.contains(IPv6Address::from_str("2001:db8:ffff::2").value()));
+}
+
+TEST(IPNetwork, from_str) {
+    const auto v4 = IPNetwork::from_str("192.168.1.7/24").value();
+    EXPECT_EQ(v4, IPNetwork(IPv4Address(192, 168, 1, 0), 24));
+    EXPECT_EQ(v4.str(), "192.168.1.0/24");
+
+    const auto v6 = IPNetwork::from_str("fe80::1/10").value();
+    EXPECT_EQ(v6.prefix_len(), 10);
+    EXPECT_EQ(v6.str(), "fe80::/10");
+    EXPECT_EQ(IPNetwork::from_str("::/0").value().str(), "::/0");
+    EXPECT_EQ(IPNetwork::from_str("::1/128").value().str(), "::1/128");
+
+    for (const char* s : {"10.0.0.0", "10.0.0/8", "/8", "::1:/64"}) {
+        EXPECT_EQ(IPNetwork::from_str(s).error(),
+                  IPAddressFormatError::INVALID_IP)
+            << s;
+    }
+    for (const char* s : {"10.0.0.0/", "10.0.0.0/33", "10.0.0.0/08",
+                          "10.0.0.0/+8", "10.0.0.0/8 ", "::/129",
+                          "::/0128"}) {
+        EXPECT_EQ(IPNetwork::from_str(s).error(),
+                  IPAddressFormatError::INVALID_PREFIX_LEN)
+            << s;
+    }
+}
+
+TEST(IPNetwork, to_chars) {
+    const auto net = IPNetwork::from_str("::ffff:255.255.255.255/128").value();
+    char buf[IPNetwork::kMaxStrLen];
+    auto [end, ec] = net.to_chars(buf, buf + sizeof(buf));
+    EXPECT_EQ(ec, std::errc());
+    EXPECT_EQ(std::string(buf, end), "::ffff:255.255.255.255/128");
+
+    const auto v4 = IPNetwork::from_str("10.0.0.0/8").value();
+    EXPECT_EQ(v4.to_chars(buf, buf + 7).ec, std::errc::value_too_large);
+    EXPECT_EQ(v4.to_chars(buf, buf + 8).ec, std::errc::value_too_large);
+    EXPECT_EQ(v4.to_chars(buf, buf + 9).ec, std::errc::value_too_large);
+    EXPECT_EQ(v4.to_chars(buf, buf + 10).ptr, buf + 10);
+
+    EXPECT_EQ(IPNetwork().str(), "");
+}
+
+TEST(IPNetwork, order) {
+    const auto a = IPNetwork::from_str("10.0.0.0/8").value();
+    const auto b = IPNetwork::from_str("10.0.0.0/16").value();
+    const auto c = IPNetwork::from_str("11.0.0.0/8").value();
+    EXPECT_LT(a, b);
+    EXPECT_LT(b, c);
+    EXPECT_LT(a, IPNetwork::from_str("::/0").value());
+}
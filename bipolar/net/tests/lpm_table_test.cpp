@@ -0,0 +1,236 @@
+#include "bipolar/net/lpm_table.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bipolar/core/byteorder.hpp"
+
+using namespace bipolar;
+
+namespace {
+// The longest prefix match by a linear scan
+Option<std::uint32_t>
+linear_lookup(const std::vector<std::pair<IPNetwork, std::uint32_t>>& rules,
+              const IPAddress& addr) {
+    int best_len = -1;
+    std::uint32_t best = 0;
+    for (const auto& [net, value] : rules) {
+        if (net.contains(addr) && net.prefix_len() > best_len) {
+            best_len = net.prefix_len();
+            best = value;
+        }
+    }
+    if (best_len < 0) {
+        return None;
+    }
+    return Some(std::uint32_t(best));
+}
+
+IPv4Address random_ipv4(std::mt19937& rng) {
+    return IPv4Address(static_cast<std::uint32_t>(rng()));
+}
+
+// Addresses under a few /16s, so that random prefixes overlap
+IPv6Address random_ipv6(std::mt19937& rng) {
+    auto group = [&](std::uint32_t n) {
+        return static_cast<std::uint16_t>(rng() % n);
+    };
+    return IPv6Address(static_cast<std::uint16_t>(0x2001), group(4), group(4),
+                       group(65536), group(65536), group(65536), group(65536),
+                       group(65536));
+}
+
+} // namespace
+
+TEST(LpmTable, empty) {
+    LpmTable table;
+    auto snapshot = table.snapshot();
+    EXPECT_EQ(snapshot->size(), 0);
+    EXPECT_FALSE(snapshot->lookup(IPv4Address(1, 2, 3, 4)).has_value());
+    EXPECT_FALSE(snapshot->lookup(IPv6Address()).has_value());
+    EXPECT_FALSE(snapshot->lookup(IPAddress()).has_value());
+
+    IPv4Address addrs[3] = {};
+    std::uint32_t values[3] = {};
+    snapshot->lookup(addrs, 3, values);
+    for (auto v : values) {
+        EXPECT_EQ(v, LpmSnapshot::kNoMatch);
+    }
+}
+
+TEST(LpmTable, longest_prefix) {
+    LpmTable table;
+    EXPECT_TRUE(table.insert(IPNetwork::from_str("0.0.0.0/0").value(), 0));
+    EXPECT_TRUE(table.insert(IPNetwork::from_str("10.0.0.0/8").value(), 1));
+    EXPECT_TRUE(table.insert(IPNetwork::from_str("10.1.0.0/16").value(), 2));
+    EXPECT_TRUE(table.insert(IPNetwork::from_str("10.1.2.0/25").value(), 3));
+    EXPECT_TRUE(table.insert(IPNetwork::from_str("10.1.2.3/32").value(), 4));
+    EXPECT_TRUE(table.insert(IPNetwork::from_str("2001:db8::/32").value(), 5));
+    EXPECT_TRUE(
+        table.insert(IPNetwork::from_str("2001:db8:1::/48").value(), 6));
+    EXPECT_TRUE(
+        table.insert(IPNetwork::from_str("2001:db8::1/128").value(), 7));
+    EXPECT_FALSE(table.insert(IPNetwork::from_str("10.0.0.0/8").value(), 8));
+    EXPECT_EQ(table.size(), 8);
+
+    // staged until committed
+    EXPECT_FALSE(
+        table.snapshot()->lookup(IPv4Address(10, 0, 0, 0)).has_value());
+    table.commit();
+    auto snapshot = table.snapshot();
+    EXPECT_EQ(snapshot->size(), 8);
+
+    auto lookup = [&](const char* s) {
+        return snapshot->lookup(IPAddress::from_str(s).value());
+    };
+    EXPECT_EQ(lookup("192.168.0.1").value(), 0);
+    EXPECT_EQ(lookup("10.0.0.1").value(), 8);
+    EXPECT_EQ(lookup("10.1.255.255").value(), 2);
+    EXPECT_EQ(lookup("10.1.2.0").value(), 3);
+    EXPECT_EQ(lookup("10.1.2.3").value(), 4);
+    EXPECT_EQ(lookup("10.1.2.4").value(), 3);
+    EXPECT_EQ(lookup("10.1.2.128").value(), 2);
+    EXPECT_EQ(lookup("2001:db8::2").value(), 5);
+    EXPECT_EQ(lookup("2001:db8::1").value(), 7);
+    EXPECT_EQ(lookup("2001:db8:1:2::").value(), 6);
+    EXPECT_FALSE(lookup("2001:db9::").has_value());
+    EXPECT_FALSE(lookup("::").has_value());
+
+    // the old snapshot is kept by its readers
+    EXPECT_TRUE(table.erase(IPNetwork::from_str("10.1.2.3/32").value()));
+    EXPECT_FALSE(table.erase(IPNetwork::from_str("10.1.2.3/32").value()));
+    table.commit();
+    EXPECT_EQ(lookup("10.1.2.3").value(), 4);
+    EXPECT_EQ(
+        table.snapshot()->lookup(IPv4Address(10, 1, 2, 3)).value(), 3);
+
+    table.clear();
+    table.commit();
+    EXPECT_FALSE(
+        table.snapshot()->lookup(IPv4Address(10, 1, 2, 3)).has_value());
+}
+
+TEST(LpmTable, random_ipv4) {
+    std::mt19937 rng(42);
+    std::vector<std::pair<IPNetwork, std::uint32_t>> rules;
+    LpmTable table;
+    for (std::uint32_t i = 0; i < 2000; ++i) {
+        // mostly long prefixes under a few /8s
+        const auto addr = IPv4Address(hton(
+            static_cast<std::uint32_t>(rng() % 4 + 10) << 24 |
+            static_cast<std::uint32_t>(rng() % (1 << 24))));
+        const auto len = i % 8 == 0 ? rng() % 33 : rng() % 17 + 16;
+        const IPNetwork net(addr, static_cast<std::uint8_t>(len));
+        if (table.insert(net, i)) {
+            rules.emplace_back(net, i);
+        } else {
+            for (auto& rule : rules) {
+                if (rule.first == net) {
+                    rule.second = i;
+                }
+            }
+        }
+    }
+    table.commit();
+    auto snapshot = table.snapshot();
+    EXPECT_EQ(snapshot->size(), rules.size());
+
+    // addresses of the prefixes and random ones
+    std::vector<IPv4Address> addrs;
+    for (const auto& rule : rules) {
+        const auto base = ntoh(rule.first.addr().as_ipv4().to_long());
+        addrs.emplace_back(hton(base));
+        addrs.emplace_back(hton(base | (rng() & 0xff)));
+        addrs.emplace_back(hton(base + 0x100));
+        addrs.push_back(random_ipv4(rng));
+    }
+
+    std::vector<std::uint32_t> values(addrs.size());
+    snapshot->lookup(addrs.data(), addrs.size(), values.data());
+    for (std::size_t i = 0; i < addrs.size(); ++i) {
+        const auto expected = linear_lookup(rules, addrs[i]);
+        EXPECT_EQ(snapshot->lookup(addrs[i]), expected) << addrs[i].str();
+        EXPECT_EQ(values[i], expected.has_value() ? expected.value()
+                                                  : LpmSnapshot::kNoMatch)
+            << addrs[i].str();
+    }
+}
+
+TEST(LpmTable, random_ipv6) {
+    std::mt19937 rng(42);
+    std::vector<std::pair<IPNetwork, std::uint32_t>> rules;
+    LpmTable table;
+    for (std::uint32_t i = 0; i < 2000; ++i) {
+        const auto len = i % 8 == 0 ? rng() % 129 : rng() % 48 + 16;
+        const IPNetwork net(random_ipv6(rng), static_cast<std::uint8_t>(len));
+        if (table.insert(net, i)) {
+            rules.emplace_back(net, i);
+        } else {
+            for (auto& rule : rules) {
+                if (rule.first == net) {
+                    rule.second = i;
+                }
+            }
+        }
+    }
+    table.commit();
+    auto snapshot = table.snapshot();
+
+    std::vector<IPv6Address> addrs;
+    for (const auto& rule : rules) {
+        auto native = rule.first.addr().as_ipv6().native();
+        addrs.emplace_back(native);
+        native.s6_addr[15] ^= static_cast<std::uint8_t>(rng());
+        native.s6_addr[rng() % 16] ^= static_cast<std::uint8_t>(rng());
+        addrs.emplace_back(native);
+        addrs.push_back(random_ipv6(rng));
+    }
+
+    std::vector<std::uint32_t> values(addrs.size());
+    snapshot->lookup(addrs.data(), addrs.size(), values.data());
+    for (std::size_t i = 0; i < addrs.size(); ++i) {
+        const auto expected = linear_lookup(rules, addrs[i]);
+        EXPECT_EQ(snapshot->lookup(addrs[i]), expected) << addrs[i].str();
+        EXPECT_EQ(values[i], expected.has_value() ? expected.value()
+                                                  : LpmSnapshot::kNoMatch)
+            << addrs[i].str();
+    }
+}
+
+TEST(LpmTable, concurrent_commit) {
+    const auto net = IPNetwork::from_str("2001:db8::/32").value();
+    const auto addr = IPv6Address::from_str("2001:db8::1").value();
+    LpmTable table;
+    table.insert(net, 0);
+    table.commit();
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            std::uint32_t last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                // a snapshot never goes back in time
+                const auto value = table.snapshot()->lookup(addr).value();
+                EXPECT_GE(value, last);
+                last = value;
+            }
+        });
+    }
+
+    for (std::uint32_t i = 1; i <= 100; ++i) {
+        table.insert(net, i);
+        table.commit();
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(table.snapshot()->lookup(addr).value(), 100);
+}
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
@@ -70,3 +71,31 @@ TEST(SocketAddress, str) {
     SocketAddress sa(IPAddress{}, 0);
     EXPECT_EQ(sa.str(), "");
 }
+
+TEST(SocketAddress, to_chars) {
+    char buf[SocketAddress::kMaxStrLen];
+    const auto v6 = SocketAddress::from_str(
+                        "[ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255]:65535")
+                        .value();
+    auto [end, ec] = v6.to_chars(buf, buf + sizeof(buf));
+    EXPECT_EQ(ec, std::errc());
+    EXPECT_EQ(std::string_view(buf, end - buf),
+              "[ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff]:65535");
+    EXPECT_EQ(v6.str(), std::string_view(buf, end - buf));
+
+    const SocketAddress v4(IPAddress(IPv4Address(127, 0, 0, 1)),
+                           hton(static_cast<std::uint16_t>(80)));
+    auto r = v4.to_chars(buf, buf + 11);
+    EXPECT_EQ(r.ec, std::errc::value_too_large);
+    r = v4.to_chars(buf, buf + 12);
+    EXPECT_EQ(r.ec, std::errc());
+    EXPECT_EQ(std::string_view(buf, r.ptr - buf), "127.0.0.1:80");
+
+    // the address isn't copied to a null-terminated buffer
+    const std::string_view sv = "[::1]:8086 trailing";
+    const auto addr = SocketAddress::from_str(sv.substr(0, 10)).value();
+    EXPECT_EQ(addr.str(), "[::1]:8086");
+
+    const std::string long_addr(100, '1');
+    EXPECT_FALSE(SocketAddress::from_str(long_addr + ":80").is_ok());
+}
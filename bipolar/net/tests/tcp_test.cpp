@@ -547,3 +547,84 @@ TEST(TcpStream, send) {
     char buf[1024];
     strm.send(buf, sizeof(buf));
 }
+
+TEST(TcpStream, timestamping) {
+    auto listener =
+        TcpListener::bind(anonymous_addr).expect("bind to 127.0.0.1:0 failed");
+    auto client = TcpStream::connect(listener.local_addr().value()).value();
+
+    Option<TcpStream> accepted = None;
+    while (!accepted.has_value()) {
+        auto ret = listener.accept();
+        if (ret.is_ok()) {
+            accepted = Some(std::move(std::get<0>(ret.take_value())));
+        } else {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    auto& server = accepted.value();
+
+    EXPECT_TRUE(server
+                    .set_timestamping(SOF_TIMESTAMPING_RX_SOFTWARE |
+                                      SOF_TIMESTAMPING_SOFTWARE)
+                    .is_ok());
+
+    // The kernel turns RX timestamping on asynchronously, so the segments
+    // received right after may have no timestamp
+    char buf[100] = {};
+    auto before = std::chrono::system_clock::now().time_since_epoch();
+    Timestamps stamps;
+    for (int round = 0; round < 100 && !stamps.software.has_value();
+         ++round) {
+        before = std::chrono::system_clock::now().time_since_epoch();
+        EXPECT_EQ(client.send(buf, sizeof(buf)).value(), sizeof(buf));
+
+        std::size_t received = 0;
+        while (received < sizeof(buf)) {
+            auto ret = server.recv_with_timestamps(buf, sizeof(buf), &stamps);
+            if (ret.is_ok()) {
+                received += ret.value();
+            } else {
+                EXPECT_EQ(ret.error(), EAGAIN);
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+    }
+    ASSERT_TRUE(stamps.software.has_value());
+    EXPECT_LE(before, stamps.software.value());
+    EXPECT_LE(stamps.software.value(),
+              std::chrono::system_clock::now().time_since_epoch());
+
+    // the ids count the bytes sent since the option is set
+    const std::uint32_t tx_flags =
+        SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_ACK |
+        SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID |
+        SOF_TIMESTAMPING_OPT_TSONLY;
+    EXPECT_TRUE(client.set_timestamping(tx_flags).is_ok());
+    EXPECT_EQ(client.timestamping().value(), tx_flags);
+
+    before = std::chrono::system_clock::now().time_since_epoch();
+    EXPECT_EQ(client.send(buf, sizeof(buf)).value(), sizeof(buf));
+
+    // sent and acknowledged, both for the last byte
+    TxTimestamps tx[4];
+    std::size_t n = 0;
+    for (int retry = 0; n < 2 && retry < 100; ++retry) {
+        auto ret = client.take_tx_timestamps(tx + n, 4 - n);
+        if (ret.is_ok()) {
+            n += ret.value();
+        } else {
+            EXPECT_EQ(ret.error(), EAGAIN);
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    ASSERT_EQ(n, 2);
+    EXPECT_EQ(tx[0].kind, SCM_TSTAMP_SND);
+    EXPECT_EQ(tx[1].kind, SCM_TSTAMP_ACK);
+    for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(tx[i].id, sizeof(buf) - 1);
+        ASSERT_TRUE(tx[i].stamps.software.has_value());
+        EXPECT_LE(before, tx[i].stamps.software.value());
+    }
+    EXPECT_LE(tx[0].stamps.software.value(), tx[1].stamps.software.value());
+}
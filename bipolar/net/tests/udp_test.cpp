@@ -1,6 +1,11 @@
 #include "bipolar/net/udp.hpp"
 
+#include <sys/socket.h>
+
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -175,6 +180,25 @@ TEST(UdpSocket, sendto_and_recvfrom) {
     });
 }
 
+TEST(UdpSocket, sendto_and_recvfrom_compact) {
+    const char send_buf[] = "buzz";
+    char recv_buf[10] = "";
+
+    connected_test_v6([&](UdpSocket& sender, UdpSocket& receiver) {
+        const CompactSocketAddress to(receiver.local_addr().value());
+        const auto send_result = sender.sendto(send_buf, 4, to);
+        EXPECT_TRUE(send_result.is_ok());
+        EXPECT_EQ(send_result.value(), 4);
+
+        CompactSocketAddress from;
+        const auto recv_result = receiver.recvfrom(recv_buf, 10, &from);
+        EXPECT_TRUE(recv_result.is_ok());
+        EXPECT_EQ(recv_result.value(), 4);
+        EXPECT_EQ(recv_buf, "buzz"s);
+        EXPECT_EQ(from, CompactSocketAddress(sender.local_addr().value()));
+    });
+}
+
 TEST(UdpSocket, writev_and_readv) {
     connected_test([](UdpSocket& sender, UdpSocket& receiver) {
         char send_buf[] = "bizz";
@@ -320,3 +344,102 @@ TEST(UdpSocket, take_error) {
         EXPECT_EQ(err.value(), 0);
     });
 }
+
+TEST(UdpSocket, timestamping) {
+    connected_test([](UdpSocket& sender, UdpSocket& receiver) {
+        const std::uint32_t rx_flags =
+            SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        const std::uint32_t tx_flags =
+            SOF_TIMESTAMPING_TX_SCHED | SOF_TIMESTAMPING_TX_SOFTWARE |
+            SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID |
+            SOF_TIMESTAMPING_OPT_TSONLY;
+        EXPECT_TRUE(receiver.set_timestamping(rx_flags).is_ok());
+        EXPECT_EQ(receiver.timestamping().value(), rx_flags);
+
+        // The kernel turns RX timestamping on asynchronously, so the
+        // datagrams received right after may have no timestamp
+        bool stamped = false;
+        for (int round = 0; round < 100 && !stamped; ++round) {
+            EXPECT_EQ(sender.send("warm", 4).value(), 4);
+            alignas(struct cmsghdr) char control[Timestamps::kControlLen];
+            char buf[8];
+            struct iovec iov = {.iov_base = buf, .iov_len = sizeof(buf)};
+            struct msghdr msg = {};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            EXPECT_EQ(receiver.recvmsg(&msg).value(), 4);
+            stamped = Timestamps::from_msghdr(msg).software.has_value();
+        }
+        ASSERT_TRUE(stamped);
+
+        // the ids count the datagrams sent since the option is set
+        EXPECT_TRUE(sender.set_timestamping(tx_flags).is_ok());
+        EXPECT_EQ(sender.timestamping().value(), tx_flags);
+
+        // nothing sent yet
+        TxTimestamps tx[8];
+        EXPECT_EQ(sender.take_tx_timestamps(tx, 8).error(), EAGAIN);
+
+        const auto before = std::chrono::system_clock::now().time_since_epoch();
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_EQ(sender.send("buzz", 4).value(), 4);
+        }
+
+        constexpr std::size_t kMsgs = 4;
+        char bufs[kMsgs][8];
+        struct iovec iovs[kMsgs];
+        alignas(struct cmsghdr) char controls[kMsgs][Timestamps::kControlLen];
+        struct mmsghdr msgvec[kMsgs] = {};
+        for (std::size_t i = 0; i < kMsgs; ++i) {
+            iovs[i].iov_base = bufs[i];
+            iovs[i].iov_len = sizeof(bufs[i]);
+            msgvec[i].msg_hdr.msg_iov = &iovs[i];
+            msgvec[i].msg_hdr.msg_iovlen = 1;
+            msgvec[i].msg_hdr.msg_control = controls[i];
+            msgvec[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+        }
+
+        Timestamps stamps[kMsgs];
+        EXPECT_EQ(receiver.recvmmsg(msgvec, kMsgs, stamps).value(), 3);
+        const auto after = std::chrono::system_clock::now().time_since_epoch();
+        for (std::size_t i = 0; i < 3; ++i) {
+            EXPECT_EQ(msgvec[i].msg_len, 4);
+            ASSERT_TRUE(stamps[i].software.has_value());
+            EXPECT_FALSE(stamps[i].hardware.has_value());
+            EXPECT_LE(before, stamps[i].software.value());
+            EXPECT_LE(stamps[i].software.value(), after);
+        }
+        EXPECT_LE(stamps[0].software.value(), stamps[2].software.value());
+
+        // a scheduled and a sent timestamp for each datagram
+        std::size_t n = 0;
+        for (int retry = 0; n < 6 && retry < 100; ++retry) {
+            auto ret = sender.take_tx_timestamps(tx + n, 8 - n);
+            if (ret.is_ok()) {
+                n += ret.value();
+            } else {
+                EXPECT_EQ(ret.error(), EAGAIN);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        ASSERT_EQ(n, 6);
+
+        std::uint32_t sched = 0;
+        std::uint32_t snd = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            EXPECT_LT(tx[i].id, 3);
+            ASSERT_TRUE(tx[i].stamps.software.has_value());
+            EXPECT_LE(before, tx[i].stamps.software.value());
+            EXPECT_LE(tx[i].stamps.software.value(), after);
+            if (tx[i].kind == SCM_TSTAMP_SCHED) {
+                sched |= 1 << tx[i].id;
+            } else if (tx[i].kind == SCM_TSTAMP_SND) {
+                snd |= 1 << tx[i].id;
+            }
+        }
+        EXPECT_EQ(sched, 0b111);
+        EXPECT_EQ(snd, 0b111);
+    });
+}
@@ -0,0 +1,299 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "bipolar/net/socket_ancillary.hpp"
+#include "bipolar/net/tcp.hpp"
+#include "bipolar/net/unix.hpp"
+#include "bipolar/net/unix_socket_address.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace bipolar;
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+// abstract names are unique per process, so that tests may run in parallel
+static UnixSocketAddress unique_abstract(std::string_view tag) {
+    const auto name = "bipolar." + std::string(tag) + "." +
+                      std::to_string(::getpid());
+    return UnixSocketAddress::from_abstract(name).value();
+}
+
+TEST(UnixSocketAddress, pathname) {
+    auto addr = UnixSocketAddress::from_pathname("/run/app.sock").value();
+    EXPECT_FALSE(addr.is_unnamed());
+    EXPECT_FALSE(addr.is_abstract());
+    EXPECT_EQ(addr.as_pathname().value(), "/run/app.sock"sv);
+    EXPECT_FALSE(addr.as_abstract().has_value());
+    EXPECT_EQ(addr.str(), "/run/app.sock");
+    EXPECT_EQ(addr.get()->sa_family, AF_UNIX);
+
+    EXPECT_EQ(UnixSocketAddress::from_pathname("").error(), EINVAL);
+    EXPECT_EQ(UnixSocketAddress::from_pathname("a\0b"sv).error(), EINVAL);
+    EXPECT_EQ(UnixSocketAddress::from_pathname(std::string(108, 'a')).error(),
+              ENAMETOOLONG);
+    EXPECT_FALSE(
+        UnixSocketAddress::from_pathname(std::string(107, 'a')).is_error());
+}
+
+TEST(UnixSocketAddress, abstract) {
+    auto addr = UnixSocketAddress::from_abstract("app\0x"sv).value();
+    EXPECT_FALSE(addr.is_unnamed());
+    EXPECT_TRUE(addr.is_abstract());
+    EXPECT_EQ(addr.as_abstract().value(), "app\0x"sv);
+    EXPECT_FALSE(addr.as_pathname().has_value());
+    EXPECT_EQ(addr.str(), "@app\0x"s);
+
+    EXPECT_EQ(UnixSocketAddress::from_abstract(std::string(108, 'a')).error(),
+              ENAMETOOLONG);
+    EXPECT_FALSE(
+        UnixSocketAddress::from_abstract(std::string(107, 'a')).is_error());
+    EXPECT_TRUE(UnixSocketAddress::from_abstract("").value().is_abstract());
+}
+
+TEST(UnixSocketAddress, unnamed) {
+    UnixSocketAddress addr;
+    EXPECT_TRUE(addr.is_unnamed());
+    EXPECT_FALSE(addr.is_abstract());
+    EXPECT_FALSE(addr.as_pathname().has_value());
+    EXPECT_FALSE(addr.as_abstract().has_value());
+    EXPECT_EQ(addr.str(), "(unnamed)");
+}
+
+TEST(UnixSocketAddress, comparison) {
+    auto path = UnixSocketAddress::from_pathname("app").value();
+    auto name = UnixSocketAddress::from_abstract("app").value();
+    EXPECT_EQ(path, UnixSocketAddress::from_pathname("app").value());
+    EXPECT_EQ(name, UnixSocketAddress::from_abstract("app").value());
+    EXPECT_NE(path, name);
+    EXPECT_NE(path, UnixSocketAddress());
+    EXPECT_NE(name, UnixSocketAddress());
+    EXPECT_EQ(UnixSocketAddress(), UnixSocketAddress());
+
+    const struct sockaddr sa = {.sa_family = AF_INET, .sa_data = {}};
+    EXPECT_EQ(UnixSocketAddress::from_native(&sa, sizeof(sa)).error(), EINVAL);
+}
+
+TEST(UnixStream, pair) {
+    auto [a, b] = UnixStream::pair().expect("socketpair failed");
+    EXPECT_TRUE(a.local_addr().value().is_unnamed());
+    EXPECT_TRUE(a.peer_addr().value().is_unnamed());
+
+    EXPECT_EQ(a.write("ping", 4).value(), 4);
+    char buf[8];
+    EXPECT_EQ(b.read(buf, sizeof(buf)).value(), 4);
+    EXPECT_EQ(std::string_view(buf, 4), "ping");
+
+    // nonblocking
+    EXPECT_EQ(b.read(buf, sizeof(buf)).error(), EAGAIN);
+
+    auto cred = a.peer_cred().value();
+    EXPECT_EQ(cred.pid, ::getpid());
+    EXPECT_EQ(cred.uid, ::getuid());
+    EXPECT_EQ(cred.gid, ::getgid());
+
+    EXPECT_FALSE(a.shutdown(SHUT_WR).is_error());
+    EXPECT_EQ(b.read(buf, sizeof(buf)).value(), 0);
+    EXPECT_EQ(b.take_error().value(), 0);
+}
+
+TEST(UnixListener, bind_and_accept) {
+    const auto addr = unique_abstract("listener");
+    auto listener = UnixListener::bind(addr).expect("bind failed");
+    EXPECT_EQ(listener.local_addr().value(), addr);
+
+    // no connections
+    EXPECT_EQ(listener.accept().error(), EAGAIN);
+
+    // the name is taken as long as the listener is alive
+    EXPECT_EQ(UnixListener::bind(addr).error(), EADDRINUSE);
+
+    auto client = UnixStream::connect(addr).expect("connect failed");
+    auto [server, peer] = listener.accept().expect("accept failed");
+    EXPECT_TRUE(peer.is_unnamed());
+    EXPECT_EQ(client.peer_addr().value(), addr);
+    EXPECT_EQ(server.local_addr().value(), addr);
+
+    EXPECT_EQ(client.write("hello", 5).value(), 5);
+    char buf[8];
+    EXPECT_EQ(server.read(buf, sizeof(buf)).value(), 5);
+    EXPECT_EQ(std::string_view(buf, 5), "hello");
+
+    EXPECT_EQ(listener.take_error().value(), 0);
+
+    // the abstract name vanishes with the listener
+    EXPECT_FALSE(listener.close().is_error());
+    EXPECT_EQ(UnixStream::connect(addr).error(), ECONNREFUSED);
+    EXPECT_FALSE(UnixListener::bind(addr).is_error());
+}
+
+TEST(UnixListener, pathname) {
+    const auto path = "/tmp/bipolar.unix_test." + std::to_string(::getpid());
+    const auto addr = UnixSocketAddress::from_pathname(path).value();
+    ::unlink(path.c_str());
+
+    {
+        auto listener = UnixListener::bind(addr).expect("bind failed");
+        EXPECT_EQ(listener.local_addr().value(), addr);
+        auto client = UnixStream::connect(addr).expect("connect failed");
+        auto [server, peer] = listener.accept().expect("accept failed");
+        EXPECT_EQ(client.peer_addr().value().as_pathname().value(), path);
+    }
+
+    // the file is left in place
+    EXPECT_EQ(UnixListener::bind(addr).error(), EADDRINUSE);
+    EXPECT_EQ(::unlink(path.c_str()), 0);
+}
+
+TEST(UnixDatagram, sendto_and_recvfrom) {
+    const auto addr = unique_abstract("datagram");
+    auto server = UnixDatagram::bind(addr).expect("bind failed");
+    auto client = UnixDatagram::unbound().expect("socket failed");
+
+    EXPECT_EQ(client.sendto("ping", 4, addr).value(), 4);
+    char buf[8];
+    auto [n, from] = server.recvfrom(buf, sizeof(buf)).value();
+    EXPECT_EQ(n, 4);
+    EXPECT_EQ(std::string_view(buf, n), "ping");
+    EXPECT_TRUE(from.is_unnamed());
+
+    // no more datagrams
+    EXPECT_EQ(server.recvfrom(buf, sizeof(buf)).error(), EAGAIN);
+
+    // datagrams are truncated
+    EXPECT_FALSE(client.connect(addr).is_error());
+    EXPECT_EQ(client.peer_addr().value(), addr);
+    EXPECT_EQ(client.send("too long", 8).value(), 8);
+    EXPECT_EQ(server.recv(buf, 3).value(), 3);
+    EXPECT_EQ(server.recv(buf, sizeof(buf)).error(), EAGAIN);
+    EXPECT_EQ(server.take_error().value(), 0);
+}
+
+TEST(UnixDatagram, pair) {
+    auto [a, b] = UnixDatagram::pair().expect("socketpair failed");
+    EXPECT_EQ(a.send("one", 3).value(), 3);
+    EXPECT_EQ(a.send("two", 3).value(), 3);
+
+    char buf[8];
+    EXPECT_EQ(b.recv(buf, sizeof(buf)).value(), 3);
+    EXPECT_EQ(std::string_view(buf, 3), "one");
+    EXPECT_EQ(b.recv(buf, sizeof(buf)).value(), 3);
+    EXPECT_EQ(std::string_view(buf, 3), "two");
+}
+
+TEST(SocketAncillary, add_and_clear) {
+    SocketAncillary ancillary;
+    EXPECT_TRUE(ancillary.empty());
+    EXPECT_EQ(ancillary.fds_count(), 0);
+    EXPECT_FALSE(ancillary.creds().has_value());
+
+    const int fds[] = {0, 1, 2};
+    EXPECT_TRUE(ancillary.add_fds(fds, 3));
+    EXPECT_TRUE(ancillary.add_creds(UnixCredentials{1, 2, 3}));
+    EXPECT_FALSE(ancillary.empty());
+    EXPECT_EQ(ancillary.fds_count(), 3);
+    EXPECT_EQ(ancillary.creds().value().gid, 3);
+
+    int out[2];
+    EXPECT_EQ(ancillary.fds(out, 2), 2);
+    EXPECT_EQ(out[1], 1);
+
+    // too many file descriptors for a message
+    int many[SocketAncillary::kMaxFds + 1] = {};
+    EXPECT_FALSE(ancillary.add_fds(many, SocketAncillary::kMaxFds + 1));
+    EXPECT_FALSE(ancillary.add_fds(many, SocketAncillary::kMaxFds));
+
+    ancillary.clear();
+    EXPECT_TRUE(ancillary.empty());
+    EXPECT_TRUE(ancillary.add_fds(many, SocketAncillary::kMaxFds));
+    EXPECT_EQ(ancillary.fds_count(), SocketAncillary::kMaxFds);
+}
+
+TEST(SocketAncillary, listener_handoff) {
+    auto listener =
+        TcpListener::bind(SocketAddress(IPv4Address(127, 0, 0, 1), 0))
+            .expect("bind to 127.0.0.1:0 failed");
+    const auto server_addr = listener.local_addr().value();
+    auto [old_process, new_process] = UnixStream::pair().value();
+
+    // the old process hands the listener over, and closes its copy
+    {
+        SocketAncillary ancillary;
+        const int fd = listener.as_fd();
+        EXPECT_TRUE(ancillary.add_fds(&fd, 1));
+        EXPECT_EQ(old_process.send_with_ancillary("L", 1, ancillary).value(),
+                  1);
+        EXPECT_FALSE(listener.close().is_error());
+    }
+
+    // a connection arriving in the meantime isn't lost
+    auto client = TcpStream::connect(server_addr).expect("connect failed");
+
+    SocketAncillary ancillary;
+    char tag = 0;
+    EXPECT_EQ(new_process.recv_with_ancillary(&tag, 1, ancillary).value(), 1);
+    EXPECT_EQ(tag, 'L');
+    EXPECT_FALSE(ancillary.truncated());
+    ASSERT_EQ(ancillary.fds_count(), 1);
+
+    int fd = -1;
+    ASSERT_EQ(ancillary.fds(&fd, 1), 1);
+    EXPECT_TRUE(::fcntl(fd, F_GETFD) & FD_CLOEXEC);
+
+    TcpListener taken_over(fd);
+    EXPECT_EQ(taken_over.local_addr().value(), server_addr);
+    auto [conn, peer] = taken_over.accept().expect("accept failed");
+    EXPECT_EQ(peer, client.local_addr().value());
+}
+
+TEST(SocketAncillary, truncated) {
+    auto [a, b] = UnixDatagram::pair().value();
+    auto [c, d] = UnixStream::pair().value();
+
+    SocketAncillary ancillary;
+    const int fds[] = {c.as_fd(), d.as_fd()};
+    EXPECT_TRUE(ancillary.add_fds(fds, 2));
+    EXPECT_EQ(a.send_with_ancillary("x", 1, ancillary).value(), 1);
+
+    // no room for the control messages
+    char buf;
+    struct iovec iov = {.iov_base = &buf, .iov_len = 1};
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    EXPECT_EQ(b.recvmsg(&msg).value(), 1);
+    EXPECT_TRUE(msg.msg_flags & MSG_CTRUNC);
+}
+
+TEST(SocketAncillary, credentials) {
+    auto [a, b] = UnixDatagram::pair().value();
+    EXPECT_FALSE(b.set_passcred(true).is_error());
+
+    // sent implicitly
+    SocketAncillary ancillary;
+    EXPECT_EQ(a.send("x", 1).value(), 1);
+    char buf;
+    EXPECT_EQ(b.recv_with_ancillary(&buf, 1, ancillary).value(), 1);
+    auto creds = ancillary.creds().value();
+    EXPECT_EQ(creds.pid, ::getpid());
+    EXPECT_EQ(creds.uid, ::getuid());
+    EXPECT_EQ(creds.gid, ::getgid());
+    EXPECT_EQ(ancillary.fds_count(), 0);
+
+    // and explicitly
+    ancillary.clear();
+    EXPECT_TRUE(ancillary.add_creds(UnixCredentials{::getpid(), ::getuid(),
+                                                    ::getgid()}));
+    EXPECT_EQ(a.send_with_ancillary("y", 1, ancillary).value(), 1);
+    EXPECT_EQ(b.recv_with_ancillary(&buf, 1, ancillary).value(), 1);
+    EXPECT_EQ(buf, 'y');
+    EXPECT_EQ(ancillary.creds().value().pid, ::getpid());
+}
@@ -0,0 +1,129 @@
+#include "bipolar/net/timestamping.hpp"
+
+#include <sys/socket.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace bipolar {
+namespace {
+// A zero timestamp is the one not generated
+Option<std::chrono::nanoseconds> to_duration(const struct timespec& ts) {
+    if (ts.tv_sec == 0 && ts.tv_nsec == 0) {
+        return None;
+    }
+    return Some(std::chrono::seconds(ts.tv_sec) +
+                std::chrono::nanoseconds(ts.tv_nsec));
+}
+
+bool parse_timestamping(const struct cmsghdr& cmsg, Timestamps* stamps) {
+    if (cmsg.cmsg_level != SOL_SOCKET || cmsg.cmsg_type != SCM_TIMESTAMPING ||
+        cmsg.cmsg_len < CMSG_LEN(sizeof(struct scm_timestamping))) {
+        return false;
+    }
+
+    // ts[1] is deprecated and always zero
+    struct scm_timestamping tss;
+    std::memcpy(&tss, CMSG_DATA(&cmsg), sizeof(tss));
+    stamps->software = to_duration(tss.ts[0]);
+    stamps->hardware = to_duration(tss.ts[2]);
+    return true;
+}
+
+} // namespace
+
+Timestamps Timestamps::from_msghdr(const struct msghdr& msg) noexcept {
+    Timestamps stamps;
+    auto* hdr = const_cast<struct msghdr*>(&msg);
+    for (auto* cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (parse_timestamping(*cmsg, &stamps)) {
+            break;
+        }
+    }
+    return stamps;
+}
+
+Option<TxTimestamps>
+TxTimestamps::from_msghdr(const struct msghdr& msg) noexcept {
+    TxTimestamps tx;
+    bool is_timestamp = false;
+    auto* hdr = const_cast<struct msghdr*>(&msg);
+    for (auto* cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (parse_timestamping(*cmsg, &tx.stamps)) {
+            continue;
+        }
+
+        // IPv4 packets sent by IPv6 sockets report IP_RECVERR
+        const bool is_recverr =
+            (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+            (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+        if (!is_recverr ||
+            cmsg->cmsg_len < CMSG_LEN(sizeof(struct sock_extended_err))) {
+            continue;
+        }
+
+        struct sock_extended_err err;
+        std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+        if (err.ee_errno == ENOMSG &&
+            err.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+            tx.id = err.ee_data;
+            tx.kind = err.ee_info;
+            is_timestamp = true;
+        }
+    }
+
+    if (!is_timestamp) {
+        return None;
+    }
+    return Some(std::move(tx));
+}
+
+namespace internal {
+Result<std::size_t, int> recv_tx_timestamps(int fd, TxTimestamps* out,
+                                            std::size_t n) noexcept {
+    constexpr std::size_t kBatch = 16;
+
+    struct mmsghdr msgvec[kBatch];
+    alignas(struct cmsghdr) char control[kBatch][TxTimestamps::kControlLen];
+
+    std::size_t count = 0;
+    std::size_t read = 0;
+    while (count < n) {
+        const std::size_t vlen = std::min(n - count, kBatch);
+        // the packets looped back aren't read, only their control messages
+        std::memset(msgvec, 0, sizeof(struct mmsghdr) * vlen);
+        for (std::size_t i = 0; i < vlen; ++i) {
+            msgvec[i].msg_hdr.msg_control = control[i];
+            msgvec[i].msg_hdr.msg_controllen = sizeof(control[i]);
+        }
+
+        const int ret = ::recvmmsg(fd, msgvec, vlen,
+                                   MSG_ERRQUEUE | MSG_DONTWAIT, nullptr);
+        if (ret == -1) {
+            if (errno == EAGAIN && read > 0) {
+                break;
+            }
+            return Err(errno);
+        }
+
+        read += ret;
+        for (int i = 0; i < ret; ++i) {
+            auto tx = TxTimestamps::from_msghdr(msgvec[i].msg_hdr);
+            if (tx.has_value()) {
+                out[count++] = tx.value();
+            }
+        }
+
+        if (static_cast<std::size_t>(ret) < vlen) {
+            break;
+        }
+    }
+    return Ok(count);
+}
+
+} // namespace internal
+} // namespace bipolar
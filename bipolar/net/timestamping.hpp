@@ -0,0 +1,122 @@
+//! Kernel timestamping
+//!
+//! see `Timestamps` and `TxTimestamps` for details
+
+#ifndef BIPOLAR_NET_TIMESTAMPING_HPP_
+#define BIPOLAR_NET_TIMESTAMPING_HPP_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+
+// after <time.h>, which defines the `timespec` it uses
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+
+namespace bipolar {
+/// Timestamps
+///
+/// # Brief
+///
+/// The timestamps the kernel attaches to a packet as a `SCM_TIMESTAMPING`
+/// control message, once `SO_TIMESTAMPING` is set on the socket by
+/// `set_timestamping` of `UdpSocket` or `TcpStream`.
+///
+/// Both are durations since the epoch of `CLOCK_REALTIME`, the hardware one
+/// by the clock of the NIC, which may need to be synchronized with
+/// `phc2sys`. Either is `None` if not generated: the software one needs
+/// `SOF_TIMESTAMPING_SOFTWARE` and the hardware one
+/// `SOF_TIMESTAMPING_RAW_HARDWARE`, besides the flags saying when to take
+/// them, and a NIC configured by `SIOCSHWTSTAMP`.
+///
+/// # Examples
+///
+/// Measures how long received datagrams wait in the kernel:
+///
+/// ```
+/// socket.set_timestamping(SOF_TIMESTAMPING_RX_SOFTWARE |
+///                         SOF_TIMESTAMPING_SOFTWARE)
+///     .expect("SO_TIMESTAMPING not supported");
+///
+/// alignas(struct cmsghdr) char control[Timestamps::kControlLen];
+/// struct msghdr msg = { ... };
+/// msg.msg_control = control;
+/// msg.msg_controllen = sizeof(control);
+/// socket.recvmsg(&msg).expect("recvmsg failed");
+///
+/// const auto stamps = Timestamps::from_msghdr(msg);
+/// if (stamps.software.has_value()) {
+///     const auto now = std::chrono::system_clock::now().time_since_epoch();
+///     record(now - stamps.software.value());
+/// }
+/// ```
+///
+/// `Documentation/networking/timestamping.rst` of Linux for more
+/// information.
+struct Timestamps {
+    /// The number of bytes of the control buffer to receive the timestamps
+    static constexpr std::size_t kControlLen =
+        CMSG_SPACE(sizeof(struct scm_timestamping));
+
+    /// Parses the `SCM_TIMESTAMPING` message received in `msg`, if any
+    static Timestamps from_msghdr(const struct msghdr& msg) noexcept;
+
+    Option<std::chrono::nanoseconds> software;
+    Option<std::chrono::nanoseconds> hardware;
+};
+
+/// TxTimestamps
+///
+/// # Brief
+///
+/// The timestamps of a packet sent, looped back to the error queue of the
+/// socket by the kernel when `SO_TIMESTAMPING` has some of the
+/// `SOF_TIMESTAMPING_TX_*` flags, and read by `take_tx_timestamps` of
+/// `UdpSocket` or `TcpStream`.
+///
+/// A packet gets a timestamp at each point of the path the flags ask for:
+///
+/// - `SCM_TSTAMP_SCHED`, entering the queueing discipline
+/// - `SCM_TSTAMP_SND`, handed to, or sent by, the NIC
+/// - `SCM_TSTAMP_ACK`, acknowledged by the peer, TCP only
+///
+/// With `SOF_TIMESTAMPING_OPT_ID`, `id` tells the packet: the number of
+/// datagrams sent before it for UDP, and the number of bytes sent before
+/// its last byte for TCP. Set `SOF_TIMESTAMPING_OPT_TSONLY` too to save
+/// the kernel from looping the whole packet back.
+struct TxTimestamps {
+    /// The number of bytes of the control buffer to receive the timestamps
+    /// and the extended error carrying `id` and `kind`
+    static constexpr std::size_t kControlLen =
+        Timestamps::kControlLen +
+        CMSG_SPACE(sizeof(struct sock_extended_err) +
+                   sizeof(struct sockaddr_in6));
+
+    /// Parses the message read from the error queue in `msg`, `None` if
+    /// it's not a timestamp, e.g. an ICMP error
+    static Option<TxTimestamps> from_msghdr(const struct msghdr& msg) noexcept;
+
+    Timestamps stamps;
+    std::uint32_t id = 0;
+    /// One of `SCM_TSTAMP_SCHED`, `SCM_TSTAMP_SND` and `SCM_TSTAMP_ACK`
+    std::uint32_t kind = 0;
+};
+
+namespace internal {
+/// Reads at most `n` timestamps from the error queue of `fd`.
+/// On success, returns the number of timestamps read, skipping the other
+/// errors queued. Returns `EAGAIN` if the queue is empty.
+Result<std::size_t, int> recv_tx_timestamps(int fd, TxTimestamps* out,
+                                            std::size_t n) noexcept;
+
+} // namespace internal
+} // namespace bipolar
+
+#endif
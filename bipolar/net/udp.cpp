@@ -6,7 +6,7 @@
 #include <unistd.h>
 
 #include "bipolar/core/assert.hpp"
-#include "bipolar/net/internal/native_to_socket_address.hpp"
+#include "bipolar/net/compact_socket_address.hpp"
 
 namespace bipolar {
 UdpSocket::~UdpSocket() noexcept {
@@ -39,10 +39,8 @@ Result<UdpSocket, int> UdpSocket::bind(const SocketAddress& sa) noexcept {
         return Err(errno);
     }
 
-    const auto addr = sa.to_sockaddr();
-    const socklen_t len = sa.addr().is_ipv4() ? sizeof(struct sockaddr_in)
-                                              : sizeof(struct sockaddr_in6);
-    ret = ::bind(sock, (const struct sockaddr*)&addr, len);
+    const NativeSocketAddress addr(sa);
+    ret = ::bind(sock, addr.get(), addr.size());
     if (ret == -1) {
         ::close(sock);
         return Err(errno);
@@ -51,11 +49,8 @@ Result<UdpSocket, int> UdpSocket::bind(const SocketAddress& sa) noexcept {
 }
 
 Result<Void, int> UdpSocket::connect(const SocketAddress& sa) noexcept {
-    const auto addr = sa.to_sockaddr();
-    const socklen_t addr_len = sa.addr().is_ipv4()
-                                   ? sizeof(struct sockaddr_in)
-                                   : sizeof(struct sockaddr_in6);
-    const int ret = ::connect(fd_, (const struct sockaddr*)&addr, addr_len);
+    const NativeSocketAddress addr(sa);
+    const int ret = ::connect(fd_, addr.get(), addr.size());
     if (ret == -1) {
         return Err(errno);
     }
@@ -96,12 +91,21 @@ Result<std::size_t, int> UdpSocket::send(const void* buf, std::size_t len,
 Result<std::size_t, int> UdpSocket::sendto(const void* buf, std::size_t len,
                                            const SocketAddress& sa,
                                            int flags) noexcept {
-    const auto addr = sa.to_sockaddr();
-    const socklen_t addr_len = sa.addr().is_ipv4()
-                                   ? sizeof(struct sockaddr_in)
-                                   : sizeof(struct sockaddr_in6);
+    const NativeSocketAddress addr(sa);
     const ssize_t ret =
-        ::sendto(fd_, buf, len, flags, (const struct sockaddr*)&addr, addr_len);
+        ::sendto(fd_, buf, len, flags, addr.get(), addr.size());
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UdpSocket::sendto(const void* buf, std::size_t len,
+                                           const CompactSocketAddress& sa,
+                                           int flags) noexcept {
+    const NativeSocketAddress addr(sa);
+    const ssize_t ret =
+        ::sendto(fd_, buf, len, flags, addr.get(), addr.size());
     if (ret == -1) {
         return Err(errno);
     }
@@ -147,20 +151,39 @@ Result<std::size_t, int> UdpSocket::recv(void* buf, std::size_t len,
 
 Result<std::tuple<std::size_t, SocketAddress>, int>
 UdpSocket::recvfrom(void* buf, std::size_t len, int flags) noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
     const ssize_t ret =
-        ::recvfrom(fd_, buf, len, flags, (struct sockaddr*)&addr, &addr_len);
+        ::recvfrom(fd_, buf, len, flags, addr.get(), &addr_len);
     if (ret == -1) {
         return Err(errno);
     }
 
-    return internal::native_addr_to_socket_address(&addr, addr_len)
+    return addr.to_socket_address(addr_len)
         .map([ret](SocketAddress sa) {
             return std::make_tuple(static_cast<std::size_t>(ret), sa);
         });
 }
 
+Result<std::size_t, int> UdpSocket::recvfrom(void* buf, std::size_t len,
+                                             CompactSocketAddress* from,
+                                             int flags) noexcept {
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const ssize_t ret =
+        ::recvfrom(fd_, buf, len, flags, addr.get(), &addr_len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+
+    auto sa = CompactSocketAddress::from_native(addr.get(), addr_len);
+    if (sa.is_error()) {
+        return Err(sa.error());
+    }
+    *from = sa.value();
+    return Ok(static_cast<std::size_t>(ret));
+}
+
 Result<std::size_t, int> UdpSocket::readv(struct iovec* iov,
                                           std::size_t vlen) noexcept {
     const ssize_t ret = ::readv(fd_, iov, vlen);
@@ -189,26 +212,40 @@ Result<std::size_t, int> UdpSocket::recvmmsg(struct mmsghdr* msgvec,
     return Ok(static_cast<std::size_t>(ret));
 }
 
+Result<std::size_t, int> UdpSocket::recvmmsg(struct mmsghdr* msgvec,
+                                             std::size_t vlen,
+                                             Timestamps* stamps,
+                                             int flags) noexcept {
+    const int ret = ::recvmmsg(fd_, msgvec, vlen, flags, nullptr);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    for (int i = 0; i < ret; ++i) {
+        stamps[i] = Timestamps::from_msghdr(msgvec[i].msg_hdr);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
 Result<SocketAddress, int> UdpSocket::local_addr() noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
-    const int ret = ::getsockname(fd_, (struct sockaddr*)&addr, &addr_len);
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const int ret = ::getsockname(fd_, addr.get(), &addr_len);
     if (ret == -1) {
         return Err(errno);
     }
 
-    return internal::native_addr_to_socket_address(&addr, addr_len);
+    return addr.to_socket_address(addr_len);
 }
 
 Result<SocketAddress, int> UdpSocket::peer_addr() noexcept {
-    struct sockaddr_storage addr;
-    socklen_t addr_len = sizeof(addr);
-    const int ret = ::getpeername(fd_, (struct sockaddr*)&addr, &addr_len);
+    NativeSocketAddress addr;
+    socklen_t addr_len = NativeSocketAddress::capacity();
+    const int ret = ::getpeername(fd_, addr.get(), &addr_len);
     if (ret == -1) {
         return Err(errno);
     }
 
-    return internal::native_addr_to_socket_address(&addr, addr_len);
+    return addr.to_socket_address(addr_len);
 }
 
 Result<int, int> UdpSocket::take_error() noexcept {
@@ -220,4 +257,30 @@ Result<int, int> UdpSocket::take_error() noexcept {
     }
     return Ok(optval);
 }
+
+Result<Void, int> UdpSocket::set_timestamping(std::uint32_t flags) noexcept {
+    const int optval = static_cast<int>(flags);
+    const int ret = ::setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &optval,
+                                 sizeof(optval));
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+Result<std::uint32_t, int> UdpSocket::timestamping() noexcept {
+    int optval = 0;
+    socklen_t len = sizeof(optval);
+    const int ret =
+        ::getsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &optval, &len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::uint32_t>(optval));
+}
+
+Result<std::size_t, int>
+UdpSocket::take_tx_timestamps(TxTimestamps* out, std::size_t n) noexcept {
+    return internal::recv_tx_timestamps(fd_, out, n);
+}
 } // namespace bipolar
@@ -7,7 +7,9 @@
 #include "bipolar/core/movable.hpp"
 #include "bipolar/core/result.hpp"
 #include "bipolar/core/void.hpp"
+#include "bipolar/net/compact_socket_address.hpp"
 #include "bipolar/net/socket_address.hpp"
+#include "bipolar/net/timestamping.hpp"
 
 #include <cstdint>
 #include <tuple>
@@ -141,6 +143,14 @@ public:
                                     const SocketAddress& sa,
                                     int flags = 0) noexcept;
 
+    /// Sends data on the socket to the given compact socket address.
+    /// On success, returns the number of bytes written.
+    ///
+    /// see `sendto` for details
+    Result<std::size_t, int> sendto(const void* buf, std::size_t len,
+                                    const CompactSocketAddress& sa,
+                                    int flags = 0) noexcept;
+
     /// An alias of `send`
     Result<std::size_t, int> write(const void* buf, std::size_t len) noexcept {
         return send(buf, len);
@@ -197,6 +207,15 @@ public:
     Result<std::tuple<std::size_t, SocketAddress>, int>
     recvfrom(void* buf, std::size_t len, int flags = 0) noexcept;
 
+    /// Receives a single datagram message on the socket, storing its origin
+    /// in `from`.
+    /// On success, returns the number of bytes read.
+    ///
+    /// see `recvfrom` for details
+    Result<std::size_t, int> recvfrom(void* buf, std::size_t len,
+                                      CompactSocketAddress* from,
+                                      int flags = 0) noexcept;
+
     /// An alias of `recv`
     Result<std::size_t, int> read(void* buf, std::size_t len) noexcept {
         return recv(buf, len);
@@ -224,6 +243,18 @@ public:
     Result<std::size_t, int> recvmmsg(struct mmsghdr* msgvec, std::size_t vlen,
                                       int flags = 0) noexcept;
 
+    /// Receives multiple messages like `recvmmsg`, storing the kernel
+    /// timestamps of the message `msgvec[i]` in `stamps[i]`.
+    ///
+    /// The `msg_control` of each message must hold at least
+    /// `Timestamps::kControlLen` bytes, and `msg_controllen` be reset before
+    /// the messages are reused, since the kernel overwrites it.
+    ///
+    /// see `set_timestamping` for details
+    Result<std::size_t, int> recvmmsg(struct mmsghdr* msgvec, std::size_t vlen,
+                                      Timestamps* stamps,
+                                      int flags = 0) noexcept;
+
     /// Returns the socket address that this socket was created from
     Result<SocketAddress, int> local_addr() noexcept;
 
@@ -238,6 +269,35 @@ public:
     /// between calls.
     Result<int, int> take_error() noexcept;
 
+    /// Sets the value of the `SO_TIMESTAMPING` option on this socket, the
+    /// `SOF_TIMESTAMPING_*` flags of the timestamps the kernel generates.
+    ///
+    /// RX timestamps are received as control messages along with the
+    /// datagrams, see `Timestamps`, and TX ones are read by
+    /// `take_tx_timestamps`, see `TxTimestamps`.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// socket.set_timestamping(SOF_TIMESTAMPING_RX_SOFTWARE |
+    ///                         SOF_TIMESTAMPING_TX_SOFTWARE |
+    ///                         SOF_TIMESTAMPING_SOFTWARE |
+    ///                         SOF_TIMESTAMPING_OPT_ID |
+    ///                         SOF_TIMESTAMPING_OPT_TSONLY)
+    ///     .expect("SO_TIMESTAMPING not supported");
+    /// ```
+    Result<Void, int> set_timestamping(std::uint32_t flags) noexcept;
+
+    /// Gets the value of the `SO_TIMESTAMPING` option on this socket.
+    Result<std::uint32_t, int> timestamping() noexcept;
+
+    /// Reads at most `n` TX timestamps from the error queue of this socket.
+    /// On success, returns the number of timestamps read.
+    ///
+    /// Returns `EAGAIN` if there's none, and skips the other errors queued.
+    Result<std::size_t, int> take_tx_timestamps(TxTimestamps* out,
+                                                std::size_t n) noexcept;
+
     /// Returns the underlying file descriptor.
     ///
     /// NOTE:
@@ -0,0 +1,492 @@
+#include "bipolar/net/unix.hpp"
+
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <limits>
+
+#include "bipolar/core/assert.hpp"
+
+namespace bipolar {
+namespace {
+Result<int, int> unix_socket(int type) noexcept {
+    const int sock = ::socket(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock == -1) {
+        return Err(errno);
+    }
+    return Ok(sock);
+}
+
+Result<std::tuple<int, int>, int> unix_socketpair(int type) noexcept {
+    int fds[2];
+    const int ret =
+        ::socketpair(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(std::make_tuple(fds[0], fds[1]));
+}
+
+Result<UnixSocketAddress, int> unix_sockname(int fd, bool peer) noexcept {
+    UnixSocketAddress addr;
+    socklen_t addr_len = UnixSocketAddress::capacity();
+    const int ret = peer ? ::getpeername(fd, addr.get(), &addr_len)
+                         : ::getsockname(fd, addr.get(), &addr_len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return UnixSocketAddress::from_native(addr.get(), addr_len);
+}
+
+Result<std::size_t, int> unix_send_with_ancillary(int fd, const void* buf,
+                                                  std::size_t len,
+                                                  SocketAncillary& ancillary,
+                                                  int flags) noexcept {
+    struct iovec iov = {
+        .iov_base = const_cast<void*>(buf),
+        .iov_len = len,
+    };
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    ancillary.prepare_send(&msg);
+
+    const ssize_t ret = ::sendmsg(fd, &msg, flags | MSG_NOSIGNAL);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> unix_recv_with_ancillary(int fd, void* buf,
+                                                  std::size_t len,
+                                                  SocketAncillary& ancillary,
+                                                  int flags) noexcept {
+    struct iovec iov = {
+        .iov_base = buf,
+        .iov_len = len,
+    };
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    ancillary.prepare_recv(&msg);
+
+    // the file descriptors received must not leak into child processes
+    const ssize_t ret = ::recvmsg(fd, &msg, flags | MSG_CMSG_CLOEXEC);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    ancillary.finish_recv(msg);
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<Void, int> unix_set_passcred(int fd, bool enable) noexcept {
+    const int optval = static_cast<int>(enable);
+    const int ret =
+        ::setsockopt(fd, SOL_SOCKET, SO_PASSCRED, &optval, sizeof(optval));
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+Result<Void, int> unix_close(int& fd) noexcept {
+    if (fd != -1) {
+        const int copy_fd = std::exchange(fd, -1);
+        const int ret = ::close(copy_fd);
+        if (ret == -1) {
+            return Err(errno);
+        }
+    }
+    return Ok(Void{});
+}
+
+Result<int, int> unix_take_error(int fd) noexcept {
+    int optval = 0;
+    socklen_t len = sizeof(optval);
+    const int ret = ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &optval, &len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(optval);
+}
+
+} // namespace
+
+UnixStream::~UnixStream() noexcept {
+    const auto ret = close();
+    BIPOLAR_ASSERT(!ret.is_error(), "unix stream closed with error: {}",
+                   ret.error());
+}
+
+Result<UnixStream, int> UnixStream::try_clone() noexcept {
+    const int new_fd = ::dup(fd_);
+    if (new_fd == -1) {
+        return Err(errno);
+    }
+    return Ok(UnixStream(new_fd));
+}
+
+Result<UnixStream, int>
+UnixStream::connect(const UnixSocketAddress& addr) noexcept {
+    auto sock = unix_socket(SOCK_STREAM);
+    if (sock.is_error()) {
+        return Err(sock.error());
+    }
+
+    const int ret = ::connect(sock.value(), addr.get(), addr.size());
+    const int err = errno; // `close` may overwrite errno, so we save a copy
+    if (ret == -1 && err != EINPROGRESS) {
+        ::close(sock.value());
+        return Err(err);
+    }
+    return Ok(UnixStream(sock.value()));
+}
+
+Result<std::tuple<UnixStream, UnixStream>, int> UnixStream::pair() noexcept {
+    return unix_socketpair(SOCK_STREAM).map([](std::tuple<int, int> fds) {
+        return std::make_tuple(UnixStream(std::get<0>(fds)),
+                               UnixStream(std::get<1>(fds)));
+    });
+}
+
+Result<std::size_t, int> UnixStream::send(const void* buf, std::size_t len,
+                                          int flags) noexcept {
+    const ssize_t ret = ::send(fd_, buf, len, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UnixStream::writev(const struct iovec* iov,
+                                            std::size_t vlen) noexcept {
+    const ssize_t ret = ::writev(fd_, iov, vlen);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UnixStream::sendmsg(const struct msghdr* msg,
+                                             int flags) noexcept {
+    const ssize_t ret = ::sendmsg(fd_, msg, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int>
+UnixStream::send_with_ancillary(const void* buf, std::size_t len,
+                                SocketAncillary& ancillary,
+                                int flags) noexcept {
+    return unix_send_with_ancillary(fd_, buf, len, ancillary, flags);
+}
+
+Result<std::size_t, int> UnixStream::recv(void* buf, std::size_t len,
+                                          int flags) noexcept {
+    const ssize_t ret = ::recv(fd_, buf, len, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UnixStream::readv(struct iovec* iov,
+                                           std::size_t vlen) noexcept {
+    const ssize_t ret = ::readv(fd_, iov, vlen);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UnixStream::recvmsg(struct msghdr* msg,
+                                             int flags) noexcept {
+    const ssize_t ret = ::recvmsg(fd_, msg, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int>
+UnixStream::recv_with_ancillary(void* buf, std::size_t len,
+                                SocketAncillary& ancillary,
+                                int flags) noexcept {
+    return unix_recv_with_ancillary(fd_, buf, len, ancillary, flags);
+}
+
+Result<UnixSocketAddress, int> UnixStream::local_addr() noexcept {
+    return unix_sockname(fd_, false);
+}
+
+Result<UnixSocketAddress, int> UnixStream::peer_addr() noexcept {
+    return unix_sockname(fd_, true);
+}
+
+Result<UnixCredentials, int> UnixStream::peer_cred() noexcept {
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    const int ret = ::getsockopt(fd_, SOL_SOCKET, SO_PEERCRED, &cred, &len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(UnixCredentials{cred.pid, cred.uid, cred.gid});
+}
+
+Result<Void, int> UnixStream::set_passcred(bool enable) noexcept {
+    return unix_set_passcred(fd_, enable);
+}
+
+Result<Void, int> UnixStream::close() noexcept {
+    return unix_close(fd_);
+}
+
+Result<Void, int> UnixStream::shutdown(int how) noexcept {
+    const int ret = ::shutdown(fd_, how);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+Result<Void, int> UnixStream::set_nonblocking(bool enable) noexcept {
+    int opt = static_cast<int>(enable);
+    const int ret = ::ioctl(fd_, FIONBIO, &opt);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+Result<int, int> UnixStream::take_error() noexcept {
+    return unix_take_error(fd_);
+}
+
+UnixListener::~UnixListener() noexcept {
+    const auto ret = close();
+    BIPOLAR_ASSERT(!ret.is_error(), "unix listener closed with error: {}",
+                   ret.error());
+}
+
+Result<UnixListener, int> UnixListener::try_clone() noexcept {
+    const int new_fd = ::dup(fd_);
+    if (new_fd == -1) {
+        return Err(errno);
+    }
+    return Ok(UnixListener(new_fd));
+}
+
+Result<Void, int> UnixListener::close() noexcept {
+    return unix_close(fd_);
+}
+
+Result<UnixListener, int>
+UnixListener::bind(const UnixSocketAddress& addr) noexcept {
+    auto sock = unix_socket(SOCK_STREAM);
+    if (sock.is_error()) {
+        return Err(sock.error());
+    }
+
+    int ret = ::bind(sock.value(), addr.get(), addr.size());
+    if (ret == -1) {
+        const int err = errno;
+        ::close(sock.value());
+        return Err(err);
+    }
+
+    // Sets the backlog with INT_MAX.
+    // `somaxconn` is the only soft constraint now
+    ret = ::listen(sock.value(), std::numeric_limits<int>::max());
+    if (ret == -1) {
+        const int err = errno;
+        ::close(sock.value());
+        return Err(err);
+    }
+    return Ok(UnixListener(sock.value()));
+}
+
+Result<std::tuple<UnixStream, UnixSocketAddress>, int>
+UnixListener::accept() noexcept {
+    UnixSocketAddress addr;
+    socklen_t addr_len = UnixSocketAddress::capacity();
+    const int conn = ::accept4(fd_, addr.get(), &addr_len,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (conn == -1) {
+        return Err(errno);
+    }
+
+    // `UnixStream` closes the connection if the address is malformed
+    UnixStream stream(conn);
+    auto peer = UnixSocketAddress::from_native(addr.get(), addr_len);
+    if (peer.is_error()) {
+        return Err(peer.error());
+    }
+    return Ok(std::make_tuple(std::move(stream), peer.value()));
+}
+
+Result<UnixSocketAddress, int> UnixListener::local_addr() noexcept {
+    return unix_sockname(fd_, false);
+}
+
+Result<int, int> UnixListener::take_error() noexcept {
+    return unix_take_error(fd_);
+}
+
+UnixDatagram::~UnixDatagram() noexcept {
+    const auto ret = close();
+    BIPOLAR_ASSERT(!ret.is_error(), "unix datagram closed with error: {}",
+                   ret.error());
+}
+
+Result<UnixDatagram, int> UnixDatagram::try_clone() noexcept {
+    const int new_fd = ::dup(fd_);
+    if (new_fd == -1) {
+        return Err(errno);
+    }
+    return Ok(UnixDatagram(new_fd));
+}
+
+Result<UnixDatagram, int>
+UnixDatagram::bind(const UnixSocketAddress& addr) noexcept {
+    auto sock = unix_socket(SOCK_DGRAM);
+    if (sock.is_error()) {
+        return Err(sock.error());
+    }
+
+    const int ret = ::bind(sock.value(), addr.get(), addr.size());
+    if (ret == -1) {
+        const int err = errno;
+        ::close(sock.value());
+        return Err(err);
+    }
+    return Ok(UnixDatagram(sock.value()));
+}
+
+Result<UnixDatagram, int> UnixDatagram::unbound() noexcept {
+    return unix_socket(SOCK_DGRAM).map([](int fd) {
+        return UnixDatagram(fd);
+    });
+}
+
+Result<std::tuple<UnixDatagram, UnixDatagram>, int>
+UnixDatagram::pair() noexcept {
+    return unix_socketpair(SOCK_DGRAM).map([](std::tuple<int, int> fds) {
+        return std::make_tuple(UnixDatagram(std::get<0>(fds)),
+                               UnixDatagram(std::get<1>(fds)));
+    });
+}
+
+Result<Void, int>
+UnixDatagram::connect(const UnixSocketAddress& addr) noexcept {
+    const int ret = ::connect(fd_, addr.get(), addr.size());
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(Void{});
+}
+
+Result<Void, int> UnixDatagram::close() noexcept {
+    return unix_close(fd_);
+}
+
+Result<std::size_t, int> UnixDatagram::send(const void* buf, std::size_t len,
+                                            int flags) noexcept {
+    const ssize_t ret = ::send(fd_, buf, len, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UnixDatagram::sendto(const void* buf,
+                                              std::size_t len,
+                                              const UnixSocketAddress& addr,
+                                              int flags) noexcept {
+    const ssize_t ret =
+        ::sendto(fd_, buf, len, flags, addr.get(), addr.size());
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int> UnixDatagram::sendmsg(const struct msghdr* msg,
+                                               int flags) noexcept {
+    const ssize_t ret = ::sendmsg(fd_, msg, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int>
+UnixDatagram::send_with_ancillary(const void* buf, std::size_t len,
+                                  SocketAncillary& ancillary,
+                                  int flags) noexcept {
+    return unix_send_with_ancillary(fd_, buf, len, ancillary, flags);
+}
+
+Result<std::size_t, int> UnixDatagram::recv(void* buf, std::size_t len,
+                                            int flags) noexcept {
+    const ssize_t ret = ::recv(fd_, buf, len, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::tuple<std::size_t, UnixSocketAddress>, int>
+UnixDatagram::recvfrom(void* buf, std::size_t len, int flags) noexcept {
+    UnixSocketAddress addr;
+    socklen_t addr_len = UnixSocketAddress::capacity();
+    const ssize_t ret =
+        ::recvfrom(fd_, buf, len, flags, addr.get(), &addr_len);
+    if (ret == -1) {
+        return Err(errno);
+    }
+
+    return UnixSocketAddress::from_native(addr.get(), addr_len)
+        .map([ret](UnixSocketAddress from) {
+            return std::make_tuple(static_cast<std::size_t>(ret), from);
+        });
+}
+
+Result<std::size_t, int> UnixDatagram::recvmsg(struct msghdr* msg,
+                                               int flags) noexcept {
+    const ssize_t ret = ::recvmsg(fd_, msg, flags);
+    if (ret == -1) {
+        return Err(errno);
+    }
+    return Ok(static_cast<std::size_t>(ret));
+}
+
+Result<std::size_t, int>
+UnixDatagram::recv_with_ancillary(void* buf, std::size_t len,
+                                  SocketAncillary& ancillary,
+                                  int flags) noexcept {
+    return unix_recv_with_ancillary(fd_, buf, len, ancillary, flags);
+}
+
+Result<UnixSocketAddress, int> UnixDatagram::local_addr() noexcept {
+    return unix_sockname(fd_, false);
+}
+
+Result<UnixSocketAddress, int> UnixDatagram::peer_addr() noexcept {
+    return unix_sockname(fd_, true);
+}
+
+Result<Void, int> UnixDatagram::set_passcred(bool enable) noexcept {
+    return unix_set_passcred(fd_, enable);
+}
+
+Result<int, int> UnixDatagram::take_error() noexcept {
+    return unix_take_error(fd_);
+}
+
+} // namespace bipolar
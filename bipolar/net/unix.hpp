@@ -0,0 +1,474 @@
+//! Unix domain socket building blocks
+//!
+//! - `UnixStream`
+//! - `UnixListener`
+//! - `UnixDatagram`
+//!
+
+#ifndef BIPOLAR_NET_UNIX_HPP_
+#define BIPOLAR_NET_UNIX_HPP_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "bipolar/core/movable.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/net/socket_ancillary.hpp"
+#include "bipolar/net/unix_socket_address.hpp"
+
+namespace bipolar {
+/// UnixStream
+///
+/// A Unix domain stream socket with RAII semantics.
+///
+/// Besides data, it carries ancillary data: file descriptors, e.g. the
+/// `TcpListener` and `TcpStream` sockets handed over to a new process on a
+/// hot restart, and credentials. See `SocketAncillary` for details.
+///
+/// # Examples
+///
+/// ```
+/// auto addr = UnixSocketAddress::from_abstract("app.handoff").value();
+/// auto stream = UnixStream::connect(addr)
+///     .expect("couldn't connect to @app.handoff");
+///
+/// char buf[] = "buzz";
+/// stream.write(buf, 4);
+/// stream.read(buf, 4);
+/// ```
+///
+/// `man 7 unix` for more information.
+class UnixStream final : public Movable {
+public:
+    /// Constructs a Unix stream from native handle (file descriptor).
+    /// Ownership transfers.
+    explicit UnixStream(int fd) noexcept : fd_(fd) {}
+
+    /// Constructs from the given `UnixStream`, leaving it invalid
+    UnixStream(UnixStream&& rhs) noexcept : fd_(rhs.fd_) {
+        rhs.fd_ = -1;
+    }
+
+    UnixStream& operator=(UnixStream&& rhs) noexcept {
+        UnixStream(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /// Close if it's valid.
+    ///
+    /// see `TcpStream::~TcpStream` for details
+    ~UnixStream() noexcept;
+
+    /// Creates a new independently owned handle to the underlying socket.
+    ///
+    /// see `TcpStream::try_clone` for details
+    Result<UnixStream, int> try_clone() noexcept;
+
+    /// Creates a new **nonblocking** Unix stream and connects it to the
+    /// specified address.
+    ///
+    /// Returns `EAGAIN` if the backlog of the listener is full.
+    static Result<UnixStream, int>
+    connect(const UnixSocketAddress& addr) noexcept;
+
+    /// Creates a pair of connected **nonblocking** Unix streams.
+    ///
+    /// `man 2 socketpair` for more information.
+    static Result<std::tuple<UnixStream, UnixStream>, int> pair() noexcept;
+
+    /// Sends data on the socket to the peer.
+    /// On success, returns the number of bytes written.
+    ///
+    /// `man 2 send` for more information.
+    Result<std::size_t, int> send(const void* buf, std::size_t len,
+                                  int flags = 0) noexcept;
+
+    /// An alias of `send`
+    Result<std::size_t, int> write(const void* buf, std::size_t len) noexcept {
+        return send(buf, len);
+    }
+
+    /// Sends data on the socket to the peer.
+    /// On success, returns the number of bytes written.
+    ///
+    /// `man 2 writev` for more information.
+    Result<std::size_t, int> writev(const struct iovec* iov,
+                                    std::size_t vlen) noexcept;
+
+    /// Sends a message to the peer.
+    /// On success, returns the number of bytes written.
+    ///
+    /// `man 2 sendmsg` for more information.
+    Result<std::size_t, int> sendmsg(const struct msghdr* msg,
+                                     int flags = 0) noexcept;
+
+    /// Sends data along with the control messages of `ancillary`.
+    /// On success, returns the number of bytes written.
+    ///
+    /// The control messages are sent with the first byte of the data, which
+    /// therefore must not be empty.
+    Result<std::size_t, int>
+    send_with_ancillary(const void* buf, std::size_t len,
+                        SocketAncillary& ancillary, int flags = 0) noexcept;
+
+    /// Receives data from the peer.
+    /// On success, returns the number of bytes read.
+    ///
+    /// `man 2 recv` for more information.
+    Result<std::size_t, int> recv(void* buf, std::size_t len,
+                                  int flags = 0) noexcept;
+
+    /// An alias of `recv`
+    Result<std::size_t, int> read(void* buf, std::size_t len) noexcept {
+        return recv(buf, len);
+    }
+
+    /// Receives data from the peer.
+    /// On success, returns the number of bytes read.
+    ///
+    /// `man 2 readv` for more information.
+    Result<std::size_t, int> readv(struct iovec* iov,
+                                   std::size_t vlen) noexcept;
+
+    /// Receives a message from the peer.
+    /// On success, returns the number of bytes read.
+    ///
+    /// `man 2 recvmsg` for more information.
+    Result<std::size_t, int> recvmsg(struct msghdr* msg,
+                                     int flags = 0) noexcept;
+
+    /// Receives data, and the control messages sent with it into
+    /// `ancillary`.
+    /// On success, returns the number of bytes read.
+    ///
+    /// A read never spans data sent with different control messages, so
+    /// that they're received with the data they were sent with.
+    Result<std::size_t, int>
+    recv_with_ancillary(void* buf, std::size_t len, SocketAncillary& ancillary,
+                        int flags = 0) noexcept;
+
+    /// Returns the socket address of the local half of this connection
+    Result<UnixSocketAddress, int> local_addr() noexcept;
+
+    /// Returns the socket address of the remote peer of this connection
+    Result<UnixSocketAddress, int> peer_addr() noexcept;
+
+    /// Returns the credentials of the peer process when it connected, by
+    /// the `SO_PEERCRED` option
+    Result<UnixCredentials, int> peer_cred() noexcept;
+
+    /// Sets the value of the `SO_PASSCRED` option on this socket, so that
+    /// the credentials of the sender are received with every message
+    Result<Void, int> set_passcred(bool enable) noexcept;
+
+    /// Closes the socket
+    Result<Void, int> close() noexcept;
+
+    /// Shutdowns the read, write, or both halves of ths connection.
+    ///
+    /// `man 2 shutdown` for more information.
+    Result<Void, int> shutdown(int how) noexcept;
+
+    /// Moves this stream into or out of nonblocking mode.
+    ///
+    /// see `TcpStream::set_nonblocking` for details
+    Result<Void, int> set_nonblocking(bool enable) noexcept;
+
+    /// Gets the value of the `SO_ERROR` option on this socket.
+    ///
+    /// see `TcpStream::take_error` for details
+    Result<int, int> take_error() noexcept;
+
+    /// Returns the underlying file descriptor.
+    ///
+    /// NOTE:
+    ///
+    /// The returned fd may be invalidated after some methods such as
+    /// `operator=`
+    [[nodiscard]] int as_fd() const noexcept {
+        return fd_;
+    }
+
+    /// Returns the underlying file descriptor and leaving it invalid.
+    [[nodiscard]] int into_fd() noexcept {
+        return std::exchange(fd_, -1);
+    }
+
+    /// Swaps
+    void swap(UnixStream& rhs) noexcept {
+        std::swap(fd_, rhs.fd_);
+    }
+
+private:
+    int fd_;
+};
+
+/// UnixListener
+///
+/// A Unix domain stream listener with RAII semantics.
+///
+/// # Examples
+///
+/// ```
+/// auto listener = UnixListener::bind(
+///     UnixSocketAddress::from_pathname("/run/app.sock").value())
+///         .expect("couldn't bind to /run/app.sock");
+/// auto [stream, peer] = listener.accept().value();
+/// ```
+class UnixListener final : public Movable {
+public:
+    /// Constructs a Unix listener from native handle (file descriptor).
+    /// Ownership transfers.
+    explicit UnixListener(int fd) noexcept : fd_(fd) {}
+
+    /// Constructs from the given `UnixListener`, leaving it invalid
+    UnixListener(UnixListener&& rhs) noexcept : fd_(rhs.fd_) {
+        rhs.fd_ = -1;
+    }
+
+    UnixListener& operator=(UnixListener&& rhs) noexcept {
+        UnixListener(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /// Close if it's valid.
+    ///
+    /// The file of a pathname address is left in place, see `bind`.
+    ~UnixListener() noexcept;
+
+    /// Creates a new independently owned handle to the underlying socket.
+    ///
+    /// see `TcpListener::try_clone` for details
+    Result<UnixListener, int> try_clone() noexcept;
+
+    /// Closes the listener
+    Result<Void, int> close() noexcept;
+
+    /// Binds a new **nonblocking** Unix listener to the specified address.
+    ///
+    /// The returned listener is ready for accepting connections.
+    ///
+    /// NOTE:
+    ///
+    /// 1. Binding to a pathname which already exists fails with
+    ///    `EADDRINUSE`, even if no socket listens on it any longer. It's up
+    ///    to the caller to `unlink` stale files, and the file of its own
+    ///    listener once done.
+    /// 2. Abstract addresses have none of these issues.
+    ///
+    /// `man 2 bind/listen` for more information.
+    static Result<UnixListener, int>
+    bind(const UnixSocketAddress& addr) noexcept;
+
+    /// Accepts a new `UnixStream`, **nonblocking**.
+    /// On success, returns the `UnixStream` with associated address,
+    /// usually unnamed.
+    /// On failure, returns the errno. Be cautious with `EAGAIN` errno.
+    ///
+    /// `man 2 accept` for more information.
+    Result<std::tuple<UnixStream, UnixSocketAddress>, int> accept() noexcept;
+
+    /// Returns the local socket address of this listener
+    Result<UnixSocketAddress, int> local_addr() noexcept;
+
+    /// Gets the value of the `SO_ERROR` option on this socket.
+    ///
+    /// see `TcpListener::take_error` for details
+    Result<int, int> take_error() noexcept;
+
+    /// Returns the underlying file descriptor.
+    ///
+    /// NOTE:
+    ///
+    /// The returned fd may be invalidated after some methods such as
+    /// `operator=`
+    [[nodiscard]] int as_fd() const noexcept {
+        return fd_;
+    }
+
+    /// Returns the underlying file descriptor and leaving it invalid.
+    [[nodiscard]] int into_fd() noexcept {
+        return std::exchange(fd_, -1);
+    }
+
+    /// Swaps
+    void swap(UnixListener& rhs) noexcept {
+        std::swap(fd_, rhs.fd_);
+    }
+
+private:
+    int fd_;
+};
+
+/// UnixDatagram
+///
+/// A Unix domain datagram socket with RAII semantics.
+///
+/// Unlike UDP, datagrams are reliable and ordered, and a sender blocks, or
+/// gets `EAGAIN`, while the receive queue of the peer is full.
+///
+/// # Examples
+///
+/// ```
+/// auto socket = UnixDatagram::bind(
+///     UnixSocketAddress::from_abstract("app.events").value()).value();
+/// char buf[64];
+/// auto [n, from] = socket.recvfrom(buf, sizeof(buf)).value();
+/// ```
+class UnixDatagram final : public Movable {
+public:
+    /// Constructs a Unix datagram socket from native handle (file
+    /// descriptor). Ownership transfers.
+    explicit UnixDatagram(int fd) noexcept : fd_(fd) {}
+
+    /// Constructs from the given `UnixDatagram`, leaving it invalid
+    UnixDatagram(UnixDatagram&& rhs) noexcept : fd_(rhs.fd_) {
+        rhs.fd_ = -1;
+    }
+
+    UnixDatagram& operator=(UnixDatagram&& rhs) noexcept {
+        UnixDatagram(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /// Close if it's valid.
+    ///
+    /// see `UnixListener::~UnixListener` for details
+    ~UnixDatagram() noexcept;
+
+    /// Creates a new independently owned handle to the underlying socket.
+    Result<UnixDatagram, int> try_clone() noexcept;
+
+    /// Creates a **nonblocking** Unix datagram socket bound to the given
+    /// address.
+    ///
+    /// see `UnixListener::bind` for the notes about pathnames
+    static Result<UnixDatagram, int>
+    bind(const UnixSocketAddress& addr) noexcept;
+
+    /// Creates a **nonblocking** Unix datagram socket which is not bound to
+    /// any address, to send datagrams.
+    static Result<UnixDatagram, int> unbound() noexcept;
+
+    /// Creates a pair of connected **nonblocking** Unix datagram sockets.
+    ///
+    /// `man 2 socketpair` for more information.
+    static Result<std::tuple<UnixDatagram, UnixDatagram>, int> pair() noexcept;
+
+    /// Connects this socket to a remote address, allowing the `send` and
+    /// `recv` syscalls to be used, and only receiving data from that
+    /// address.
+    ///
+    /// `man 2 connect` for more information.
+    Result<Void, int> connect(const UnixSocketAddress& addr) noexcept;
+
+    /// Closes the socket
+    Result<Void, int> close() noexcept;
+
+    /// Sends data on the socket to the connected address.
+    /// On success, returns the number of bytes written.
+    ///
+    /// `man 2 send` for more information.
+    Result<std::size_t, int> send(const void* buf, std::size_t len,
+                                  int flags = 0) noexcept;
+
+    /// Sends data on the socket to the given address.
+    /// On success, returns the number of bytes written.
+    ///
+    /// `man 2 sendto` for more information.
+    Result<std::size_t, int> sendto(const void* buf, std::size_t len,
+                                    const UnixSocketAddress& addr,
+                                    int flags = 0) noexcept;
+
+    /// Sends a message.
+    /// On success, returns the number of bytes written.
+    ///
+    /// `man 2 sendmsg` for more information.
+    Result<std::size_t, int> sendmsg(const struct msghdr* msg,
+                                     int flags = 0) noexcept;
+
+    /// Sends a datagram to the connected address along with the control
+    /// messages of `ancillary`.
+    /// On success, returns the number of bytes written.
+    Result<std::size_t, int>
+    send_with_ancillary(const void* buf, std::size_t len,
+                        SocketAncillary& ancillary, int flags = 0) noexcept;
+
+    /// Receives a datagram from the connected address.
+    /// On success, returns the number of bytes read.
+    ///
+    /// The excess bytes of a datagram longer than `len` are discarded.
+    ///
+    /// `man 2 recv` for more information.
+    Result<std::size_t, int> recv(void* buf, std::size_t len,
+                                  int flags = 0) noexcept;
+
+    /// Receives a datagram.
+    /// On success, returns the number of bytes read and the origin, which
+    /// is unnamed if the sender isn't bound.
+    ///
+    /// `man 2 recvfrom` for more information.
+    Result<std::tuple<std::size_t, UnixSocketAddress>, int>
+    recvfrom(void* buf, std::size_t len, int flags = 0) noexcept;
+
+    /// Receives a message.
+    /// On success, returns the number of bytes read.
+    ///
+    /// `man 2 recvmsg` for more information.
+    Result<std::size_t, int> recvmsg(struct msghdr* msg,
+                                     int flags = 0) noexcept;
+
+    /// Receives a datagram and its control messages into `ancillary`.
+    /// On success, returns the number of bytes read.
+    Result<std::size_t, int>
+    recv_with_ancillary(void* buf, std::size_t len, SocketAncillary& ancillary,
+                        int flags = 0) noexcept;
+
+    /// Returns the socket address that this socket was bound to
+    Result<UnixSocketAddress, int> local_addr() noexcept;
+
+    /// Returns the socket address of the connected peer
+    Result<UnixSocketAddress, int> peer_addr() noexcept;
+
+    /// Sets the value of the `SO_PASSCRED` option on this socket.
+    ///
+    /// see `UnixStream::set_passcred` for details
+    Result<Void, int> set_passcred(bool enable) noexcept;
+
+    /// Gets the value of the `SO_ERROR` option on this socket.
+    ///
+    /// see `UdpSocket::take_error` for details
+    Result<int, int> take_error() noexcept;
+
+    /// Returns the underlying file descriptor.
+    ///
+    /// NOTE:
+    ///
+    /// The returned fd may be invalidated after some methods such as
+    /// `operator=`
+    [[nodiscard]] int as_fd() const noexcept {
+        return fd_;
+    }
+
+    /// Returns the underlying file descriptor and leaving it invalid.
+    [[nodiscard]] int into_fd() noexcept {
+        return std::exchange(fd_, -1);
+    }
+
+    /// Swaps
+    void swap(UnixDatagram& rhs) noexcept {
+        std::swap(fd_, rhs.fd_);
+    }
+
+private:
+    int fd_;
+};
+
+} // namespace bipolar
+
+#endif
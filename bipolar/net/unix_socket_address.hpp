@@ -0,0 +1,198 @@
+//! UnixSocketAddress
+//!
+//! see `UnixSocketAddress` for details
+
+#ifndef BIPOLAR_NET_UNIX_SOCKET_ADDRESS_HPP_
+#define BIPOLAR_NET_UNIX_SOCKET_ADDRESS_HPP_
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+
+namespace bipolar {
+/// UnixSocketAddress
+///
+/// # Brief
+///
+/// The address of a Unix domain socket, one of
+///
+/// - a pathname, bound to a file in the filesystem
+/// - an abstract name, which is Linux specific, doesn't live in the
+///   filesystem and vanishes with the last socket bound to it
+/// - unnamed, for unbound sockets and those created by `socketpair`
+///
+/// # Textual representation
+///
+/// The pathname, `@` followed by the abstract name, or `(unnamed)`, like
+/// `ss` and `netstat` do.
+///
+/// # Examples
+///
+/// ```
+/// auto path = UnixSocketAddress::from_pathname("/run/app.sock").value();
+/// assert(path.as_pathname().value() == "/run/app.sock");
+///
+/// auto name = UnixSocketAddress::from_abstract("app").value();
+/// assert(name.str() == "@app");
+/// ```
+///
+/// `man 7 unix` for more information.
+class UnixSocketAddress {
+public:
+    /// Creates an unnamed address
+    UnixSocketAddress() noexcept : addr_(), len_(kPathOffset) {
+        addr_.sun_family = AF_UNIX;
+    }
+
+    /// Creates a new address bound to `path`
+    ///
+    /// Returns `EINVAL` if it's empty or contains a null character, and
+    /// `ENAMETOOLONG` if it doesn't fit in `sun_path` with its terminator.
+    static Result<UnixSocketAddress, int>
+    from_pathname(std::string_view path) noexcept {
+        if (path.empty() || path.find('\0') != std::string_view::npos) {
+            return Err(EINVAL);
+        }
+        if (path.size() >= sizeof(addr_.sun_path)) {
+            return Err(ENAMETOOLONG);
+        }
+
+        UnixSocketAddress addr;
+        std::memcpy(addr.addr_.sun_path, path.data(), path.size());
+        addr.len_ = static_cast<socklen_t>(kPathOffset + path.size() + 1);
+        return Ok(addr);
+    }
+
+    /// Creates a new address in the abstract namespace
+    ///
+    /// The name may contain any byte, null ones included. Returns
+    /// `ENAMETOOLONG` if it doesn't fit in `sun_path` after the leading null
+    /// byte.
+    static Result<UnixSocketAddress, int>
+    from_abstract(std::string_view name) noexcept {
+        if (name.size() >= sizeof(addr_.sun_path)) {
+            return Err(ENAMETOOLONG);
+        }
+
+        UnixSocketAddress addr;
+        std::memcpy(addr.addr_.sun_path + 1, name.data(), name.size());
+        addr.len_ = static_cast<socklen_t>(kPathOffset + 1 + name.size());
+        return Ok(addr);
+    }
+
+    /// Creates a new address from the native one of `len` bytes, filled by
+    /// `accept`, `recvfrom`, `getsockname`, etc.
+    ///
+    /// An empty one is unnamed, as `recvfrom` fills for unbound senders.
+    /// Returns `EINVAL` if it's not a Unix domain socket address.
+    static Result<UnixSocketAddress, int>
+    from_native(const struct sockaddr* addr, socklen_t len) noexcept {
+        if (len == 0) {
+            return Ok(UnixSocketAddress());
+        }
+        if (len < sizeof(sa_family_t) || addr->sa_family != AF_UNIX ||
+            len > sizeof(struct sockaddr_un)) {
+            return Err(EINVAL);
+        }
+
+        UnixSocketAddress ret;
+        std::memcpy(&ret.addr_, addr, len);
+        ret.len_ = len < kPathOffset ? kPathOffset : len;
+        return Ok(ret);
+    }
+
+    /// Returns the number of bytes system calls may fill
+    static constexpr socklen_t capacity() noexcept {
+        return sizeof(struct sockaddr_un);
+    }
+
+    /// Returns `true` if this address is unnamed
+    [[nodiscard]] bool is_unnamed() const noexcept {
+        return len_ == kPathOffset;
+    }
+
+    /// Returns `true` if this address is in the abstract namespace
+    [[nodiscard]] bool is_abstract() const noexcept {
+        return len_ > kPathOffset && addr_.sun_path[0] == '\0';
+    }
+
+    /// Returns the pathname, if it's bound to one
+    [[nodiscard]] Option<std::string_view> as_pathname() const noexcept {
+        if (is_unnamed() || is_abstract()) {
+            return None;
+        }
+        // the terminator may or may not be counted
+        const std::size_t max = len_ - kPathOffset;
+        return Some(std::string_view(addr_.sun_path,
+                                     ::strnlen(addr_.sun_path, max)));
+    }
+
+    /// Returns the abstract name, without the leading null byte, if it's in
+    /// the abstract namespace
+    [[nodiscard]] Option<std::string_view> as_abstract() const noexcept {
+        if (!is_abstract()) {
+            return None;
+        }
+        return Some(
+            std::string_view(addr_.sun_path + 1, len_ - kPathOffset - 1));
+    }
+
+    /// @{
+    /// Returns the address to pass to system calls
+    [[nodiscard]] const struct sockaddr* get() const noexcept {
+        return reinterpret_cast<const struct sockaddr*>(&addr_);
+    }
+    [[nodiscard]] struct sockaddr* get() noexcept {
+        return reinterpret_cast<struct sockaddr*>(&addr_);
+    }
+    /// @}
+
+    /// Returns the length of the address
+    [[nodiscard]] socklen_t size() const noexcept {
+        return len_;
+    }
+
+    /// Stringify the address
+    [[nodiscard]] std::string str() const {
+        if (is_unnamed()) {
+            return "(unnamed)";
+        }
+        if (is_abstract()) {
+            return "@" + std::string(as_abstract().value());
+        }
+        return std::string(as_pathname().value());
+    }
+
+private:
+    static constexpr socklen_t kPathOffset =
+        offsetof(struct sockaddr_un, sun_path);
+
+    struct sockaddr_un addr_;
+    socklen_t len_;
+};
+
+/// Compares `UnixSocketAddress` with other `UnixSocketAddress`
+inline bool operator==(const UnixSocketAddress& lhs,
+                       const UnixSocketAddress& rhs) noexcept {
+    if (lhs.is_abstract() || rhs.is_abstract()) {
+        return lhs.as_abstract() == rhs.as_abstract();
+    }
+    return lhs.as_pathname() == rhs.as_pathname();
+}
+
+inline bool operator!=(const UnixSocketAddress& lhs,
+                       const UnixSocketAddress& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace bipolar
+
+#endif
@@ -1,165 +1,99 @@
-#include <arpa/inet.h>
-#include <sys/poll.h>
-#include <sys/socket.h>
-#include <sys/types.h>
-#include <unistd.h>
-
+// An echo server over io_uring, epoll or blocking threads, and a load
+// generator measuring it over loopback.
+//
+//     echo server [io_uring|epoll|blocking] [port]
+//     echo load <port> [connections] [payload] [threads] [seconds]
+
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
-#include <vector>
-
-#include "bipolar/io/io_uring.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
 
-#define MAX_CONN 1000
-#define MAX_MSG 1000
-#define PORT 9999
+#include "examples/echo_load.hpp"
+#include "examples/echo_server.hpp"
 
 using namespace bipolar;
+using namespace bipolar::examples;
+
+namespace {
+constexpr std::uint16_t kDefaultPort = 9999;
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s server [io_uring|epoll|blocking] [port]\n"
+                 "       %s load <port> [connections] [payload] [threads] "
+                 "[seconds]\n",
+                 argv0, argv0);
+    return EXIT_FAILURE;
+}
 
-const std::uint64_t LISTEN = 0, ECHO_RECV = 1, ECHO_SEND = 2, ECHO = 3;
-
-#define GET_TYPE(x) ((x) >> 48)
-#define GET_VALUE(x) ((x)&0xffffffffffffull)
-#define TYPE_VALUE(t, v) (((t) << 48) | (v))
-
-struct Connection {
-    int fd;
-    struct iovec iov[2];
-    char buf[MAX_MSG];
-};
-
-#define RX 0
-#define TX 1
-
-Connection conns[MAX_CONN];
-
-int main() {
-    for (std::size_t i = 0; i < MAX_CONN; ++i) {
-        std::memset(&conns[i], 0, sizeof(conns[i]));
-        // RX
-        conns[i].iov[RX].iov_base = conns[i].buf;
-        conns[i].iov[RX].iov_len = MAX_MSG;
+std::size_t arg_or(int argc, char* argv[], int i, std::size_t value) {
+    return argc > i ? std::strtoull(argv[i], nullptr, 10) : value;
+}
 
-        // TX
-        conns[i].iov[TX].iov_base = conns[i].buf;
-        conns[i].iov[TX].iov_len = 0;
+int run_server(int argc, char* argv[]) {
+    const auto mode = parse_echo_mode(argc > 2 ? argv[2] : "io_uring");
+    if (!mode.has_value()) {
+        return usage(argv[0]);
     }
+    const auto port =
+        static_cast<std::uint16_t>(arg_or(argc, argv, 3, kDefaultPort));
 
-    struct io_uring_params p{};
-    IOUring ring(512, &p);
-
-    struct sockaddr_in saddr;
-    std::memset(&saddr, 0, sizeof(saddr));
-    saddr.sin_family = AF_INET;
-    saddr.sin_addr.s_addr = htonl(INADDR_ANY);
-    saddr.sin_port = htons(PORT);
-
-    int sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
-    if (sock < 0) {
-        std::perror("socket");
-        exit(-1);
+    auto listener = TcpListener::bind(SocketAddress(IPv4Address(), port));
+    if (listener.is_error()) {
+        std::fprintf(stderr, "bind: %s\n", std::strerror(listener.error()));
+        return EXIT_FAILURE;
     }
 
-    const int enable_socket_reuseaddr = 1;
-    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable_socket_reuseaddr,
-               sizeof(enable_socket_reuseaddr));
-
-    if (bind(sock, (struct sockaddr*)&saddr, sizeof(saddr)) < 0) {
-        std::perror("bind");
-        exit(-1);
+    std::printf("echo server (%s) listening on port %u\n",
+                echo_mode_name(mode.value()), port);
+    auto served = serve_echo(listener.value(), mode.value());
+    if (served.is_error()) {
+        std::fprintf(stderr, "serve: %s\n", std::strerror(served.error()));
+        return EXIT_FAILURE;
     }
+    return EXIT_SUCCESS;
+}
 
-    if (listen(sock, 100) < 0) {
-        std::perror("listen");
-        exit(-1);
+int run_load(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage(argv[0]);
+    }
+    const auto port = static_cast<std::uint16_t>(arg_or(argc, argv, 2, 0));
+
+    EchoLoadOptions options;
+    options.connections = arg_or(argc, argv, 3, options.connections);
+    options.payload = arg_or(argc, argv, 4, options.payload);
+    options.threads = arg_or(argc, argv, 5, options.threads);
+    options.duration = std::chrono::seconds(arg_or(argc, argv, 6, 5));
+
+    auto report = run_echo_load(
+        SocketAddress(IPv4Address(127, 0, 0, 1), port), options);
+    if (report.is_error()) {
+        std::fprintf(stderr, "load: %s\n", std::strerror(report.error()));
+        return EXIT_FAILURE;
     }
 
-    ring.get_submission_entry().and_then(
-        [sock, &ring](IOUringSQE& sqe) -> Result<Void, Void> {
-            sqe.poll_add(sock, POLLIN);
-            sqe.user_data = TYPE_VALUE(LISTEN, sock);
-            std::puts("polling listen fd");
-            return ring.submit(1);
-        });
-
-    while (auto result = ring.get_completion_entry()) {
-        IOUringCQE& cqe = result.value();
-
-        auto type = GET_TYPE(cqe.user_data);
-        auto value = GET_VALUE(cqe.user_data);
-        switch (type) {
-        case LISTEN:
-            if ((cqe.res & POLLIN) == POLLIN) {
-                const int sock = value;
-                ring.get_submission_entry().and_then(
-                    [sock, &ring](IOUringSQE& sqe) -> Result<Void, Void> {
-                        sqe.poll_add(sock, POLLIN);
-                        sqe.user_data = TYPE_VALUE(LISTEN, sock);
-                        std::puts("polling listen fd again");
-                        return Ok(Void{});
-                    });
-
-                struct sockaddr_in addr;
-                socklen_t len;
-
-                int fd;
-                while ((fd = accept4(sock, (struct sockaddr*)&addr, &len,
-                                     SOCK_NONBLOCK)) != -1) {
-                    if (fd >= MAX_CONN) {
-                        close(fd);
-                        break;
-                    }
-
-                    std::puts("LISTEN: poll client_fd submitted");
-                    ring.get_submission_entry().and_then(
-                        [fd](IOUringSQE& sqe) -> Result<Void, Void> {
-                            sqe.poll_add(fd, POLLIN);
-                            sqe.user_data = TYPE_VALUE(ECHO, fd);
-                            return Ok(Void{});
-                        });
-                }
-            }
-            break;
-
-        case ECHO:
-            if ((cqe.res & POLLIN) == POLLIN) {
-                std::puts("ECHO: readv submitted");
-                ring.get_submission_entry().and_then(
-                    [fd = value](IOUringSQE& sqe) -> Result<Void, Void> {
-                        sqe.readv(fd, &conns[fd].iov[RX], 1, 0);
-                        sqe.user_data = TYPE_VALUE(ECHO_RECV, fd);
-                        return Ok(Void{});
-                    });
-            }
-            break;
-
-        case ECHO_RECV:
-            if (cqe.res == -1 || cqe.res == 0) {
-                close(value);
-            } else {
-                std::puts("ECHO_RECV: writev submitted");
-                conns[value].iov[TX].iov_len = cqe.res;
-                ring.get_submission_entry().and_then(
-                    [fd = value](IOUringSQE& sqe) -> Result<Void, Void> {
-                        sqe.writev(fd, &conns[fd].iov[TX], 1, 0);
-                        sqe.user_data = TYPE_VALUE(ECHO_SEND, fd);
-                        return Ok(Void{});
-                    });
-            }
-            break;
+    const EchoLoadReport& r = report.value();
+    std::printf("connections=%zu payload=%zu threads=%zu\n"
+                "requests=%zu req/s=%.0f p50=%.1fus p99=%.1fus "
+                "p999=%.1fus\n",
+                options.connections, options.payload, options.threads,
+                r.requests, r.requests_per_second(), r.p50.count() / 1e3,
+                r.p99.count() / 1e3, r.p999.count() / 1e3);
+    return EXIT_SUCCESS;
+}
 
-        case ECHO_SEND:
-            std::puts("ECHO_SEND: poll client_fd submitted");
-            ring.get_submission_entry().and_then(
-                [fd = value](IOUringSQE& sqe) -> Result<Void, Void> {
-                    sqe.poll_add(fd, POLLIN);
-                    sqe.user_data = TYPE_VALUE(ECHO, fd);
-                    return Ok(Void{});
-                });
-        }
+} // namespace
 
-        ring.submit(1);
-        ring.seen(1);
+int main(int argc, char* argv[]) {
+    const std::string_view command = argc > 1 ? argv[1] : "";
+    if (command == "server") {
+        return run_server(argc, argv);
+    } else if (command == "load") {
+        return run_load(argc, argv);
     }
-
-    return 0;
+    return usage(argv[0]);
 }
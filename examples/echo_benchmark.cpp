@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#include "examples/echo_load.hpp"
+#include "examples/echo_server.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace bipolar;
+using namespace bipolar::examples;
+
+namespace {
+constexpr auto kDuration = std::chrono::seconds(2);
+
+// Modes × connections × payload sizes
+void echo_loads(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"mode", "conns", "payload"});
+    for (const auto mode :
+         {EchoMode::io_uring, EchoMode::epoll, EchoMode::blocking}) {
+        for (const std::int64_t conns : {1, 64, 512}) {
+            for (const std::int64_t payload : {64, 4096}) {
+                b->Args({static_cast<std::int64_t>(mode), conns, payload});
+            }
+        }
+    }
+}
+
+} // namespace
+
+// A single iteration runs the load generator against a server thread,
+// reporting its throughput and latency percentiles as counters
+static void BM_Echo(benchmark::State& state) {
+    const auto mode = static_cast<EchoMode>(state.range(0));
+    state.SetLabel(echo_mode_name(mode));
+
+    auto listener =
+        TcpListener::bind(SocketAddress(IPv4Address(127, 0, 0, 1), 0))
+            .expect("bind to 127.0.0.1:0 failed");
+    const auto addr = listener.local_addr().value();
+    std::thread server([&listener, mode] {
+        serve_echo(listener, mode).expect("echo server failed");
+    });
+
+    EchoLoadOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    options.connections = state.range(1);
+    options.payload = state.range(2);
+    options.duration = kDuration;
+
+    EchoLoadReport report;
+    for (auto _ : state) {
+        report = run_echo_load(addr, options).expect("echo load failed");
+        state.SetIterationTime(report.elapsed.count() / 1e9);
+    }
+    shutdown_echo_server(listener);
+    server.join();
+
+    state.SetItemsProcessed(report.requests);
+    state.SetBytesProcessed(report.requests * options.payload * 2);
+    state.counters["p50_us"] = report.p50.count() / 1e3;
+    state.counters["p99_us"] = report.p99.count() / 1e3;
+    state.counters["p999_us"] = report.p999.count() / 1e3;
+}
+BENCHMARK(BM_Echo)->Apply(echo_loads)->Iterations(1)->UseManualTime();
@@ -0,0 +1,249 @@
+#include "examples/echo_load.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bipolar/net/epoll.hpp"
+#include "bipolar/net/tcp.hpp"
+
+namespace bipolar {
+namespace examples {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kMaxEvents = 256;
+constexpr std::size_t kMinRecvSize = 64 * 1024;
+constexpr std::chrono::milliseconds kPollInterval{10};
+
+struct LoadConnection {
+    TcpStream stream;
+    std::size_t written = 0;
+    std::size_t read = 0;
+    bool waiting_out = false;
+    Clock::time_point start;
+};
+
+// The connections of a thread
+class LoadWorker {
+public:
+    explicit LoadWorker(const std::vector<char>& payload)
+        : payload_(payload), scratch_(std::max(payload.size(), kMinRecvSize)) {}
+
+    void add(TcpStream stream) {
+        conns_.push_back(LoadConnection{std::move(stream)});
+    }
+
+    // Measures the requests started from `measure_from` and completed
+    // before `deadline`. Returns 0 or the errno of the first failure
+    int run(Clock::time_point measure_from, Clock::time_point deadline) {
+        measure_from_ = measure_from;
+        deadline_ = deadline;
+
+        auto epoll_result = Epoll::create();
+        if (epoll_result.is_error()) {
+            return epoll_result.error();
+        }
+        Epoll& epoll = epoll_result.value();
+
+        for (std::size_t i = 0; i < conns_.size(); ++i) {
+            const int fd = conns_[i].stream.as_fd();
+            auto added = epoll.add(fd, static_cast<int>(i), EPOLLIN);
+            if (added.is_error()) {
+                return added.error();
+            }
+            conns_[i].start = Clock::now();
+            if (const int err = send_request(epoll, i); err != 0) {
+                return err;
+            }
+        }
+
+        std::vector<struct epoll_event> events;
+        while (Clock::now() < deadline_) {
+            // `poll` shrinks `events` to the ready ones
+            events.resize(kMaxEvents);
+            auto polled = epoll.poll(events, kPollInterval);
+            if (polled.is_error()) {
+                if (polled.error() == EINTR) {
+                    continue;
+                }
+                return polled.error();
+            }
+
+            for (const auto& event : events) {
+                const auto i = static_cast<std::size_t>(event.data.fd);
+                if (event.events & EPOLLOUT) {
+                    if (const int err = send_request(epoll, i); err != 0) {
+                        return err;
+                    }
+                }
+                if (event.events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                    if (const int err = recv_response(epoll, i); err != 0) {
+                        return err;
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+
+    std::vector<std::int64_t>& latencies() noexcept {
+        return latencies_;
+    }
+
+private:
+    int send_request(Epoll& epoll, std::size_t i) {
+        LoadConnection& conn = conns_[i];
+        const int fd = conn.stream.as_fd();
+        while (conn.written < payload_.size()) {
+            auto n = conn.stream.send(payload_.data() + conn.written,
+                                      payload_.size() - conn.written,
+                                      MSG_NOSIGNAL);
+            if (n.is_error()) {
+                if (n.error() != EAGAIN) {
+                    return n.error();
+                }
+                if (!conn.waiting_out) {
+                    conn.waiting_out = true;
+                    auto modified = epoll.mod(fd, static_cast<int>(i),
+                                              EPOLLIN | EPOLLOUT);
+                    return modified.is_error() ? modified.error() : 0;
+                }
+                return 0;
+            }
+            conn.written += n.value();
+        }
+
+        if (conn.waiting_out) {
+            conn.waiting_out = false;
+            auto modified = epoll.mod(fd, static_cast<int>(i), EPOLLIN);
+            return modified.is_error() ? modified.error() : 0;
+        }
+        return 0;
+    }
+
+    int recv_response(Epoll& epoll, std::size_t i) {
+        LoadConnection& conn = conns_[i];
+        auto n = conn.stream.recv(scratch_.data(), scratch_.size(), 0);
+        if (n.is_error()) {
+            return n.error() == EAGAIN ? 0 : n.error();
+        }
+        if (n.value() == 0) {
+            return ECONNRESET;
+        }
+
+        conn.read += n.value();
+        if (conn.read < payload_.size()) {
+            return 0;
+        }
+
+        const auto now = Clock::now();
+        if (conn.start >= measure_from_ && now < deadline_) {
+            latencies_.push_back((now - conn.start).count());
+        }
+        conn.written = 0;
+        conn.read = 0;
+        conn.start = now;
+        return send_request(epoll, i);
+    }
+
+    const std::vector<char>& payload_;
+    Clock::time_point measure_from_;
+    Clock::time_point deadline_;
+    std::vector<char> scratch_;
+    std::vector<LoadConnection> conns_;
+    std::vector<std::int64_t> latencies_;
+};
+
+std::chrono::nanoseconds percentile(const std::vector<std::int64_t>& sorted,
+                                    double q) noexcept {
+    if (sorted.empty()) {
+        return std::chrono::nanoseconds(0);
+    }
+    const auto i = std::min(sorted.size() - 1,
+                            static_cast<std::size_t>(q * sorted.size()));
+    return std::chrono::nanoseconds(sorted[i]);
+}
+
+} // namespace
+
+Result<EchoLoadReport, int> run_echo_load(const SocketAddress& server,
+                                          const EchoLoadOptions& options) {
+    if (options.threads == 0 || options.connections == 0 ||
+        options.payload == 0) {
+        return Err(EINVAL);
+    }
+
+    const std::vector<char> payload(options.payload, 'x');
+    const std::size_t nthreads =
+        std::min(options.threads, options.connections);
+
+    std::vector<LoadWorker> workers;
+    workers.reserve(nthreads);
+    for (std::size_t i = 0; i < nthreads; ++i) {
+        workers.emplace_back(payload);
+    }
+
+    for (std::size_t i = 0; i < options.connections; ++i) {
+        auto stream = TcpStream::connect(server);
+        if (stream.is_error()) {
+            return Err(stream.error());
+        }
+
+        const int optval = 1;
+        ::setsockopt(stream.value().as_fd(), IPPROTO_TCP, TCP_NODELAY,
+                     &optval, sizeof(optval));
+        auto nonblocking = stream.value().set_nonblocking(true);
+        if (nonblocking.is_error()) {
+            return Err(nonblocking.error());
+        }
+        workers[i % nthreads].add(std::move(stream.value()));
+    }
+
+    const auto measure_from = Clock::now() + options.warmup;
+    const auto deadline = measure_from + options.duration;
+    std::vector<int> errors(nthreads);
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+    for (std::size_t i = 0; i < nthreads; ++i) {
+        threads.emplace_back(
+            [&workers, &errors, i, measure_from, deadline] {
+                errors[i] = workers[i].run(measure_from, deadline);
+            });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const int err : errors) {
+        if (err != 0) {
+            return Err(err);
+        }
+    }
+
+    std::vector<std::int64_t> latencies;
+    for (auto& worker : workers) {
+        auto& l = worker.latencies();
+        latencies.insert(latencies.end(), l.begin(), l.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    EchoLoadReport report;
+    report.requests = latencies.size();
+    report.elapsed = options.duration;
+    report.p50 = percentile(latencies, 0.5);
+    report.p99 = percentile(latencies, 0.99);
+    report.p999 = percentile(latencies, 0.999);
+    return Ok(report);
+}
+
+} // namespace examples
+} // namespace bipolar
@@ -0,0 +1,62 @@
+/// \file echo_load.hpp
+/// A closed-loop load generator for the echo servers
+
+#ifndef BIPOLAR_EXAMPLES_ECHO_LOAD_HPP_
+#define BIPOLAR_EXAMPLES_ECHO_LOAD_HPP_
+
+#include <chrono>
+#include <cstddef>
+
+#include "bipolar/core/result.hpp"
+#include "bipolar/net/socket_address.hpp"
+
+namespace bipolar {
+namespace examples {
+/// \struct EchoLoadOptions
+/// \brief The shape of the load
+struct EchoLoadOptions {
+    /// \brief The number of threads driving the connections
+    std::size_t threads = 1;
+
+    /// \brief The number of connections, spread over the threads
+    std::size_t connections = 64;
+
+    /// \brief The size of a request, echoed back as its response
+    std::size_t payload = 64;
+
+    /// \brief The requests completed within are measured
+    std::chrono::milliseconds duration{5000};
+
+    /// \brief The requests started within aren't measured
+    std::chrono::milliseconds warmup{500};
+};
+
+/// \struct EchoLoadReport
+/// \brief Throughput and latency percentiles of the measured requests
+struct EchoLoadReport {
+    std::size_t requests = 0;
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds p999{0};
+
+    /// \brief Returns the number of requests per second
+    double requests_per_second() const noexcept {
+        return elapsed.count() > 0 ? requests * 1e9 / elapsed.count() : 0.0;
+    }
+};
+
+/// \brief Connects \c options.connections to \c server, each sending a
+/// request once the previous one is echoed back, and measures the
+/// round trips.
+///
+/// The connections are closed on return.
+///
+/// \return the report, or \c Err with the errno of the first failure
+Result<EchoLoadReport, int> run_echo_load(const SocketAddress& server,
+                                          const EchoLoadOptions& options);
+
+} // namespace examples
+} // namespace bipolar
+
+#endif
@@ -0,0 +1,388 @@
+#include "examples/echo_server.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bipolar/io/internal/blocking.hpp"
+#include "bipolar/io/io_uring.hpp"
+#include "bipolar/io/io_uring_op.hpp"
+#include "bipolar/net/epoll.hpp"
+
+namespace bipolar {
+namespace examples {
+namespace {
+constexpr std::size_t kBufferSize = 16 * 1024;
+constexpr unsigned kRingEntries = 256;
+constexpr std::size_t kMaxEvents = 256;
+
+void set_nodelay(int fd) noexcept {
+    const int optval = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
+}
+
+// io_uring: every connection is a pooled operation alternating between a
+// recv and the sends echoing it back. The handlers only queue SQEs, which
+// are submitted by a single `io_uring_enter` per loop iteration.
+class UringEchoServer;
+
+struct UringConnection {
+    UringEchoServer* server;
+    int fd;
+    std::size_t len = 0;
+    std::size_t sent = 0;
+    char buf[kBufferSize];
+};
+
+using UringPool = IOUringOpPool<UringConnection>;
+
+class UringEchoServer {
+public:
+    UringEchoServer(IOUring& ring, int listener) noexcept
+        : ring_(ring), listener_(listener) {
+        acceptor_.handler = &UringEchoServer::on_accept;
+        acceptor_.server = this;
+    }
+
+    Result<Void, int> run() {
+        accept();
+        while (accepting_ || pool_.in_use() > 0) {
+            auto submitted = ring_.submit(1);
+            if (submitted.is_ok() && submitted.value() == 0) {
+                submitted = ring_.wait_completions(1).map(
+                    [](std::size_t) { return 0; });
+            }
+            if (submitted.is_error() && submitted.error() != EINTR) {
+                return Err(submitted.error());
+            }
+            dispatch_completions(ring_);
+        }
+        return Ok(Void{});
+    }
+
+private:
+    struct Acceptor : IOUringOp {
+        UringEchoServer* server;
+    };
+
+    void accept() {
+        IOUringSQE sqe;
+        sqe.accept(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+        sqe.user_data = acceptor_.user_data();
+        ring_.queue_submission_entry(sqe);
+    }
+
+    void recv(UringPool::Op& op) {
+        UringConnection& conn = op.state();
+        IOUringSQE sqe;
+        sqe.recv(conn.fd, conn.buf, kBufferSize, 0);
+        sqe.user_data = op.user_data();
+        ring_.queue_submission_entry(sqe);
+    }
+
+    void send(UringPool::Op& op) {
+        UringConnection& conn = op.state();
+        IOUringSQE sqe;
+        sqe.send(conn.fd, conn.buf + conn.sent, conn.len - conn.sent,
+                 MSG_NOSIGNAL);
+        sqe.user_data = op.user_data();
+        ring_.queue_submission_entry(sqe);
+    }
+
+    void close(UringPool::Op& op) {
+        ::close(op.state().fd);
+        pool_.release(&op);
+    }
+
+    static void on_accept(IOUringOp& op, const IOUringCQE& cqe) {
+        UringEchoServer& server = *static_cast<Acceptor&>(op).server;
+        if (cqe.res < 0) {
+            // `EINVAL` once the listener is shut down
+            if (cqe.res == -EINTR || cqe.res == -ECONNABORTED) {
+                server.accept();
+            } else {
+                server.accepting_ = false;
+            }
+            return;
+        }
+
+        set_nodelay(cqe.res);
+        server.recv(*server.pool_.acquire<on_recv>(&server, cqe.res));
+        server.accept();
+    }
+
+    static void on_recv(UringPool::Op& op, const IOUringCQE& cqe) {
+        UringConnection& conn = op.state();
+        if (cqe.res <= 0) {
+            conn.server->close(op);
+            return;
+        }
+
+        conn.len = cqe.res;
+        conn.sent = 0;
+        UringPool::bind<on_send>(op);
+        conn.server->send(op);
+    }
+
+    static void on_send(UringPool::Op& op, const IOUringCQE& cqe) {
+        UringConnection& conn = op.state();
+        if (cqe.res < 0) {
+            conn.server->close(op);
+            return;
+        }
+
+        conn.sent += cqe.res;
+        if (conn.sent < conn.len) {
+            conn.server->send(op);
+            return;
+        }
+        UringPool::bind<on_recv>(op);
+        conn.server->recv(op);
+    }
+
+    IOUring& ring_;
+    int listener_;
+    Acceptor acceptor_;
+    bool accepting_ = true;
+    UringPool pool_;
+};
+
+Result<Void, int> serve_io_uring(TcpListener& listener) {
+    internal::set_blocking(listener.as_fd());
+
+    IOUringOptions options;
+    options.entries = kRingEntries;
+    options.single_issuer = true;
+    options.defer_taskrun = true;
+    options.register_ring_fd = true;
+    IOUring ring(options);
+
+    return UringEchoServer(ring, listener.as_fd()).run();
+}
+
+// epoll: level-triggered readiness of nonblocking sockets, a connection
+// waits for `EPOLLOUT` only when the socket buffer is full
+struct EpollConnection {
+    TcpStream stream;
+    std::size_t len = 0;
+    std::size_t sent = 0;
+    char buf[kBufferSize];
+};
+
+// Returns false if the connection must be closed
+bool flush(Epoll& epoll, EpollConnection& conn) {
+    while (conn.sent < conn.len) {
+        auto n = conn.stream.send(conn.buf + conn.sent, conn.len - conn.sent,
+                                  MSG_NOSIGNAL);
+        if (n.is_error()) {
+            if (n.error() != EAGAIN) {
+                return false;
+            }
+            return epoll.mod(conn.stream.as_fd(), conn.stream.as_fd(),
+                             EPOLLOUT)
+                .is_ok();
+        }
+        conn.sent += n.value();
+    }
+    return true;
+}
+
+bool on_ready(Epoll& epoll, EpollConnection& conn) {
+    if (conn.sent < conn.len) {
+        if (!flush(epoll, conn)) {
+            return false;
+        }
+        if (conn.sent < conn.len) {
+            return true;
+        }
+        if (epoll.mod(conn.stream.as_fd(), conn.stream.as_fd(), EPOLLIN)
+                .is_error()) {
+            return false;
+        }
+    }
+
+    auto n = conn.stream.recv(conn.buf, kBufferSize, 0);
+    if (n.is_error()) {
+        return n.error() == EAGAIN;
+    }
+    if (n.value() == 0) {
+        return false;
+    }
+
+    conn.len = n.value();
+    conn.sent = 0;
+    return flush(epoll, conn);
+}
+
+Result<Void, int> serve_epoll(TcpListener& listener) {
+    auto epoll_result = Epoll::create();
+    if (epoll_result.is_error()) {
+        return Err(epoll_result.error());
+    }
+    Epoll& epoll = epoll_result.value();
+
+    // nonblocking since bound
+    const int listener_fd = listener.as_fd();
+    auto added = epoll.add(listener_fd, listener_fd, EPOLLIN);
+    if (added.is_error()) {
+        return Err(added.error());
+    }
+
+    bool accepting = true;
+    std::unordered_map<int, std::unique_ptr<EpollConnection>> conns;
+    std::vector<struct epoll_event> events;
+    while (accepting || !conns.empty()) {
+        // `poll` shrinks `events` to the ready ones
+        events.resize(kMaxEvents);
+        auto polled = epoll.poll(events, std::chrono::milliseconds(-1));
+        if (polled.is_error()) {
+            if (polled.error() == EINTR) {
+                continue;
+            }
+            return Err(polled.error());
+        }
+
+        for (const auto& event : events) {
+            const int fd = event.data.fd;
+            if (fd != listener_fd) {
+                auto it = conns.find(fd);
+                if (!on_ready(epoll, *it->second)) {
+                    (void)epoll.del(fd);
+                    conns.erase(it);
+                }
+                continue;
+            }
+
+            while (true) {
+                auto accepted = listener.accept();
+                if (accepted.is_error()) {
+                    // `EINVAL` once the listener is shut down
+                    if (accepted.error() != EAGAIN &&
+                        accepted.error() != ECONNABORTED) {
+                        (void)epoll.del(listener_fd);
+                        accepting = false;
+                    }
+                    break;
+                }
+
+                auto conn = std::make_unique<EpollConnection>(
+                    EpollConnection{std::move(std::get<0>(accepted.value()))});
+                const int conn_fd = conn->stream.as_fd();
+                set_nodelay(conn_fd);
+                if (epoll.add(conn_fd, conn_fd, EPOLLIN).is_ok()) {
+                    conns.emplace(conn_fd, std::move(conn));
+                }
+            }
+        }
+    }
+    return Ok(Void{});
+}
+
+// blocking: a thread per connection, as a baseline
+void echo_blocking(TcpStream stream) {
+    std::unique_ptr<char[]> buf(new char[kBufferSize]);
+    while (true) {
+        auto n = stream.recv(buf.get(), kBufferSize, 0);
+        if (n.is_error() && n.error() == EINTR) {
+            continue;
+        }
+        if (n.is_error() || n.value() == 0) {
+            return;
+        }
+
+        for (std::size_t sent = 0; sent < n.value();) {
+            auto m = stream.send(buf.get() + sent, n.value() - sent,
+                                 MSG_NOSIGNAL);
+            if (m.is_error()) {
+                if (m.error() == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            sent += m.value();
+        }
+    }
+}
+
+Result<Void, int> serve_blocking(TcpListener& listener) {
+    internal::set_blocking(listener.as_fd());
+
+    std::vector<std::thread> threads;
+    while (true) {
+        auto accepted = listener.accept();
+        if (accepted.is_error()) {
+            // `EINVAL` once the listener is shut down
+            if (accepted.error() == EINTR ||
+                accepted.error() == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+
+        TcpStream& stream = std::get<0>(accepted.value());
+        (void)stream.set_nonblocking(false);
+        set_nodelay(stream.as_fd());
+        threads.emplace_back(echo_blocking, std::move(stream));
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    return Ok(Void{});
+}
+
+} // namespace
+
+Option<EchoMode> parse_echo_mode(std::string_view s) noexcept {
+    if (s == "io_uring") {
+        return Some(EchoMode::io_uring);
+    } else if (s == "epoll") {
+        return Some(EchoMode::epoll);
+    } else if (s == "blocking") {
+        return Some(EchoMode::blocking);
+    }
+    return None;
+}
+
+const char* echo_mode_name(EchoMode mode) noexcept {
+    switch (mode) {
+    case EchoMode::io_uring:
+        return "io_uring";
+    case EchoMode::epoll:
+        return "epoll";
+    case EchoMode::blocking:
+        return "blocking";
+    }
+    return "unknown";
+}
+
+Result<Void, int> serve_echo(TcpListener& listener, EchoMode mode) {
+    switch (mode) {
+    case EchoMode::io_uring:
+        return serve_io_uring(listener);
+    case EchoMode::epoll:
+        return serve_epoll(listener);
+    case EchoMode::blocking:
+        return serve_blocking(listener);
+    }
+    return Err(EINVAL);
+}
+
+void shutdown_echo_server(TcpListener& listener) noexcept {
+    ::shutdown(listener.as_fd(), SHUT_RD);
+}
+
+} // namespace examples
+} // namespace bipolar
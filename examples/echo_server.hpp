@@ -0,0 +1,50 @@
+/// \file echo_server.hpp
+/// Echo servers over the I/O models of bipolar, sharing the same protocol
+/// so that \c run_echo_load can compare them
+
+#ifndef BIPOLAR_EXAMPLES_ECHO_SERVER_HPP_
+#define BIPOLAR_EXAMPLES_ECHO_SERVER_HPP_
+
+#include <string_view>
+
+#include "bipolar/core/option.hpp"
+#include "bipolar/core/result.hpp"
+#include "bipolar/core/void.hpp"
+#include "bipolar/net/tcp.hpp"
+
+namespace bipolar {
+namespace examples {
+/// \enum EchoMode
+/// \brief The I/O model of an echo server
+enum class EchoMode {
+    /// A single thread submitting recv/send to an \c IOUring
+    io_uring,
+    /// A single thread waiting for readiness on an \c Epoll
+    epoll,
+    /// A blocking thread per connection
+    blocking,
+};
+
+/// \brief Parses \c io_uring, \c epoll or \c blocking
+Option<EchoMode> parse_echo_mode(std::string_view s) noexcept;
+
+/// \brief Returns the name of \c mode
+const char* echo_mode_name(EchoMode mode) noexcept;
+
+/// \brief Echoes the data of the connections accepted by \c listener on the
+/// calling thread.
+///
+/// Returns once \c listener is shut down (see \c shutdown_echo_server) and
+/// all its connections are closed by the peers.
+///
+/// \return \c Ok, or \c Err with the errno of a failed setup
+Result<Void, int> serve_echo(TcpListener& listener, EchoMode mode);
+
+/// \brief Stops \c listener from accepting connections, which makes
+/// \c serve_echo return once the connections are closed
+void shutdown_echo_server(TcpListener& listener) noexcept;
+
+} // namespace examples
+} // namespace bipolar
+
+#endif